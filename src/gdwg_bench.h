@@ -0,0 +1,72 @@
+#ifndef GDWG_BENCH_H
+#define GDWG_BENCH_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Minimal benchmark harness shared by the *.bench.cpp programs
+// Every measurement is printed as one JSON object per line so results can be collected and compared
+namespace gdwg::bench {
+	// A named parameter of a measurement, printed as a JSON number
+	using parameter = std::pair<std::string, double>;
+
+	// Run fn repetitions times and return the fastest run in seconds
+	template<typename F>
+	double best_of(std::size_t repetitions, F&& fn) {
+		auto best = std::numeric_limits<double>::infinity();
+		for (std::size_t i = 0; i < std::max<std::size_t>(1, repetitions); ++i) {
+			auto const start = std::chrono::steady_clock::now();
+			fn();
+			auto const stop = std::chrono::steady_clock::now();
+			best = std::min(best, std::chrono::duration<double>(stop - start).count());
+		}
+		return best;
+	}
+
+	// Run setup() and then fn() repetitions times and return the fastest fn() in seconds; setup() is not timed
+	template<typename Setup, typename F>
+	double best_of(std::size_t repetitions, Setup&& setup, F&& fn) {
+		auto best = std::numeric_limits<double>::infinity();
+		for (std::size_t i = 0; i < std::max<std::size_t>(1, repetitions); ++i) {
+			setup();
+			auto const start = std::chrono::steady_clock::now();
+			fn();
+			auto const stop = std::chrono::steady_clock::now();
+			best = std::min(best, std::chrono::duration<double>(stop - start).count());
+		}
+		return best;
+	}
+
+	// Print one measurement: {"benchmark": name, <parameters>, "seconds": seconds, <metrics>}
+	inline void report(std::ostream& os,
+	                   std::string const& name,
+	                   std::vector<parameter> const& parameters,
+	                   double seconds,
+	                   std::vector<parameter> const& metrics = {}) {
+		auto const precision = os.precision(15); // Keep counts exact
+		os << "{\"benchmark\": \"" << name << '"';
+		for (auto const& [key, value] : parameters) {
+			os << ", \"" << key << "\": " << value;
+		}
+		os << ", \"seconds\": " << seconds;
+		for (auto const& [key, value] : metrics) {
+			os << ", \"" << key << "\": " << value;
+		}
+		os << "}\n";
+		os.precision(precision);
+	}
+
+	// Read the i-th command line argument as a number, falling back to a default
+	inline std::size_t argument(int argc, char** argv, int i, std::size_t fallback) {
+		return i < argc ? static_cast<std::size_t>(std::strtoull(argv[i], nullptr, 10)) : fallback;
+	}
+} // namespace gdwg::bench
+
+#endif // GDWG_BENCH_H
@@ -0,0 +1,525 @@
+#ifndef GDWG_BINARY_H
+#define GDWG_BINARY_H
+
+#include "gdwg_builder.h"
+#include "gdwg_csr.h"
+#include "gdwg_graph.h"
+#include "gdwg_mapped_file.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Versioned binary graph files that are memory-mapped and queried in place
+//
+// Layout (all integers in the writer's byte order, every section 8-byte aligned):
+//   header        binary_header, with an endianness tag and checksums of itself and of the rest of the file
+//   nodes         N[n] in ascending order, or for strings u64[n] positions into node_data
+//   node_data     strings only: length-prefixed entries (u64 length, bytes, padding to 8)
+//   offsets       u64[n + 1], CSR row offsets
+//   targets       u64[m], target node index of every edge; rows are sorted by (target, weight)
+//   weights       E[m] (zero bytes for unweighted edges), or for strings u64[m] positions into weight_data
+//   weight_data   strings only: length-prefixed entries
+//   unweighted    u64[(m + 63) / 64], bit e set if edge e has no weight
+// Node and weight types must be trivially copyable or std::string
+namespace gdwg {
+	namespace detail {
+		enum class binary_kind : std::uint32_t { trivial = 0, string = 1 };
+
+		template<typename T>
+		struct binary_codec {
+			static_assert(std::is_trivially_copyable_v<T>,
+			              "gdwg binary graph files need trivially copyable node and weight types, or std::string");
+			static constexpr auto kind = binary_kind::trivial;
+			static constexpr auto size = static_cast<std::uint32_t>(sizeof(T));
+			using view = T;
+		};
+
+		template<>
+		struct binary_codec<std::string> {
+			static constexpr auto kind = binary_kind::string;
+			static constexpr auto size = std::uint32_t{0};
+			using view = std::string_view;
+		};
+
+		inline constexpr auto binary_magic = std::array<char, 8>{'G', 'D', 'W', 'G', 'C', 'S', 'R', '\0'};
+		inline constexpr auto binary_version = std::uint32_t{1};
+		inline constexpr auto binary_endian = std::uint64_t{0x0102030405060708};
+
+		struct binary_header {
+			std::array<char, 8> magic;
+			std::uint64_t endian; // binary_endian as written; reads back byte-swapped on the other byte order
+			std::uint32_t version;
+			std::uint32_t flags; // Reserved, 0
+			binary_kind node_kind;
+			std::uint32_t node_size;
+			binary_kind weight_kind;
+			std::uint32_t weight_size;
+			std::uint64_t node_count;
+			std::uint64_t edge_count;
+			// Byte offsets of the sections from the start of the file
+			std::uint64_t nodes;
+			std::uint64_t node_data;
+			std::uint64_t offsets;
+			std::uint64_t targets;
+			std::uint64_t weights;
+			std::uint64_t weight_data;
+			std::uint64_t unweighted;
+			std::uint64_t file_size;
+			std::uint64_t payload_checksum; // Of every byte after the header
+			std::uint64_t header_checksum; // Of the header with this field zero
+		};
+
+		inline std::uint64_t align8(std::uint64_t bytes) {
+			return (bytes + 7) / 8 * 8;
+		}
+
+		// Streaming 64-bit checksum over 8-byte words (a multiply-rotate hash with a final avalanche); the
+		// result does not depend on how the input is split between calls
+		class checksum64 {
+		 public:
+			void update(void const* data, std::size_t size) {
+				auto const* bytes = static_cast<unsigned char const*>(data);
+				while (size > 0 and pending_size_ > 0) {
+					pending_[pending_size_++] = *bytes++;
+					--size;
+					if (pending_size_ == 8) {
+						mix(pending_.data());
+						pending_size_ = 0;
+					}
+				}
+				for (; size >= 8; size -= 8, bytes += 8) {
+					mix(bytes);
+				}
+				for (; size > 0; --size) {
+					pending_[pending_size_++] = *bytes++;
+				}
+			}
+
+			[[nodiscard]] std::uint64_t value() const {
+				auto copy = *this;
+				if (copy.pending_size_ > 0) {
+					auto const used = static_cast<std::ptrdiff_t>(copy.pending_size_);
+					std::fill(copy.pending_.begin() + used, copy.pending_.end(), 0);
+					copy.mix(copy.pending_.data());
+					copy.length_ -= 8 - copy.pending_size_;
+				}
+				auto h = copy.state_ ^ copy.length_;
+				h = (h ^ (h >> 33)) * 0xff51afd7ed558ccdULL;
+				h = (h ^ (h >> 33)) * 0xc4ceb9fe1a85ec53ULL;
+				return h ^ (h >> 33);
+			}
+
+		 private:
+			void mix(unsigned char const* word) {
+				auto w = std::uint64_t{0};
+				std::memcpy(&w, word, 8);
+				state_ = std::rotl(state_ ^ (w * 0x87c37b91114253d5ULL), 31) * 0x4cf5ad432745937fULL;
+				length_ += 8;
+			}
+
+			std::uint64_t state_ = 0x9e3779b97f4a7c15ULL;
+			std::uint64_t length_ = 0;
+			std::array<unsigned char, 8> pending_ = {};
+			std::size_t pending_size_ = 0;
+		};
+
+		inline std::uint64_t header_checksum(binary_header header) {
+			header.header_checksum = 0;
+			auto sum = checksum64{};
+			sum.update(&header, sizeof(header));
+			return sum.value();
+		}
+
+		// Sequential file writer that checksums everything after the header
+		class binary_file_writer {
+		 public:
+			explicit binary_file_writer(std::string const& path)
+			: out_(path, std::ios::binary | std::ios::trunc) {
+				if (!out_) {
+					throw std::runtime_error("Cannot call gdwg::save_binary: cannot open " + path);
+				}
+				auto const blank = binary_header{};
+				out_.write(reinterpret_cast<char const*>(&blank), sizeof(blank));
+				position_ = sizeof(blank);
+			}
+
+			void write(void const* data, std::size_t size) {
+				out_.write(static_cast<char const*>(data), static_cast<std::streamsize>(size));
+				checksum_.update(data, size);
+				position_ += size;
+			}
+
+			void write_word(std::uint64_t word) {
+				write(&word, sizeof(word));
+			}
+
+			// Pad with zero bytes up to the given position
+			void pad_to(std::uint64_t position) {
+				static constexpr auto zeros = std::array<char, 8>{};
+				while (position_ < position) {
+					write(zeros.data(), std::min<std::uint64_t>(zeros.size(), position - position_));
+				}
+			}
+
+			[[nodiscard]] std::uint64_t position() const noexcept {
+				return position_;
+			}
+
+			// Fill in the header's checksums and write it over the placeholder
+			void finish(binary_header header, std::string const& path) {
+				header.payload_checksum = checksum_.value();
+				header.header_checksum = header_checksum(header);
+				out_.seekp(0);
+				out_.write(reinterpret_cast<char const*>(&header), sizeof(header));
+				out_.flush();
+				if (!out_) {
+					throw std::runtime_error("Cannot call gdwg::save_binary: writing " + path + " failed");
+				}
+			}
+
+		 private:
+			std::ofstream out_;
+			checksum64 checksum_;
+			std::uint64_t position_ = 0;
+		};
+
+		// Bytes taken by a section of values: the value array itself, or the positions and entries of strings
+		template<typename T, typename Get>
+		std::uint64_t section_size(std::size_t count, Get const& get) {
+			if constexpr (binary_codec<T>::kind == binary_kind::string) {
+				auto bytes = std::uint64_t{count * 8};
+				for (std::size_t i = 0; i < count; ++i) {
+					bytes += 8 + align8(get(i).size());
+				}
+				return bytes;
+			}
+			else {
+				return count * sizeof(T);
+			}
+		}
+
+		// Lay out a file with n nodes and m edges, given the bytes taken by the node and weight sections
+		// (including their string data); the checksums are left to binary_file_writer::finish
+		template<typename N, typename E>
+		binary_header
+		make_binary_header(std::uint64_t n, std::uint64_t m, std::uint64_t node_bytes, std::uint64_t weight_bytes) {
+			auto header = binary_header{};
+			header.magic = binary_magic;
+			header.endian = binary_endian;
+			header.version = binary_version;
+			header.node_kind = binary_codec<N>::kind;
+			header.node_size = binary_codec<N>::size;
+			header.weight_kind = binary_codec<E>::kind;
+			header.weight_size = binary_codec<E>::size;
+			header.node_count = n;
+			header.edge_count = m;
+			header.nodes = sizeof(binary_header);
+			header.node_data = binary_codec<N>::kind == binary_kind::string ? header.nodes + n * 8 : 0;
+			header.offsets = align8(header.nodes + node_bytes);
+			header.targets = header.offsets + (n + 1) * 8;
+			header.weights = header.targets + m * 8;
+			header.weight_data = binary_codec<E>::kind == binary_kind::string ? header.weights + m * 8 : 0;
+			header.unweighted = align8(header.weights + weight_bytes);
+			header.file_size = header.unweighted + (m + 63) / 64 * 8;
+			return header;
+		}
+
+		// Write a section laid out by section_size
+		template<typename T, typename Get>
+		void write_section(binary_file_writer& out, std::uint64_t data_start, std::size_t count, Get const& get) {
+			if constexpr (binary_codec<T>::kind == binary_kind::string) {
+				auto position = std::uint64_t{0};
+				for (std::size_t i = 0; i < count; ++i) {
+					out.write_word(position);
+					position += 8 + align8(get(i).size());
+				}
+				out.pad_to(data_start);
+				for (std::size_t i = 0; i < count; ++i) {
+					auto const& value = get(i);
+					out.write_word(value.size());
+					out.write(value.data(), value.size());
+					out.pad_to(align8(out.position()));
+				}
+			}
+			else {
+				for (std::size_t i = 0; i < count; ++i) {
+					auto const value = T(get(i));
+					out.write(&value, sizeof(T));
+				}
+			}
+		}
+	} // namespace detail
+
+	// Save a snapshot as a binary graph file
+	template<typename N, typename E>
+	void save_binary(csr_graph<N, E> const& g, std::string const& path) {
+		if (!std::is_sorted(g.nodes().begin(), g.nodes().end())) {
+			throw std::runtime_error("Cannot call gdwg::save_binary on a reordered snapshot");
+		}
+		auto const n = g.node_count();
+		auto const m = g.edge_count();
+		auto const node = [&g](std::size_t u) -> N const& { return g.node(u); };
+		auto const weight = [&g](std::size_t e) {
+			auto const& w = g.edge_weights()[e];
+			return w ? *w : E{};
+		};
+
+		auto const header =
+		   detail::make_binary_header<N, E>(n, m, detail::section_size<N>(n, node), detail::section_size<E>(m, weight));
+
+		auto out = detail::binary_file_writer(path);
+		detail::write_section<N>(out, header.node_data, n, node);
+		out.pad_to(header.offsets);
+		for (auto offset : g.offsets()) {
+			out.write_word(offset);
+		}
+		for (auto target : g.targets()) {
+			out.write_word(target);
+		}
+		detail::write_section<E>(out, header.weight_data, m, weight);
+		out.pad_to(header.unweighted);
+		for (std::size_t first = 0; first < m; first += 64) {
+			auto word = std::uint64_t{0};
+			for (auto e = first; e < std::min<std::size_t>(first + 64, m); ++e) {
+				word |= g.edge_weights()[e] ? 0 : std::uint64_t{1} << (e - first);
+			}
+			out.write_word(word);
+		}
+		out.finish(header, path);
+	}
+
+	// Save a graph as a binary graph file
+	template<typename N, typename E>
+	void save_binary(graph<N, E> const& g, std::string const& path) {
+		save_binary(csr_graph<N, E>(g), path);
+	}
+
+	// A binary graph file mapped into memory and queried in place
+	// Opening reads and checks only the header, so it takes the same time for any size of file; verify()
+	// checks the rest of the file against its checksum. String nodes and weights are returned as views into the
+	// mapping, valid while the mmap_graph lives
+	template<typename N, typename E>
+	class mmap_graph {
+	 public:
+		using node_view = typename detail::binary_codec<N>::view;
+		using weight_view = typename detail::binary_codec<E>::view;
+
+		// Map the file at path; with verify, also check the checksum of the whole file
+		explicit mmap_graph(std::string const& path, bool verify = false)
+		: file_(path) {
+			if (file_.size() < sizeof(detail::binary_header)) {
+				throw std::runtime_error("Cannot open gdwg::mmap_graph file " + path + ": not a graph file");
+			}
+			std::memcpy(&header_, file_.data(), sizeof(header_));
+			if (header_.magic != detail::binary_magic) {
+				throw std::runtime_error("Cannot open gdwg::mmap_graph file " + path + ": not a graph file");
+			}
+			if (header_.endian != detail::binary_endian) {
+				throw std::runtime_error("Cannot open gdwg::mmap_graph file " + path
+				                         + ": written with another byte order");
+			}
+			if (header_.version != detail::binary_version) {
+				throw std::runtime_error("Cannot open gdwg::mmap_graph file " + path + ": unsupported version "
+				                         + std::to_string(header_.version));
+			}
+			if (header_.header_checksum != detail::header_checksum(header_) or header_.file_size != file_.size()) {
+				throw std::runtime_error("Cannot open gdwg::mmap_graph file " + path + ": the file is corrupt");
+			}
+			if (header_.node_kind != detail::binary_codec<N>::kind or header_.node_size != detail::binary_codec<N>::size
+			    or header_.weight_kind != detail::binary_codec<E>::kind
+			    or header_.weight_size != detail::binary_codec<E>::size) {
+				throw std::runtime_error("Cannot open gdwg::mmap_graph file " + path
+				                         + ": node or weight type mismatch");
+			}
+			if (verify and !this->verify()) {
+				throw std::runtime_error("Cannot open gdwg::mmap_graph file " + path + ": checksum mismatch");
+			}
+			offsets_ = at<std::uint64_t>(header_.offsets);
+			targets_ = at<std::uint64_t>(header_.targets);
+			unweighted_ = at<std::uint64_t>(header_.unweighted);
+		}
+
+		// Check every byte after the header against the stored checksum
+		[[nodiscard]] bool verify() const {
+			auto sum = detail::checksum64{};
+			sum.update(file_.data() + sizeof(detail::binary_header), file_.size() - sizeof(detail::binary_header));
+			return sum.value() == header_.payload_checksum;
+		}
+
+		[[nodiscard]] std::size_t node_count() const noexcept {
+			return header_.node_count;
+		}
+
+		[[nodiscard]] std::size_t edge_count() const noexcept {
+			return header_.edge_count;
+		}
+
+		// Return the value of node u (nodes are numbered in ascending order)
+		[[nodiscard]] node_view node(std::size_t u) const {
+			return value<N>(header_.nodes, header_.node_data, u);
+		}
+
+		// Return the index of a node value, or std::nullopt if it is not in the file
+		[[nodiscard]] std::optional<std::size_t> index_of(node_view value) const {
+			auto first = std::size_t{0};
+			auto count = node_count();
+			while (count > 0) {
+				auto const half = count / 2;
+				if (node(first + half) < value) {
+					first += half + 1;
+					count -= half + 1;
+				}
+				else {
+					count = half;
+				}
+			}
+			if (first == node_count() or value < node(first)) {
+				return std::nullopt;
+			}
+			return first;
+		}
+
+		[[nodiscard]] bool is_node(node_view value) const {
+			return index_of(value).has_value();
+		}
+
+		// Return the position of the first edge of node u
+		[[nodiscard]] std::size_t offset(std::size_t u) const {
+			return offsets_[u];
+		}
+
+		[[nodiscard]] std::size_t degree(std::size_t u) const {
+			return offsets_[u + 1] - offsets_[u];
+		}
+
+		// Return the target indices of the edges leaving node u (sorted ascending)
+		[[nodiscard]] std::span<std::uint64_t const> neighbours(std::size_t u) const {
+			return {targets_ + offsets_[u], degree(u)};
+		}
+
+		// Return the weight of edge e, or std::nullopt if it is unweighted
+		[[nodiscard]] std::optional<weight_view> weight(std::size_t e) const {
+			if ((unweighted_[e / 64] >> (e % 64)) & 1) {
+				return std::nullopt;
+			}
+			return value<E>(header_.weights, header_.weight_data, e);
+		}
+
+		// Check if there is an edge from src to dst
+		[[nodiscard]] bool is_connected(node_view src, node_view dst) const {
+			auto const u = index_of(src);
+			auto const v = index_of(dst);
+			if (!u or !v) {
+				throw std::runtime_error("Cannot call gdwg::mmap_graph<N, E>::is_connected if src or dst node don't "
+				                         "exist in the graph");
+			}
+			auto const row = neighbours(*u);
+			return std::binary_search(row.begin(), row.end(), *v);
+		}
+
+		// Return all dst nodes of edges from src, sorted in ascending order
+		[[nodiscard]] std::vector<N> connections(node_view src) const {
+			auto const u = index_of(src);
+			if (!u) {
+				throw std::runtime_error("Cannot call gdwg::mmap_graph<N, E>::connections if src doesn't exist in the "
+				                         "graph");
+			}
+			auto result = std::vector<N>{};
+			auto const row = neighbours(*u);
+			for (std::size_t i = 0; i < row.size(); ++i) {
+				if (i == 0 or row[i] != row[i - 1]) {
+					result.emplace_back(node(row[i]));
+				}
+			}
+			return result;
+		}
+
+		// Return all edges from src to dst, unweighted first and then by ascending weight
+		[[nodiscard]] std::vector<std::unique_ptr<edge<N, E>>> edges(node_view src, node_view dst) const {
+			auto const u = index_of(src);
+			auto const v = index_of(dst);
+			if (!u or !v) {
+				throw std::runtime_error("Cannot call gdwg::mmap_graph<N, E>::edges if src or dst node don't exist in "
+				                         "the graph");
+			}
+			auto result = std::vector<std::unique_ptr<edge<N, E>>>{};
+			auto const row = neighbours(*u);
+			auto const [first, last] = std::equal_range(row.begin(), row.end(), *v);
+			for (auto it = first; it != last; ++it) {
+				auto const e = offset(*u) + static_cast<std::size_t>(it - row.begin());
+				if (auto const w = weight(e)) {
+					result.push_back(std::make_unique<weighted_edge<N, E>>(N(src), N(dst), E(*w)));
+				}
+				else {
+					result.push_back(std::make_unique<unweighted_edge<N, E>>(N(src), N(dst)));
+				}
+			}
+			return result;
+		}
+
+		// Copy the whole file into a graph
+		// Rows are stored in the graph's own order, so they go straight into the graph without sorting
+		[[nodiscard]] graph<N, E> to_graph() const {
+			using edge_type = typename graph_builder<N, E>::edge_type;
+			auto u = std::size_t{0};
+			auto src = std::size_t{0};
+			auto e = std::size_t{0};
+			return graph_builder<N, E>::build_sorted(
+			    [&]() -> std::optional<N> { return u == node_count() ? std::nullopt : std::optional<N>(N(node(u++))); },
+			    [&]() -> std::optional<edge_type> {
+				    if (e == edge_count()) {
+					    return std::nullopt;
+				    }
+				    while (offsets_[src + 1] <= e) {
+					    ++src;
+				    }
+				    auto const w = weight(e);
+				    auto const dst = targets_[e++];
+				    return edge_type(N(node(src)), N(node(dst)), w ? std::optional<E>(E(*w)) : std::nullopt);
+			    });
+		}
+
+	 private:
+		template<typename T>
+		T const* at(std::uint64_t offset) const {
+			return reinterpret_cast<T const*>(file_.data() + offset);
+		}
+
+		// Element i of a section written by save_binary
+		template<typename T>
+		typename detail::binary_codec<T>::view value(std::uint64_t section, std::uint64_t data, std::size_t i) const {
+			if constexpr (detail::binary_codec<T>::kind == detail::binary_kind::string) {
+				auto const entry = data + at<std::uint64_t>(section)[i];
+				auto const length = *at<std::uint64_t>(entry);
+				return {reinterpret_cast<char const*>(file_.data() + entry + 8), length};
+			}
+			else {
+				auto result = T{};
+				std::memcpy(&result, file_.data() + section + i * sizeof(T), sizeof(T));
+				return result;
+			}
+		}
+
+		detail::mapped_file file_;
+		detail::binary_header header_ = {};
+		std::uint64_t const* offsets_ = nullptr;
+		std::uint64_t const* targets_ = nullptr;
+		std::uint64_t const* unweighted_ = nullptr;
+	};
+} // namespace gdwg
+
+#endif // GDWG_BINARY_H
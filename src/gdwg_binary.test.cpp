@@ -0,0 +1,219 @@
+#include "gdwg_binary.h"
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#include <unistd.h>
+
+namespace {
+	// A path in the temporary directory that is removed at the end of the test
+	class temporary_file {
+	 public:
+		explicit temporary_file(std::string const& tag)
+		: path_("/tmp/gdwg_test_" + tag + "_" + std::to_string(::getpid()) + ".bin") {}
+
+		temporary_file(temporary_file const&) = delete;
+		temporary_file& operator=(temporary_file const&) = delete;
+
+		~temporary_file() {
+			std::remove(path_.c_str());
+		}
+
+		[[nodiscard]] std::string const& path() const noexcept {
+			return path_;
+		}
+
+	 private:
+		std::string path_;
+	};
+
+	gdwg::graph<int, double> random_graph(int nodes, int edges, unsigned seed) {
+		auto rng = std::mt19937(seed);
+		gdwg::graph<int, double> g;
+		for (auto v = 0; v < nodes; ++v) {
+			g.insert_node(v * 7 - 50);
+		}
+		for (auto e = 0; e < edges; ++e) {
+			auto const u = static_cast<int>(rng() % static_cast<unsigned>(nodes)) * 7 - 50;
+			auto const v = static_cast<int>(rng() % static_cast<unsigned>(nodes)) * 7 - 50;
+			if (rng() % 4 == 0) {
+				g.insert_edge(u, v);
+			}
+			else {
+				g.insert_edge(u, v, static_cast<double>(rng() % 5) / 2);
+			}
+		}
+		return g;
+	}
+
+	// graph::operator== treats nodes without edges as differences, so compare snapshots instead
+	template<typename N, typename E>
+	bool same_graph(gdwg::graph<N, E> const& lhs, gdwg::graph<N, E> const& rhs) {
+		auto const a = gdwg::csr_graph<N, E>(lhs);
+		auto const b = gdwg::csr_graph<N, E>(rhs);
+		return a.nodes() == b.nodes() and a.offsets() == b.offsets() and a.targets() == b.targets()
+		       and a.edge_weights() == b.edge_weights();
+	}
+
+	// Overwrite one byte of a file
+	void poke(std::string const& path, std::streamoff position, char value) {
+		auto file = std::fstream(path, std::ios::in | std::ios::out | std::ios::binary);
+		file.seekp(position);
+		file.put(value);
+	}
+} // namespace
+
+// Binary graph file tests
+TEST_CASE("Binary files answer queries like the graph they were saved from", "[binary]") {
+	auto const g = random_graph(150, 600, 41);
+	auto const file = temporary_file("round_trip");
+	gdwg::save_binary(g, file.path());
+
+	auto const mapped = gdwg::mmap_graph<int, double>(file.path(), true);
+	auto const snapshot = gdwg::csr_graph<int, double>(g);
+	REQUIRE(mapped.verify());
+	REQUIRE(mapped.node_count() == 150);
+	REQUIRE(mapped.edge_count() == snapshot.edge_count());
+	for (std::size_t u = 0; u < snapshot.node_count(); ++u) {
+		REQUIRE(mapped.node(u) == snapshot.node(u));
+		REQUIRE(mapped.index_of(snapshot.node(u)) == u);
+		auto const row = mapped.neighbours(u);
+		REQUIRE(std::equal(row.begin(), row.end(), snapshot.neighbours(u).begin(), snapshot.neighbours(u).end()));
+		for (std::size_t i = 0; i < row.size(); ++i) {
+			REQUIRE(mapped.weight(mapped.offset(u) + i) == snapshot.weights(u)[i]);
+		}
+	}
+	REQUIRE_FALSE(mapped.is_node(0));
+	REQUIRE_FALSE(mapped.index_of(-51));
+	for (auto v = -50; v < 1000; v += 7) {
+		REQUIRE(mapped.connections(v) == g.connections(v));
+		for (auto w = -50; w < 100; w += 7) {
+			REQUIRE(mapped.is_connected(v, w) == g.is_connected(v, w));
+			auto const expected = g.edges(v, w);
+			auto const stored = mapped.edges(v, w);
+			REQUIRE(stored.size() == expected.size());
+			for (std::size_t i = 0; i < stored.size(); ++i) {
+				REQUIRE(stored[i]->print_edge() == expected[i]->print_edge());
+			}
+		}
+	}
+	REQUIRE(same_graph(mapped.to_graph(), g));
+
+	REQUIRE_THROWS_WITH(mapped.is_connected(0, -50),
+	                    "Cannot call gdwg::mmap_graph<N, E>::is_connected if src or dst node don't exist in the graph");
+	REQUIRE_THROWS_WITH(mapped.connections(0),
+	                    "Cannot call gdwg::mmap_graph<N, E>::connections if src doesn't exist in the graph");
+	REQUIRE_THROWS_WITH(mapped.edges(-50, 0),
+	                    "Cannot call gdwg::mmap_graph<N, E>::edges if src or dst node don't exist in the graph");
+}
+
+TEST_CASE("Strings are stored length-prefixed and read as views", "[binary]") {
+	gdwg::graph<std::string, std::string> g{"", "apple", "banana", "a much longer node name than the others"};
+	g.insert_edge("apple", "banana", "ripe");
+	g.insert_edge("apple", "banana", "");
+	g.insert_edge("apple", "banana");
+	g.insert_edge("banana", "", "to nowhere");
+	g.insert_edge("", "", "loop");
+	auto const file = temporary_file("strings");
+	gdwg::save_binary(g, file.path());
+
+	auto const mapped = gdwg::mmap_graph<std::string, std::string>(file.path(), true);
+	REQUIRE(mapped.node_count() == 4);
+	REQUIRE(mapped.node(0).empty());
+	REQUIRE(mapped.node(2) == "apple");
+	REQUIRE(mapped.index_of("a much longer node name than the others") == 1);
+	REQUIRE_FALSE(mapped.is_node("cherry"));
+	REQUIRE(mapped.connections("banana") == std::vector<std::string>{""});
+	auto const edges = mapped.edges("apple", "banana");
+	REQUIRE(edges.size() == 3);
+	REQUIRE(edges[0]->print_edge() == "apple -> banana | U");
+	REQUIRE(edges[1]->print_edge() == "apple -> banana | W | ");
+	REQUIRE(edges[2]->print_edge() == "apple -> banana | W | ripe");
+	REQUIRE(same_graph(mapped.to_graph(), g));
+}
+
+TEST_CASE("Damaged and mismatched files are rejected", "[binary]") {
+	auto const g = random_graph(20, 50, 42);
+	auto const file = temporary_file("damaged");
+	gdwg::save_binary(g, file.path());
+
+	SECTION("Other node or weight types") {
+		REQUIRE_THROWS_WITH((gdwg::mmap_graph<int, int>(file.path())),
+		                    "Cannot open gdwg::mmap_graph file " + file.path() + ": node or weight type mismatch");
+		REQUIRE_THROWS((gdwg::mmap_graph<std::string, double>(file.path())));
+	}
+
+	SECTION("Payload damage is found by verify") {
+		poke(file.path(), static_cast<std::streamoff>(sizeof(gdwg::detail::binary_header) + 3), '\x7f');
+		auto const mapped = gdwg::mmap_graph<int, double>(file.path());
+		REQUIRE_FALSE(mapped.verify());
+		REQUIRE_THROWS_WITH((gdwg::mmap_graph<int, double>(file.path(), true)),
+		                    "Cannot open gdwg::mmap_graph file " + file.path() + ": checksum mismatch");
+	}
+
+	SECTION("Header damage is found on open") {
+		poke(file.path(), offsetof(gdwg::detail::binary_header, edge_count), '\x01');
+		REQUIRE_THROWS_WITH((gdwg::mmap_graph<int, double>(file.path())),
+		                    "Cannot open gdwg::mmap_graph file " + file.path() + ": the file is corrupt");
+	}
+
+	SECTION("Files from the other byte order") {
+		// Write the tag byte-swapped, as a machine of the other byte order would read it
+		auto tag = std::array<char, 8>{};
+		std::memcpy(tag.data(), &gdwg::detail::binary_endian, tag.size());
+		auto const position = static_cast<std::streamoff>(offsetof(gdwg::detail::binary_header, endian));
+		for (std::size_t i = 0; i < tag.size(); ++i) {
+			poke(file.path(), position + static_cast<std::streamoff>(i), tag[tag.size() - 1 - i]);
+		}
+		REQUIRE_THROWS_WITH((gdwg::mmap_graph<int, double>(file.path())),
+		                    "Cannot open gdwg::mmap_graph file " + file.path() + ": written with another byte order");
+	}
+
+	SECTION("Files that are not graph files") {
+		poke(file.path(), 0, 'X');
+		REQUIRE_THROWS_WITH((gdwg::mmap_graph<int, double>(file.path())),
+		                    "Cannot open gdwg::mmap_graph file " + file.path() + ": not a graph file");
+		REQUIRE_THROWS((gdwg::mmap_graph<int, double>("/tmp/gdwg_test_missing_file.bin")));
+	}
+}
+
+TEST_CASE("Binary file edge cases", "[binary]") {
+	SECTION("Empty graphs") {
+		auto const file = temporary_file("empty");
+		gdwg::save_binary(gdwg::graph<int, double>{}, file.path());
+		auto const mapped = gdwg::mmap_graph<int, double>(file.path(), true);
+		REQUIRE(mapped.node_count() == 0);
+		REQUIRE(mapped.edge_count() == 0);
+		REQUIRE_FALSE(mapped.is_node(1));
+		REQUIRE(mapped.to_graph().empty());
+	}
+
+	SECTION("Nodes without edges and more than one bitmap word") {
+		gdwg::graph<char, int> g{'a', 'b', 'z'};
+		for (auto w = 0; w < 100; ++w) {
+			g.insert_edge('a', 'b', w);
+		}
+		g.insert_edge('a', 'b');
+		auto const file = temporary_file("bitmap");
+		gdwg::save_binary(g, file.path());
+		auto const mapped = gdwg::mmap_graph<char, int>(file.path(), true);
+		REQUIRE(mapped.degree(0) == 101);
+		REQUIRE(mapped.degree(2) == 0);
+		REQUIRE_FALSE(mapped.weight(0));
+		REQUIRE(mapped.weight(100) == 99);
+		REQUIRE(same_graph(mapped.to_graph(), g));
+	}
+
+	SECTION("Reordered snapshots are refused") {
+		auto const g = random_graph(5, 5, 43);
+		auto const order = std::vector<std::size_t>{4, 3, 2, 1, 0};
+		auto const file = temporary_file("reordered");
+		REQUIRE_THROWS_WITH(gdwg::save_binary(gdwg::csr_graph<int, double>(g, order), file.path()),
+		                    "Cannot call gdwg::save_binary on a reordered snapshot");
+	}
+}
@@ -0,0 +1,129 @@
+#ifndef GDWG_BUILDER_H
+#define GDWG_BUILDER_H
+
+#include "gdwg_graph.h"
+#include "gdwg_parallel.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// Bulk construction of a graph: nodes and edges are collected unsorted, then sorted once and deduplicated with
+	// the same rules as graph::insert_edge (edges are duplicates only if src, dst and weight are all equal)
+	// Unlike graph::insert_edge, the endpoints of an edge do not have to be inserted first; they become nodes
+	template<typename N, typename E>
+	class graph_builder {
+	 public:
+		using edge_type = std::tuple<N, N, std::optional<E>>;
+
+		// Reserve space for the given number of edges
+		void reserve(std::size_t edges) {
+			edges_.reserve(edges);
+		}
+
+		// Add a node
+		void insert_node(N value) {
+			nodes_.push_back(std::move(value));
+		}
+
+		// Add an edge and its endpoints
+		void insert_edge(N src, N dst, std::optional<E> weight = std::nullopt) {
+			edges_.emplace_back(std::move(src), std::move(dst), std::move(weight));
+		}
+
+		// Return the number of edges added so far, counting duplicates
+		[[nodiscard]] std::size_t edge_count() const noexcept {
+			return edges_.size();
+		}
+
+		// Move the nodes and edges of several builders into this one, copying them in parallel when possible
+		void merge(std::vector<graph_builder>& parts, thread_pool& pool = default_thread_pool()) {
+			append(parts, pool, [](graph_builder& b) -> std::vector<N>& { return b.nodes_; });
+			append(parts, pool, [](graph_builder& b) -> std::vector<edge_type>& { return b.edges_; });
+		}
+
+		// Build the graph, leaving the builder empty
+		[[nodiscard]] graph<N, E> build(thread_pool& pool = default_thread_pool()) {
+			auto edges = std::exchange(edges_, {});
+			auto nodes = std::exchange(nodes_, {});
+			parallel_sort(pool, edges.begin(), edges.end());
+			edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+			nodes.reserve(nodes.size() + 2 * edges.size());
+			for (auto const& [src, dst, weight] : edges) {
+				if (nodes.empty() or !(nodes.back() == src)) {
+					nodes.push_back(src); // Consecutive edges share their src, so most are skipped here
+				}
+				nodes.push_back(dst);
+			}
+			parallel_sort(pool, nodes.begin(), nodes.end());
+			nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+			auto node = nodes.begin();
+			auto edge = edges.begin();
+			return build_sorted([&]() -> std::optional<N> {
+				return node == nodes.end() ? std::nullopt : std::optional<N>(std::move(*node++));
+			}, [&]() -> std::optional<edge_type> {
+				return edge == edges.end() ? std::nullopt : std::optional<edge_type>(std::move(*edge++));
+			});
+		}
+
+		// Build a graph from nodes and edges that are already sorted and free of duplicates, pulled one at a time
+		// from next_node() and next_edge() (each returns an empty optional at the end); every src must be a node
+		template<typename NextNode, typename NextEdge>
+		[[nodiscard]] static graph<N, E> build_sorted(NextNode next_node, NextEdge next_edge) {
+			auto result = graph<N, E>{};
+			auto edge = next_edge();
+			while (auto node = next_node()) {
+				auto& row = result.adj_list_.emplace_hint(result.adj_list_.end(), *node, row_type{})->second;
+				for (; edge and std::get<0>(*edge) == *node; edge = next_edge()) {
+					row.emplace_back(std::move(std::get<1>(*edge)), std::move(std::get<2>(*edge)));
+				}
+				result.nodes_.emplace_hint(result.nodes_.end(), std::move(*node));
+			}
+			return result;
+		}
+
+	 private:
+		using row_type = std::vector<std::pair<N, std::optional<E>>>;
+
+		// Move one member vector of every part onto the end of this builder's
+		template<typename Member>
+		void append(std::vector<graph_builder>& parts, thread_pool& pool, Member member) {
+			auto& target = member(*this);
+			auto starts = std::vector<std::size_t>{};
+			auto total = target.size();
+			for (auto& part : parts) {
+				starts.push_back(total);
+				total += member(part).size();
+			}
+			using value_type = typename std::remove_reference_t<decltype(target)>::value_type;
+			if constexpr (std::is_default_constructible_v<value_type>) {
+				target.resize(total);
+				pool.run(parts.size(), [&](std::size_t p, std::size_t) {
+					auto& source = member(parts[p]);
+					std::move(source.begin(), source.end(), target.begin() + static_cast<std::ptrdiff_t>(starts[p]));
+					source = {};
+				});
+			}
+			else {
+				target.reserve(total);
+				for (auto& part : parts) {
+					auto& source = member(part);
+					std::move(source.begin(), source.end(), std::back_inserter(target));
+					source = {};
+				}
+			}
+		}
+
+		std::vector<N> nodes_;
+		std::vector<edge_type> edges_;
+	};
+} // namespace gdwg
+
+#endif // GDWG_BUILDER_H
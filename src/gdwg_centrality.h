@@ -0,0 +1,349 @@
+#ifndef GDWG_CENTRALITY_H
+#define GDWG_CENTRALITY_H
+
+#include "gdwg_csr.h"
+#include "gdwg_graph.h"
+#include "gdwg_parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// Settings shared by the betweenness routines
+	struct betweenness_options {
+		// Use arithmetic edge weights as lengths (unweighted edges have length 1); lengths must be positive
+		bool use_weights = true;
+		bool normalized = false; // Divide by (n - 1)(n - 2), the number of ordered pairs excluding the node
+	};
+
+	// Settings for sampled betweenness
+	struct betweenness_sampling {
+		std::size_t sources = 64; // Number of distinct source nodes to sample
+		double confidence = 0.95; // Confidence level of the reported error bounds
+		std::uint64_t seed = 6771; // Seed of the source sampler
+	};
+
+	// Betweenness centrality of every node of a snapshot, by node index
+	struct betweenness_result {
+		std::vector<double> centrality; // (Estimated) betweenness of every node
+		std::vector<double> error; // Half-width of the confidence interval of every estimate (0 when exact)
+		std::size_t sources = 0; // Number of sources the result is based on
+	};
+
+	namespace detail {
+		// Simple directed graph for shortest-path searches: loops dropped, parallel edges collapsed to the shortest
+		struct length_graph {
+			std::vector<std::size_t> offsets;
+			std::vector<std::size_t> targets;
+			std::vector<double> lengths; // Empty when every edge has length 1
+		};
+
+		template<typename N, typename E>
+		length_graph shortest_path_graph(csr_graph<N, E> const& g, bool use_weights, char const* caller) {
+			auto result = length_graph{};
+			auto const n = g.node_count();
+			auto weighted = false;
+			if constexpr (std::is_arithmetic_v<E>) {
+				weighted = use_weights
+				           and std::any_of(g.edge_weights().begin(), g.edge_weights().end(), [](auto const& w) {
+					               return w.has_value();
+				               });
+			}
+			result.offsets.reserve(n + 1);
+			result.offsets.push_back(0);
+			for (std::size_t u = 0; u < n; ++u) {
+				auto const targets = g.neighbours(u);
+				auto const weights = g.weights(u);
+				for (std::size_t e = 0; e < targets.size(); ++e) {
+					if (targets[e] == u) {
+						continue;
+					}
+					auto length = 1.0;
+					if constexpr (std::is_arithmetic_v<E>) {
+						if (weighted and weights[e]) {
+							length = static_cast<double>(*weights[e]);
+							if (length <= 0.0) {
+								throw std::runtime_error(std::string("Cannot call gdwg::") + caller
+								                         + " on a graph with non-positive edge weights");
+							}
+						}
+					}
+					// Targets are sorted, so parallel edges are adjacent
+					if (result.targets.size() > result.offsets.back() and result.targets.back() == targets[e]) {
+						if (weighted) {
+							result.lengths.back() = std::min(result.lengths.back(), length);
+						}
+						continue;
+					}
+					result.targets.push_back(targets[e]);
+					if (weighted) {
+						result.lengths.push_back(length);
+					}
+				}
+				result.offsets.push_back(result.targets.size());
+			}
+			return result;
+		}
+
+		// Per-worker state of Brandes' algorithm, reused across sources
+		class brandes_search {
+		 public:
+			explicit brandes_search(std::size_t n)
+			: distance_(n, infinity)
+			, paths_(n, 0.0)
+			, dependency_(n, 0.0) {
+				order_.reserve(n);
+			}
+
+			// Run a single-source search from s and call add(v, dependency of s on v) for every v != s
+			template<typename F>
+			void run(length_graph const& g, std::size_t s, F&& add) {
+				if (g.lengths.empty()) {
+					breadth_first(g, s);
+				}
+				else {
+					dijkstra(g, s);
+				}
+				// Walk the nodes back from the farthest, pulling dependencies from successors on shortest paths
+				for (auto it = order_.rbegin(); it != order_.rend(); ++it) {
+					auto const w = *it;
+					auto delta = 0.0;
+					for (auto e = g.offsets[w]; e < g.offsets[w + 1]; ++e) {
+						auto const x = g.targets[e];
+						if (distance_[x] == distance_[w] + length(g, e)) {
+							delta += paths_[w] / paths_[x] * (1.0 + dependency_[x]);
+						}
+					}
+					dependency_[w] = delta;
+					if (w != s) {
+						add(w, delta);
+					}
+				}
+				for (auto v : order_) {
+					distance_[v] = infinity;
+					paths_[v] = 0.0;
+					dependency_[v] = 0.0;
+				}
+				order_.clear();
+			}
+
+		 private:
+			static constexpr auto infinity = std::numeric_limits<double>::infinity();
+
+			static double length(length_graph const& g, std::size_t e) {
+				return g.lengths.empty() ? 1.0 : g.lengths[e];
+			}
+
+			void breadth_first(length_graph const& g, std::size_t s) {
+				distance_[s] = 0.0;
+				paths_[s] = 1.0;
+				order_.push_back(s);
+				for (std::size_t head = 0; head < order_.size(); ++head) {
+					auto const v = order_[head];
+					for (auto e = g.offsets[v]; e < g.offsets[v + 1]; ++e) {
+						auto const w = g.targets[e];
+						if (distance_[w] == infinity) {
+							distance_[w] = distance_[v] + 1.0;
+							order_.push_back(w);
+						}
+						if (distance_[w] == distance_[v] + 1.0) {
+							paths_[w] += paths_[v];
+						}
+					}
+				}
+			}
+
+			void dijkstra(length_graph const& g, std::size_t s) {
+				distance_[s] = 0.0;
+				paths_[s] = 1.0;
+				heap_.clear();
+				heap_.emplace_back(0.0, s);
+				while (!heap_.empty()) {
+					std::pop_heap(heap_.begin(), heap_.end(), std::greater<>{});
+					auto const [d, v] = heap_.back();
+					heap_.pop_back();
+					if (d > distance_[v]) {
+						continue; // Stale entry: v was pushed again with a shorter distance
+					}
+					order_.push_back(v);
+					for (auto e = g.offsets[v]; e < g.offsets[v + 1]; ++e) {
+						auto const w = g.targets[e];
+						auto const candidate = d + g.lengths[e];
+						if (candidate < distance_[w]) {
+							distance_[w] = candidate;
+							paths_[w] = paths_[v];
+							heap_.emplace_back(candidate, w);
+							std::push_heap(heap_.begin(), heap_.end(), std::greater<>{});
+						}
+						else if (candidate == distance_[w]) {
+							paths_[w] += paths_[v];
+						}
+					}
+				}
+			}
+
+			std::vector<double> distance_; // Shortest distance from the source
+			std::vector<double> paths_; // Number of shortest paths from the source
+			std::vector<double> dependency_; // Dependency of the source on each node
+			std::vector<std::size_t> order_; // Nodes in non-decreasing distance order
+			std::vector<std::pair<double, std::size_t>> heap_; // Dijkstra frontier
+		};
+
+		// Return z such that a standard normal variable lies in [-z, z] with the given probability
+		inline double normal_quantile(double confidence) {
+			auto lo = 0.0;
+			auto hi = 40.0;
+			for (auto i = 0; i < 200; ++i) {
+				auto const mid = (lo + hi) / 2;
+				(std::erf(mid / std::sqrt(2.0)) < confidence ? lo : hi) = mid;
+			}
+			return (lo + hi) / 2;
+		}
+
+		// Run Brandes from every source in sources, returning per-node sums and sums of squares of the dependencies
+		inline std::pair<std::vector<double>, std::vector<double>>
+		brandes(length_graph const& g, std::size_t n, std::vector<std::size_t> const& sources, thread_pool& pool) {
+			// Per-worker accumulators, reduced once every source is done
+			auto sums = std::vector<std::vector<double>>(pool.size());
+			auto squares = std::vector<std::vector<double>>(pool.size());
+			auto searches = std::vector<std::optional<brandes_search>>(pool.size());
+			pool.run(sources.size(), [&](std::size_t task, std::size_t worker) {
+				if (!searches[worker]) {
+					searches[worker].emplace(n);
+					sums[worker].assign(n, 0.0);
+					squares[worker].assign(n, 0.0);
+				}
+				auto& sum = sums[worker];
+				auto& square = squares[worker];
+				searches[worker]->run(g, sources[task], [&](std::size_t v, double delta) {
+					sum[v] += delta;
+					square[v] += delta * delta;
+				});
+			});
+			auto total = std::vector<double>(n, 0.0);
+			auto total_squares = std::vector<double>(n, 0.0);
+			for (std::size_t worker = 0; worker < pool.size(); ++worker) {
+				for (std::size_t v = 0; v < n and !sums[worker].empty(); ++v) {
+					total[v] += sums[worker][v];
+					total_squares[v] += squares[worker][v];
+				}
+			}
+			return {std::move(total), std::move(total_squares)};
+		}
+
+		inline void normalize_betweenness(betweenness_result& result, std::size_t n) {
+			if (n <= 2) {
+				return;
+			}
+			auto const pairs = static_cast<double>(n - 1) * static_cast<double>(n - 2);
+			for (std::size_t v = 0; v < n; ++v) {
+				result.centrality[v] /= pairs;
+				result.error[v] /= pairs;
+			}
+		}
+	} // namespace detail
+
+	// Exact betweenness centrality by Brandes' algorithm, with the sources spread across the pool
+	template<typename N, typename E>
+	[[nodiscard]] betweenness_result betweenness_centrality(csr_graph<N, E> const& g,
+	                                                        betweenness_options const& options = {},
+	                                                        thread_pool& pool = default_thread_pool()) {
+		auto const n = g.node_count();
+		auto const lengths = detail::shortest_path_graph(g, options.use_weights, "betweenness_centrality");
+		auto sources = std::vector<std::size_t>(n);
+		std::iota(sources.begin(), sources.end(), std::size_t{0});
+
+		auto result = betweenness_result{};
+		result.centrality = detail::brandes(lengths, n, sources, pool).first;
+		result.error.assign(n, 0.0);
+		result.sources = n;
+		if (options.normalized) {
+			detail::normalize_betweenness(result, n);
+		}
+		return result;
+	}
+
+	// Approximate betweenness centrality from a uniform sample of distinct sources
+	// Each estimate is n / k times the summed dependencies of the k sampled sources; its error is the
+	// normal-approximation confidence half-width, with the finite population correction for sampling
+	// without replacement. The bound is asymptotic and can be optimistic for nodes that few sources depend on
+	template<typename N, typename E>
+	[[nodiscard]] betweenness_result approximate_betweenness_centrality(csr_graph<N, E> const& g,
+	                                                                    betweenness_sampling const& sampling,
+	                                                                    betweenness_options const& options = {},
+	                                                                    thread_pool& pool = default_thread_pool()) {
+		if (sampling.confidence <= 0.0 or sampling.confidence >= 1.0) {
+			throw std::runtime_error("Cannot call gdwg::approximate_betweenness_centrality with a confidence outside "
+			                         "(0, 1)");
+		}
+		auto const n = g.node_count();
+		auto const k = std::min(sampling.sources, n);
+		auto const lengths =
+		    detail::shortest_path_graph(g, options.use_weights, "approximate_betweenness_centrality");
+
+		// Partial Fisher-Yates shuffle picks k distinct sources
+		auto rng = std::mt19937_64(sampling.seed);
+		auto pool_of_sources = std::vector<std::size_t>(n);
+		std::iota(pool_of_sources.begin(), pool_of_sources.end(), std::size_t{0});
+		for (std::size_t i = 0; i < k; ++i) {
+			auto pick = std::uniform_int_distribution<std::size_t>(i, n - 1);
+			std::swap(pool_of_sources[i], pool_of_sources[pick(rng)]);
+		}
+		pool_of_sources.resize(k);
+
+		auto const [sums, squares] = detail::brandes(lengths, n, pool_of_sources, pool);
+		auto result = betweenness_result{};
+		result.centrality.assign(n, 0.0);
+		result.error.assign(n, 0.0);
+		result.sources = k;
+		if (k == 0) {
+			return result;
+		}
+		auto const scale = static_cast<double>(n) / static_cast<double>(k);
+		auto const z = detail::normal_quantile(sampling.confidence);
+		auto const correction = n > 1 ? std::sqrt(static_cast<double>(n - k) / static_cast<double>(n - 1)) : 0.0;
+		for (std::size_t v = 0; v < n; ++v) {
+			result.centrality[v] = scale * sums[v];
+			if (k > 1) {
+				auto const mean = sums[v] / static_cast<double>(k);
+				auto const variance =
+				    std::max(0.0, (squares[v] - static_cast<double>(k) * mean * mean) / static_cast<double>(k - 1));
+				auto const standard_error = std::sqrt(variance / static_cast<double>(k));
+				result.error[v] = z * static_cast<double>(n) * standard_error * correction;
+			}
+		}
+		if (options.normalized) {
+			detail::normalize_betweenness(result, n);
+		}
+		return result;
+	}
+
+	// Exact betweenness centrality of every node of a graph, keyed by node value
+	template<typename N, typename E>
+	[[nodiscard]] std::map<N, double> betweenness_centrality(graph<N, E> const& g,
+	                                                         betweenness_options const& options = {},
+	                                                         thread_pool& pool = default_thread_pool()) {
+		auto const snapshot = csr_graph<N, E>(g);
+		auto const result = betweenness_centrality(snapshot, options, pool);
+		auto centrality = std::map<N, double>{};
+		for (std::size_t u = 0; u < snapshot.node_count(); ++u) {
+			centrality.emplace_hint(centrality.end(), snapshot.node(u), result.centrality[u]);
+		}
+		return centrality;
+	}
+} // namespace gdwg
+
+#endif // GDWG_CENTRALITY_H
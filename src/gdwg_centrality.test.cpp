@@ -0,0 +1,183 @@
+#include "gdwg_centrality.h"
+
+#include <catch2/catch.hpp>
+
+#include <random>
+
+namespace {
+	// Betweenness from all-pairs shortest path counts (Floyd-Warshall), to compare against
+	std::vector<double> reference_betweenness(gdwg::csr_graph<int, int> const& g, bool weighted) {
+		auto const n = g.node_count();
+		auto const inf = std::numeric_limits<double>::infinity();
+		auto dist = std::vector<std::vector<double>>(n, std::vector<double>(n, inf));
+		for (std::size_t u = 0; u < n; ++u) {
+			dist[u][u] = 0;
+			for (std::size_t e = 0; e < g.degree(u); ++e) {
+				auto const v = g.neighbours(u)[e];
+				auto const w = weighted ? static_cast<double>(g.weights(u)[e].value_or(1)) : 1.0;
+				if (v != u) {
+					dist[u][v] = std::min(dist[u][v], w);
+				}
+			}
+		}
+		auto const direct = dist;
+		for (std::size_t k = 0; k < n; ++k) {
+			for (std::size_t i = 0; i < n; ++i) {
+				for (std::size_t j = 0; j < n; ++j) {
+					dist[i][j] = std::min(dist[i][j], dist[i][k] + dist[k][j]);
+				}
+			}
+		}
+		// Count shortest paths by processing targets in order of distance from each source
+		auto paths = std::vector<std::vector<double>>(n, std::vector<double>(n, 0));
+		for (std::size_t s = 0; s < n; ++s) {
+			auto order = std::vector<std::size_t>(n);
+			std::iota(order.begin(), order.end(), std::size_t{0});
+			std::sort(order.begin(), order.end(), [&](auto a, auto b) { return dist[s][a] < dist[s][b]; });
+			paths[s][s] = 1;
+			for (auto t : order) {
+				for (std::size_t p = 0; p < n and t != s; ++p) {
+					if (p != t and direct[p][t] < inf and dist[s][p] + direct[p][t] == dist[s][t]) {
+						paths[s][t] += paths[s][p];
+					}
+				}
+			}
+		}
+		auto result = std::vector<double>(n, 0);
+		for (std::size_t s = 0; s < n; ++s) {
+			for (std::size_t t = 0; t < n; ++t) {
+				for (std::size_t v = 0; v < n; ++v) {
+					if (s != t and v != s and v != t and dist[s][t] < inf and dist[s][v] + dist[v][t] == dist[s][t]) {
+						result[v] += paths[s][v] * paths[v][t] / paths[s][t];
+					}
+				}
+			}
+		}
+		return result;
+	}
+
+	gdwg::graph<int, int> random_graph(int n, int edges, unsigned seed) {
+		auto rng = std::mt19937(seed);
+		gdwg::graph<int, int> g;
+		for (auto i = 0; i < n; ++i) {
+			g.insert_node(i);
+		}
+		for (auto e = 0; e < edges; ++e) {
+			auto const u = static_cast<int>(rng() % static_cast<unsigned>(n));
+			auto const v = static_cast<int>(rng() % static_cast<unsigned>(n));
+			if (e % 3 == 0) {
+				g.insert_edge(u, v);
+			}
+			else {
+				g.insert_edge(u, v, 1 + static_cast<int>(rng() % 4));
+			}
+		}
+		return g;
+	}
+} // namespace
+
+// Exact betweenness tests
+TEST_CASE("Betweenness of a path", "[centrality]") {
+	gdwg::graph<std::string, int> g;
+	for (auto const& node : {"a", "b", "c", "d"}) {
+		g.insert_node(node);
+	}
+	g.insert_edge("a", "b");
+	g.insert_edge("b", "c");
+	g.insert_edge("c", "d");
+
+	auto const centrality = gdwg::betweenness_centrality(g);
+	REQUIRE(centrality.at("a") == Approx(0.0));
+	REQUIRE(centrality.at("b") == Approx(2.0)); // a -> c and a -> d
+	REQUIRE(centrality.at("c") == Approx(2.0)); // a -> d and b -> d
+	REQUIRE(centrality.at("d") == Approx(0.0));
+
+	auto options = gdwg::betweenness_options{};
+	options.normalized = true;
+	REQUIRE(gdwg::betweenness_centrality(g, options).at("b") == Approx(2.0 / 6.0));
+}
+
+TEST_CASE("Betweenness uses weights and splits ties", "[centrality]") {
+	gdwg::graph<char, double> g;
+	for (auto c : {'s', 'x', 'y', 't'}) {
+		g.insert_node(c);
+	}
+	// Two shortest s -> t routes of length 3 through x and y; a parallel edge must not add a route
+	g.insert_edge('s', 'x', 1.0);
+	g.insert_edge('s', 'x', 5.0);
+	g.insert_edge('x', 't', 2.0);
+	g.insert_edge('s', 'y', 2.0);
+	g.insert_edge('y', 't', 1.0);
+	g.insert_edge('s', 't', 4.0);
+
+	auto const weighted = gdwg::betweenness_centrality(g);
+	REQUIRE(weighted.at('x') == Approx(0.5));
+	REQUIRE(weighted.at('y') == Approx(0.5));
+
+	auto options = gdwg::betweenness_options{};
+	options.use_weights = false; // The direct edge now wins
+	auto const unweighted = gdwg::betweenness_centrality(g, options);
+	REQUIRE(unweighted.at('x') == Approx(0.0));
+	REQUIRE(unweighted.at('y') == Approx(0.0));
+
+	g.insert_edge('x', 'y', -1.0);
+	REQUIRE_THROWS_WITH(gdwg::betweenness_centrality(g),
+	                    "Cannot call gdwg::betweenness_centrality on a graph with non-positive edge weights");
+}
+
+TEST_CASE("Betweenness matches all-pairs shortest paths", "[centrality]") {
+	auto const g = random_graph(40, 160, 11);
+	auto const csr = gdwg::csr_graph<int, int>(g);
+	auto pool = gdwg::thread_pool(4);
+
+	for (auto weighted : {true, false}) {
+		auto options = gdwg::betweenness_options{};
+		options.use_weights = weighted;
+		auto const result = gdwg::betweenness_centrality(csr, options, pool);
+		auto const expected = reference_betweenness(csr, weighted);
+		REQUIRE(result.sources == csr.node_count());
+		for (std::size_t v = 0; v < csr.node_count(); ++v) {
+			REQUIRE(result.centrality[v] == Approx(expected[v]).margin(1e-9));
+			REQUIRE(result.error[v] == 0.0);
+		}
+	}
+}
+
+// Sampled betweenness tests
+TEST_CASE("Sampled betweenness", "[centrality]") {
+	auto const g = random_graph(200, 800, 5);
+	auto const csr = gdwg::csr_graph<int, int>(g);
+	auto pool = gdwg::thread_pool(4);
+	auto const exact = gdwg::betweenness_centrality(csr, {}, pool);
+
+	SECTION("Sampling every source is exact") {
+		auto const all = gdwg::approximate_betweenness_centrality(csr, {1000, 0.95, 1}, {}, pool);
+		REQUIRE(all.sources == 200);
+		for (std::size_t v = 0; v < csr.node_count(); ++v) {
+			REQUIRE(all.centrality[v] == Approx(exact.centrality[v]));
+			REQUIRE(all.error[v] == Approx(0.0).margin(1e-9));
+		}
+	}
+
+	// The bounds are a normal approximation, so nodes that rarely lie on shortest paths can fall outside them
+	SECTION("Estimates mostly fall within their confidence bounds") {
+		auto const sampled = gdwg::approximate_betweenness_centrality(csr, {100, 0.99, 2}, {}, pool);
+		REQUIRE(sampled.sources == 100);
+		auto inside = 0;
+		for (std::size_t v = 0; v < csr.node_count(); ++v) {
+			inside += std::abs(sampled.centrality[v] - exact.centrality[v]) <= sampled.error[v] + 1e-9 ? 1 : 0;
+		}
+		REQUIRE(inside >= 170);
+	}
+
+	SECTION("The sample is reproducible from its seed") {
+		auto const a = gdwg::approximate_betweenness_centrality(csr, {30, 0.9, 3}, {}, pool);
+		auto const b = gdwg::approximate_betweenness_centrality(csr, {30, 0.9, 3}, {}, pool);
+		for (std::size_t v = 0; v < csr.node_count(); ++v) {
+			REQUIRE(a.centrality[v] == Approx(b.centrality[v])); // Summation order may differ between runs
+		}
+	}
+
+	REQUIRE_THROWS_WITH(gdwg::approximate_betweenness_centrality(csr, {10, 1.0, 3}),
+	                    "Cannot call gdwg::approximate_betweenness_centrality with a confidence outside (0, 1)");
+}
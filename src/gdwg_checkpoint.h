@@ -0,0 +1,348 @@
+#ifndef GDWG_CHECKPOINT_H
+#define GDWG_CHECKPOINT_H
+
+#include "gdwg_binary.h"
+#include "gdwg_mapped_file.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Incremental checkpoints: delta segments and their compaction into a binary graph file
+// A delta segment holds the adjacency lists of the nodes that changed since the previous checkpoint, each either
+// the node's whole row or a mark that the node is gone. A graph is stored as a base file (see gdwg_binary.h) and the
+// delta segments written after it, applied in order; compaction merges them into a new base file without loading
+// the graph, reading each input sequentially. Edges to nodes that are not in the merged graph are dropped, as
+// save_binary drops them.
+//
+// Layout of a delta segment: delta_header, then for every changed node in ascending order the node, a present flag,
+// and if present the row's length and its edges (target, weighted flag, weight if weighted), sorted like the rows
+// of a graph. Values are stored as their bytes, strings as a u64 length and their characters.
+// Node and weight types must be trivially copyable or std::string
+namespace gdwg::detail {
+	inline constexpr auto delta_magic = std::array<char, 8>{'G', 'D', 'W', 'G', 'D', 'L', 'T', '\0'};
+	inline constexpr auto delta_version = std::uint32_t{1};
+
+	struct delta_header {
+		std::array<char, 8> magic;
+		std::uint64_t endian; // binary_endian as written
+		std::uint32_t version;
+		std::uint32_t flags; // Reserved, 0
+		binary_kind node_kind;
+		std::uint32_t node_size;
+		binary_kind weight_kind;
+		std::uint32_t weight_size;
+		std::uint64_t generation; // Number of the checkpoint that wrote the segment
+		std::uint64_t entry_count;
+		std::uint64_t payload_size;
+		std::uint64_t payload_checksum;
+		std::uint64_t header_checksum; // Of the header with this field zero
+	};
+
+	template<typename N, typename E>
+	using delta_row = std::vector<std::pair<N, std::optional<E>>>;
+
+	// Changed rows by node; an empty optional marks a node that was erased
+	template<typename N, typename E>
+	using delta_rows = std::map<N, std::optional<delta_row<N, E>>>;
+
+	template<typename T>
+	void append_operand(std::string& out, T const& value) {
+		if constexpr (binary_codec<T>::kind == binary_kind::string) {
+			append_operand(out, std::uint64_t{value.size()});
+			out.append(value);
+		}
+		else {
+			out.append(reinterpret_cast<char const*>(&value), sizeof(T));
+		}
+	}
+
+	template<typename T>
+	bool read_operand(std::string_view& in, T& value) {
+		if constexpr (binary_codec<T>::kind == binary_kind::string) {
+			auto size = std::uint64_t{0};
+			if (!read_operand(in, size) or size > in.size()) {
+				return false;
+			}
+			value.assign(in.substr(0, size));
+			in.remove_prefix(size);
+		}
+		else {
+			if (in.size() < sizeof(T)) {
+				return false;
+			}
+			std::memcpy(&value, in.data(), sizeof(T));
+			in.remove_prefix(sizeof(T));
+		}
+		return true;
+	}
+
+	inline std::uint64_t delta_header_checksum(delta_header header) {
+		header.header_checksum = 0;
+		auto sum = checksum64{};
+		sum.update(&header, sizeof(header));
+		return sum.value();
+	}
+
+	// Write a delta segment through a temporary file, so that it appears whole or not at all
+	template<typename N, typename E>
+	void write_delta(std::string const& path,
+	                 std::string const& directory,
+	                 std::uint64_t generation,
+	                 delta_rows<N, E> const& rows) {
+		auto payload = std::string{};
+		for (auto const& [node, row] : rows) {
+			append_operand(payload, node);
+			append_operand(payload, row.has_value());
+			if (!row) {
+				continue;
+			}
+			append_operand(payload, std::uint64_t{row->size()});
+			for (auto const& [dst, weight] : *row) {
+				append_operand(payload, dst);
+				append_operand(payload, weight.has_value());
+				if (weight) {
+					append_operand(payload, *weight);
+				}
+			}
+		}
+
+		auto header = delta_header{};
+		header.magic = delta_magic;
+		header.endian = binary_endian;
+		header.version = delta_version;
+		header.node_kind = binary_codec<N>::kind;
+		header.node_size = binary_codec<N>::size;
+		header.weight_kind = binary_codec<E>::kind;
+		header.weight_size = binary_codec<E>::size;
+		header.generation = generation;
+		header.entry_count = rows.size();
+		header.payload_size = payload.size();
+		auto sum = checksum64{};
+		sum.update(payload.data(), payload.size());
+		header.payload_checksum = sum.value();
+		header.header_checksum = delta_header_checksum(header);
+		payload.insert(0, reinterpret_cast<char const*>(&header), sizeof(header));
+		replace_file(path, payload, directory);
+	}
+
+	// Read a whole delta segment, checking it against its checksums
+	template<typename N, typename E>
+	delta_rows<N, E> read_delta(std::string const& path) {
+		auto const fail = [&path](std::string const& reason) {
+			return std::runtime_error("Cannot read delta segment " + path + ": " + reason);
+		};
+		auto const file = mapped_file(path);
+		auto header = delta_header{};
+		if (file.size() < sizeof(header)) {
+			throw fail("not a delta segment");
+		}
+		std::memcpy(&header, file.data(), sizeof(header));
+		if (header.magic != delta_magic or header.endian != binary_endian or header.version != delta_version) {
+			throw fail("not a delta segment of this version and byte order");
+		}
+		if (header.header_checksum != delta_header_checksum(header)
+		    or header.payload_size != file.size() - sizeof(header))
+		{
+			throw fail("the segment is corrupt");
+		}
+		if (header.node_kind != binary_codec<N>::kind or header.node_size != binary_codec<N>::size
+		    or header.weight_kind != binary_codec<E>::kind or header.weight_size != binary_codec<E>::size)
+		{
+			throw fail("node or weight type mismatch");
+		}
+		auto payload =
+		   std::string_view(reinterpret_cast<char const*>(file.data()) + sizeof(header), header.payload_size);
+		auto sum = checksum64{};
+		sum.update(payload.data(), payload.size());
+		if (sum.value() != header.payload_checksum) {
+			throw fail("checksum mismatch");
+		}
+
+		auto rows = delta_rows<N, E>{};
+		for (std::uint64_t i = 0; i < header.entry_count; ++i) {
+			auto node = N{};
+			auto present = false;
+			auto size = std::uint64_t{0};
+			if (!read_operand(payload, node) or !read_operand(payload, present)
+			    or (present and !read_operand(payload, size)))
+			{
+				throw fail("the segment is corrupt");
+			}
+			auto& row = rows.emplace_hint(rows.end(), std::move(node), std::nullopt)->second;
+			if (!present) {
+				continue;
+			}
+			row.emplace();
+			for (std::uint64_t e = 0; e < size; ++e) {
+				auto dst = N{};
+				auto weighted = false;
+				auto weight = std::optional<E>{};
+				if (!read_operand(payload, dst) or !read_operand(payload, weighted)
+				    or (weighted and !read_operand(payload, weight.emplace())))
+				{
+					throw fail("the segment is corrupt");
+				}
+				row->emplace_back(std::move(dst), std::move(weight));
+			}
+		}
+		return rows;
+	}
+
+	// Merge a base file and the delta segments written after it, oldest first, into a new binary graph file
+	// The result is the file save_binary would write for the merged graph. Only the node list and one word per node
+	// are held in memory; the edges are streamed from the base file's mapping once per section of the output
+	template<typename N, typename E>
+	void compact_segments(std::string const& base_path,
+	                      std::vector<std::string> const& delta_paths,
+	                      std::string const& output) {
+		using weight_view = typename binary_codec<E>::view;
+		static constexpr auto missing = std::numeric_limits<std::uint64_t>::max();
+		auto const base = mmap_graph<N, E>(base_path);
+		auto changes = delta_rows<N, E>{};
+		for (auto const& path : delta_paths) {
+			for (auto& [node, row] : read_delta<N, E>(path)) {
+				changes.insert_or_assign(node, std::move(row));
+			}
+		}
+
+		// Merge the node lists; each node's row comes from the last delta that changed it, or else from the base
+		struct row_source {
+			delta_row<N, E> const* delta;
+			std::uint64_t base;
+		};
+		auto nodes = std::vector<N>{};
+		auto sources = std::vector<row_source>{};
+		auto remap = std::vector<std::uint64_t>(base.node_count(), missing); // Base index to merged index
+		auto change = changes.begin();
+		for (std::size_t u = 0; u <= base.node_count(); ++u) {
+			auto const in_base = u < base.node_count();
+			for (; change != changes.end() and (!in_base or change->first < base.node(u)); ++change) {
+				if (change->second) {
+					nodes.push_back(change->first);
+					sources.push_back({&*change->second, missing});
+				}
+			}
+			if (!in_base) {
+				break;
+			}
+			if (change != changes.end() and change->first == base.node(u)) {
+				if (change->second) {
+					remap[u] = nodes.size();
+					nodes.push_back(change->first);
+					sources.push_back({&*change->second, missing});
+				}
+				++change;
+				continue;
+			}
+			remap[u] = nodes.size();
+			nodes.push_back(N(base.node(u)));
+			sources.push_back({nullptr, u});
+		}
+
+		// Call fn(target, weight) for every edge of the merged graph in order, dropping edges to missing nodes
+		auto const for_each_edge = [&](auto fn) {
+			for (auto const& source : sources) {
+				if (source.delta != nullptr) {
+					for (auto const& [dst, weight] : *source.delta) {
+						auto const it = std::lower_bound(nodes.begin(), nodes.end(), dst);
+						if (it != nodes.end() and *it == dst) {
+							fn(static_cast<std::uint64_t>(it - nodes.begin()),
+							   weight ? std::optional<weight_view>(*weight) : std::nullopt);
+						}
+					}
+					continue;
+				}
+				auto const row = base.neighbours(source.base);
+				for (std::size_t i = 0; i < row.size(); ++i) {
+					if (auto const target = remap[row[i]]; target != missing) {
+						fn(target, base.weight(base.offset(source.base) + i));
+					}
+				}
+			}
+		};
+
+		auto offsets = std::vector<std::uint64_t>{0};
+		offsets.reserve(nodes.size() + 1);
+		auto weight_bytes = std::uint64_t{0};
+		for (auto const& source : sources) {
+			auto degree = std::uint64_t{0};
+			if (source.delta != nullptr) {
+				for (auto const& [dst, weight] : *source.delta) {
+					degree += std::binary_search(nodes.begin(), nodes.end(), dst) ? 1U : 0U;
+				}
+			}
+			else {
+				for (auto const target : base.neighbours(source.base)) {
+					degree += remap[target] != missing ? 1U : 0U;
+				}
+			}
+			offsets.push_back(offsets.back() + degree);
+		}
+		auto const m = offsets.back();
+		if constexpr (binary_codec<E>::kind == binary_kind::string) {
+			for_each_edge([&](std::uint64_t, std::optional<weight_view> weight) {
+				weight_bytes += 16 + align8(weight ? weight->size() : 0);
+			});
+		}
+		else {
+			weight_bytes = m * sizeof(E);
+		}
+
+		auto const node = [&nodes](std::size_t u) -> N const& { return nodes[u]; };
+		auto const header =
+		   make_binary_header<N, E>(nodes.size(), m, section_size<N>(nodes.size(), node), weight_bytes);
+		auto out = binary_file_writer(output);
+		write_section<N>(out, header.node_data, nodes.size(), node);
+		out.pad_to(header.offsets);
+		for (auto const offset : offsets) {
+			out.write_word(offset);
+		}
+		for_each_edge([&out](std::uint64_t target, std::optional<weight_view>) { out.write_word(target); });
+		if constexpr (binary_codec<E>::kind == binary_kind::string) {
+			auto position = std::uint64_t{0};
+			for_each_edge([&](std::uint64_t, std::optional<weight_view> weight) {
+				out.write_word(position);
+				position += 8 + align8(weight ? weight->size() : 0);
+			});
+			out.pad_to(header.weight_data);
+			for_each_edge([&out](std::uint64_t, std::optional<weight_view> weight) {
+				auto const value = weight.value_or(weight_view{});
+				out.write_word(value.size());
+				out.write(value.data(), value.size());
+				out.pad_to(align8(out.position()));
+			});
+		}
+		else {
+			for_each_edge([&out](std::uint64_t, std::optional<weight_view> weight) {
+				auto const value = weight.value_or(E{});
+				out.write(&value, sizeof(E));
+			});
+		}
+		out.pad_to(header.unweighted);
+		auto word = std::uint64_t{0};
+		auto e = std::uint64_t{0};
+		for_each_edge([&](std::uint64_t, std::optional<weight_view> weight) {
+			word |= weight ? 0 : std::uint64_t{1} << (e % 64);
+			if (++e % 64 == 0) {
+				out.write_word(std::exchange(word, 0));
+			}
+		});
+		if (e % 64 != 0) {
+			out.write_word(word);
+		}
+		out.finish(header, output);
+	}
+} // namespace gdwg::detail
+
+#endif // GDWG_CHECKPOINT_H
@@ -0,0 +1,279 @@
+#include "gdwg_testing.h"
+#include "gdwg_wal.h"
+
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+namespace {
+	using gdwg::testing::contents;
+	using gdwg::testing::scratch_directory;
+
+	// Random insertions and erasures, including of nodes that were erased before, and with renames, replaced and
+	// merged nodes, whose old values come back later too
+	template<typename Graph>
+	void churn(Graph& g, std::size_t operations, unsigned seed, bool renames = false) {
+		auto rng = std::mt19937(seed);
+		for (std::size_t i = 0; i < operations; ++i) {
+			auto const u = static_cast<int>(rng() % 300);
+			auto const v = static_cast<int>(rng() % 300);
+			auto const weight = static_cast<double>(rng() % 3);
+			switch (rng() % (renames ? 12 : 10)) {
+			case 10:
+				g.insert_node(u);
+				g.replace_node(u, v);
+				break;
+			case 11:
+				g.insert_node(u);
+				g.insert_node(v);
+				if (u != v) {
+					g.merge_replace_node(u, v);
+				}
+				break;
+			case 0: g.erase_node(u); break;
+			case 1:
+				g.insert_node(u);
+				g.insert_node(v);
+				g.erase_edge(u, v, weight);
+				break;
+			case 2: g.insert_node(u); break;
+			case 3:
+				g.insert_node(u);
+				g.insert_node(v);
+				g.insert_edge(u, v);
+				break;
+			default:
+				g.insert_node(u);
+				g.insert_node(v);
+				g.insert_edge(u, v, weight);
+				break;
+			}
+		}
+	}
+
+	// The binary file save_binary writes for the graph inside a durable graph
+	template<typename N, typename E>
+	std::string saved(gdwg::durable_graph<N, E> const& g, std::string const& path) {
+		g.read([&path](gdwg::graph<N, E> const& inner) { gdwg::save_binary(inner, path); });
+		return contents(path);
+	}
+} // namespace
+
+// Incremental checkpoint tests
+TEST_CASE("Delta segments and their compaction store the same graph as a snapshot", "[checkpoint]") {
+	auto const scratch = scratch_directory("checkpoint_compaction");
+	auto const expected_files = scratch_directory("checkpoint_compaction_expected");
+	auto const expected_path = expected_files.file("expected");
+	auto options = gdwg::durable_options{};
+	options.sync = gdwg::wal_sync::manual;
+	options.compact_after = 0;
+	auto expected = gdwg::graph<int, double>{};
+	{
+		auto g = gdwg::durable_graph<int, double>(scratch.path(), options);
+		churn(g, 3000, 1);
+		churn(expected, 3000, 1);
+		g.checkpoint(); // The first checkpoint is a whole snapshot
+		REQUIRE(g.delta_segments() == 0);
+		for (auto round = 2u; round <= 6; ++round) {
+			churn(g, 200, round);
+			churn(expected, 200, round);
+			g.checkpoint();
+		}
+		REQUIRE(g.delta_segments() == 5);
+		churn(g, 50, 7); // Left in the log
+		churn(expected, 50, 7);
+	}
+	gdwg::save_binary(expected, expected_path);
+	REQUIRE(scratch.files()
+	        == std::vector<std::string>{"delta.2", "delta.3", "delta.4", "delta.5", "delta.6", "snapshot.1", "wal"});
+
+	auto g = gdwg::durable_graph<int, double>(scratch.path(), options);
+	REQUIRE(saved(g, expected_files.file("reopened")) == contents(expected_path));
+	g.checkpoint();
+	g.compact();
+	REQUIRE(g.delta_segments() == 0);
+	REQUIRE(scratch.files() == std::vector<std::string>{"snapshot.7", "wal"});
+	REQUIRE(contents(scratch.file("snapshot.7")) == contents(expected_path));
+	g.compact(); // Nothing left to merge
+	REQUIRE(scratch.files() == std::vector<std::string>{"snapshot.7", "wal"});
+}
+
+TEST_CASE("Checkpoint I/O follows the churn, not the size of the graph", "[checkpoint]") {
+	auto const scratch = scratch_directory("checkpoint_churn");
+	auto options = gdwg::durable_options{};
+	options.sync = gdwg::wal_sync::manual;
+	auto g = gdwg::durable_graph<int, int>(scratch.path(), options);
+	auto rng = std::mt19937(2);
+	for (auto v = 0; v < 20000; ++v) {
+		g.insert_node(v);
+	}
+	for (auto e = 0; e < 100000; ++e) {
+		g.insert_edge(static_cast<int>(rng() % 20000), static_cast<int>(rng() % 20000), static_cast<int>(rng() % 9));
+	}
+	g.checkpoint();
+	g.checkpoint(); // Nothing changed, so nothing is written
+	REQUIRE(scratch.files() == std::vector<std::string>{"snapshot.1", "wal"});
+
+	for (auto e = 0; e < 10; ++e) {
+		g.insert_edge(e, e + 1, 100);
+	}
+	g.checkpoint();
+	auto const snapshot = std::filesystem::file_size(scratch.file("snapshot.1"));
+	auto const delta = std::filesystem::file_size(scratch.file("delta.2"));
+	REQUIRE(delta * 100 < snapshot);
+
+	// Erasing a node rewrites the lists that had edges to it, so it stays gone if it comes back
+	auto const sources = g.read([](auto const& inner) {
+		auto count = 0;
+		for (auto const& edge : inner) {
+			count += edge.to == 7 ? 1 : 0;
+		}
+		return count;
+	});
+	REQUIRE(sources > 0);
+	g.erase_node(7);
+	g.checkpoint();
+	g.insert_node(7);
+	g.checkpoint();
+	auto const reopened = gdwg::durable_graph<int, int>(scratch.path() + "/.", options);
+	REQUIRE(reopened.read([](auto const& inner) { return inner.is_node(7) and inner.connections(7).empty(); }));
+	REQUIRE(reopened.read([](auto const& inner) {
+		return std::none_of(inner.begin(), inner.end(), [](auto const& edge) { return edge.to == 7; });
+	}));
+}
+
+TEST_CASE("Replaced and merged nodes do not bring their old edges back", "[checkpoint]") {
+	auto const scratch = scratch_directory("checkpoint_renames");
+	auto const kept_files = scratch_directory("checkpoint_renames_kept");
+	auto options = gdwg::durable_options{};
+	options.sync = gdwg::wal_sync::manual;
+	options.compact_after = 0;
+
+	SECTION("An edge into a replaced node stays gone once the node comes back") {
+		{
+			auto g = gdwg::durable_graph<int, double>(scratch.path(), options);
+			g.insert_node(1);
+			g.insert_node(2);
+			g.insert_edge(1, 2, 5);
+			g.checkpoint();
+			g.replace_node(2, 20);
+			REQUIRE_FALSE(g.read([](auto const& inner) { return inner.is_connected(1, 20); }));
+			g.insert_node(2);
+			REQUIRE_FALSE(g.read([](auto const& inner) { return inner.is_connected(1, 2); }));
+			g.checkpoint();
+		}
+		auto g = gdwg::durable_graph<int, double>(scratch.path(), options);
+		REQUIRE_FALSE(g.read([](auto const& inner) { return inner.is_connected(1, 2); }));
+		g.compact();
+		REQUIRE(contents(scratch.file("snapshot.2")) == saved(g, kept_files.file("expected")));
+	}
+
+	SECTION("Reopening after every checkpoint gives the graph that was never closed") {
+		auto kept = gdwg::durable_graph<int, double>(kept_files.file("kept"), options);
+		for (auto round = 1u; round <= 8; ++round) {
+			{
+				auto g = gdwg::durable_graph<int, double>(scratch.path(), options);
+				churn(g, 300, round, true);
+				g.checkpoint();
+			}
+			churn(kept, 300, round, true);
+			kept.checkpoint();
+			auto const reopened = gdwg::durable_graph<int, double>(scratch.path(), options);
+			REQUIRE(saved(reopened, kept_files.file("reopened")) == saved(kept, kept_files.file("expected")));
+		}
+		auto g = gdwg::durable_graph<int, double>(scratch.path(), options);
+		g.compact();
+		REQUIRE(scratch.files() == std::vector<std::string>{"snapshot.8", "wal"});
+		REQUIRE(contents(scratch.file("snapshot.8")) == saved(kept, kept_files.file("expected")));
+	}
+}
+
+TEST_CASE("Compaction runs in the background once enough segments pile up", "[checkpoint]") {
+	auto const scratch = scratch_directory("checkpoint_background");
+	auto const expected_files = scratch_directory("checkpoint_background_expected");
+	auto options = gdwg::durable_options{};
+	options.sync = gdwg::wal_sync::manual;
+	options.compact_after = 3;
+	auto expected = gdwg::graph<int, double>{};
+	{
+		auto g = gdwg::durable_graph<int, double>(scratch.path(), options);
+		for (auto round = 1u; round <= 10; ++round) {
+			churn(g, 100, round);
+			churn(expected, 100, round);
+			g.checkpoint(); // Mutations go on while the background thread merges
+		}
+		g.compact();
+		REQUIRE(g.delta_segments() == 0);
+	}
+	REQUIRE(scratch.files() == std::vector<std::string>{"snapshot.10", "wal"});
+	gdwg::save_binary(expected, expected_files.file("expected"));
+	REQUIRE(contents(scratch.file("snapshot.10")) == contents(expected_files.file("expected")));
+}
+
+TEST_CASE("Replaced nodes, strings and files left by crashes", "[checkpoint]") {
+	auto const scratch = scratch_directory("checkpoint_crashes");
+	auto options = gdwg::durable_options{};
+	options.compact_after = 0;
+	{
+		auto g = gdwg::durable_graph<std::string, std::string>(scratch.path(), options);
+		for (auto const* name : {"a", "b", "c", "d"}) {
+			g.insert_node(name);
+		}
+		g.insert_edge("a", "b", "ab");
+		g.insert_edge("c", "a");
+		g.insert_edge("d", "c", "");
+		g.checkpoint();
+		g.replace_node("b", "bb");
+		g.merge_replace_node("c", "a");
+		g.insert_edge("bb", "a", std::string(500, 'w'));
+		g.checkpoint();
+		g.clear(); // The next checkpoint is a whole snapshot again
+		g.insert_node("z");
+		g.checkpoint();
+		g.insert_node("y");
+		g.checkpoint();
+		REQUIRE(g.delta_segments() == 1);
+	}
+	REQUIRE(scratch.files() == std::vector<std::string>{"delta.4", "snapshot.3", "wal"});
+
+	SECTION("Leftovers of an interrupted checkpoint or compaction are removed") {
+		std::filesystem::copy_file(scratch.file("delta.4"), scratch.file("delta.2"));
+		std::ofstream(scratch.file("snapshot.5.tmp")) << "partial";
+		std::filesystem::copy_file(scratch.file("snapshot.3"), scratch.file("snapshot.1"));
+		auto const g = gdwg::durable_graph<std::string, std::string>(scratch.path(), options);
+		REQUIRE(g.read([](auto inner) { return inner.nodes(); }) == std::vector<std::string>{"y", "z"});
+		REQUIRE(scratch.files() == std::vector<std::string>{"delta.4", "snapshot.3", "wal"});
+	}
+
+	SECTION("A missing segment is an error") {
+		std::filesystem::rename(scratch.file("delta.4"), scratch.file("delta.5"));
+		REQUIRE_THROWS_WITH((gdwg::durable_graph<std::string, std::string>(scratch.path(), options)),
+		                    "Cannot open gdwg::durable_graph " + scratch.path() + ": delta segment 4 is missing");
+	}
+
+	SECTION("Replaced and merged nodes survive a delta segment") {
+		auto const other = scratch_directory("checkpoint_replaced");
+		auto g = gdwg::durable_graph<std::string, std::string>(other.path(), options);
+		for (auto const* name : {"a", "b", "c", "d"}) {
+			g.insert_node(name);
+		}
+		g.insert_edge("a", "b", "ab");
+		g.insert_edge("c", "a");
+		g.insert_edge("d", "c", "");
+		g.checkpoint();
+		g.replace_node("b", "bb");
+		g.merge_replace_node("c", "a");
+		g.insert_edge("bb", "a", std::string(500, 'w'));
+		g.checkpoint();
+		auto const reopened = gdwg::durable_graph<std::string, std::string>(other.path() + "/.", options);
+		REQUIRE(reopened.read([](auto inner) { return inner.nodes(); })
+		        == std::vector<std::string>{"a", "bb", "d"});
+		REQUIRE(reopened.read([](auto const& inner) { return inner.connections("a"); })
+		        == std::vector<std::string>{"a"});
+		REQUIRE(reopened.read([](auto const& inner) { return inner.connections("d"); }).empty());
+		REQUIRE(reopened.read([](auto const& inner) { return inner.edges("bb", "a")[0]->get_weight(); })
+		        == std::string(500, 'w'));
+	}
+}
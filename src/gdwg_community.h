@@ -0,0 +1,732 @@
+#ifndef GDWG_COMMUNITY_H
+#define GDWG_COMMUNITY_H
+
+#include "gdwg_csr.h"
+#include "gdwg_graph.h"
+#include "gdwg_parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	enum class community_method {
+		louvain, // Local moving and aggregation
+		leiden, // Local moving, refinement into well-connected subcommunities, then aggregation
+	};
+
+	struct community_options {
+		community_method method = community_method::louvain;
+		double resolution = 1.0; // Resolution parameter of the modularity; larger values give smaller communities
+		double tolerance = 1e-7; // Least modularity gain for another sweep of local moving
+		std::size_t max_sweeps = 32; // Local moving sweeps per level at most
+		std::size_t max_levels = 32; // Levels of local moving and aggregation at most
+	};
+
+	struct label_propagation_options {
+		bool deterministic = false; // Synchronous rounds over a fixed order instead of asynchronous updates
+		double threshold = 1e-3; // Stop once at most this fraction of the labels changes in a round
+		std::size_t max_rounds = 100; // Rounds at most
+		std::uint64_t seed = 6771; // Seed of the visiting order of asynchronous rounds
+	};
+
+	// Communities of a snapshot, by node index
+	struct community_labels {
+		std::vector<std::size_t> community; // Community id of every node; ids are 0..k-1 in order of first node
+		std::vector<std::size_t> sizes; // Number of nodes in each community
+		double modularity = 0; // Modularity of the partition at the requested resolution
+		std::size_t levels = 0; // Number of levels run (rounds, for label propagation)
+	};
+
+	// Communities of a graph, by node value
+	template<typename N>
+	struct communities {
+		std::map<N, std::size_t> community; // Community id of every node; ids are 0..k-1 in order of smallest node
+		std::vector<std::size_t> sizes; // Number of nodes in each community
+		double modularity = 0; // Modularity of the partition at the requested resolution
+		std::size_t levels = 0; // Number of levels run
+	};
+
+	namespace detail {
+		// Symmetric weighted adjacency in CSR form: a_uv = w(u, v) + w(v, u), and a self loop holds twice its
+		// weight in a single entry, so every row sums to the node's strength
+		struct community_graph {
+			std::vector<std::size_t> offsets;
+			std::vector<std::size_t> targets; // Sorted by index within each node, without duplicates
+			std::vector<double> weights;
+			std::vector<double> strength; // Weighted degree of every node
+			double total = 0; // Sum of all strengths (twice the total edge weight)
+
+			[[nodiscard]] std::size_t node_count() const noexcept {
+				return strength.size();
+			}
+		};
+
+		template<typename N, typename E>
+		community_graph make_community_graph(csr_graph<N, E> const& g, thread_pool& pool) {
+			static_assert(std::is_arithmetic_v<E>, "gdwg::detect_communities needs arithmetic edge weights");
+			auto const n = g.node_count();
+			auto offsets = std::vector<std::size_t>(n + 1, 0);
+			for (std::size_t u = 0; u < n; ++u) {
+				for (auto v : g.neighbours(u)) {
+					++offsets[u + 1];
+					if (u != v) {
+						++offsets[v + 1];
+					}
+				}
+			}
+			for (std::size_t u = 0; u < n; ++u) {
+				offsets[u + 1] += offsets[u];
+			}
+			auto both = std::vector<std::pair<std::size_t, double>>(offsets.back());
+			auto fill = std::vector<std::size_t>(offsets.begin(), offsets.end() - 1);
+			for (std::size_t u = 0; u < n; ++u) {
+				auto const targets = g.neighbours(u);
+				auto const weights = g.weights(u);
+				for (std::size_t e = 0; e < targets.size(); ++e) {
+					auto const v = targets[e];
+					auto const weight = weights[e] ? static_cast<double>(*weights[e]) : 1.0;
+					if (weight < 0.0) {
+						throw std::runtime_error("Cannot call gdwg::detect_communities on a graph with negative edge "
+						                         "weights");
+					}
+					if (u == v) {
+						both[fill[u]++] = {u, 2.0 * weight};
+					}
+					else {
+						both[fill[u]++] = {v, weight};
+						both[fill[v]++] = {u, weight};
+					}
+				}
+			}
+
+			// Sort every row and merge entries with the same target, then compact the rows
+			auto result = community_graph{};
+			result.offsets.assign(n + 1, 0);
+			result.strength.assign(n, 0.0);
+			parallel_for(pool, 0, n, 256, [&](std::size_t lo, std::size_t hi, std::size_t) {
+				for (auto u = lo; u < hi; ++u) {
+					auto const first = both.begin() + static_cast<std::ptrdiff_t>(offsets[u]);
+					auto const last = both.begin() + static_cast<std::ptrdiff_t>(offsets[u + 1]);
+					std::sort(first, last);
+					auto out = first;
+					for (auto it = first; it != last; ++it) {
+						result.strength[u] += it->second;
+						if (out != first and (out - 1)->first == it->first) {
+							(out - 1)->second += it->second;
+						}
+						else {
+							*out++ = *it;
+						}
+					}
+					result.offsets[u + 1] = static_cast<std::size_t>(out - first);
+				}
+			});
+			for (std::size_t u = 0; u < n; ++u) {
+				result.offsets[u + 1] += result.offsets[u];
+				result.total += result.strength[u];
+			}
+			result.targets.assign(result.offsets.back(), 0);
+			result.weights.assign(result.offsets.back(), 0.0);
+			parallel_for(pool, 0, n, 256, [&](std::size_t lo, std::size_t hi, std::size_t) {
+				for (auto u = lo; u < hi; ++u) {
+					for (std::size_t i = 0; i < result.offsets[u + 1] - result.offsets[u]; ++i) {
+						result.targets[result.offsets[u] + i] = both[offsets[u] + i].first;
+						result.weights[result.offsets[u] + i] = both[offsets[u] + i].second;
+					}
+				}
+			});
+			return result;
+		}
+
+		// Sparse accumulator of weights per community, reset in time proportional to the entries touched
+		class community_accumulator {
+		 public:
+			explicit community_accumulator(std::size_t size)
+			: weight_(size, 0.0)
+			, seen_(size, false) {}
+
+			void add(std::size_t c, double weight) {
+				if (!seen_[c]) {
+					seen_[c] = true;
+					touched_.push_back(c);
+				}
+				weight_[c] += weight;
+			}
+
+			[[nodiscard]] double operator[](std::size_t c) const {
+				return weight_[c];
+			}
+
+			[[nodiscard]] std::vector<std::size_t>& touched() noexcept {
+				return touched_;
+			}
+
+			void clear() {
+				for (auto c : touched_) {
+					weight_[c] = 0.0;
+					seen_[c] = false;
+				}
+				touched_.clear();
+			}
+
+		 private:
+			std::vector<double> weight_;
+			std::vector<bool> seen_;
+			std::vector<std::size_t> touched_;
+		};
+
+		// One accumulator per worker, created on first use; every level of a run fits in the first level's size
+		class community_workspace {
+		 public:
+			community_workspace(thread_pool& pool, std::size_t size)
+			: accumulators_(pool.size())
+			, size_(size) {}
+
+			community_accumulator& get(std::size_t worker) {
+				if (!accumulators_[worker]) {
+					accumulators_[worker].emplace(size_);
+				}
+				return *accumulators_[worker];
+			}
+
+		 private:
+			std::vector<std::optional<community_accumulator>> accumulators_;
+			std::size_t size_;
+		};
+
+		// Renumber labels to 0..k-1 in order of first occurrence and return k
+		inline std::size_t renumber(std::vector<std::size_t>& labels, std::size_t bound) {
+			auto id = std::vector<std::size_t>(bound, bound);
+			auto count = std::size_t{0};
+			for (auto& label : labels) {
+				if (id[label] == bound) {
+					id[label] = count++;
+				}
+				label = id[label];
+			}
+			return count;
+		}
+
+		// Modularity of a partition: sum over communities of internal weight / total - resolution * (strength /
+		// total)^2. Partial sums are kept per chunk, so the result does not depend on the number of workers
+		inline double modularity(community_graph const& g,
+		                         std::vector<std::size_t> const& community,
+		                         double resolution,
+		                         thread_pool& pool) {
+			auto const n = g.node_count();
+			if (g.total == 0.0) {
+				return 0.0;
+			}
+			constexpr auto grain = std::size_t{1} << 12;
+			auto internal = std::vector<double>((n + grain - 1) / grain, 0.0);
+			parallel_for(pool, 0, n, grain, [&](std::size_t lo, std::size_t hi, std::size_t) {
+				auto sum = 0.0;
+				for (auto u = lo; u < hi; ++u) {
+					for (auto e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+						if (community[g.targets[e]] == community[u]) {
+							sum += g.weights[e];
+						}
+					}
+				}
+				internal[lo / grain] = sum;
+			});
+			auto strength = std::vector<double>(n, 0.0);
+			for (std::size_t u = 0; u < n; ++u) {
+				strength[community[u]] += g.strength[u];
+			}
+			auto q = 0.0;
+			for (auto sum : internal) {
+				q += sum / g.total;
+			}
+			for (auto s : strength) {
+				q -= resolution * (s / g.total) * (s / g.total);
+			}
+			return q;
+		}
+
+		// Local moving: sweeps over the nodes in parallel, moving each to the neighbouring community with the
+		// largest modularity gain, until a sweep gains less than the tolerance. Community labels and strengths
+		// are shared atomics that workers update as they go, so later nodes of a sweep see earlier moves.
+		// Returns the number of moves
+		inline std::size_t move_nodes(community_graph const& g,
+		                              std::vector<std::size_t>& community,
+		                              community_options const& options,
+		                              thread_pool& pool,
+		                              community_workspace& workspace) {
+			auto const n = g.node_count();
+			if (g.total == 0.0) {
+				return 0;
+			}
+			auto label = std::make_unique<std::atomic<std::size_t>[]>(n);
+			auto total = std::make_unique<std::atomic<double>[]>(n);
+			auto size = std::make_unique<std::atomic<std::size_t>[]>(n);
+			for (std::size_t u = 0; u < n; ++u) {
+				label[u].store(community[u], std::memory_order_relaxed);
+				total[community[u]].fetch_add(g.strength[u], std::memory_order_relaxed);
+				size[community[u]].fetch_add(1, std::memory_order_relaxed);
+			}
+
+			auto moves = std::size_t{0};
+			auto moved = std::vector<std::size_t>(pool.size(), 0);
+			auto q = modularity(g, community, options.resolution, pool);
+			for (std::size_t sweep = 0; sweep < options.max_sweeps; ++sweep) {
+				std::fill(moved.begin(), moved.end(), 0);
+				parallel_for(pool, 0, n, 256, [&](std::size_t lo, std::size_t hi, std::size_t worker) {
+					auto& weight_to = workspace.get(worker);
+					for (auto u = lo; u < hi; ++u) {
+						auto const current = label[u].load(std::memory_order_relaxed);
+						weight_to.clear();
+						weight_to.add(current, 0.0);
+						for (auto e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+							if (g.targets[e] != u) {
+								weight_to.add(label[g.targets[e]].load(std::memory_order_relaxed), g.weights[e]);
+							}
+						}
+						// Gain of joining c, up to terms that are the same for every c
+						auto const scale = options.resolution * g.strength[u] / g.total;
+						auto best = current;
+						auto best_gain = weight_to[current]
+						                 - scale * (total[current].load(std::memory_order_relaxed) - g.strength[u]);
+						for (auto c : weight_to.touched()) {
+							auto const gain = weight_to[c] - scale * total[c].load(std::memory_order_relaxed);
+							if (gain > best_gain or (gain == best_gain and best != current and c < best)) {
+								best = c;
+								best_gain = gain;
+							}
+						}
+						if (best == current) {
+							continue;
+						}
+						// Two singletons joining each other at once would just swap, so only the larger id moves
+						if (size[current].load(std::memory_order_relaxed) == 1
+						    and size[best].load(std::memory_order_relaxed) == 1 and best > current)
+						{
+							continue;
+						}
+						total[current].fetch_sub(g.strength[u], std::memory_order_relaxed);
+						total[best].fetch_add(g.strength[u], std::memory_order_relaxed);
+						size[current].fetch_sub(1, std::memory_order_relaxed);
+						size[best].fetch_add(1, std::memory_order_relaxed);
+						label[u].store(best, std::memory_order_relaxed);
+						++moved[worker];
+					}
+				});
+				auto swept = std::size_t{0};
+				for (auto m : moved) {
+					swept += m;
+				}
+				if (swept == 0) {
+					break;
+				}
+				moves += swept;
+				for (std::size_t u = 0; u < n; ++u) {
+					community[u] = label[u].load(std::memory_order_relaxed);
+				}
+				auto const next = modularity(g, community, options.resolution, pool);
+				if (next - q < options.tolerance) {
+					break;
+				}
+				q = next;
+			}
+			return moves;
+		}
+
+		// Group the nodes by community: members of community c are members[offsets[c], offsets[c + 1])
+		inline std::pair<std::vector<std::size_t>, std::vector<std::size_t>>
+		group_members(std::vector<std::size_t> const& community, std::size_t count) {
+			auto offsets = std::vector<std::size_t>(count + 1, 0);
+			for (auto c : community) {
+				++offsets[c + 1];
+			}
+			for (std::size_t c = 0; c < count; ++c) {
+				offsets[c + 1] += offsets[c];
+			}
+			auto members = std::vector<std::size_t>(community.size());
+			auto fill = std::vector<std::size_t>(offsets.begin(), offsets.end() - 1);
+			for (std::size_t u = 0; u < community.size(); ++u) {
+				members[fill[community[u]]++] = u;
+			}
+			return {std::move(offsets), std::move(members)};
+		}
+
+		// Leiden refinement: within each community, nodes that are still singletons merge greedily into
+		// well-connected subcommunities of it. Communities are refined independently in parallel.
+		// Returns the refined labels (ids 0..k-1 in order of first node) and the community of every refined label
+		inline std::pair<std::vector<std::size_t>, std::vector<std::size_t>>
+		refine_partition(community_graph const& g,
+		                 std::vector<std::size_t> const& community,
+		                 std::size_t count,
+		                 community_options const& options,
+		                 thread_pool& pool,
+		                 community_workspace& workspace) {
+			auto const n = g.node_count();
+			auto const [offsets, members] = group_members(community, count);
+			auto refined = std::vector<std::size_t>(n);
+			auto refined_total = std::vector<double>(g.strength);
+			auto refined_size = std::vector<std::size_t>(n, 1);
+			auto cut = std::vector<double>(n, 0.0); // Weight from a subcommunity to the rest of its community
+			auto inside = std::vector<double>(n, 0.0); // Weight from a node to the rest of its community
+			parallel_for(pool, 0, count, 16, [&](std::size_t lo, std::size_t hi, std::size_t worker) {
+				auto& weight_to = workspace.get(worker);
+				for (auto c = lo; c < hi; ++c) {
+					auto community_total = 0.0;
+					for (auto i = offsets[c]; i < offsets[c + 1]; ++i) {
+						auto const v = members[i];
+						refined[v] = v;
+						community_total += g.strength[v];
+						for (auto e = g.offsets[v]; e < g.offsets[v + 1]; ++e) {
+							if (g.targets[e] != v and community[g.targets[e]] == c) {
+								inside[v] += g.weights[e];
+							}
+						}
+						cut[v] = inside[v];
+					}
+					auto well_connected = [&](double weight, double strength) {
+						return weight >= options.resolution * strength * (community_total - strength) / g.total;
+					};
+					for (auto i = offsets[c]; i < offsets[c + 1]; ++i) {
+						auto const v = members[i];
+						if (refined[v] != v or refined_size[v] != 1 or !well_connected(inside[v], g.strength[v])) {
+							continue;
+						}
+						weight_to.clear();
+						for (auto e = g.offsets[v]; e < g.offsets[v + 1]; ++e) {
+							auto const t = g.targets[e];
+							if (t != v and community[t] == c) {
+								weight_to.add(refined[t], g.weights[e]);
+							}
+						}
+						auto const scale = options.resolution * g.strength[v] / g.total;
+						auto best = v;
+						auto best_gain = 0.0;
+						for (auto target : weight_to.touched()) {
+							if (!well_connected(cut[target], refined_total[target])) {
+								continue;
+							}
+							auto const gain = weight_to[target] - scale * refined_total[target];
+							if (gain > best_gain) {
+								best = target;
+								best_gain = gain;
+							}
+						}
+						if (best != v) {
+							refined[v] = best;
+							refined_total[best] += g.strength[v];
+							cut[best] += inside[v] - 2.0 * weight_to[best];
+							++refined_size[best];
+							refined_size[v] = 0;
+						}
+					}
+				}
+			});
+			auto const refined_count = renumber(refined, n);
+			auto parent = std::vector<std::size_t>(refined_count, 0);
+			for (std::size_t v = 0; v < n; ++v) {
+				parent[refined[v]] = community[v];
+			}
+			return {std::move(refined), std::move(parent)};
+		}
+
+		// Collapse every community into one node. Communities are built independently in two passes over
+		// their members (count, then fill), so the coarse graph is written straight into CSR arrays
+		inline community_graph aggregate(community_graph const& g,
+		                                 std::vector<std::size_t> const& community,
+		                                 std::size_t count,
+		                                 thread_pool& pool,
+		                                 community_workspace& workspace) {
+			auto const [offsets, members] = group_members(community, count);
+			auto result = community_graph{};
+			result.offsets.assign(count + 1, 0);
+			result.strength.assign(count, 0.0);
+			result.total = g.total;
+
+			auto accumulate = [&](std::size_t c, community_accumulator& weight_to) {
+				weight_to.clear();
+				for (auto i = offsets[c]; i < offsets[c + 1]; ++i) {
+					auto const u = members[i];
+					for (auto e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+						weight_to.add(community[g.targets[e]], g.weights[e]);
+					}
+				}
+			};
+			parallel_for(pool, 0, count, 64, [&](std::size_t lo, std::size_t hi, std::size_t worker) {
+				auto& weight_to = workspace.get(worker);
+				for (auto c = lo; c < hi; ++c) {
+					accumulate(c, weight_to);
+					result.offsets[c + 1] = weight_to.touched().size();
+				}
+			});
+			for (std::size_t c = 0; c < count; ++c) {
+				result.offsets[c + 1] += result.offsets[c];
+			}
+			result.targets.assign(result.offsets.back(), 0);
+			result.weights.assign(result.offsets.back(), 0.0);
+			parallel_for(pool, 0, count, 64, [&](std::size_t lo, std::size_t hi, std::size_t worker) {
+				auto& weight_to = workspace.get(worker);
+				for (auto c = lo; c < hi; ++c) {
+					accumulate(c, weight_to);
+					auto& touched = weight_to.touched();
+					std::sort(touched.begin(), touched.end());
+					auto out = result.offsets[c];
+					for (auto d : touched) {
+						result.targets[out] = d;
+						result.weights[out] = weight_to[d];
+						result.strength[c] += weight_to[d];
+						++out;
+					}
+				}
+			});
+			return result;
+		}
+
+		// The label with the largest total weight among u's neighbours: the current label if it is one of the
+		// heaviest, otherwise the smallest heaviest one. Nodes without neighbours keep their label
+		template<typename Label>
+		std::size_t heaviest_label(community_graph const& g,
+		                           std::size_t u,
+		                           std::size_t current,
+		                           Label label_of,
+		                           community_accumulator& weight_to) {
+			weight_to.clear();
+			for (auto e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+				if (g.targets[e] != u) {
+					weight_to.add(label_of(g.targets[e]), g.weights[e]);
+				}
+			}
+			auto best = current;
+			auto best_weight = weight_to[current];
+			for (auto c : weight_to.touched()) {
+				if (weight_to[c] > best_weight or (weight_to[c] == best_weight and best != current and c < best)) {
+					best = c;
+					best_weight = weight_to[c];
+				}
+			}
+			return best;
+		}
+
+		// Renumber the final labels and count the community sizes
+		inline community_labels finish_labels(std::vector<std::size_t> community) {
+			auto result = community_labels{};
+			auto const count = renumber(community, std::max<std::size_t>(community.size(), 1));
+			result.sizes.assign(count, 0);
+			for (auto c : community) {
+				++result.sizes[c];
+			}
+			result.community = std::move(community);
+			return result;
+		}
+
+		template<typename N, typename E>
+		communities<N> by_node_value(csr_graph<N, E> const& snapshot, community_labels labels) {
+			auto result = communities<N>{};
+			for (std::size_t u = 0; u < snapshot.node_count(); ++u) {
+				result.community.emplace_hint(result.community.end(), snapshot.node(u), labels.community[u]);
+			}
+			result.sizes = std::move(labels.sizes);
+			result.modularity = labels.modularity;
+			result.levels = labels.levels;
+			return result;
+		}
+	} // namespace detail
+
+	// Modularity of a partition of a snapshot, treating it as undirected with weights (1 if unweighted)
+	template<typename N, typename E>
+	[[nodiscard]] double modularity(csr_graph<N, E> const& g,
+	                                std::vector<std::size_t> const& community,
+	                                double resolution = 1.0,
+	                                thread_pool& pool = default_thread_pool()) {
+		if (community.size() != g.node_count()) {
+			throw std::runtime_error("Cannot call gdwg::modularity with a partition of a different size");
+		}
+		if (community.empty()) {
+			return 0.0;
+		}
+		auto labels = community;
+		detail::renumber(labels, *std::max_element(labels.begin(), labels.end()) + 1);
+		return detail::modularity(detail::make_community_graph(g, pool), labels, resolution, pool);
+	}
+
+	// Detect communities of a snapshot by maximising modularity with the Louvain method, optionally with the
+	// Leiden refinement, which guarantees connected communities
+	// The snapshot is treated as undirected: the weight between two nodes is the sum of the edge weights in
+	// both directions, with unweighted edges counting as 1. Local moving runs on the pool with shared atomic
+	// community state, so with more than one worker the result can vary between runs; with one it is
+	// deterministic. Leiden's randomised merge in the refinement is replaced by the greedy choice
+	template<typename N, typename E>
+	[[nodiscard]] community_labels detect_communities(csr_graph<N, E> const& g,
+	                                                  community_options const& options = {},
+	                                                  thread_pool& pool = default_thread_pool()) {
+		auto level = detail::make_community_graph(g, pool);
+		auto workspace = detail::community_workspace(pool, g.node_count());
+		auto const n = g.node_count();
+		auto membership = std::vector<std::size_t>(n); // Node of the current level holding every original node
+		auto community = std::vector<std::size_t>(n);
+		for (std::size_t u = 0; u < n; ++u) {
+			membership[u] = u;
+			community[u] = u;
+		}
+
+		auto levels = std::size_t{0};
+		while (levels < options.max_levels) {
+			auto const moves = detail::move_nodes(level, community, options, pool, workspace);
+			++levels;
+			if (moves == 0) {
+				break;
+			}
+			auto const count = detail::renumber(community, level.node_count());
+			auto next = std::vector<std::size_t>{};
+			if (options.method == community_method::leiden) {
+				auto [refined, parent] = detail::refine_partition(level, community, count, options, pool, workspace);
+				for (auto& u : membership) {
+					u = refined[u];
+				}
+				level = detail::aggregate(level, refined, parent.size(), pool, workspace);
+				next = std::move(parent);
+			}
+			else {
+				for (auto& u : membership) {
+					u = community[u];
+				}
+				level = detail::aggregate(level, community, count, pool, workspace);
+				next.resize(count);
+				for (std::size_t c = 0; c < count; ++c) {
+					next[c] = c;
+				}
+			}
+			community = std::move(next);
+		}
+
+		auto final = std::vector<std::size_t>(n);
+		for (std::size_t u = 0; u < n; ++u) {
+			final[u] = community[membership[u]];
+		}
+		auto result = detail::finish_labels(std::move(final));
+		// Aggregation preserves modularity, so it can be measured on the last level
+		result.modularity = detail::modularity(level, community, options.resolution, pool);
+		result.levels = levels;
+		return result;
+	}
+
+	// Detect communities of a graph by modularity optimisation, keyed by node value
+	template<typename N, typename E>
+	[[nodiscard]] communities<N> detect_communities(graph<N, E> const& g,
+	                                                community_options const& options = {},
+	                                                thread_pool& pool = default_thread_pool()) {
+		auto const snapshot = csr_graph<N, E>(g);
+		return detail::by_node_value(snapshot, detect_communities(snapshot, options, pool));
+	}
+	// Detect communities of a snapshot by weighted label propagation: every node repeatedly adopts the label
+	// with the largest total weight among its neighbours (over the symmetrised graph, unweighted edges counting
+	// as 1) until at most the threshold fraction of labels changes in a round; a threshold of 0 runs until a round
+	// changes no label.
+	// By default rounds are asynchronous: workers update shared atomic labels in place, visiting the nodes in a
+	// shuffled order, so results vary between runs. The deterministic mode reads only labels fixed before each
+	// step: a round updates the even nodes from the labels of the previous round, then the odd nodes from
+	// those, which gives the same result for any number of workers and avoids the label swapping of fully
+	// synchronous rounds
+	template<typename N, typename E>
+	[[nodiscard]] community_labels label_propagation(csr_graph<N, E> const& g,
+	                                                 label_propagation_options const& options = {},
+	                                                 thread_pool& pool = default_thread_pool()) {
+		auto const level = detail::make_community_graph(g, pool);
+		auto workspace = detail::community_workspace(pool, g.node_count());
+		auto const n = g.node_count();
+		auto label = std::vector<std::size_t>(n);
+		for (std::size_t u = 0; u < n; ++u) {
+			label[u] = u;
+		}
+		auto changed = std::vector<std::size_t>(pool.size(), 0);
+		auto changes = [&changed] {
+			auto sum = std::size_t{0};
+			for (auto& c : changed) {
+				sum += std::exchange(c, 0);
+			}
+			return sum;
+		};
+		constexpr auto grain = std::size_t{256};
+
+		auto rounds = std::size_t{0};
+		if (options.deterministic) {
+			auto next = label;
+			auto const label_of = [&label](std::size_t v) { return label[v]; };
+			while (rounds < options.max_rounds) {
+				++rounds;
+				for (std::size_t parity = 0; parity < 2; ++parity) {
+					auto const half = (n + 1 - parity) / 2;
+					parallel_for(pool, 0, half, grain, [&](std::size_t lo, std::size_t hi, std::size_t worker) {
+						auto& weight_to = workspace.get(worker);
+						for (auto i = lo; i < hi; ++i) {
+							auto const u = 2 * i + parity;
+							next[u] = detail::heaviest_label(level, u, label[u], label_of, weight_to);
+							changed[worker] += next[u] != label[u] ? std::size_t{1} : std::size_t{0};
+						}
+					});
+					for (auto u = parity; u < n; u += 2) {
+						label[u] = next[u];
+					}
+				}
+				if (static_cast<double>(changes()) <= options.threshold * static_cast<double>(n)) {
+					break;
+				}
+			}
+		}
+		else {
+			auto shared = std::make_unique<std::atomic<std::size_t>[]>(n);
+			auto order = std::vector<std::size_t>(n);
+			for (std::size_t u = 0; u < n; ++u) {
+				shared[u].store(u, std::memory_order_relaxed);
+				order[u] = u;
+			}
+			auto rng = std::mt19937_64(options.seed);
+			auto const label_of = [&shared](std::size_t v) { return shared[v].load(std::memory_order_relaxed); };
+			while (rounds < options.max_rounds) {
+				++rounds;
+				std::shuffle(order.begin(), order.end(), rng);
+				parallel_for(pool, 0, n, grain, [&](std::size_t lo, std::size_t hi, std::size_t worker) {
+					auto& weight_to = workspace.get(worker);
+					for (auto i = lo; i < hi; ++i) {
+						auto const u = order[i];
+						auto const current = label_of(u);
+						auto const best = detail::heaviest_label(level, u, current, label_of, weight_to);
+						if (best != current) {
+							shared[u].store(best, std::memory_order_relaxed);
+							++changed[worker];
+						}
+					}
+				});
+				if (static_cast<double>(changes()) <= options.threshold * static_cast<double>(n)) {
+					break;
+				}
+			}
+			for (std::size_t u = 0; u < n; ++u) {
+				label[u] = label_of(u);
+			}
+		}
+
+		auto result = detail::finish_labels(std::move(label));
+		result.modularity = detail::modularity(level, result.community, 1.0, pool);
+		result.levels = rounds;
+		return result;
+	}
+
+	// Detect communities of a graph by label propagation, keyed by node value
+	template<typename N, typename E>
+	[[nodiscard]] communities<N> label_propagation(graph<N, E> const& g,
+	                                               label_propagation_options const& options = {},
+	                                               thread_pool& pool = default_thread_pool()) {
+		auto const snapshot = csr_graph<N, E>(g);
+		return detail::by_node_value(snapshot, label_propagation(snapshot, options, pool));
+	}
+} // namespace gdwg
+
+#endif // GDWG_COMMUNITY_H
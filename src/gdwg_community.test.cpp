@@ -0,0 +1,262 @@
+#include "gdwg_community.h"
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <set>
+
+namespace {
+	// Zachary's karate club, with members numbered from 1
+	gdwg::graph<int, int> karate_club() {
+		auto const edges = std::vector<std::pair<int, int>>{
+		   {1, 2},   {1, 3},   {1, 4},   {1, 5},   {1, 6},   {1, 7},   {1, 8},   {1, 9},   {1, 11},  {1, 12},
+		   {1, 13},  {1, 14},  {1, 18},  {1, 20},  {1, 22},  {1, 32},  {2, 3},   {2, 4},   {2, 8},   {2, 14},
+		   {2, 18},  {2, 20},  {2, 22},  {2, 31},  {3, 4},   {3, 8},   {3, 9},   {3, 10},  {3, 14},  {3, 28},
+		   {3, 29},  {3, 33},  {4, 8},   {4, 13},  {4, 14},  {5, 7},   {5, 11},  {6, 7},   {6, 11},  {6, 17},
+		   {7, 17},  {9, 31},  {9, 33},  {9, 34},  {10, 34}, {14, 34}, {15, 33}, {15, 34}, {16, 33}, {16, 34},
+		   {19, 33}, {19, 34}, {20, 34}, {21, 33}, {21, 34}, {23, 33}, {23, 34}, {24, 26}, {24, 28}, {24, 30},
+		   {24, 33}, {24, 34}, {25, 26}, {25, 28}, {25, 32}, {26, 32}, {27, 30}, {27, 34}, {28, 34}, {29, 32},
+		   {29, 34}, {30, 33}, {30, 34}, {31, 33}, {31, 34}, {32, 33}, {32, 34}, {33, 34}};
+		gdwg::graph<int, int> g;
+		for (auto v = 1; v <= 34; ++v) {
+			g.insert_node(v);
+		}
+		for (auto [u, v] : edges) {
+			g.insert_edge(u, v);
+		}
+		return g;
+	}
+
+	// Whether every community induces a connected subgraph (ignoring direction)
+	bool communities_connected(gdwg::csr_graph<int, int> const& g, std::vector<std::size_t> const& community) {
+		auto const n = g.node_count();
+		auto adjacency = std::vector<std::vector<std::size_t>>(n);
+		for (std::size_t u = 0; u < n; ++u) {
+			for (auto v : g.neighbours(u)) {
+				adjacency[u].push_back(v);
+				adjacency[v].push_back(u);
+			}
+		}
+		auto seen = std::vector<bool>(n, false);
+		auto roots = std::set<std::size_t>{};
+		for (std::size_t s = 0; s < n; ++s) {
+			if (seen[s]) {
+				continue;
+			}
+			if (!roots.insert(community[s]).second) {
+				return false; // A second piece of the same community
+			}
+			auto stack = std::vector<std::size_t>{s};
+			seen[s] = true;
+			while (!stack.empty()) {
+				auto const u = stack.back();
+				stack.pop_back();
+				for (auto v : adjacency[u]) {
+					if (!seen[v] and community[v] == community[s]) {
+						seen[v] = true;
+						stack.push_back(v);
+					}
+				}
+			}
+		}
+		return true;
+	}
+} // namespace
+
+// Community detection tests
+TEST_CASE("Two cliques joined by one edge split into two communities", "[community]") {
+	gdwg::graph<int, double> g;
+	for (auto v = 0; v < 10; ++v) {
+		g.insert_node(v);
+	}
+	for (auto base : {0, 5}) {
+		for (auto u = base; u < base + 5; ++u) {
+			for (auto v = u + 1; v < base + 5; ++v) {
+				g.insert_edge(u, v, 1.0);
+			}
+		}
+	}
+	g.insert_edge(4, 5, 0.5);
+
+	for (auto method : {gdwg::community_method::louvain, gdwg::community_method::leiden}) {
+		auto options = gdwg::community_options{};
+		options.method = method;
+		auto const result = gdwg::detect_communities(g, options);
+		REQUIRE(result.sizes == std::vector<std::size_t>{5, 5});
+		for (auto v = 0; v < 10; ++v) {
+			REQUIRE(result.community.at(v) == (v < 5 ? 0 : 1));
+		}
+		// Internal weight 20 of 20.5, and each half holds half the strength
+		REQUIRE(result.modularity == Approx(20.0 / 20.5 - 0.5));
+	}
+}
+
+TEST_CASE("Communities of the karate club", "[community]") {
+	auto const g = karate_club();
+	auto const snapshot = gdwg::csr_graph<int, int>(g);
+	auto pool = gdwg::thread_pool(1);
+	for (auto method : {gdwg::community_method::louvain, gdwg::community_method::leiden}) {
+		auto options = gdwg::community_options{};
+		options.method = method;
+		auto const result = gdwg::detect_communities(snapshot, options, pool);
+		// The best partition has modularity 0.4198; the greedy methods land close to it
+		REQUIRE(result.modularity > 0.40);
+		REQUIRE(result.modularity == Approx(gdwg::modularity(snapshot, result.community)));
+		REQUIRE(result.sizes.size() >= 3);
+		REQUIRE(result.sizes.size() <= 5);
+		REQUIRE(communities_connected(snapshot, result.community));
+		// The instructor and the administrator end up apart
+		REQUIRE(result.community[0] != result.community[33]);
+	}
+
+	// A higher resolution gives more, smaller communities
+	auto options = gdwg::community_options{};
+	options.resolution = 2.0;
+	REQUIRE(gdwg::detect_communities(snapshot, options, pool).sizes.size() > 5);
+}
+
+TEST_CASE("Planted partitions are recovered", "[community]") {
+	auto rng = std::mt19937(34);
+	auto coin = std::uniform_real_distribution<double>(0.0, 1.0);
+	constexpr auto groups = 4;
+	constexpr auto group_size = 40;
+	gdwg::graph<int, int> g;
+	for (auto v = 0; v < groups * group_size; ++v) {
+		g.insert_node(v);
+	}
+	for (auto u = 0; u < groups * group_size; ++u) {
+		for (auto v = 0; v < groups * group_size; ++v) {
+			auto const p = u / group_size == v / group_size ? 0.2 : 0.005;
+			if (u != v and coin(rng) < p) {
+				g.insert_edge(u, v, 1 + static_cast<int>(rng() % 3));
+			}
+		}
+	}
+	auto const snapshot = gdwg::csr_graph<int, int>(g);
+	for (auto threads : {std::size_t{1}, std::size_t{4}}) {
+		auto pool = gdwg::thread_pool(threads);
+		for (auto method : {gdwg::community_method::louvain, gdwg::community_method::leiden}) {
+			auto options = gdwg::community_options{};
+			options.method = method;
+			auto const result = gdwg::detect_communities(snapshot, options, pool);
+			REQUIRE(result.sizes == std::vector<std::size_t>(groups, group_size));
+			for (std::size_t u = 0; u < snapshot.node_count(); ++u) {
+				REQUIRE(result.community[u] == u / group_size);
+			}
+			REQUIRE(result.modularity == Approx(gdwg::modularity(snapshot, result.community, 1.0, pool)));
+		}
+	}
+}
+
+TEST_CASE("Community detection edge cases", "[community]") {
+	SECTION("Graphs without edges keep every node alone") {
+		gdwg::graph<int, int> g{1, 2, 3};
+		auto const result = gdwg::detect_communities(g);
+		REQUIRE(result.sizes == std::vector<std::size_t>{1, 1, 1});
+		REQUIRE(result.modularity == 0.0);
+		REQUIRE(gdwg::detect_communities(gdwg::graph<int, int>{}).sizes.empty());
+	}
+
+	SECTION("Negative weights throw") {
+		gdwg::graph<int, int> g{1, 2};
+		g.insert_edge(1, 2, -1);
+		REQUIRE_THROWS_WITH(gdwg::detect_communities(g),
+		                    "Cannot call gdwg::detect_communities on a graph with negative edge weights");
+	}
+}
+
+TEST_CASE("Label propagation finds clear communities", "[community]") {
+	auto rng = std::mt19937(35);
+	auto coin = std::uniform_real_distribution<double>(0.0, 1.0);
+	constexpr auto groups = 5;
+	constexpr auto group_size = 30;
+	gdwg::graph<int, int> g;
+	for (auto v = 0; v < groups * group_size; ++v) {
+		g.insert_node(v);
+	}
+	for (auto u = 0; u < groups * group_size; ++u) {
+		for (auto v = u + 1; v < groups * group_size; ++v) {
+			auto const p = u / group_size == v / group_size ? 0.4 : 0.002;
+			if (coin(rng) < p) {
+				g.insert_edge(u, v);
+			}
+		}
+	}
+	auto const snapshot = gdwg::csr_graph<int, int>(g);
+
+	for (auto deterministic : {false, true}) {
+		auto options = gdwg::label_propagation_options{};
+		options.deterministic = deterministic;
+		options.threshold = 0.0;
+		auto pool = gdwg::thread_pool(4);
+		auto const result = gdwg::label_propagation(snapshot, options, pool);
+		REQUIRE(result.sizes == std::vector<std::size_t>(groups, group_size));
+		for (std::size_t u = 0; u < snapshot.node_count(); ++u) {
+			REQUIRE(result.community[u] == u / group_size);
+		}
+		REQUIRE(result.levels < options.max_rounds);
+		REQUIRE(result.modularity == Approx(gdwg::modularity(snapshot, result.community)));
+	}
+}
+
+TEST_CASE("Deterministic label propagation is reproducible", "[community]") {
+	auto const g = karate_club();
+	auto options = gdwg::label_propagation_options{};
+	options.deterministic = true;
+	auto one = gdwg::thread_pool(1);
+	auto four = gdwg::thread_pool(4);
+	auto const expected = gdwg::label_propagation(g, options, one);
+	for (auto run = 0; run < 5; ++run) {
+		auto const result = gdwg::label_propagation(g, options, run % 2 == 0 ? four : one);
+		REQUIRE(result.community == expected.community);
+		REQUIRE(result.levels == expected.levels);
+	}
+
+	// Two nodes joined by one edge settle instead of swapping labels forever
+	gdwg::graph<int, int> pair{1, 2};
+	pair.insert_edge(1, 2);
+	auto const settled = gdwg::label_propagation(pair, options, one);
+	REQUIRE(settled.sizes == std::vector<std::size_t>{2});
+	REQUIRE(settled.levels <= 2);
+}
+
+TEST_CASE("Label propagation stops early once few labels change", "[community]") {
+	// On a sparse random graph a few labels keep changing for many rounds
+	auto rng = std::mt19937(35);
+	gdwg::graph<int, int> g;
+	for (auto v = 0; v < 2000; ++v) {
+		g.insert_node(v);
+	}
+	for (auto e = 0; e < 6000; ++e) {
+		g.insert_edge(static_cast<int>(rng() % 2000), static_cast<int>(rng() % 2000));
+	}
+	auto pool = gdwg::thread_pool(1);
+	auto options = gdwg::label_propagation_options{};
+	options.deterministic = true;
+	options.threshold = 0.0;
+	options.max_rounds = 50;
+	auto const full = gdwg::label_propagation(g, options, pool);
+	options.threshold = 0.05;
+	auto const early = gdwg::label_propagation(g, options, pool);
+	REQUIRE(early.levels < full.levels);
+	REQUIRE(early.modularity > 0.25);
+	options.max_rounds = 1;
+	REQUIRE(gdwg::label_propagation(g, options, pool).levels == 1);
+}
+
+TEST_CASE("Label propagation with a threshold of 0 runs until no label changes", "[community]") {
+	auto const g = karate_club();
+	auto pool = gdwg::thread_pool(1);
+	auto options = gdwg::label_propagation_options{};
+	options.deterministic = true;
+	options.threshold = 0.0;
+	auto const full = gdwg::label_propagation(g, options, pool);
+	REQUIRE(full.levels > 1);
+	REQUIRE(full.levels < options.max_rounds);
+
+	// The last round changed nothing, so stopping one round earlier gives the same labels
+	options.max_rounds = full.levels - 1;
+	auto const cut = gdwg::label_propagation(g, options, pool);
+	REQUIRE(cut.levels == full.levels - 1);
+	REQUIRE(cut.community == full.community);
+}
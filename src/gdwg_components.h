@@ -0,0 +1,199 @@
+#ifndef GDWG_COMPONENTS_H
+#define GDWG_COMPONENTS_H
+
+#include "gdwg_csr.h"
+#include "gdwg_graph.h"
+#include "gdwg_parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// Lock-free union-find with union by rank and path halving
+	// Each element is a single atomic word holding its parent in the low bits and its rank in the top bits,
+	// so a root is only ever linked by a CAS that also checks its rank has not changed
+	class concurrent_union_find {
+	 public:
+		explicit concurrent_union_find(std::size_t size)
+		: size_(size)
+		, words_(std::make_unique<std::atomic<std::uint64_t>[]>(size)) {
+			if (size > parent_mask) {
+				throw std::length_error("Cannot construct gdwg::concurrent_union_find with more than 2^58 elements");
+			}
+			for (std::size_t i = 0; i < size; ++i) {
+				words_[i].store(i, std::memory_order_relaxed);
+			}
+		}
+
+		// Return the number of elements
+		[[nodiscard]] std::size_t size() const noexcept {
+			return size_;
+		}
+
+		// Return the representative of x's set, compressing the path on the way
+		[[nodiscard]] std::size_t find(std::size_t x) {
+			for (;;) {
+				auto word = words_[x].load(std::memory_order_acquire);
+				auto const parent = parent_of(word);
+				if (parent == x) {
+					return x;
+				}
+				auto const grandparent = parent_of(words_[parent].load(std::memory_order_acquire));
+				if (grandparent != parent) {
+					// Path halving: point x at its grandparent; losing the race is harmless
+					words_[x].compare_exchange_weak(word, pack(grandparent, rank_of(word)), std::memory_order_acq_rel);
+				}
+				x = grandparent;
+			}
+		}
+
+		// Return whether x and y are currently in the same set
+		[[nodiscard]] bool same(std::size_t x, std::size_t y) {
+			for (;;) {
+				x = find(x);
+				y = find(y);
+				if (x == y) {
+					return true;
+				}
+				// x may have been linked after it was found; only a root x gives a stable answer
+				if (parent_of(words_[x].load(std::memory_order_acquire)) == x) {
+					return false;
+				}
+			}
+		}
+
+		// Merge the sets of x and y, returning false if they were already merged
+		bool unite(std::size_t x, std::size_t y) {
+			for (;;) {
+				x = find(x);
+				y = find(y);
+				if (x == y) {
+					return false;
+				}
+				auto wx = words_[x].load(std::memory_order_acquire);
+				auto wy = words_[y].load(std::memory_order_acquire);
+				if (parent_of(wx) != x or parent_of(wy) != y) {
+					continue; // One of them was linked meanwhile
+				}
+				// Link the lower (rank, index) root under the higher one
+				if (rank_of(wx) > rank_of(wy) or (rank_of(wx) == rank_of(wy) and x > y)) {
+					std::swap(x, y);
+					std::swap(wx, wy);
+				}
+				if (!words_[x].compare_exchange_strong(wx, pack(y, rank_of(wx)), std::memory_order_acq_rel)) {
+					continue;
+				}
+				if (rank_of(wx) == rank_of(wy)) {
+					// Best effort: the rank is only a balancing hint
+					words_[y].compare_exchange_strong(wy, pack(y, rank_of(wy) + 1), std::memory_order_acq_rel);
+				}
+				return true;
+			}
+		}
+
+	 private:
+		static constexpr auto rank_shift = 58;
+		static constexpr auto parent_mask = (std::uint64_t{1} << rank_shift) - 1;
+
+		[[nodiscard]] static std::size_t parent_of(std::uint64_t word) noexcept {
+			return static_cast<std::size_t>(word & parent_mask);
+		}
+		[[nodiscard]] static std::uint64_t rank_of(std::uint64_t word) noexcept {
+			return word >> rank_shift;
+		}
+		[[nodiscard]] static std::uint64_t pack(std::size_t parent, std::uint64_t rank) noexcept {
+			return static_cast<std::uint64_t>(parent) | (rank << rank_shift);
+		}
+
+		std::size_t size_;
+		std::unique_ptr<std::atomic<std::uint64_t>[]> words_;
+	};
+
+	// Weakly connected components of a snapshot, by node index
+	struct component_labels {
+		std::vector<std::size_t> component; // Component id of every node; ids are 0..k-1 in order of first node
+		std::vector<std::size_t> sizes; // Number of nodes in each component
+		std::map<std::size_t, std::size_t> size_histogram; // Component size -> number of components of that size
+	};
+
+	// Weakly connected components of a graph, by node value
+	template<typename N>
+	struct components {
+		std::map<N, std::size_t> component; // Component id of every node; ids are 0..k-1 in order of smallest node
+		std::vector<std::size_t> sizes; // Number of nodes in each component
+		std::map<std::size_t, std::size_t> size_histogram; // Component size -> number of components of that size
+	};
+
+	// Compute the weakly connected components of g, treating every edge as undirected
+	// Edge chunks are united concurrently on the pool; the labelling pass is then parallel over nodes
+	template<typename N, typename E>
+	[[nodiscard]] component_labels weakly_connected_components(csr_graph<N, E> const& g,
+	                                                           thread_pool& pool = default_thread_pool()) {
+		auto const n = g.node_count();
+		auto sets = concurrent_union_find(n);
+		auto const& offsets = g.offsets();
+		auto const& targets = g.targets();
+
+		// Chunks are fixed-size ranges of edges, so hub nodes are split across workers
+		constexpr auto grain = std::size_t{1} << 14;
+		parallel_for(pool, 0, g.edge_count(), grain, [&](std::size_t lo, std::size_t hi, std::size_t) {
+			auto const first = std::upper_bound(offsets.begin(), offsets.end(), lo) - 1;
+			auto u = static_cast<std::size_t>(first - offsets.begin());
+			for (auto e = lo; e < hi; ++e) {
+				while (offsets[u + 1] <= e) {
+					++u;
+				}
+				sets.unite(u, targets[e]);
+			}
+		});
+
+		auto roots = std::vector<std::size_t>(n);
+		parallel_for(pool, 0, n, grain, [&](std::size_t lo, std::size_t hi, std::size_t) {
+			for (auto u = lo; u < hi; ++u) {
+				roots[u] = sets.find(u);
+			}
+		});
+
+		// Number the components in order of their first node so the ids are deterministic
+		auto result = component_labels{};
+		result.component.assign(n, 0);
+		auto id_of_root = std::vector<std::size_t>(n, n);
+		for (std::size_t u = 0; u < n; ++u) {
+			auto& id = id_of_root[roots[u]];
+			if (id == n) {
+				id = result.sizes.size();
+				result.sizes.push_back(0);
+			}
+			result.component[u] = id;
+			++result.sizes[id];
+		}
+		for (auto size : result.sizes) {
+			++result.size_histogram[size];
+		}
+		return result;
+	}
+
+	// Compute the weakly connected components of g, keyed by node value
+	template<typename N, typename E>
+	[[nodiscard]] components<N> weakly_connected_components(graph<N, E> const& g,
+	                                                        thread_pool& pool = default_thread_pool()) {
+		auto const snapshot = csr_graph<N, E>(g);
+		auto labels = weakly_connected_components(snapshot, pool);
+		auto result = components<N>{};
+		for (std::size_t u = 0; u < snapshot.node_count(); ++u) {
+			result.component.emplace_hint(result.component.end(), snapshot.node(u), labels.component[u]);
+		}
+		result.sizes = std::move(labels.sizes);
+		result.size_histogram = std::move(labels.size_histogram);
+		return result;
+	}
+} // namespace gdwg
+
+#endif // GDWG_COMPONENTS_H
@@ -0,0 +1,85 @@
+#include "gdwg_components.h"
+
+#include <catch2/catch.hpp>
+
+// Concurrent union-find tests
+TEST_CASE("Concurrent union-find", "[components]") {
+	auto sets = gdwg::concurrent_union_find(6);
+	REQUIRE(sets.unite(0, 1));
+	REQUIRE(sets.unite(2, 3));
+	REQUIRE(sets.unite(1, 3));
+	REQUIRE_FALSE(sets.unite(0, 2)); // Already in the same set
+	REQUIRE(sets.same(0, 3));
+	REQUIRE_FALSE(sets.same(0, 4));
+	REQUIRE(sets.find(4) == 4);
+}
+
+TEST_CASE("Concurrent union-find from many threads", "[components]") {
+	auto pool = gdwg::thread_pool(4);
+	auto const n = std::size_t{20000};
+	auto sets = gdwg::concurrent_union_find(n);
+	// Chain every even element and every odd element together, in interleaved order
+	gdwg::parallel_for(pool, 2, n, 97, [&](std::size_t lo, std::size_t hi, std::size_t) {
+		for (auto i = lo; i < hi; ++i) {
+			sets.unite(i, i - 2);
+		}
+	});
+	REQUIRE(sets.same(0, n - 2));
+	REQUIRE(sets.same(1, n - 1));
+	REQUIRE_FALSE(sets.same(0, 1));
+}
+
+// Weakly connected component tests
+TEST_CASE("Weakly connected components of a graph", "[components]") {
+	gdwg::graph<std::string, int> g;
+	for (auto const& node : {"a", "b", "c", "d", "e", "f", "g"}) {
+		g.insert_node(node);
+	}
+	g.insert_edge("b", "a", 1); // Edge direction does not matter
+	g.insert_edge("c", "b");
+	g.insert_edge("e", "d", 5);
+	g.insert_edge("d", "e", 5);
+	g.insert_edge("f", "f"); // Self loop
+
+	auto const result = gdwg::weakly_connected_components(g);
+
+	SECTION("Component ids are numbered in node order") {
+		REQUIRE(result.component.at("a") == 0);
+		REQUIRE(result.component.at("b") == 0);
+		REQUIRE(result.component.at("c") == 0);
+		REQUIRE(result.component.at("d") == 1);
+		REQUIRE(result.component.at("e") == 1);
+		REQUIRE(result.component.at("f") == 2);
+		REQUIRE(result.component.at("g") == 3);
+	}
+
+	SECTION("Sizes and histogram") {
+		REQUIRE(result.sizes == std::vector<std::size_t>{3, 2, 1, 1});
+		REQUIRE(result.size_histogram == std::map<std::size_t, std::size_t>{{1, 2}, {2, 1}, {3, 1}});
+	}
+}
+
+TEST_CASE("Weakly connected components on a larger graph in parallel", "[components]") {
+	// 50 disjoint rings of 200 nodes each, with edges pointing both ways around the ring
+	gdwg::graph<int, int> g;
+	auto const rings = 50;
+	auto const length = 200;
+	for (auto i = 0; i < rings * length; ++i) {
+		g.insert_node(i);
+	}
+	for (auto r = 0; r < rings; ++r) {
+		for (auto i = 0; i < length; ++i) {
+			auto const from = r * length + i;
+			auto const to = r * length + (i + 1) % length;
+			g.insert_edge(i % 2 == 0 ? from : to, i % 2 == 0 ? to : from, i);
+		}
+	}
+
+	auto pool = gdwg::thread_pool(4);
+	auto const labels = gdwg::weakly_connected_components(gdwg::csr_graph<int, int>(g), pool);
+	REQUIRE(labels.sizes.size() == rings);
+	REQUIRE(labels.size_histogram == std::map<std::size_t, std::size_t>{{length, rings}});
+	for (auto i = 0; i < rings * length; ++i) {
+		REQUIRE(labels.component[static_cast<std::size_t>(i)] == static_cast<std::size_t>(i / length));
+	}
+}
@@ -0,0 +1,184 @@
+#ifndef GDWG_CORES_H
+#define GDWG_CORES_H
+
+#include "gdwg_csr.h"
+#include "gdwg_graph.h"
+#include "gdwg_parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// k-core decomposition of a snapshot, by node index
+	// The snapshot is treated as a simple undirected graph (edge direction, parallel edges and self loops are
+	// ignored); the k-core is the largest subgraph in which every node has at least k neighbours
+	struct core_labels {
+		std::vector<std::size_t> core; // Core number of every node: the largest k whose k-core contains it
+		std::vector<std::size_t> order; // Degeneracy ordering: no node has more than degeneracy neighbours after it
+		std::size_t degeneracy = 0; // Largest core number
+	};
+
+	// k-core decomposition of a graph, by node value
+	template<typename N>
+	struct cores {
+		std::map<N, std::size_t> core; // Core number of every node
+		std::vector<N> order; // Degeneracy ordering
+		std::size_t degeneracy = 0; // Largest core number
+	};
+
+	// Compute the core numbers of a snapshot by bucket-based peeling (Batagelj-Zaversnik), in O(n + m)
+	// Nodes are kept sorted by remaining degree in one array with a start position per degree bucket, so
+	// removing a node moves each neighbour down one bucket with a single swap
+	template<typename N, typename E>
+	[[nodiscard]] core_labels k_core_decomposition(csr_graph<N, E> const& g,
+	                                               thread_pool& pool = default_thread_pool()) {
+		auto const n = g.node_count();
+		auto const undirected = detail::make_undirected(g, pool);
+		auto result = core_labels{};
+		auto& degree = result.core; // Remaining degree, which becomes the core number once a node is removed
+		degree.assign(n, 0);
+		auto max_degree = std::size_t{0};
+		for (std::size_t u = 0; u < n; ++u) {
+			degree[u] = undirected.offsets[u + 1] - undirected.offsets[u];
+			max_degree = std::max(max_degree, degree[u]);
+		}
+
+		// Counting sort of the nodes by degree; bucket[d] is where nodes of degree d start in order
+		auto bucket = std::vector<std::size_t>(max_degree + 2, 0);
+		for (auto d : degree) {
+			++bucket[d + 1];
+		}
+		for (std::size_t d = 0; d <= max_degree; ++d) {
+			bucket[d + 1] += bucket[d];
+		}
+		auto& order = result.order;
+		order.assign(n, 0);
+		auto position = std::vector<std::size_t>(n, 0);
+		auto fill = std::vector<std::size_t>(bucket.begin(), bucket.end() - 1);
+		for (std::size_t u = 0; u < n; ++u) {
+			position[u] = fill[degree[u]]++;
+			order[position[u]] = u;
+		}
+
+		for (std::size_t i = 0; i < n; ++i) {
+			auto const v = order[i];
+			result.degeneracy = std::max(result.degeneracy, degree[v]);
+			for (auto u : detail::undirected_neighbours(undirected, v)) {
+				if (degree[u] > degree[v]) {
+					// Swap u with the first node of its bucket, then shrink the bucket past it
+					auto const d = degree[u];
+					auto const w = order[bucket[d]];
+					std::swap(order[position[u]], order[bucket[d]]);
+					std::swap(position[u], position[w]);
+					++bucket[d];
+					--degree[u];
+				}
+			}
+		}
+		return result;
+	}
+
+	// Compute the core numbers of a snapshot by level-synchronous parallel peeling
+	// For k = 0, 1, ... every remaining node of degree at most k is peeled in rounds: the nodes of a round
+	// decrement their neighbours' degrees atomically, and the decrement that takes a neighbour from k + 1 to k
+	// puts it in the next round. Nodes of one round are in the degeneracy ordering in no particular order
+	template<typename N, typename E>
+	[[nodiscard]] core_labels parallel_k_core_decomposition(csr_graph<N, E> const& g,
+	                                                        thread_pool& pool = default_thread_pool()) {
+		auto const n = g.node_count();
+		auto const undirected = detail::make_undirected(g, pool);
+		constexpr auto grain = std::size_t{1} << 10;
+		auto degree = std::make_unique<std::atomic<std::size_t>[]>(n);
+		auto remaining = std::vector<std::size_t>(n);
+		parallel_for(pool, 0, n, grain, [&](std::size_t lo, std::size_t hi, std::size_t) {
+			for (auto u = lo; u < hi; ++u) {
+				degree[u].store(undirected.offsets[u + 1] - undirected.offsets[u], std::memory_order_relaxed);
+				remaining[u] = u;
+			}
+		});
+
+		auto result = core_labels{};
+		auto const none = n;
+		result.core.assign(n, none);
+		result.order.reserve(n);
+		auto buffers = std::vector<std::vector<std::size_t>>(pool.size());
+		auto frontier = std::vector<std::size_t>{};
+
+		// Move every worker's buffer onto the end of out
+		auto gather = [&buffers](std::vector<std::size_t>& out) {
+			out.clear();
+			for (auto& buffer : buffers) {
+				out.insert(out.end(), buffer.begin(), buffer.end());
+				buffer.clear();
+			}
+		};
+
+		auto k = std::size_t{0};
+		while (!remaining.empty()) {
+			// Skip straight to the smallest remaining degree
+			auto lowest = degree[remaining.front()].load(std::memory_order_relaxed);
+			for (auto u : remaining) {
+				lowest = std::min(lowest, degree[u].load(std::memory_order_relaxed));
+			}
+			k = std::max(k, lowest);
+
+			parallel_for(pool, 0, remaining.size(), grain, [&](std::size_t lo, std::size_t hi, std::size_t worker) {
+				for (auto i = lo; i < hi; ++i) {
+					auto const u = remaining[i];
+					if (degree[u].load(std::memory_order_relaxed) <= k) {
+						result.core[u] = k;
+						buffers[worker].push_back(u);
+					}
+				}
+			});
+			gather(frontier);
+
+			while (!frontier.empty()) {
+				result.order.insert(result.order.end(), frontier.begin(), frontier.end());
+				parallel_for(pool, 0, frontier.size(), 64, [&](std::size_t lo, std::size_t hi, std::size_t worker) {
+					for (auto i = lo; i < hi; ++i) {
+						for (auto u : detail::undirected_neighbours(undirected, frontier[i])) {
+							// Nodes already peeled are at or below k, so only live ones can cross k + 1 -> k
+							if (degree[u].fetch_sub(1, std::memory_order_relaxed) == k + 1) {
+								result.core[u] = k;
+								buffers[worker].push_back(u);
+							}
+						}
+					}
+				});
+				gather(frontier);
+			}
+
+			std::erase_if(remaining, [&](std::size_t u) { return result.core[u] != none; });
+			result.degeneracy = k;
+			++k;
+		}
+		return result;
+	}
+
+	// Compute the core number of every node of a graph and a degeneracy ordering, keyed by node value
+	// Uses the parallel peeling when the pool has more than one worker
+	template<typename N, typename E>
+	[[nodiscard]] cores<N> k_core_decomposition(graph<N, E> const& g, thread_pool& pool = default_thread_pool()) {
+		auto const snapshot = csr_graph<N, E>(g);
+		auto const labels = pool.size() > 1 ? parallel_k_core_decomposition(snapshot, pool)
+		                                    : k_core_decomposition(snapshot, pool);
+		auto result = cores<N>{};
+		for (std::size_t u = 0; u < snapshot.node_count(); ++u) {
+			result.core.emplace_hint(result.core.end(), snapshot.node(u), labels.core[u]);
+		}
+		result.order.reserve(labels.order.size());
+		for (auto u : labels.order) {
+			result.order.push_back(snapshot.node(u));
+		}
+		result.degeneracy = labels.degeneracy;
+		return result;
+	}
+} // namespace gdwg
+
+#endif // GDWG_CORES_H
@@ -0,0 +1,122 @@
+#include "gdwg_cores.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+
+namespace {
+	// Core numbers straight from the definition: repeatedly delete nodes with fewer than k neighbours
+	std::vector<std::size_t> reference_cores(std::vector<std::set<std::size_t>> const& adjacency) {
+		auto const n = adjacency.size();
+		auto core = std::vector<std::size_t>(n, 0);
+		for (std::size_t k = 1;; ++k) {
+			auto alive = std::vector<bool>(n, true);
+			auto changed = true;
+			while (changed) {
+				changed = false;
+				for (std::size_t u = 0; u < n; ++u) {
+					if (!alive[u]) {
+						continue;
+					}
+					auto const live = std::count_if(adjacency[u].begin(), adjacency[u].end(), [&](std::size_t v) {
+						return alive[v];
+					});
+					if (static_cast<std::size_t>(live) < k) {
+						alive[u] = false;
+						changed = true;
+					}
+				}
+			}
+			if (std::none_of(alive.begin(), alive.end(), [](bool b) { return b; })) {
+				return core;
+			}
+			for (std::size_t u = 0; u < n; ++u) {
+				if (alive[u]) {
+					core[u] = k;
+				}
+			}
+		}
+	}
+
+	// Every node has at most degeneracy neighbours later in the ordering
+	void check_ordering(gdwg::core_labels const& labels, std::vector<std::set<std::size_t>> const& adjacency) {
+		auto const n = adjacency.size();
+		REQUIRE(labels.order.size() == n);
+		auto rank = std::vector<std::size_t>(n, n);
+		for (std::size_t i = 0; i < n; ++i) {
+			rank[labels.order[i]] = i;
+		}
+		for (std::size_t u = 0; u < n; ++u) {
+			REQUIRE(rank[u] < n);
+			auto const later = std::count_if(adjacency[u].begin(), adjacency[u].end(), [&](std::size_t v) {
+				return rank[v] > rank[u];
+			});
+			CHECK(static_cast<std::size_t>(later) <= labels.degeneracy);
+		}
+	}
+} // namespace
+
+// k-core decomposition tests
+TEST_CASE("Core numbers of a small graph", "[cores]") {
+	// A 4-clique {1, 2, 3, 4} with a triangle {4, 5, 6} and a tail 6 -> 7, plus an isolated node
+	gdwg::graph<int, int> g{1, 2, 3, 4, 5, 6, 7, 8};
+	auto const edges = std::vector<std::pair<int, int>>{
+	   {1, 2}, {1, 3}, {1, 4}, {2, 3}, {2, 4}, {3, 4}, {4, 5}, {5, 6}, {6, 4}, {6, 7}};
+	for (auto [u, v] : edges) {
+		g.insert_edge(u, v);
+	}
+	// Direction, reciprocal and parallel edges and loops make no difference
+	g.insert_edge(2, 1);
+	g.insert_edge(2, 1, 5);
+	g.insert_edge(7, 7);
+
+	auto const expected = std::map<int, std::size_t>{{1, 3}, {2, 3}, {3, 3}, {4, 3}, {5, 2}, {6, 2}, {7, 1}, {8, 0}};
+	for (auto threads : {std::size_t{1}, std::size_t{4}}) {
+		auto pool = gdwg::thread_pool(threads);
+		auto const result = gdwg::k_core_decomposition(g, pool);
+		REQUIRE(result.core == expected);
+		REQUIRE(result.degeneracy == 3);
+		REQUIRE(result.order.size() == 8);
+		REQUIRE(std::set<int>(result.order.begin(), result.order.end()).size() == 8);
+	}
+
+	REQUIRE(gdwg::k_core_decomposition(gdwg::graph<int, int>{}).degeneracy == 0);
+}
+
+TEST_CASE("Sequential and parallel peeling agree with the definition on random graphs", "[cores]") {
+	auto rng = std::mt19937(33);
+	auto pool = gdwg::thread_pool(4);
+	for (auto trial = 0; trial < 20; ++trial) {
+		auto const n = 1 + static_cast<int>(rng() % 60);
+		auto const edges = static_cast<int>(rng() % static_cast<unsigned>(n * 6));
+		gdwg::graph<int, int> g;
+		for (auto v = 0; v < n; ++v) {
+			g.insert_node(v);
+		}
+		auto adjacency = std::vector<std::set<std::size_t>>(static_cast<std::size_t>(n));
+		for (auto e = 0; e < edges; ++e) {
+			auto const u = static_cast<int>(rng() % static_cast<unsigned>(n));
+			auto const v = static_cast<int>(rng() % static_cast<unsigned>(n));
+			g.insert_edge(u, v, e);
+			if (u != v) {
+				adjacency[static_cast<std::size_t>(u)].insert(static_cast<std::size_t>(v));
+				adjacency[static_cast<std::size_t>(v)].insert(static_cast<std::size_t>(u));
+			}
+		}
+		auto const expected = reference_cores(adjacency);
+		auto const snapshot = gdwg::csr_graph<int, int>(g);
+
+		auto const sequential = gdwg::k_core_decomposition(snapshot, pool);
+		REQUIRE(sequential.core == expected);
+		REQUIRE(sequential.degeneracy == *std::max_element(expected.begin(), expected.end()));
+		check_ordering(sequential, adjacency);
+
+		auto const parallel = gdwg::parallel_k_core_decomposition(snapshot, pool);
+		REQUIRE(parallel.core == expected);
+		REQUIRE(parallel.degeneracy == sequential.degeneracy);
+		check_ordering(parallel, adjacency);
+	}
+}
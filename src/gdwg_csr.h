@@ -0,0 +1,326 @@
+#ifndef GDWG_CSR_H
+#define GDWG_CSR_H
+
+#include "gdwg_graph.h"
+#include "gdwg_parallel.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// Compact snapshot of a graph in compressed sparse row (CSR) form
+	// Nodes are numbered 0..n-1 in ascending order unless the snapshot was built with a node order (see
+	// gdwg_reorder.h), and the edges leaving node u are stored in [offset(u), offset(u + 1)) of the target and
+	// weight arrays, sorted by target index
+	template<typename N, typename E>
+	class csr_graph {
+	 public:
+		using size_type = std::size_t;
+
+		// Default constructor, builds an empty snapshot
+		csr_graph() noexcept
+		: nodes_{}
+		, offsets_{0}
+		, targets_{}
+		, weights_{}
+		, by_value_{} {}
+
+		// Build a snapshot of g
+		explicit csr_graph(graph<N, E> const& g)
+		: nodes_(g.nodes_.begin(), g.nodes_.end())
+		, offsets_{}
+		, targets_{}
+		, weights_{}
+		, by_value_{} {
+			offsets_.reserve(nodes_.size() + 1);
+			offsets_.push_back(0);
+			for (auto const& node : nodes_) {
+				auto it = g.adj_list_.find(node);
+				if (it != g.adj_list_.end()) {
+					auto const first = targets_.size();
+					for (auto const& [dst, weight] : it->second) {
+						// Skip edges whose dst is no longer a node of the graph
+						if (auto idx = index_of(dst)) {
+							targets_.push_back(*idx);
+							weights_.push_back(weight);
+						}
+					}
+					sort_row(first);
+				}
+				offsets_.push_back(targets_.size());
+			}
+		}
+
+		// Build a snapshot of g with its nodes laid out in the given order: order[i] is the ascending rank of the
+		// node placed at index i, so order must be a permutation of 0..n-1
+		csr_graph(graph<N, E> const& g, std::span<size_type const> order)
+		: nodes_{}
+		, offsets_{}
+		, targets_{}
+		, weights_{}
+		, by_value_(rank_of(order, g.nodes_.size())) {
+			auto const ascending = std::vector<N>(g.nodes_.begin(), g.nodes_.end());
+			nodes_.reserve(ascending.size());
+			for (auto rank : order) {
+				nodes_.push_back(ascending[rank]);
+			}
+			offsets_.reserve(nodes_.size() + 1);
+			offsets_.push_back(0);
+			for (auto const& node : nodes_) {
+				auto it = g.adj_list_.find(node);
+				if (it != g.adj_list_.end()) {
+					auto const first = targets_.size();
+					for (auto const& [dst, weight] : it->second) {
+						auto const rank = std::lower_bound(ascending.begin(), ascending.end(), dst);
+						if (rank != ascending.end() and !(dst < *rank)) {
+							targets_.push_back(by_value_[static_cast<size_type>(rank - ascending.begin())]);
+							weights_.push_back(weight);
+						}
+					}
+					sort_row(first);
+				}
+				offsets_.push_back(targets_.size());
+			}
+		}
+
+		// Build a snapshot directly from its arrays; offsets must have nodes.size() + 1 entries
+		csr_graph(std::vector<N> nodes,
+		          std::vector<size_type> offsets,
+		          std::vector<size_type> targets,
+		          std::vector<std::optional<E>> weights)
+		: nodes_(std::move(nodes))
+		, offsets_(std::move(offsets))
+		, targets_(std::move(targets))
+		, weights_(std::move(weights))
+		, by_value_{} {
+			if (!std::is_sorted(nodes_.begin(), nodes_.end())) {
+				by_value_.assign(nodes_.size(), 0);
+				for (size_type u = 0; u < nodes_.size(); ++u) {
+					by_value_[u] = u;
+				}
+				std::sort(by_value_.begin(), by_value_.end(), [this](size_type a, size_type b) {
+					return nodes_[a] < nodes_[b];
+				});
+			}
+		}
+
+		// Return a copy of this snapshot with node i of the copy being node order[i] of this one; order must be
+		// a permutation of 0..n-1. Rows of the copy are sorted by their new target indices
+		[[nodiscard]] csr_graph permuted(std::span<size_type const> order) const {
+			auto const n = node_count();
+			auto const position = rank_of(order, n); // New index of every old index
+			auto result = csr_graph{};
+			result.nodes_.reserve(n);
+			result.offsets_.reserve(n + 1);
+			result.targets_.reserve(edge_count());
+			result.weights_.reserve(edge_count());
+			for (auto u : order) {
+				result.nodes_.push_back(nodes_[u]);
+				auto const first = result.targets_.size();
+				for (auto e = offsets_[u]; e < offsets_[u + 1]; ++e) {
+					result.targets_.push_back(position[targets_[e]]);
+					result.weights_.push_back(weights_[e]);
+				}
+				result.sort_row(first);
+				result.offsets_.push_back(result.targets_.size());
+			}
+			if (by_value_.empty()) {
+				result.by_value_ = position;
+			}
+			else {
+				result.by_value_.assign(n, 0);
+				for (size_type k = 0; k < n; ++k) {
+					result.by_value_[k] = position[by_value_[k]];
+				}
+			}
+			return result;
+		}
+
+		// Return the number of nodes
+		[[nodiscard]] size_type node_count() const noexcept {
+			return nodes_.size();
+		}
+
+		// Return the number of edges
+		[[nodiscard]] size_type edge_count() const noexcept {
+			return targets_.size();
+		}
+
+		// Return the node value stored at index u
+		[[nodiscard]] N const& node(size_type u) const {
+			return nodes_[u];
+		}
+
+		// Return all node values, indexed by node index
+		[[nodiscard]] std::vector<N> const& nodes() const noexcept {
+			return nodes_;
+		}
+
+		// Return the index of a node value, or std::nullopt if it is not in the snapshot
+		[[nodiscard]] std::optional<size_type> index_of(N const& value) const {
+			if (!by_value_.empty()) {
+				auto it = std::partition_point(by_value_.begin(), by_value_.end(), [&](size_type u) {
+					return nodes_[u] < value;
+				});
+				if (it == by_value_.end() or value < nodes_[*it]) {
+					return std::nullopt;
+				}
+				return *it;
+			}
+			auto it = std::lower_bound(nodes_.begin(), nodes_.end(), value);
+			if (it == nodes_.end() or value < *it) {
+				return std::nullopt;
+			}
+			return static_cast<size_type>(it - nodes_.begin());
+		}
+
+		// Return the position of the first edge of node u (offset(node_count()) == edge_count())
+		[[nodiscard]] size_type offset(size_type u) const {
+			return offsets_[u];
+		}
+
+		// Return the number of edges leaving node u, counting parallel edges
+		[[nodiscard]] size_type degree(size_type u) const {
+			return offsets_[u + 1] - offsets_[u];
+		}
+
+		// Return the target indices of the edges leaving node u (sorted ascending)
+		[[nodiscard]] std::span<size_type const> neighbours(size_type u) const {
+			return {targets_.data() + offsets_[u], degree(u)};
+		}
+
+		// Return the weights of the edges leaving node u, aligned with neighbours(u)
+		[[nodiscard]] std::span<std::optional<E> const> weights(size_type u) const {
+			return {weights_.data() + offsets_[u], degree(u)};
+		}
+
+		// Raw arrays, for algorithms that walk the whole structure
+		[[nodiscard]] std::vector<size_type> const& offsets() const noexcept {
+			return offsets_;
+		}
+		[[nodiscard]] std::vector<size_type> const& targets() const noexcept {
+			return targets_;
+		}
+		[[nodiscard]] std::vector<std::optional<E>> const& edge_weights() const noexcept {
+			return weights_;
+		}
+
+	 private:
+		// Invert a node order, checking that it is a permutation of 0..n-1
+		static std::vector<size_type> rank_of(std::span<size_type const> order, size_type n) {
+			auto position = std::vector<size_type>(n, n);
+			if (order.size() != n) {
+				throw std::runtime_error("Cannot build a gdwg::csr_graph from a node order that is not a permutation");
+			}
+			for (size_type i = 0; i < n; ++i) {
+				if (order[i] >= n or position[order[i]] != n) {
+					throw std::runtime_error("Cannot build a gdwg::csr_graph from a node order that is not a "
+					                         "permutation");
+				}
+				position[order[i]] = i;
+			}
+			return position;
+		}
+
+		// Restore (target, weight) order for the row starting at first if the graph left it unsorted
+		void sort_row(size_type first) {
+			auto const last = targets_.size();
+			auto less = [this](size_type a, size_type b) {
+				return targets_[a] != targets_[b] ? targets_[a] < targets_[b] : weights_[a] < weights_[b];
+			};
+			auto sorted = true;
+			for (auto i = first + 1; i < last and sorted; ++i) {
+				sorted = !less(i, i - 1);
+			}
+			if (sorted) {
+				return;
+			}
+			auto row = std::vector<std::pair<size_type, std::optional<E>>>{};
+			for (auto i = first; i < last; ++i) {
+				row.emplace_back(targets_[i], std::move(weights_[i]));
+			}
+			std::sort(row.begin(), row.end());
+			for (auto i = first; i < last; ++i) {
+				targets_[i] = row[i - first].first;
+				weights_[i] = std::move(row[i - first].second);
+			}
+		}
+
+		std::vector<N> nodes_; // Node values, indexed by node index
+		std::vector<size_type> offsets_; // Start of each node's edges, plus one past the end
+		std::vector<size_type> targets_; // Target node index of every edge
+		std::vector<std::optional<E>> weights_; // Weight of every edge (std::nullopt if unweighted)
+		std::vector<size_type> by_value_; // Node indices in ascending node order; empty when that is 0..n-1
+	};
+
+	namespace detail {
+		// Simple undirected view of a snapshot: every edge is listed from both of its ends, without self loops
+		// or parallel edges
+		struct undirected_graph {
+			std::vector<std::size_t> offsets;
+			std::vector<std::size_t> targets; // Sorted by index within each node
+		};
+
+		template<typename N, typename E>
+		undirected_graph make_undirected(csr_graph<N, E> const& g, thread_pool& pool) {
+			auto const n = g.node_count();
+			auto offsets = std::vector<std::size_t>(n + 1, 0);
+			for (std::size_t u = 0; u < n; ++u) {
+				for (auto v : g.neighbours(u)) {
+					if (u != v) {
+						++offsets[u + 1];
+						++offsets[v + 1];
+					}
+				}
+			}
+			for (std::size_t u = 0; u < n; ++u) {
+				offsets[u + 1] += offsets[u];
+			}
+			auto both = std::vector<std::size_t>(offsets.back());
+			auto fill = std::vector<std::size_t>(offsets.begin(), offsets.end() - 1);
+			for (std::size_t u = 0; u < n; ++u) {
+				for (auto v : g.neighbours(u)) {
+					if (u != v) {
+						both[fill[u]++] = v;
+						both[fill[v]++] = u;
+					}
+				}
+			}
+
+			// Sort and deduplicate every list in parallel, then compact the lists
+			auto result = undirected_graph{};
+			result.offsets.assign(n + 1, 0);
+			parallel_for(pool, 0, n, 256, [&](std::size_t lo, std::size_t hi, std::size_t) {
+				for (auto u = lo; u < hi; ++u) {
+					auto const first = both.begin() + static_cast<std::ptrdiff_t>(offsets[u]);
+					auto const last = both.begin() + static_cast<std::ptrdiff_t>(offsets[u + 1]);
+					std::sort(first, last);
+					result.offsets[u + 1] = static_cast<std::size_t>(std::unique(first, last) - first);
+				}
+			});
+			for (std::size_t u = 0; u < n; ++u) {
+				result.offsets[u + 1] += result.offsets[u];
+			}
+			result.targets.assign(result.offsets.back(), 0);
+			parallel_for(pool, 0, n, 256, [&](std::size_t lo, std::size_t hi, std::size_t) {
+				for (auto u = lo; u < hi; ++u) {
+					std::copy_n(both.begin() + static_cast<std::ptrdiff_t>(offsets[u]),
+					            result.offsets[u + 1] - result.offsets[u],
+					            result.targets.begin() + static_cast<std::ptrdiff_t>(result.offsets[u]));
+				}
+			});
+			return result;
+		}
+
+		inline std::span<std::size_t const> undirected_neighbours(undirected_graph const& g, std::size_t u) {
+			return {g.targets.data() + g.offsets[u], g.offsets[u + 1] - g.offsets[u]};
+		}
+	} // namespace detail
+} // namespace gdwg
+
+#endif // GDWG_CSR_H
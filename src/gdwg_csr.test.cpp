@@ -0,0 +1,57 @@
+#include "gdwg_csr.h"
+
+#include <catch2/catch.hpp>
+
+// CSR snapshot tests
+TEST_CASE("CSR snapshot of a graph", "[csr]") {
+	gdwg::graph<std::string, int> g;
+	for (auto const& node : {"a", "b", "c", "d"}) {
+		g.insert_node(node);
+	}
+	g.insert_edge("c", "a", 3);
+	g.insert_edge("a", "c");
+	g.insert_edge("a", "b", 7);
+	g.insert_edge("a", "b", 2);
+
+	auto const csr = gdwg::csr_graph<std::string, int>(g);
+
+	SECTION("Nodes are indexed in ascending order") {
+		REQUIRE(csr.node_count() == 4);
+		REQUIRE(csr.node(0) == "a");
+		REQUIRE(csr.node(3) == "d");
+		REQUIRE(csr.index_of("c") == 2);
+		REQUIRE_FALSE(csr.index_of("e").has_value());
+	}
+
+	SECTION("Edges keep the graph's order") {
+		REQUIRE(csr.edge_count() == 4);
+		REQUIRE(csr.degree(0) == 3);
+		auto const targets = csr.neighbours(0);
+		auto const weights = csr.weights(0);
+		REQUIRE(std::vector<std::size_t>(targets.begin(), targets.end()) == std::vector<std::size_t>{1, 1, 2});
+		REQUIRE(weights[0] == 2);
+		REQUIRE(weights[1] == 7);
+		REQUIRE_FALSE(weights[2].has_value());
+		REQUIRE(csr.degree(1) == 0);
+		REQUIRE(csr.degree(3) == 0);
+		REQUIRE(csr.offset(4) == csr.edge_count());
+	}
+
+	SECTION("Unsorted edge lists are sorted in the snapshot") {
+		g.insert_node("e");
+		g.insert_edge("e", "d");
+		g.insert_edge("e", "b");
+		g.merge_replace_node("c", "e"); // Appends c's edges to e's list without sorting
+		auto const merged = gdwg::csr_graph<std::string, int>(g);
+		auto const e = merged.index_of("e").value();
+		auto const targets = merged.neighbours(e);
+		REQUIRE(std::is_sorted(targets.begin(), targets.end()));
+	}
+}
+
+TEST_CASE("Empty CSR snapshot", "[csr]") {
+	auto const csr = gdwg::csr_graph<int, int>(gdwg::graph<int, int>{});
+	REQUIRE(csr.node_count() == 0);
+	REQUIRE(csr.edge_count() == 0);
+	REQUIRE(csr.offsets() == std::vector<std::size_t>{0});
+}
@@ -0,0 +1,112 @@
+#include "gdwg_bench.h"
+#include "gdwg_edge_list.h"
+
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+#include <unistd.h>
+
+namespace {
+	// Write random "src dst [weight]" lines until the file holds at least the given number of bytes
+	std::size_t write_edge_list(std::string const& path, std::size_t bytes, std::size_t nodes, std::uint64_t seed) {
+		auto rng = std::mt19937_64(seed);
+		auto out = std::ofstream(path, std::ios::binary | std::ios::trunc);
+		auto buffer = std::string{};
+		auto line = std::array<char, 64>{};
+		auto written = std::size_t{0};
+		auto edges = std::size_t{0};
+		while (written < bytes) {
+			auto* end = std::to_chars(line.data(), line.data() + line.size(), rng() % nodes).ptr;
+			*end++ = ' ';
+			end = std::to_chars(end, line.data() + line.size(), rng() % nodes).ptr;
+			if (rng() % 4 != 0) {
+				*end++ = ' ';
+				end = std::to_chars(end, line.data() + line.size(), static_cast<double>(rng() % 10000) / 100).ptr;
+			}
+			*end++ = '\n';
+			buffer.append(line.data(), end);
+			++edges;
+			if (buffer.size() >= (1 << 20)) {
+				out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+				written += buffer.size();
+				buffer.clear();
+			}
+		}
+		out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		return edges;
+	}
+} // namespace
+
+// Edge-list loading throughput
+// Usage: gdwg_edge_list_bench [megabytes] [nodes] [threads]
+auto main(int argc, char** argv) -> int {
+	auto const megabytes = gdwg::bench::argument(argc, argv, 1, 256);
+	auto const nodes = gdwg::bench::argument(argc, argv, 2, 1 << 20);
+	auto pool = gdwg::thread_pool(gdwg::bench::argument(argc, argv, 3, 0));
+	auto const path = "/tmp/gdwg_edge_list_bench_" + std::to_string(::getpid()) + ".txt";
+
+	auto const edges = write_edge_list(path, megabytes << 20, nodes, 6771);
+	auto const bytes = static_cast<double>(std::ifstream(path, std::ios::binary | std::ios::ate).tellg());
+	auto const parameters = std::vector<gdwg::bench::parameter>{{"bytes", bytes},
+	                                                            {"edges", static_cast<double>(edges)},
+	                                                            {"nodes", static_cast<double>(nodes)},
+	                                                            {"threads", static_cast<double>(pool.size())}};
+
+	// Parsing alone, then sorting into the graph
+	auto builder = gdwg::graph_builder<std::size_t, double>{};
+	auto seconds = gdwg::bench::best_of(1, [&] { gdwg::read_edge_list(path, builder, {}, pool); });
+	gdwg::bench::report(std::cout,
+	                    "edge_list_parse",
+	                    parameters,
+	                    seconds,
+	                    {{"gigabytes_per_second", bytes / seconds / 1e9}});
+	auto g = gdwg::graph<std::size_t, double>{};
+	seconds = gdwg::bench::best_of(1, [&] { g = builder.build(pool); });
+	gdwg::bench::report(std::cout,
+	                    "edge_list_build",
+	                    parameters,
+	                    seconds,
+	                    {{"graph_nodes", static_cast<double>(g.node_count())}});
+	g = {};
+
+	seconds = gdwg::bench::best_of(1, [&] { g = gdwg::read_edge_list<std::size_t, double>(path, {}, pool); });
+	gdwg::bench::report(std::cout,
+	                    "read_edge_list",
+	                    parameters,
+	                    seconds,
+	                    {{"gigabytes_per_second", bytes / seconds / 1e9}});
+	g = {};
+
+	// The single-threaded operator>> and insert_edge loop it replaces, on the first 1/32 of the file
+	auto const prefix = bytes / 32;
+	auto baseline = gdwg::graph<std::size_t, double>{};
+	seconds = gdwg::bench::best_of(1, [&] {
+		auto in = std::ifstream(path);
+		auto text = std::string{};
+		while (static_cast<double>(in.tellg()) < prefix and std::getline(in, text)) {
+			auto line = std::istringstream(text);
+			auto src = std::size_t{0};
+			auto dst = std::size_t{0};
+			auto weight = 0.0;
+			line >> src >> dst;
+			baseline.insert_node(src);
+			baseline.insert_node(dst);
+			if (line >> weight) {
+				baseline.insert_edge(src, dst, weight);
+			}
+			else {
+				baseline.insert_edge(src, dst);
+			}
+		}
+	});
+	gdwg::bench::report(std::cout,
+	                    "iostream_insert_edge",
+	                    {{"bytes", prefix}, {"threads", 1}},
+	                    seconds,
+	                    {{"gigabytes_per_second", prefix / seconds / 1e9}});
+	std::remove(path.c_str());
+}
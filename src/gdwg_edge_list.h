@@ -0,0 +1,280 @@
+#ifndef GDWG_EDGE_LIST_H
+#define GDWG_EDGE_LIST_H
+
+#include "gdwg_builder.h"
+#include "gdwg_graph.h"
+#include "gdwg_mapped_file.h"
+#include "gdwg_parallel.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+// Parallel text edge-list loading
+// Every line is one of
+//   src dst [weight]              a plain edge list, separated by spaces or tabs
+//   node                          a node without edges
+//   src -> dst | U                an edge as printed by operator<<
+//   src -> dst | W | weight
+//   node (  and  )                the node headers and closing brackets printed by operator<<
+// Blank lines and lines starting with # or % are skipped. Numbers are parsed with std::from_chars; char values
+// are single characters and std::string values are single tokens without whitespace.
+// The output of operator<< reads back as the same graph when its nodes and weights are integral, char, or
+// strings without whitespace. Floating point values read back only as printed: nodes to 6 significant digits
+// and weights to 6 decimal places, as std::to_string writes them
+namespace gdwg {
+	struct edge_list_options {
+		std::size_t chunk_size = std::size_t{1} << 22; // Bytes of text parsed by one task
+	};
+
+	namespace detail {
+		// Parse one whole token into value, returning false if it is not a valid value of type T
+		template<typename T>
+		bool parse_token(std::string_view token, T& value) {
+			if constexpr (std::is_same_v<T, std::string>) {
+				value.assign(token);
+				return true;
+			}
+			else if constexpr (std::is_same_v<T, char>) {
+				value = token.front();
+				return token.size() == 1;
+			}
+			else {
+				static_assert(std::is_arithmetic_v<T>, "gdwg edge lists hold arithmetic, char or std::string values");
+				auto const [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+				return error == std::errc{} and end == token.data() + token.size();
+			}
+		}
+
+		// Spaces, tabs, carriage returns and other control characters separate tokens
+		inline bool is_blank(char c) {
+			return static_cast<unsigned char>(c) <= ' ';
+		}
+
+		template<typename T>
+		inline constexpr bool is_number = std::is_arithmetic_v<T> and !std::is_same_v<T, char>;
+
+		// Parse a number that starts at p and is followed by a blank or the end, moving p past the blanks after it
+		template<typename T>
+		bool parse_number(char const*& p, char const* end, T& value) {
+			auto const [next, error] = std::from_chars(p, end, value);
+			if (error != std::errc{} or (next != end and !is_blank(*next))) {
+				return false;
+			}
+			for (p = next; p != end and is_blank(*p); ++p) {
+			}
+			return true;
+		}
+
+		// Parse a plain numeric "src dst [weight]" line, which make up nearly all of a large input, without
+		// splitting it into tokens first; returns false for anything else
+		template<typename N, typename E, typename Builder>
+		bool parse_plain_line(std::string_view line, Builder& builder) {
+			auto const* p = line.data();
+			auto const* const end = line.data() + line.size();
+			for (; p != end and is_blank(*p); ++p) {
+			}
+			auto src = N{};
+			auto dst = N{};
+			if (!parse_number(p, end, src) or !parse_number(p, end, dst)) {
+				return false;
+			}
+			if (p == end) {
+				builder.insert_edge(src, dst);
+				return true;
+			}
+			auto weight = E{};
+			if (!parse_number(p, end, weight) or p != end) {
+				return false;
+			}
+			builder.insert_edge(src, dst, weight);
+			return true;
+		}
+
+		// Parse one line into the builder (a graph_builder or anything with the same insert_node and insert_edge),
+		// returning false if it is malformed
+		template<typename N, typename E, typename Builder>
+		bool parse_edge_line(std::string_view line, Builder& builder) {
+			if constexpr (is_number<N> and is_number<E>) {
+				if (parse_plain_line<N, E>(line, builder)) {
+					return true;
+				}
+			}
+			auto tokens = std::array<std::string_view, 8>{};
+			auto count = std::size_t{0};
+			for (auto const *p = line.data(), *end = line.data() + line.size(); p != end;) {
+				if (is_blank(*p)) {
+					++p;
+					continue;
+				}
+				auto const* const start = p;
+				while (p != end and !is_blank(*p)) {
+					++p;
+				}
+				if (count == tokens.size()) {
+					return false;
+				}
+				tokens[count++] = std::string_view(start, static_cast<std::size_t>(p - start));
+			}
+			if (count == 0 or tokens[0].front() == '#' or tokens[0].front() == '%'
+			    or (count == 1 and tokens[0] == ")")) {
+				return true;
+			}
+
+			auto src = N{};
+			if (!parse_token(tokens[0], src)) {
+				return false;
+			}
+			if (count == 1 or (count == 2 and tokens[1] == "(")) {
+				builder.insert_node(std::move(src));
+				return true;
+			}
+			auto const printed = tokens[1] == "->";
+			auto dst = N{};
+			if (!parse_token(tokens[printed ? 2 : 1], dst)) {
+				return false;
+			}
+			if (!printed and count == 2) {
+				builder.insert_edge(std::move(src), std::move(dst));
+				return true;
+			}
+			if (printed and count == 5 and tokens[3] == "|" and tokens[4] == "U") {
+				builder.insert_edge(std::move(src), std::move(dst));
+				return true;
+			}
+			// A printed empty string weight leaves nothing after "W |"
+			auto const weight_token = !printed ? 2 : 6;
+			if (printed and (count < 6 or tokens[3] != "|" or tokens[4] != "W" or tokens[5] != "|")) {
+				return false;
+			}
+			auto weight = E{};
+			if (count == static_cast<std::size_t>(weight_token) + 1) {
+				if (!parse_token(tokens[static_cast<std::size_t>(weight_token)], weight)) {
+					return false;
+				}
+			}
+			else if (!(std::is_same_v<E, std::string> and printed and count == 6)) {
+				return false;
+			}
+			builder.insert_edge(std::move(src), std::move(dst), std::move(weight));
+			return true;
+		}
+
+		// Return the position of the first line break in text[first, last), or last if there is none
+		inline std::size_t find_newline(std::string_view text, std::size_t first, std::size_t last) {
+			auto const* newline = static_cast<char const*>(std::memchr(text.data() + first, '\n', last - first));
+			return newline == nullptr ? last : static_cast<std::size_t>(newline - text.data());
+		}
+
+		// Parse text from offset first in parallel chunks that end at line breaks, calling parse_line(line, part)
+		// for every line with the part that collects its chunk, and throwing on the first line it rejects. Line
+		// numbers in the error count from the start of text
+		template<typename Part, typename ParseLine>
+		std::vector<Part> parse_lines(std::string_view text,
+		                              std::size_t first,
+		                              edge_list_options const& options,
+		                              thread_pool& pool,
+		                              std::string const& caller,
+		                              ParseLine parse_line) {
+			auto bounds = std::vector<std::size_t>{std::min(first, text.size())};
+			while (bounds.back() < text.size()) {
+				auto end = std::min(text.size(), bounds.back() + std::max<std::size_t>(1, options.chunk_size));
+				if (end < text.size()) {
+					end = std::min(text.size(), find_newline(text, end, text.size()) + 1);
+				}
+				bounds.push_back(end);
+			}
+
+			auto const chunks = bounds.size() - 1;
+			auto parts = std::vector<Part>(chunks);
+			auto errors = std::vector<std::optional<std::size_t>>(chunks); // Offset of the first malformed line
+			pool.run(chunks, [&](std::size_t chunk, std::size_t) {
+				auto const last = bounds[chunk + 1];
+				for (auto line = bounds[chunk]; line < last;) {
+					auto const end = find_newline(text, line, last);
+					if (!parse_line(text.substr(line, end - line), parts[chunk])) {
+						errors[chunk] = line;
+						return;
+					}
+					line = end + 1;
+				}
+			});
+
+			auto const error = std::find_if(errors.begin(), errors.end(), [](auto const& e) { return e.has_value(); });
+			if (error != errors.end()) {
+				auto const offset = **error;
+				auto const line = std::count(text.begin(), text.begin() + static_cast<std::ptrdiff_t>(offset), '\n');
+				auto const content = text.substr(offset, find_newline(text, offset, text.size()) - offset);
+				throw std::runtime_error("Cannot call gdwg::" + caller + ": malformed line " + std::to_string(line + 1)
+				                         + ": " + std::string(content));
+			}
+			return parts;
+		}
+
+		// Parse an edge list in parallel chunks into builder
+		template<typename N, typename E>
+		void parse_edge_text(std::string_view text,
+		                     graph_builder<N, E>& builder,
+		                     edge_list_options const& options,
+		                     thread_pool& pool,
+		                     std::string const& caller) {
+			auto parts = parse_lines<graph_builder<N, E>>(
+			   text, 0, options, pool, caller, [](std::string_view line, graph_builder<N, E>& part) {
+				   return parse_edge_line<N, E>(line, part);
+			   });
+			builder.merge(parts, pool);
+		}
+	} // namespace detail
+
+	// Parse an edge list held in memory, adding its nodes and edges to builder
+	template<typename N, typename E>
+	void parse_edge_list(std::string_view text,
+	                     graph_builder<N, E>& builder,
+	                     edge_list_options const& options = {},
+	                     thread_pool& pool = default_thread_pool()) {
+		detail::parse_edge_text(text, builder, options, pool, "parse_edge_list");
+	}
+
+	// Parse an edge list held in memory into a graph
+	template<typename N, typename E>
+	graph<N, E> parse_edge_list(std::string_view text,
+	                            edge_list_options const& options = {},
+	                            thread_pool& pool = default_thread_pool()) {
+		auto builder = graph_builder<N, E>{};
+		parse_edge_list(text, builder, options, pool);
+		return builder.build(pool);
+	}
+
+	// Read an edge-list file, adding its nodes and edges to builder
+	// The file is memory-mapped, so it is never copied into one string
+	template<typename N, typename E>
+	void read_edge_list(std::string const& path,
+	                    graph_builder<N, E>& builder,
+	                    edge_list_options const& options = {},
+	                    thread_pool& pool = default_thread_pool()) {
+		auto const file = detail::mapped_file(path);
+		auto const text = std::string_view(reinterpret_cast<char const*>(file.data()), file.size());
+		detail::parse_edge_text(text, builder, options, pool, "read_edge_list");
+	}
+
+	// Read an edge-list file into a graph
+	template<typename N, typename E>
+	graph<N, E> read_edge_list(std::string const& path,
+	                           edge_list_options const& options = {},
+	                           thread_pool& pool = default_thread_pool()) {
+		auto builder = graph_builder<N, E>{};
+		read_edge_list(path, builder, options, pool);
+		return builder.build(pool);
+	}
+} // namespace gdwg
+
+#endif // GDWG_EDGE_LIST_H
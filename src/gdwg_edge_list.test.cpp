@@ -0,0 +1,177 @@
+#include "gdwg_edge_list.h"
+#include "gdwg_testing.h"
+
+#include <catch2/catch.hpp>
+
+#include <fstream>
+#include <random>
+
+namespace {
+	using gdwg::testing::print;
+	using gdwg::testing::scratch_directory;
+} // namespace
+
+// Edge-list parser tests
+TEST_CASE("Printed graphs read back as the same graph", "[edge_list]") {
+	auto g = gdwg::graph<int, int>{};
+	for (auto v : {1, 2, 3, 4, 5, 6, 64}) {
+		g.insert_node(v);
+	}
+	g.insert_edge(4, 1, -4);
+	g.insert_edge(3, 2, 2);
+	g.insert_edge(2, 4);
+	g.insert_edge(2, 4, 2);
+	g.insert_edge(6, 3, 10);
+	g.insert_edge(5, 2);
+	g.insert_edge(4, 1);
+	g.insert_edge(1, 5, -1);
+
+	auto const text = print(g);
+	auto const parsed = gdwg::parse_edge_list<int, int>(text);
+	REQUIRE(print(parsed) == text);
+	REQUIRE(parsed.is_node(64));
+	REQUIRE(parsed.connections(64).empty());
+	REQUIRE(parsed.edges(2, 4).size() == 2);
+
+	// Chunks of a few bytes split the text between every couple of lines
+	auto pool = gdwg::thread_pool(4);
+	auto options = gdwg::edge_list_options{};
+	options.chunk_size = 8;
+	REQUIRE(print(gdwg::parse_edge_list<int, int>(text, options, pool)) == text);
+}
+
+TEST_CASE("Printed floating point values read back rounded", "[edge_list]") {
+	auto g = gdwg::graph<double, double>{};
+	g.insert_node(1.23456789);
+	g.insert_node(2.0);
+	g.insert_edge(1.23456789, 2.0, 0.1234567);
+
+	auto const text = print(g);
+	REQUIRE(text == "\n1.23457 (\n  1.23457 -> 2 | W | 0.123457\n)\n2 (\n)\n");
+	auto parsed = gdwg::parse_edge_list<double, double>(text);
+	REQUIRE(print(parsed) == text);
+	REQUIRE(parsed != g);
+	REQUIRE(parsed.nodes() == std::vector<double>{1.23457, 2.0});
+	REQUIRE(parsed.edges(1.23457, 2.0).front()->get_weight() == 0.123457);
+}
+
+TEST_CASE("Plain edge lists follow the insert_edge duplicate rules", "[edge_list]") {
+	auto const text = std::string("# comment\n"
+	                              "% another comment\n"
+	                              "1 2 0.5\n"
+	                              "1\t2\t0.5\r\n"
+	                              "1 2 1.5\n"
+	                              "1 2\n"
+	                              "1 2\n"
+	                              "\n"
+	                              "   3 1   \n"
+	                              "7\n"
+	                              "2 -> 3 | W | 1e3\n"
+	                              "9 9 -2");
+	auto g = gdwg::parse_edge_list<int, double>(text);
+	REQUIRE(g.nodes() == std::vector<int>{1, 2, 3, 7, 9});
+	auto const edges = g.edges(1, 2);
+	REQUIRE(edges.size() == 3);
+	REQUIRE(edges[0]->print_edge() == "1 -> 2 | U");
+	REQUIRE(edges[1]->get_weight() == 0.5);
+	REQUIRE(edges[2]->get_weight() == 1.5);
+	REQUIRE(g.connections(3) == std::vector<int>{1});
+	REQUIRE(g.edges(2, 3)[0]->get_weight() == 1000.0);
+	REQUIRE(g.edges(9, 9)[0]->get_weight() == -2.0);
+	REQUIRE(g.connections(7).empty());
+}
+
+TEST_CASE("Parallel parsing matches inserting every edge", "[edge_list]") {
+	auto rng = std::mt19937(42);
+	auto reference = gdwg::graph<long, double>{};
+	auto text = std::string{};
+	for (auto e = 0; e < 20000; ++e) {
+		auto const u = static_cast<long>(rng() % 500) - 100;
+		auto const v = static_cast<long>(rng() % 500) - 100;
+		reference.insert_node(u);
+		reference.insert_node(v);
+		text += std::to_string(u) + ' ' + std::to_string(v);
+		if (rng() % 3 == 0) {
+			reference.insert_edge(u, v);
+		}
+		else {
+			auto const w = static_cast<double>(rng() % 8) / 4;
+			reference.insert_edge(u, v, w);
+			text += ' ' + std::to_string(w);
+		}
+		text += '\n';
+	}
+	auto pool = gdwg::thread_pool(4);
+	auto options = gdwg::edge_list_options{};
+	options.chunk_size = 1000;
+	REQUIRE(print(gdwg::parse_edge_list<long, double>(text, options, pool)) == print(reference));
+}
+
+TEST_CASE("Files, strings and characters", "[edge_list]") {
+	SECTION("Files are read through a mapping") {
+		auto const directory = scratch_directory("edges");
+		auto const path = directory.file("edges.txt");
+		{
+			auto out = std::ofstream(path);
+			out << "apple banana ripe\nbanana cherry\ncherry apple -\n";
+		}
+		auto const g = gdwg::read_edge_list<std::string, std::string>(path);
+		REQUIRE(g.connections("apple") == std::vector<std::string>{"banana"});
+		REQUIRE(g.edges("apple", "banana")[0]->print_edge() == "apple -> banana | W | ripe");
+		REQUIRE(g.edges("cherry", "apple")[0]->get_weight() == "-");
+		REQUIRE_THROWS(gdwg::read_edge_list<int, int>("/tmp/gdwg_test_missing_edges.txt"));
+	}
+
+	SECTION("Printed string graphs, including empty weights") {
+		auto const text = std::string("a (\n  a -> b | W | \n  a -> b | U\n)\nb (\n)\n");
+		auto const g = gdwg::parse_edge_list<std::string, std::string>(text);
+		auto const edges = g.edges("a", "b");
+		REQUIRE(edges.size() == 2);
+		REQUIRE(edges[0]->print_edge() == "a -> b | U");
+		REQUIRE(edges[1]->get_weight() == "");
+	}
+
+	SECTION("Characters") {
+		auto g = gdwg::graph<char, int>{};
+		for (auto c : {'a', 'b', 'c', 'd'}) {
+			g.insert_node(c);
+		}
+		g.insert_edge('a', 'b', 3);
+		g.insert_edge('c', 'a');
+		auto const text = print(g);
+		REQUIRE(print(gdwg::parse_edge_list<char, int>(text)) == text);
+	}
+}
+
+TEST_CASE("Edge-list edge cases", "[edge_list]") {
+	SECTION("Empty input") {
+		REQUIRE(gdwg::parse_edge_list<int, int>("").empty());
+		REQUIRE(gdwg::parse_edge_list<int, int>("\n\n# nothing\n").empty());
+	}
+
+	SECTION("Malformed lines are reported with their line number") {
+		auto const text = std::string("1 2\n3 4 5\n6 x\n7 8\n");
+		auto options = gdwg::edge_list_options{};
+		options.chunk_size = 3;
+		REQUIRE_THROWS_WITH((gdwg::parse_edge_list<int, int>(text, options)),
+		                    "Cannot call gdwg::parse_edge_list: malformed line 3: 6 x");
+		REQUIRE_THROWS_WITH((gdwg::parse_edge_list<int, int>("1 2 3 4")),
+		                    "Cannot call gdwg::parse_edge_list: malformed line 1: 1 2 3 4");
+		REQUIRE_THROWS((gdwg::parse_edge_list<int, int>("1 -> 2 | X")));
+		REQUIRE_THROWS((gdwg::parse_edge_list<int, int>("1 -> 2 | W |")));
+		REQUIRE_THROWS((gdwg::parse_edge_list<int, int>("1 2 3.5")));
+		REQUIRE_THROWS((gdwg::parse_edge_list<char, int>("ab c")));
+	}
+
+	SECTION("Builders collect from several sources before one build") {
+		auto builder = gdwg::graph_builder<int, int>{};
+		builder.insert_node(10);
+		gdwg::parse_edge_list("1 2 3\n", builder);
+		gdwg::parse_edge_list("1 2 3\n2 1\n", builder);
+		REQUIRE(builder.edge_count() == 3);
+		auto g = builder.build();
+		REQUIRE(g.nodes() == std::vector<int>{1, 2, 10});
+		REQUIRE(g.edges(1, 2).size() == 1);
+		REQUIRE(builder.edge_count() == 0);
+	}
+}
@@ -0,0 +1,51 @@
+#include "gdwg_bench.h"
+#include "gdwg_builder.h"
+#include "gdwg_export.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+#include <unistd.h>
+
+// Export throughput to a file, against operator<<
+// Usage: gdwg_export_bench [edges] [nodes] [directory]
+auto main(int argc, char** argv) -> int {
+	auto const edges = gdwg::bench::argument(argc, argv, 1, 1 << 22);
+	auto const nodes = gdwg::bench::argument(argc, argv, 2, 1 << 18);
+	auto const path = (argc > 3 ? std::string(argv[3]) : std::string("/tmp")) + "/gdwg_export_bench_"
+	                  + std::to_string(::getpid());
+
+	auto builder = gdwg::graph_builder<int, double>{};
+	auto rng = std::mt19937_64(6771);
+	builder.reserve(edges);
+	for (std::size_t e = 0; e < edges; ++e) {
+		auto const src = static_cast<int>(rng() % nodes);
+		auto const dst = static_cast<int>(rng() % nodes);
+		if (rng() % 4 == 0) {
+			builder.insert_edge(src, dst);
+		}
+		else {
+			builder.insert_edge(src, dst, static_cast<double>(rng() % 10000) / 100);
+		}
+	}
+	auto const g = builder.build();
+
+	auto report = [&](std::string const& name, auto&& save) {
+		auto const seconds = gdwg::bench::best_of(3, [&] { save(path); });
+		auto const bytes = static_cast<double>(std::filesystem::file_size(path));
+		gdwg::bench::report(std::cout,
+		                    name,
+		                    {{"edges", static_cast<double>(edges)}, {"nodes", static_cast<double>(nodes)}},
+		                    seconds,
+		                    {{"bytes", bytes}, {"megabytes_per_second", bytes / seconds / 1e6}});
+	};
+
+	report("operator_output", [&g](std::string const& file) { std::ofstream(file, std::ios::binary) << g; });
+	report("save_dot", [&g](std::string const& file) { gdwg::save_dot(g, file); });
+	report("save_graphml", [&g](std::string const& file) { gdwg::save_graphml(g, file); });
+	report("save_jsonl", [&g](std::string const& file) { gdwg::save_jsonl(g, file); });
+	std::remove(path.c_str());
+}
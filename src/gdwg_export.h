@@ -0,0 +1,457 @@
+#ifndef GDWG_EXPORT_H
+#define GDWG_EXPORT_H
+
+#include "gdwg_graph.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Streaming exporters for Graphviz DOT, GraphML and JSON Lines
+// The exporters walk the graph's sorted adjacency lists in place, without collecting or re-sorting the edges,
+// and format into one reusable buffer with std::to_chars that is handed to the stream in large blocks. Nodes
+// come first in ascending order, then the edges grouped by source, as operator<< orders them. Numbers are
+// written in their shortest round-trip form; char and std::string values are quoted and escaped as each format
+// requires
+namespace gdwg {
+	struct export_options {
+		std::string name = "G"; // The DOT graph name and the GraphML graph id
+		std::size_t block_size = std::size_t{1} << 20; // Bytes buffered between writes to the stream
+	};
+
+	namespace detail {
+		enum class text_format { plain, dot, xml, json };
+
+		// A block buffer in front of a stream; every value is formatted straight into the buffer
+		class text_writer {
+		 public:
+			text_writer(std::ostream& os, std::size_t block_size, std::string caller)
+			: os_(os)
+			, buffer_(std::max<std::size_t>(block_size, 2 * reserve))
+			, caller_(std::move(caller)) {}
+
+			text_writer(text_writer const&) = delete;
+			text_writer& operator=(text_writer const&) = delete;
+
+			void put(char c) {
+				if (size_ == buffer_.size()) {
+					flush();
+				}
+				buffer_[size_++] = c;
+			}
+
+			void put(std::string_view text) {
+				if (text.size() > buffer_.size() - size_) {
+					flush();
+					if (text.size() > buffer_.size()) {
+						write(text.data(), text.size());
+						return;
+					}
+				}
+				std::copy(text.begin(), text.end(), buffer_.begin() + static_cast<std::ptrdiff_t>(size_));
+				size_ += text.size();
+			}
+
+			// Append text with the characters that are special in the format escaped
+			void put_escaped(std::string_view text, text_format format) {
+				auto first = std::size_t{0};
+				for (std::size_t i = 0; i < text.size(); ++i) {
+					auto const replacement = escape(text[i], format);
+					if (!replacement.empty()) {
+						put(text.substr(first, i - first));
+						put(replacement);
+						first = i + 1;
+					}
+					else if (format == text_format::json and static_cast<unsigned char>(text[i]) < ' ') {
+						static constexpr auto hex = std::string_view("0123456789abcdef");
+						put(text.substr(first, i - first));
+						put("\\u00");
+						put(hex[static_cast<unsigned char>(text[i]) >> 4]);
+						put(hex[static_cast<unsigned char>(text[i]) & 15]);
+						first = i + 1;
+					}
+				}
+				put(text.substr(first));
+			}
+
+			// Append a value as unquoted text: numbers in their shortest form, strings and chars escaped
+			template<typename T>
+			void put_value(T const& value, text_format format) {
+				if constexpr (std::is_same_v<T, std::string>) {
+					put_escaped(value, format);
+				}
+				else if constexpr (std::is_same_v<T, char>) {
+					put_escaped(std::string_view(&value, 1), format);
+				}
+				else if constexpr (std::is_same_v<T, bool>) {
+					put(value ? std::string_view("true") : std::string_view("false"));
+				}
+				else {
+					static_assert(std::is_arithmetic_v<T>, "gdwg exporters write arithmetic, char or string values");
+					if constexpr (std::is_floating_point_v<T>) {
+						// JSON has no infinities or NaN
+						if (format == text_format::json and !std::isfinite(value)) {
+							put("null");
+							return;
+						}
+					}
+					if (buffer_.size() - size_ < reserve) {
+						flush();
+					}
+					auto* const first = buffer_.data() + size_;
+					auto const [end, error] = std::to_chars(first, buffer_.data() + buffer_.size(), value);
+					static_cast<void>(error); // reserve is enough for any number
+					size_ += static_cast<std::size_t>(end - first);
+				}
+			}
+
+			// Hand the buffered text to the stream, throwing if the stream fails
+			void flush() {
+				write(buffer_.data(), size_);
+				size_ = 0;
+			}
+
+		 private:
+			static constexpr auto reserve = std::size_t{64}; // Room for the longest number to_chars writes
+
+			static std::string_view escape(char c, text_format format) {
+				switch (format) {
+				case text_format::plain: return "";
+				case text_format::dot:
+					return c == '"' ? "\\\"" : c == '\\' ? "\\\\" : c == '\n' ? "\\n" : "";
+				case text_format::xml:
+					switch (c) {
+					case '&': return "&amp;";
+					case '<': return "&lt;";
+					case '>': return "&gt;";
+					case '"': return "&quot;";
+					case '\'': return "&apos;";
+					default: return "";
+					}
+				case text_format::json:
+					switch (c) {
+					case '"': return "\\\"";
+					case '\\': return "\\\\";
+					case '\n': return "\\n";
+					case '\r': return "\\r";
+					case '\t': return "\\t";
+					default: return "";
+					}
+				}
+				return "";
+			}
+
+			void write(char const* data, std::size_t size) {
+				auto const count = static_cast<std::streamsize>(size);
+				if (size != 0 and os_.rdbuf()->sputn(data, count) != count) {
+					os_.setstate(std::ios::badbit);
+					throw std::runtime_error("Cannot call gdwg::" + caller_ + ": writing to the stream failed");
+				}
+			}
+
+			std::ostream& os_;
+			std::vector<char> buffer_;
+			std::size_t size_ = 0;
+			std::string caller_;
+		};
+
+		// The GraphML attr.type of a weight type
+		template<typename E>
+		constexpr std::string_view graphml_type() {
+			if constexpr (std::is_same_v<E, bool>) {
+				return "boolean";
+			}
+			else if constexpr (std::is_integral_v<E> and !std::is_same_v<E, char>) {
+				return sizeof(E) <= 4 ? "int" : "long";
+			}
+			else if constexpr (std::is_floating_point_v<E>) {
+				return std::is_same_v<E, float> ? "float" : "double";
+			}
+			else {
+				return "string";
+			}
+		}
+	} // namespace detail
+
+	// Writes a graph in a text interchange format
+	template<typename N, typename E>
+	class graph_exporter {
+	 public:
+		explicit graph_exporter(graph<N, E> const& g)
+		: g_(g) {
+			index_nodes();
+		}
+
+		// digraph "G" {
+		//   1;
+		//   1 -> 2 [label="0.5"];
+		//   1 -> 3;
+		// }
+		// Integer nodes are bare IDs; other nodes are quoted. Unweighted edges have no label
+		void write_dot(std::ostream& os, export_options const& options = {}) const {
+			using detail::text_format;
+			auto out = detail::text_writer(os, options.block_size, "write_dot");
+			auto const put_node = [&out](N const& node) {
+				if constexpr (std::is_integral_v<N> and !std::is_same_v<N, char> and !std::is_same_v<N, bool>) {
+					out.put_value(node, text_format::dot);
+				}
+				else {
+					out.put('"');
+					out.put_value(node, text_format::dot);
+					out.put('"');
+				}
+			};
+			out.put("digraph \"");
+			out.put_escaped(options.name, text_format::dot);
+			out.put("\" {\n");
+			for (auto const& node : g_.nodes_) {
+				out.put("  ");
+				put_node(node);
+				out.put(";\n");
+			}
+			for_each_edge([&](N const& src, N const& dst, std::optional<E> const& weight) {
+				out.put("  ");
+				put_node(src);
+				out.put(" -> ");
+				put_node(dst);
+				if (weight) {
+					out.put(" [label=\"");
+					out.put_value(*weight, text_format::dot);
+					out.put("\"]");
+				}
+				out.put(";\n");
+			});
+			out.put("}\n");
+			out.flush();
+		}
+
+		// A directed GraphML graph whose node ids are the node values; weighted edges carry a "weight" data
+		// element typed after E, and unweighted edges have none
+		void write_graphml(std::ostream& os, export_options const& options = {}) const {
+			using detail::text_format;
+			auto out = detail::text_writer(os, options.block_size, "write_graphml");
+			out.put("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+			        "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+			        "  <key id=\"weight\" for=\"edge\" attr.name=\"weight\" attr.type=\"");
+			out.put(detail::graphml_type<E>());
+			out.put("\"/>\n  <graph id=\"");
+			out.put_escaped(options.name, text_format::xml);
+			out.put("\" edgedefault=\"directed\">\n");
+			for (auto const& node : g_.nodes_) {
+				out.put("    <node id=\"");
+				out.put_value(node, text_format::xml);
+				out.put("\"/>\n");
+			}
+			for_each_edge([&out](N const& src, N const& dst, std::optional<E> const& weight) {
+				out.put("    <edge source=\"");
+				out.put_value(src, text_format::xml);
+				out.put("\" target=\"");
+				out.put_value(dst, text_format::xml);
+				if (weight) {
+					out.put("\"><data key=\"weight\">");
+					out.put_value(*weight, text_format::xml);
+					out.put("</data></edge>\n");
+				}
+				else {
+					out.put("\"/>\n");
+				}
+			});
+			out.put("  </graph>\n</graphml>\n");
+			out.flush();
+		}
+
+		// One JSON object per line: {"node":1} for every node, then {"from":1,"to":2,"weight":0.5} for every edge,
+		// leaving out "weight" for unweighted edges
+		void write_jsonl(std::ostream& os, export_options const& options = {}) const {
+			using detail::text_format;
+			auto out = detail::text_writer(os, options.block_size, "write_jsonl");
+			auto const put_json = [&out](auto const& value) {
+				using T = std::decay_t<decltype(value)>;
+				if constexpr (std::is_same_v<T, std::string> or std::is_same_v<T, char>) {
+					out.put('"');
+					out.put_value(value, text_format::json);
+					out.put('"');
+				}
+				else {
+					out.put_value(value, text_format::json);
+				}
+			};
+			for (auto const& node : g_.nodes_) {
+				out.put("{\"node\":");
+				put_json(node);
+				out.put("}\n");
+			}
+			for_each_edge([&](N const& src, N const& dst, std::optional<E> const& weight) {
+				out.put("{\"from\":");
+				put_json(src);
+				out.put(",\"to\":");
+				put_json(dst);
+				if (weight) {
+					out.put(",\"weight\":");
+					put_json(*weight);
+				}
+				out.put("}\n");
+			});
+			out.flush();
+		}
+
+	 private:
+		// Call fn(src, dst, weight) for every edge in operator<< order. Lists are kept sorted by insert_edge, so they
+		// are walked in place; only a list left unsorted by merge_replace_node is sorted first, in a copy. Lists of
+		// old values and edges to them, which replace_node and merge_replace_node leave behind, are skipped
+		template<typename F>
+		void for_each_edge(F&& fn) const {
+			auto const less = [](auto const& lhs, auto const& rhs) {
+				return lhs.first < rhs.first or (!(rhs.first < lhs.first) and lhs.second < rhs.second);
+			};
+			auto unsorted = std::vector<std::pair<N, std::optional<E>>>{};
+			auto node = g_.nodes_.begin();
+			for (auto const& [src, edges] : g_.adj_list_) {
+				for (; node != g_.nodes_.end() and *node < src; ++node) {
+				}
+				if (node == g_.nodes_.end() or src < *node) {
+					continue;
+				}
+				auto const* row = &edges;
+				if (!std::is_sorted(edges.begin(), edges.end(), less)) {
+					unsorted.assign(edges.begin(), edges.end());
+					std::sort(unsorted.begin(), unsorted.end(), less);
+					row = &unsorted;
+				}
+				// Edges to the same node are adjacent, so each target is looked up once
+				auto const* last = static_cast<N const*>(nullptr);
+				auto exists = false;
+				for (auto const& [dst, weight] : *row) {
+					if (last == nullptr or *last < dst or dst < *last) {
+						exists = is_node(dst);
+						last = &dst;
+					}
+					if (exists) {
+						fn(src, dst, weight);
+					}
+				}
+			}
+		}
+
+		// Integer nodes spread over a range no more than 64 times their count are looked up in a bitmap, and other
+		// numbers in a sorted copy; both take far fewer cache misses than the tree
+		bool is_node(N const& value) const {
+			if constexpr (std::is_integral_v<N>) {
+				if (!bitmap_.empty()) {
+					if (value < low_ or high_ < value) {
+						return false;
+					}
+					auto const i = static_cast<std::uint64_t>(value) - static_cast<std::uint64_t>(low_);
+					return ((bitmap_[i / 64] >> (i % 64)) & 1U) != 0;
+				}
+			}
+			if constexpr (std::is_arithmetic_v<N>) {
+				return std::binary_search(sorted_.begin(), sorted_.end(), value);
+			}
+			else {
+				return g_.nodes_.find(value) != g_.nodes_.end();
+			}
+		}
+
+		void index_nodes() {
+			if constexpr (std::is_integral_v<N>) {
+				if (!g_.nodes_.empty()) {
+					low_ = *g_.nodes_.begin();
+					high_ = *g_.nodes_.rbegin();
+					auto const span = static_cast<std::uint64_t>(high_) - static_cast<std::uint64_t>(low_);
+					if (span / 64 < g_.nodes_.size()) {
+						bitmap_.assign(span / 64 + 1, 0);
+						for (auto const& node : g_.nodes_) {
+							auto const i = static_cast<std::uint64_t>(node) - static_cast<std::uint64_t>(low_);
+							bitmap_[i / 64] |= std::uint64_t{1} << (i % 64);
+						}
+						return;
+					}
+				}
+			}
+			if constexpr (std::is_arithmetic_v<N>) {
+				sorted_.assign(g_.nodes_.begin(), g_.nodes_.end());
+			}
+		}
+
+		graph<N, E> const& g_;
+		std::vector<N> sorted_;
+		std::vector<std::uint64_t> bitmap_;
+		N low_ = {};
+		N high_ = {};
+	};
+
+	// Write g to os as Graphviz DOT
+	template<typename N, typename E>
+	void write_dot(graph<N, E> const& g, std::ostream& os, export_options const& options = {}) {
+		graph_exporter<N, E>(g).write_dot(os, options);
+	}
+
+	// Write g to os as GraphML
+	template<typename N, typename E>
+	void write_graphml(graph<N, E> const& g, std::ostream& os, export_options const& options = {}) {
+		graph_exporter<N, E>(g).write_graphml(os, options);
+	}
+
+	// Write g to os as JSON Lines
+	template<typename N, typename E>
+	void write_jsonl(graph<N, E> const& g, std::ostream& os, export_options const& options = {}) {
+		graph_exporter<N, E>(g).write_jsonl(os, options);
+	}
+
+	namespace detail {
+		// Open path for one of the exporters, which write through the file's own buffer
+		inline std::ofstream open_export(std::string const& path, std::string const& caller) {
+			auto out = std::ofstream(path, std::ios::binary | std::ios::trunc);
+			if (!out) {
+				throw std::runtime_error("Cannot call gdwg::" + caller + ": cannot open " + path);
+			}
+			return out;
+		}
+
+		// Flush and close a file written by one of the exporters
+		inline void close_export(std::ofstream& out, std::string const& path, std::string const& caller) {
+			out.close();
+			if (!out) {
+				throw std::runtime_error("Cannot call gdwg::" + caller + ": writing " + path + " failed");
+			}
+		}
+	} // namespace detail
+
+	// Save g as a Graphviz DOT file
+	template<typename N, typename E>
+	void save_dot(graph<N, E> const& g, std::string const& path, export_options const& options = {}) {
+		auto out = detail::open_export(path, "save_dot");
+		write_dot(g, out, options);
+		detail::close_export(out, path, "save_dot");
+	}
+
+	// Save g as a GraphML file
+	template<typename N, typename E>
+	void save_graphml(graph<N, E> const& g, std::string const& path, export_options const& options = {}) {
+		auto out = detail::open_export(path, "save_graphml");
+		write_graphml(g, out, options);
+		detail::close_export(out, path, "save_graphml");
+	}
+
+	// Save g as a JSON Lines file
+	template<typename N, typename E>
+	void save_jsonl(graph<N, E> const& g, std::string const& path, export_options const& options = {}) {
+		auto out = detail::open_export(path, "save_jsonl");
+		write_jsonl(g, out, options);
+		detail::close_export(out, path, "save_jsonl");
+	}
+} // namespace gdwg
+
+#endif // GDWG_EXPORT_H
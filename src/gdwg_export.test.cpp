@@ -0,0 +1,205 @@
+#include "gdwg_export.h"
+
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <sstream>
+
+#include <unistd.h>
+
+namespace {
+	template<typename N, typename E>
+	std::string dot(gdwg::graph<N, E> const& g, gdwg::export_options const& options = {}) {
+		auto out = std::ostringstream{};
+		gdwg::write_dot(g, out, options);
+		return out.str();
+	}
+
+	template<typename N, typename E>
+	std::string graphml(gdwg::graph<N, E> const& g, gdwg::export_options const& options = {}) {
+		auto out = std::ostringstream{};
+		gdwg::write_graphml(g, out, options);
+		return out.str();
+	}
+
+	template<typename N, typename E>
+	std::string jsonl(gdwg::graph<N, E> const& g, gdwg::export_options const& options = {}) {
+		auto out = std::ostringstream{};
+		gdwg::write_jsonl(g, out, options);
+		return out.str();
+	}
+
+	gdwg::graph<int, double> small_graph() {
+		auto g = gdwg::graph<int, double>{3, -1, 2, 10};
+		g.insert_edge(3, 2, 0.5);
+		g.insert_edge(3, 2);
+		g.insert_edge(-1, 10, 1e300);
+		g.insert_edge(3, -1, -2);
+		g.insert_edge(3, 2, 0.25);
+		return g;
+	}
+} // namespace
+
+// Exporter tests
+TEST_CASE("Graphviz DOT output", "[export]") {
+	REQUIRE(dot(small_graph())
+	        == "digraph \"G\" {\n"
+	           "  -1;\n"
+	           "  2;\n"
+	           "  3;\n"
+	           "  10;\n"
+	           "  -1 -> 10 [label=\"1e+300\"];\n"
+	           "  3 -> -1 [label=\"-2\"];\n"
+	           "  3 -> 2;\n"
+	           "  3 -> 2 [label=\"0.25\"];\n"
+	           "  3 -> 2 [label=\"0.5\"];\n"
+	           "}\n");
+
+	auto g = gdwg::graph<std::string, char>{"a \"b\"", "c\\d"};
+	g.insert_edge("a \"b\"", "c\\d", '"');
+	REQUIRE(dot(g, {.name = "my\ngraph"})
+	        == "digraph \"my\\ngraph\" {\n"
+	           "  \"a \\\"b\\\"\";\n"
+	           "  \"c\\\\d\";\n"
+	           "  \"a \\\"b\\\"\" -> \"c\\\\d\" [label=\"\\\"\"];\n"
+	           "}\n");
+	REQUIRE(dot(gdwg::graph<double, int>{}) == "digraph \"G\" {\n}\n");
+}
+
+TEST_CASE("GraphML output", "[export]") {
+	auto g = gdwg::graph<std::string, std::string>{"<a>", "b&c"};
+	g.insert_edge("<a>", "b&c", "'x'");
+	g.insert_edge("b&c", "b&c");
+	REQUIRE(graphml(g)
+	        == "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+	           "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+	           "  <key id=\"weight\" for=\"edge\" attr.name=\"weight\" attr.type=\"string\"/>\n"
+	           "  <graph id=\"G\" edgedefault=\"directed\">\n"
+	           "    <node id=\"&lt;a&gt;\"/>\n"
+	           "    <node id=\"b&amp;c\"/>\n"
+	           "    <edge source=\"&lt;a&gt;\" target=\"b&amp;c\"><data key=\"weight\">&apos;x&apos;</data></edge>\n"
+	           "    <edge source=\"b&amp;c\" target=\"b&amp;c\"/>\n"
+	           "  </graph>\n"
+	           "</graphml>\n");
+
+	auto const numbers = graphml(small_graph(), {.name = "\"g\""});
+	REQUIRE(numbers.find("attr.type=\"double\"") != std::string::npos);
+	REQUIRE(numbers.find("<graph id=\"&quot;g&quot;\"") != std::string::npos);
+	REQUIRE(numbers.find("<edge source=\"3\" target=\"-1\"><data key=\"weight\">-2</data></edge>\n")
+	        != std::string::npos);
+	REQUIRE(graphml(gdwg::graph<int, long>{}).find("attr.type=\"long\"") != std::string::npos);
+	REQUIRE(graphml(gdwg::graph<int, int>{}).find("attr.type=\"int\"") != std::string::npos);
+}
+
+TEST_CASE("JSON Lines output", "[export]") {
+	REQUIRE(jsonl(small_graph())
+	        == "{\"node\":-1}\n"
+	           "{\"node\":2}\n"
+	           "{\"node\":3}\n"
+	           "{\"node\":10}\n"
+	           "{\"from\":-1,\"to\":10,\"weight\":1e+300}\n"
+	           "{\"from\":3,\"to\":-1,\"weight\":-2}\n"
+	           "{\"from\":3,\"to\":2}\n"
+	           "{\"from\":3,\"to\":2,\"weight\":0.25}\n"
+	           "{\"from\":3,\"to\":2,\"weight\":0.5}\n");
+
+	auto g = gdwg::graph<std::string, double>{"tab\tquote\"", std::string("nul\0\x1f", 5)};
+	g.insert_edge("tab\tquote\"", std::string("nul\0\x1f", 5), std::numeric_limits<double>::infinity());
+	REQUIRE(jsonl(g)
+	        == "{\"node\":\"nul\\u0000\\u001f\"}\n"
+	           "{\"node\":\"tab\\tquote\\\"\"}\n"
+	           "{\"from\":\"tab\\tquote\\\"\",\"to\":\"nul\\u0000\\u001f\",\"weight\":null}\n");
+}
+
+TEST_CASE("Exporters walk the edges in operator<< order, across many small blocks", "[export]") {
+	auto g = gdwg::graph<int, int>{};
+	auto rng = std::mt19937(4);
+	for (auto v = 0; v < 500; ++v) {
+		g.insert_node(v);
+	}
+	for (auto e = 0; e < 5000; ++e) {
+		auto const src = static_cast<int>(rng() % 500);
+		auto const dst = static_cast<int>(rng() % 500);
+		if (rng() % 4 == 0) {
+			g.insert_edge(src, dst);
+		}
+		else {
+			g.insert_edge(src, dst, static_cast<int>(rng() % 5) - 2);
+		}
+	}
+
+	auto expected = std::string{};
+	for (auto v = 0; v < 500; ++v) {
+		expected += "{\"node\":" + std::to_string(v) + "}\n";
+	}
+	for (auto const& [from, to, weight] : g) {
+		expected += "{\"from\":" + std::to_string(from) + ",\"to\":" + std::to_string(to);
+		expected += weight ? ",\"weight\":" + std::to_string(*weight) + "}\n" : "}\n";
+	}
+	REQUIRE(jsonl(g, {.block_size = 1}) == expected);
+	REQUIRE(jsonl(g, {.block_size = 100}) == expected);
+	REQUIRE(jsonl(g) == expected);
+	REQUIRE(dot(g, {.block_size = 7}) == dot(g));
+	REQUIRE(graphml(g, {.block_size = 300}) == graphml(g));
+}
+
+TEST_CASE("Lists and edges left behind by replace_node and merge_replace_node are skipped", "[export]") {
+	auto g = gdwg::graph<char, int>{'a', 'b', 'c', 'd'};
+	g.insert_edge('a', 'b', 1);
+	g.insert_edge('c', 'a', 2);
+	g.insert_edge('d', 'c', 3);
+	g.insert_edge('c', 'c', 4);
+	g.insert_edge('d', 'd', 5);
+	g.replace_node('b', 'e');
+	g.merge_replace_node('c', 'd'); // Leaves d's list out of order
+	REQUIRE(jsonl(g)
+	        == "{\"node\":\"a\"}\n"
+	           "{\"node\":\"d\"}\n"
+	           "{\"node\":\"e\"}\n"
+	           "{\"from\":\"d\",\"to\":\"a\",\"weight\":2}\n"
+	           "{\"from\":\"d\",\"to\":\"d\",\"weight\":5}\n");
+
+	// Dense and sparse integers, and floating point nodes, are looked up in different ways
+	auto const sparse = GENERATE(1, 1 << 30);
+	auto numbers = gdwg::graph<int, int>{-sparse, 0, sparse};
+	numbers.insert_edge(-sparse, sparse, 1);
+	numbers.insert_edge(-sparse, 0, 2);
+	numbers.replace_node(sparse, 5);
+	REQUIRE(jsonl(numbers)
+	        == "{\"node\":" + std::to_string(-sparse) + "}\n{\"node\":0}\n{\"node\":5}\n{\"from\":"
+	              + std::to_string(-sparse) + ",\"to\":0,\"weight\":2}\n");
+	auto reals = gdwg::graph<double, int>{0.5, 1.5};
+	reals.insert_edge(0.5, 1.5);
+	reals.insert_edge(0.5, 0.5);
+	reals.replace_node(1.5, 2.5);
+	REQUIRE(dot(reals) == "digraph \"G\" {\n  \"0.5\";\n  \"2.5\";\n  \"0.5\" -> \"0.5\";\n}\n");
+}
+
+TEST_CASE("Saving to files", "[export]") {
+	auto const directory = std::filesystem::temp_directory_path() / ("gdwg_test_export_" + std::to_string(::getpid()));
+	std::filesystem::create_directories(directory);
+	auto const g = small_graph();
+	auto const read = [](std::filesystem::path const& path) {
+		auto in = std::ifstream(path, std::ios::binary);
+		auto out = std::ostringstream{};
+		out << in.rdbuf();
+		return out.str();
+	};
+
+	gdwg::save_dot(g, (directory / "g.dot").string());
+	gdwg::save_graphml(g, (directory / "g.graphml").string());
+	gdwg::save_jsonl(g, (directory / "g.jsonl").string());
+	REQUIRE(read(directory / "g.dot") == dot(g));
+	REQUIRE(read(directory / "g.graphml") == graphml(g));
+	REQUIRE(read(directory / "g.jsonl") == jsonl(g));
+
+	auto const missing = (directory / "missing" / "g.dot").string();
+	REQUIRE_THROWS_WITH(gdwg::save_dot(g, missing), "Cannot call gdwg::save_dot: cannot open " + missing);
+	std::filesystem::remove_all(directory);
+
+	auto closed = std::ofstream{};
+	REQUIRE_THROWS_WITH(gdwg::write_jsonl(g, closed), "Cannot call gdwg::write_jsonl: writing to the stream failed");
+}
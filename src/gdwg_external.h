@@ -0,0 +1,706 @@
+#ifndef GDWG_EXTERNAL_H
+#define GDWG_EXTERNAL_H
+
+#include "gdwg_binary.h"
+#include "gdwg_builder.h"
+#include "gdwg_edge_list.h"
+#include "gdwg_graph.h"
+#include "gdwg_mapped_file.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+// Edge-list loading in bounded memory
+// The input is read in fixed-size chunks and parsed into a buffer; whenever the buffer is full it is sorted by
+// (src, dst, weight), its duplicates are dropped and it is written to a temporary run file, with a second run of its
+// node values. The runs are then merged, in extra passes first if there are too many to read at once, and the final
+// pass builds the graph or writes a binary graph file (see gdwg_binary.h). The memory budget covers the input chunk,
+// the sort buffer and the merge buffers; a graph built in memory comes on top of it.
+// Node and weight types must be trivially copyable or std::string
+namespace gdwg {
+	struct external_sort_options {
+		std::size_t memory_budget = std::size_t{256} << 20; // Bytes, at least 1 MiB is used
+		std::string temporary_directory = "/tmp"; // Where run files are written
+	};
+
+	struct external_sort_stats {
+		std::size_t runs = 0; // Sorted runs written while reading the input
+		std::size_t merge_passes = 0; // Passes over the runs, including the final one
+		std::size_t nodes = 0;
+		std::size_t edges = 0; // Without duplicates
+	};
+
+	namespace detail {
+		// A file created under a unique name and removed when this is destroyed
+		class temporary_file {
+		 public:
+			explicit temporary_file(std::string const& directory) {
+				auto name = directory + "/gdwg_XXXXXX";
+				auto const fd = ::mkstemp(name.data());
+				if (fd < 0) {
+					throw std::runtime_error("Cannot create a temporary file in " + directory + ": "
+					                         + std::strerror(errno));
+				}
+				::close(fd);
+				path_ = std::move(name);
+			}
+
+			temporary_file(temporary_file&& other) noexcept
+			: path_(std::exchange(other.path_, {})) {}
+
+			temporary_file& operator=(temporary_file&& other) noexcept {
+				if (this != &other) {
+					remove();
+					path_ = std::exchange(other.path_, {});
+				}
+				return *this;
+			}
+
+			temporary_file(temporary_file const&) = delete;
+			temporary_file& operator=(temporary_file const&) = delete;
+
+			~temporary_file() {
+				remove();
+			}
+
+			[[nodiscard]] std::string const& path() const noexcept {
+				return path_;
+			}
+
+		 private:
+			void remove() noexcept {
+				if (!path_.empty()) {
+					std::remove(path_.c_str());
+				}
+				path_.clear();
+			}
+
+			std::string path_;
+		};
+
+		template<typename T>
+		struct is_edge_record : std::false_type {};
+
+		template<typename N, typename E>
+		struct is_edge_record<std::tuple<N, N, std::optional<E>>> : std::true_type {};
+
+		// Records are small, so they go straight to the stream buffer, skipping the stream's per-call checks
+		inline void write_bytes(std::ostream& out, void const* data, std::size_t size) {
+			auto const count = static_cast<std::streamsize>(size);
+			if (out.rdbuf()->sputn(static_cast<char const*>(data), count) != count) {
+				out.setstate(std::ios::badbit);
+			}
+		}
+
+		inline bool read_bytes(std::istream& in, void* data, std::size_t size) {
+			auto const count = static_cast<std::streamsize>(size);
+			return in.rdbuf()->sgetn(static_cast<char*>(data), count) == count;
+		}
+
+		// Run files hold values back to back: trivially copyable values as their bytes, strings as a u64 length and
+		// their characters, and edges as src, dst, a has-weight bool and the weight if there is one
+		template<typename T>
+		void write_record(std::ostream& out, T const& value) {
+			if constexpr (is_edge_record<T>::value) {
+				auto const& [src, dst, weight] = value;
+				write_record(out, src);
+				write_record(out, dst);
+				write_record(out, weight.has_value());
+				if (weight) {
+					write_record(out, *weight);
+				}
+			}
+			else if constexpr (binary_codec<T>::kind == binary_kind::string) {
+				write_record(out, std::uint64_t{value.size()});
+				write_bytes(out, value.data(), value.size());
+			}
+			else {
+				write_bytes(out, &value, sizeof(T));
+			}
+		}
+
+		template<typename T>
+		bool read_record(std::istream& in, T& value) {
+			if constexpr (is_edge_record<T>::value) {
+				auto& [src, dst, weight] = value;
+				if (!read_record(in, src) or !read_record(in, dst)) {
+					return false;
+				}
+				auto has_weight = false;
+				if (!read_record(in, has_weight)) {
+					return false;
+				}
+				if (!has_weight) {
+					weight.reset();
+					return true;
+				}
+				weight.emplace();
+				return read_record(in, *weight);
+			}
+			else if constexpr (binary_codec<T>::kind == binary_kind::string) {
+				auto size = std::uint64_t{0};
+				if (!read_record(in, size)) {
+					return false;
+				}
+				value.resize(size);
+				return read_bytes(in, value.data(), size);
+			}
+			else {
+				return read_bytes(in, &value, sizeof(T));
+			}
+		}
+
+		// Heap memory owned by a value, beyond its sizeof
+		template<typename T>
+		std::size_t heap_bytes(T const& value) {
+			if constexpr (is_edge_record<T>::value) {
+				auto const& [src, dst, weight] = value;
+				return heap_bytes(src) + heap_bytes(dst) + (weight ? heap_bytes(*weight) : 0);
+			}
+			else if constexpr (std::is_same_v<T, std::string>) {
+				return value.capacity() > 15 ? value.capacity() + 1 : 0;
+			}
+			else {
+				return 0;
+			}
+		}
+
+		// A file stream with a buffer of the given size
+		template<typename Stream>
+		class buffered_stream {
+		 public:
+			buffered_stream(std::string const& path, std::ios::openmode mode, std::size_t buffer_size)
+			: buffer_(std::make_unique<char[]>(buffer_size))
+			, stream_(std::make_unique<Stream>()) {
+				stream_->rdbuf()->pubsetbuf(buffer_.get(), static_cast<std::streamsize>(buffer_size));
+				stream_->open(path, mode | std::ios::binary);
+				if (!*stream_) {
+					throw std::runtime_error("Cannot open " + path);
+				}
+			}
+
+			Stream& operator*() noexcept {
+				return *stream_;
+			}
+
+		 private:
+			std::unique_ptr<char[]> buffer_; // Declared first, so it outlives the stream
+			std::unique_ptr<Stream> stream_;
+		};
+
+		// Sequential reader of one run file
+		template<typename T>
+		class run_reader {
+		 public:
+			run_reader(std::string const& path, std::size_t buffer_size)
+			: in_(path, std::ios::in, buffer_size) {
+				advance();
+			}
+
+			[[nodiscard]] bool done() const noexcept {
+				return done_;
+			}
+
+			[[nodiscard]] T& value() noexcept {
+				return value_;
+			}
+
+			void advance() {
+				done_ = !read_record(*in_, value_);
+			}
+
+		 private:
+			buffered_stream<std::ifstream> in_;
+			T value_ = {};
+			bool done_ = false;
+		};
+
+		// k-way merge of sorted run files, returning every distinct value once in ascending order
+		template<typename T>
+		class run_merger {
+		 public:
+			run_merger(std::vector<temporary_file> const& runs, std::size_t buffer_size) {
+				for (auto const& run : runs) {
+					readers_.emplace_back(run.path(), buffer_size);
+					if (!readers_.back().done()) {
+						heap_.push_back(readers_.size() - 1);
+					}
+				}
+				std::make_heap(heap_.begin(), heap_.end(), later());
+			}
+
+			// Return the next distinct value, or std::nullopt after the last
+			std::optional<T> next() {
+				while (!heap_.empty()) {
+					std::pop_heap(heap_.begin(), heap_.end(), later());
+					auto& reader = readers_[heap_.back()];
+					auto value = std::move(reader.value());
+					reader.advance();
+					if (reader.done()) {
+						heap_.pop_back();
+					}
+					else {
+						std::push_heap(heap_.begin(), heap_.end(), later());
+					}
+					if (!last_ or !(*last_ == value)) {
+						last_ = value;
+						return value;
+					}
+				}
+				return std::nullopt;
+			}
+
+		 private:
+			// Heap order: the reader with the smallest value on top
+			auto later() {
+				return [this](std::size_t a, std::size_t b) { return readers_[b].value() < readers_[a].value(); };
+			}
+
+			std::vector<run_reader<T>> readers_;
+			std::vector<std::size_t> heap_;
+			std::optional<T> last_;
+		};
+
+		// The sorted run files of one kind of value
+		template<typename T>
+		class run_set {
+		 public:
+			explicit run_set(std::string directory)
+			: directory_(std::move(directory)) {}
+
+			[[nodiscard]] std::size_t size() const noexcept {
+				return runs_.size();
+			}
+
+			// Write sorted, distinct values as a new run
+			void write(std::vector<T> const& values, std::size_t buffer_size) {
+				auto run = temporary_file(directory_);
+				auto out = buffered_stream<std::ofstream>(run.path(), std::ios::out | std::ios::trunc, buffer_size);
+				for (auto const& value : values) {
+					write_record(*out, value);
+				}
+				(*out).flush();
+				if (!*out) {
+					throw std::runtime_error("Cannot write " + run.path());
+				}
+				runs_.push_back(std::move(run));
+			}
+
+			// Merge groups of runs until at most max_runs are left, returning the number of passes this took
+			std::size_t reduce(std::size_t max_runs, std::size_t buffer_size) {
+				max_runs = std::max<std::size_t>(2, max_runs);
+				auto passes = std::size_t{0};
+				while (runs_.size() > max_runs) {
+					auto merged = std::vector<temporary_file>{};
+					for (std::size_t first = 0; first < runs_.size(); first += max_runs) {
+						auto group = std::vector<temporary_file>{};
+						for (auto i = first; i < std::min(runs_.size(), first + max_runs); ++i) {
+							group.push_back(std::move(runs_[i]));
+						}
+						merged.push_back(temporary_file(directory_));
+						auto out = buffered_stream<std::ofstream>(merged.back().path(),
+						                                          std::ios::out | std::ios::trunc,
+						                                          buffer_size);
+						auto merger = run_merger<T>(group, buffer_size / (group.size() + 1));
+						while (auto value = merger.next()) {
+							write_record(*out, *value);
+						}
+						(*out).flush();
+						if (!*out) {
+							throw std::runtime_error("Cannot write " + merged.back().path());
+						}
+					}
+					runs_ = std::move(merged);
+					++passes;
+				}
+				return passes;
+			}
+
+			[[nodiscard]] run_merger<T> merge(std::size_t buffer_size) const {
+				return run_merger<T>(runs_, buffer_size);
+			}
+
+		 private:
+			std::string directory_;
+			std::vector<temporary_file> runs_;
+		};
+
+		// Receives parsed lines (it has the insert_node and insert_edge of graph_builder) and spills them to runs
+		template<typename N, typename E>
+		class external_edge_sorter {
+		 public:
+			using edge_type = typename graph_builder<N, E>::edge_type;
+
+			// Every buffered edge may need two node values when it is spilled
+			static constexpr auto bytes_per_edge = sizeof(edge_type) + 2 * sizeof(N);
+
+			external_edge_sorter(std::string const& directory, std::size_t buffer_bytes)
+			: limit_(buffer_bytes)
+			, node_runs_(directory)
+			, edge_runs_(directory) {
+				edges_.reserve(limit_ / bytes_per_edge);
+			}
+
+			void insert_node(N value) {
+				heap_ += heap_bytes(value);
+				nodes_.push_back(std::move(value));
+				spill_if_full();
+			}
+
+			void insert_edge(N src, N dst, std::optional<E> weight = std::nullopt) {
+				edges_.emplace_back(std::move(src), std::move(dst), std::move(weight));
+				heap_ += 2 * heap_bytes(edges_.back()); // The edge, and its endpoints once spilled
+				spill_if_full();
+			}
+
+			// Write everything still buffered and release the buffer
+			void finish() {
+				spill();
+				edges_ = {};
+				nodes_ = {};
+			}
+
+			[[nodiscard]] run_set<N>& node_runs() noexcept {
+				return node_runs_;
+			}
+
+			[[nodiscard]] run_set<edge_type>& edge_runs() noexcept {
+				return edge_runs_;
+			}
+
+		 private:
+			void spill_if_full() {
+				if (edges_.size() * bytes_per_edge + nodes_.capacity() * sizeof(N) + heap_ >= limit_
+				    or edges_.size() == edges_.capacity()) {
+					spill();
+				}
+			}
+
+			void spill() {
+				if (edges_.empty() and nodes_.empty()) {
+					return;
+				}
+				auto const write_buffer = std::max<std::size_t>(4096, limit_ / 64);
+				std::sort(edges_.begin(), edges_.end());
+				edges_.erase(std::unique(edges_.begin(), edges_.end()), edges_.end());
+				edge_runs_.write(edges_, write_buffer);
+				for (auto& [src, dst, weight] : edges_) {
+					if (nodes_.empty() or !(nodes_.back() == src)) {
+						nodes_.push_back(std::move(src));
+					}
+					nodes_.push_back(std::move(dst));
+				}
+				edges_.clear();
+				std::sort(nodes_.begin(), nodes_.end());
+				nodes_.erase(std::unique(nodes_.begin(), nodes_.end()), nodes_.end());
+				node_runs_.write(nodes_, write_buffer);
+				nodes_ = {};
+				heap_ = 0;
+			}
+
+			std::size_t limit_;
+			std::vector<edge_type> edges_;
+			std::vector<N> nodes_;
+			std::size_t heap_ = 0;
+			run_set<N> node_runs_;
+			run_set<edge_type> edge_runs_;
+		};
+
+		// How the memory budget is shared out
+		struct external_budget {
+			explicit external_budget(std::size_t memory_budget)
+			: total(std::max<std::size_t>(memory_budget, std::size_t{1} << 20))
+			, chunk(std::clamp<std::size_t>(total / 16, std::size_t{1} << 16, std::size_t{1} << 24))
+			, buffer(total - 2 * chunk)
+			, max_readers(std::max<std::size_t>(4, total / 2 / reader_buffer)) {}
+
+			static constexpr auto reader_buffer = std::size_t{1} << 16; // Smallest buffer worth reading runs with
+
+			std::size_t total;
+			std::size_t chunk; // Input read at once; a line longer than this grows it
+			std::size_t buffer; // Sort buffer
+			std::size_t max_readers; // Run files merged at once
+		};
+
+		// Read the edge list in chunks, spilling sorted runs
+		template<typename N, typename E>
+		void spill_edge_list(std::string const& path,
+		                     external_edge_sorter<N, E>& sorter,
+		                     external_budget const& budget,
+		                     std::string const& caller) {
+			auto in = std::ifstream(path, std::ios::binary);
+			if (!in) {
+				throw std::runtime_error("Cannot call gdwg::" + caller + ": cannot open " + path);
+			}
+			auto buffer = std::string(budget.chunk, '\0');
+			auto filled = std::size_t{0};
+			auto line_number = std::size_t{0};
+			for (auto end_of_file = false; !end_of_file;) {
+				in.read(buffer.data() + filled, static_cast<std::streamsize>(buffer.size() - filled));
+				filled += static_cast<std::size_t>(in.gcount());
+				end_of_file = !in;
+				auto const text = std::string_view(buffer.data(), filled);
+				auto const complete = end_of_file ? filled : text.rfind('\n') + 1; // npos + 1 == 0
+				if (complete == 0 and !end_of_file) {
+					buffer.resize(2 * buffer.size()); // One line fills the whole buffer
+					continue;
+				}
+				for (std::size_t first = 0; first < complete;) {
+					auto const end = find_newline(text, first, complete);
+					++line_number;
+					if (!parse_edge_line<N, E>(text.substr(first, end - first), sorter)) {
+						throw std::runtime_error("Cannot call gdwg::" + caller + ": malformed line "
+						                         + std::to_string(line_number) + ": "
+						                         + std::string(text.substr(first, end - first)));
+					}
+					first = end + 1;
+				}
+				buffer.erase(0, complete);
+				filled -= complete;
+				buffer.resize(std::max(buffer.size(), budget.chunk));
+			}
+			sorter.finish();
+		}
+
+		// Append a length-prefixed string entry to a string section's position and data files
+		inline void
+		write_entry(std::ostream& positions, std::ostream& data, std::uint64_t& position, std::string_view value) {
+			static constexpr auto zeros = std::array<char, 8>{};
+			auto const size = std::uint64_t{value.size()};
+			write_record(positions, position);
+			write_record(data, size);
+			data.write(value.data(), static_cast<std::streamsize>(size));
+			data.write(zeros.data(), static_cast<std::streamsize>(align8(size) - size));
+			position += 8 + align8(size);
+		}
+
+		// One section of a binary file, written as separate files while merging: the values, or for strings the
+		// positions and their entries
+		template<typename T>
+		class section_files {
+		 public:
+			section_files(std::string const& directory, std::size_t buffer_size)
+			: values_file_(directory)
+			, data_file_(directory)
+			, values_(values_file_.path(), std::ios::out | std::ios::trunc, buffer_size)
+			, data_(data_file_.path(), std::ios::out | std::ios::trunc, buffer_size) {}
+
+			void write(T const& value) {
+				if constexpr (binary_codec<T>::kind == binary_kind::string) {
+					write_entry(*values_, *data_, data_bytes_, value);
+				}
+				else {
+					write_record(*values_, value);
+				}
+				++count_;
+			}
+
+			void close() {
+				(*values_).close();
+				(*data_).close();
+			}
+
+			[[nodiscard]] std::uint64_t count() const noexcept {
+				return count_;
+			}
+
+			[[nodiscard]] std::uint64_t bytes() const noexcept {
+				return count_ * (binary_codec<T>::kind == binary_kind::string ? 8 : sizeof(T)) + data_bytes_;
+			}
+
+			[[nodiscard]] std::string const& values_path() const noexcept {
+				return values_file_.path();
+			}
+
+			[[nodiscard]] std::string const& data_path() const noexcept {
+				return data_file_.path();
+			}
+
+		 private:
+			temporary_file values_file_;
+			temporary_file data_file_;
+			buffered_stream<std::ofstream> values_;
+			buffered_stream<std::ofstream> data_;
+			std::uint64_t count_ = 0;
+			std::uint64_t data_bytes_ = 0;
+		};
+
+		// Sorted node values written by section_files, mapped back in for looking up indices
+		template<typename N>
+		class node_dictionary {
+		 public:
+			explicit node_dictionary(section_files<N> const& nodes)
+			: values_(nodes.values_path())
+			, data_(nodes.data_path())
+			, count_(nodes.count()) {}
+
+			[[nodiscard]] typename binary_codec<N>::view operator[](std::size_t i) const {
+				if constexpr (binary_codec<N>::kind == binary_kind::string) {
+					auto position = std::uint64_t{0};
+					std::memcpy(&position, values_.data() + i * 8, 8);
+					auto length = std::uint64_t{0};
+					std::memcpy(&length, data_.data() + position, 8);
+					return {reinterpret_cast<char const*>(data_.data() + position + 8), length};
+				}
+				else {
+					auto value = N{};
+					std::memcpy(&value, values_.data() + i * sizeof(N), sizeof(N));
+					return value;
+				}
+			}
+
+			// Index of a value known to be in the dictionary
+			[[nodiscard]] std::uint64_t index_of(N const& value) const {
+				auto first = std::size_t{0};
+				auto count = count_;
+				while (count > 0) {
+					auto const half = count / 2;
+					if ((*this)[first + half] < value) {
+						first += half + 1;
+						count -= half + 1;
+					}
+					else {
+						count = half;
+					}
+				}
+				return first;
+			}
+
+		 private:
+			mapped_file values_;
+			mapped_file data_;
+			std::size_t count_;
+		};
+
+		// Copy a whole file into the binary file being written
+		inline void copy_into(binary_file_writer& out, std::string const& path, std::vector<char>& buffer) {
+			auto in = std::ifstream(path, std::ios::binary);
+			while (in) {
+				in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+				out.write(buffer.data(), static_cast<std::size_t>(in.gcount()));
+			}
+		}
+	} // namespace detail
+
+	// Read an edge-list file (in the formats accepted by read_edge_list) into a graph, sorting it externally within
+	// the memory budget
+	template<typename N, typename E>
+	graph<N, E> stream_edge_list(std::string const& path, external_sort_options const& options = {}) {
+		auto const budget = detail::external_budget(options.memory_budget);
+		auto sorter = detail::external_edge_sorter<N, E>(options.temporary_directory, budget.buffer);
+		detail::spill_edge_list(path, sorter, budget, "stream_edge_list");
+		auto& node_runs = sorter.node_runs();
+		auto& edge_runs = sorter.edge_runs();
+		node_runs.reduce(budget.max_readers / 2, budget.total / 4);
+		edge_runs.reduce(budget.max_readers / 2, budget.total / 4);
+
+		auto const reader_buffer = budget.total / 2 / std::max<std::size_t>(1, node_runs.size() + edge_runs.size());
+		auto nodes = node_runs.merge(reader_buffer);
+		auto edges = edge_runs.merge(reader_buffer);
+		return graph_builder<N, E>::build_sorted([&nodes] { return nodes.next(); }, [&edges] { return edges.next(); });
+	}
+
+	// Convert an edge-list file into a binary graph file (as written by save_binary) within the memory budget.
+	// Neither the edges nor the nodes are ever held in memory all at once; target indices are looked up in the
+	// node section, which is memory-mapped from its temporary file
+	template<typename N, typename E>
+	external_sort_stats stream_edge_list_to_binary(std::string const& path,
+	                                               std::string const& binary_path,
+	                                               external_sort_options const& options = {}) {
+		auto const budget = detail::external_budget(options.memory_budget);
+		auto const& directory = options.temporary_directory;
+		auto sorter = detail::external_edge_sorter<N, E>(directory, budget.buffer);
+		detail::spill_edge_list(path, sorter, budget, "stream_edge_list_to_binary");
+		auto& node_runs = sorter.node_runs();
+		auto& edge_runs = sorter.edge_runs();
+		auto stats = external_sort_stats{};
+		stats.runs = edge_runs.size();
+		stats.merge_passes = std::max(node_runs.reduce(budget.max_readers, budget.total / 4),
+		                              edge_runs.reduce(budget.max_readers, budget.total / 4))
+		                     + 1;
+
+		// Nodes first, so that the edge pass can look up target indices
+		auto const writer_buffer = budget.total / 32;
+		auto nodes = detail::section_files<N>(directory, writer_buffer);
+		{
+			auto merger = node_runs.merge(budget.total / 2 / std::max<std::size_t>(1, node_runs.size()));
+			while (auto node = merger.next()) {
+				nodes.write(*node);
+			}
+			nodes.close();
+		}
+		auto const dictionary = detail::node_dictionary<N>(nodes);
+
+		auto offsets = detail::temporary_file(directory);
+		auto targets = detail::temporary_file(directory);
+		auto unweighted = detail::temporary_file(directory);
+		auto weights = detail::section_files<E>(directory, writer_buffer);
+		{
+			auto offsets_out = detail::buffered_stream<std::ofstream>(offsets.path(), std::ios::out, writer_buffer);
+			auto targets_out = detail::buffered_stream<std::ofstream>(targets.path(), std::ios::out, writer_buffer);
+			auto unweighted_out =
+			   detail::buffered_stream<std::ofstream>(unweighted.path(), std::ios::out, writer_buffer);
+			auto merger = edge_runs.merge(budget.total / 2 / std::max<std::size_t>(1, edge_runs.size()));
+			auto word = std::uint64_t{0};
+			auto m = std::uint64_t{0};
+			auto src = std::uint64_t{0};
+			detail::write_record(*offsets_out, m);
+			while (auto edge = merger.next()) {
+				auto& [from, to, weight] = *edge;
+				for (; !(dictionary[src] == from); ++src) {
+					detail::write_record(*offsets_out, m); // Close the rows of nodes before from
+				}
+				detail::write_record(*targets_out, dictionary.index_of(to));
+				weights.write(weight ? *weight : E{});
+				word |= weight ? 0 : std::uint64_t{1} << (m % 64);
+				if (++m % 64 == 0) {
+					detail::write_record(*unweighted_out, std::exchange(word, 0));
+				}
+			}
+			for (; src < nodes.count(); ++src) {
+				detail::write_record(*offsets_out, m);
+			}
+			if (m % 64 != 0) {
+				detail::write_record(*unweighted_out, word);
+			}
+			weights.close();
+			stats.edges = m;
+		}
+		stats.nodes = nodes.count();
+
+		auto const header = detail::make_binary_header<N, E>(stats.nodes, stats.edges, nodes.bytes(), weights.bytes());
+		auto out = detail::binary_file_writer(binary_path);
+		auto buffer = std::vector<char>(writer_buffer);
+		detail::copy_into(out, nodes.values_path(), buffer);
+		detail::copy_into(out, nodes.data_path(), buffer);
+		out.pad_to(header.offsets);
+		detail::copy_into(out, offsets.path(), buffer);
+		detail::copy_into(out, targets.path(), buffer);
+		detail::copy_into(out, weights.values_path(), buffer);
+		detail::copy_into(out, weights.data_path(), buffer);
+		out.pad_to(header.unweighted);
+		detail::copy_into(out, unweighted.path(), buffer);
+		out.finish(header, binary_path);
+		return stats;
+	}
+} // namespace gdwg
+
+#endif // GDWG_EXTERNAL_H
@@ -0,0 +1,147 @@
+#include "gdwg_external.h"
+#include "gdwg_testing.h"
+
+#include <catch2/catch.hpp>
+
+#include <fstream>
+#include <random>
+
+namespace {
+	using gdwg::testing::contents;
+	using gdwg::testing::print;
+	using gdwg::testing::scratch_directory;
+
+	void write(std::string const& path, std::string const& text) {
+		auto out = std::ofstream(path, std::ios::binary);
+		out << text;
+	}
+
+	// A random edge list with many duplicates, some node lines and some lines in the printed format
+	std::string random_edge_list(std::size_t lines, unsigned seed) {
+		auto rng = std::mt19937(seed);
+		auto text = std::string{};
+		for (std::size_t i = 0; i < lines; ++i) {
+			auto const u = std::to_string(rng() % 3000);
+			auto const v = std::to_string(rng() % 3000);
+			switch (rng() % 8) {
+			case 0: text += u + '\n'; break;
+			case 1: text += u + " " + v + '\n'; break;
+			case 2: text += "  " + u + " -> " + v + " | W | " + std::to_string(rng() % 4) + '\n'; break;
+			default: text += u + ' ' + v + ' ' + std::to_string(rng() % 4) + '\n'; break;
+			}
+		}
+		return text;
+	}
+} // namespace
+
+// External sort loader tests
+TEST_CASE("A small memory budget gives the same graph as loading in memory", "[external]") {
+	auto const scratch = scratch_directory("external_graph");
+	auto const input = scratch.file("edges.txt");
+	write(input, random_edge_list(200000, 43));
+
+	auto options = gdwg::external_sort_options{};
+	options.memory_budget = 0; // Raised to the 1 MiB minimum, well below the size of the input
+	options.temporary_directory = scratch.path();
+	auto const streamed = gdwg::stream_edge_list<int, int>(input, options);
+	REQUIRE(print(streamed) == print(gdwg::read_edge_list<int, int>(input)));
+	REQUIRE(scratch.file_count() == 1); // Only the input is left
+}
+
+TEST_CASE("Binary files written from runs match save_binary", "[external]") {
+	auto const scratch = scratch_directory("external_binary");
+	auto const input = scratch.file("edges.txt");
+	write(input, random_edge_list(200000, 44));
+	auto const expected = scratch.file("expected.bin");
+	gdwg::save_binary(gdwg::read_edge_list<int, int>(input), expected);
+
+	auto options = gdwg::external_sort_options{};
+	options.memory_budget = 0;
+	options.temporary_directory = scratch.path();
+	auto const output = scratch.file("streamed.bin");
+	auto const stats = gdwg::stream_edge_list_to_binary<int, int>(input, output, options);
+	REQUIRE(stats.runs > 4);
+	REQUIRE(stats.merge_passes >= 2);
+	REQUIRE(contents(output) == contents(expected));
+	auto const mapped = gdwg::mmap_graph<int, int>(output, true);
+	REQUIRE(mapped.node_count() == stats.nodes);
+	REQUIRE(mapped.edge_count() == stats.edges);
+	REQUIRE(scratch.file_count() == 3);
+
+	// A budget that holds everything makes a single run
+	options.memory_budget = std::size_t{64} << 20;
+	auto const single = gdwg::stream_edge_list_to_binary<int, int>(input, output, options);
+	REQUIRE(single.runs == 1);
+	REQUIRE(single.merge_passes == 1);
+	REQUIRE(contents(output) == contents(expected));
+}
+
+TEST_CASE("Strings, long lines and printed graphs", "[external]") {
+	auto const scratch = scratch_directory("external_strings");
+	auto options = gdwg::external_sort_options{};
+	options.memory_budget = 0;
+	options.temporary_directory = scratch.path();
+
+	auto g = gdwg::graph<std::string, int>{};
+	auto const long_name = std::string(200000, 'x'); // Longer than one input chunk
+	auto rng = std::mt19937(45);
+	for (auto i = 0; i < 2000; ++i) {
+		g.insert_node("node" + std::to_string(i));
+	}
+	g.insert_node(long_name);
+	for (auto i = 0; i < 20000; ++i) {
+		auto const u = "node" + std::to_string(rng() % 2000);
+		auto const v = "node" + std::to_string(rng() % 2000);
+		g.insert_edge(u, v, static_cast<int>(rng() % 3));
+	}
+	g.insert_edge(long_name, "node7");
+	g.insert_edge("node7", long_name, 7);
+
+	auto const input = scratch.file("printed.txt");
+	write(input, print(g));
+	REQUIRE(print(gdwg::stream_edge_list<std::string, int>(input, options)) == print(g));
+
+	auto const expected = scratch.file("expected.bin");
+	auto const output = scratch.file("streamed.bin");
+	gdwg::save_binary(g, expected);
+	gdwg::stream_edge_list_to_binary<std::string, int>(input, output, options);
+	REQUIRE(contents(output) == contents(expected));
+}
+
+TEST_CASE("External loading edge cases", "[external]") {
+	auto const scratch = scratch_directory("external_edge_cases");
+	auto options = gdwg::external_sort_options{};
+	options.temporary_directory = scratch.path();
+
+	SECTION("Empty input") {
+		auto const input = scratch.file("empty.txt");
+		write(input, "");
+		REQUIRE(gdwg::stream_edge_list<int, int>(input, options).empty());
+		auto const output = scratch.file("empty.bin");
+		auto const stats = gdwg::stream_edge_list_to_binary<int, int>(input, output, options);
+		REQUIRE(stats.nodes == 0);
+		REQUIRE(stats.edges == 0);
+		REQUIRE(gdwg::mmap_graph<int, int>(output, true).node_count() == 0);
+	}
+
+	SECTION("Nodes without edges only") {
+		auto const input = scratch.file("nodes.txt");
+		write(input, "5\n3\n5\n");
+		auto const stats = gdwg::stream_edge_list_to_binary<int, int>(input, scratch.file("nodes.bin"), options);
+		REQUIRE(stats.nodes == 2);
+		REQUIRE(gdwg::mmap_graph<int, int>(scratch.file("nodes.bin")).node(1) == 5);
+	}
+
+	SECTION("Errors") {
+		auto const input = scratch.file("bad.txt");
+		write(input, "1 2\n2 3\nthree 4\n");
+		REQUIRE_THROWS_WITH((gdwg::stream_edge_list<int, int>(input, options)),
+		                    "Cannot call gdwg::stream_edge_list: malformed line 3: three 4");
+		REQUIRE_THROWS_WITH((gdwg::stream_edge_list_to_binary<int, int>(scratch.file("missing.txt"),
+		                                                                 scratch.file("out.bin"),
+		                                                                 options)),
+		                    "Cannot call gdwg::stream_edge_list_to_binary: cannot open " + scratch.file("missing.txt"));
+		options.temporary_directory = scratch.file("missing_directory");
+		REQUIRE_THROWS((gdwg::stream_edge_list<int, int>(input, options)));
+	}
+}
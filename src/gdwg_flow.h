@@ -0,0 +1,278 @@
+#ifndef GDWG_FLOW_H
+#define GDWG_FLOW_H
+
+#include "gdwg_csr.h"
+#include "gdwg_graph.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace gdwg {
+	// Maximum flow value and a minimum cut of a graph, keyed by node value
+	template<typename N, typename E>
+	struct flow_cut {
+		E flow{}; // Value of a maximum flow, equal to the capacity of the cut
+		std::vector<N> source_side; // Nodes on the source side of a minimum cut (ascending)
+		std::vector<N> sink_side; // Nodes on the sink side of a minimum cut (ascending)
+	};
+
+	// FIFO push-relabel maximum flow solver with global relabelling and the gap heuristic
+	// Edge weights are capacities (unweighted edges have capacity 1). The solver builds its own compact arc
+	// arrays from a snapshot, pairing every edge with a reverse residual arc, so the graph itself is never
+	// changed; one solver can answer any number of (source, sink) queries over the same capacities
+	template<typename E>
+	class max_flow {
+		static_assert(std::is_arithmetic_v<E>, "gdwg::max_flow needs arithmetic edge weights to use as capacities");
+
+	 public:
+		template<typename N>
+		explicit max_flow(csr_graph<N, E> const& g)
+		: n_(g.node_count()) {
+			// Every non-loop edge gives a forward arc and a reverse arc; arcs are grouped by tail
+			auto degree = std::vector<std::size_t>(n_ + 1, 0);
+			for (std::size_t u = 0; u < n_; ++u) {
+				for (auto v : g.neighbours(u)) {
+					if (u != v) {
+						++degree[u + 1];
+						++degree[v + 1];
+					}
+				}
+			}
+			offsets_.assign(n_ + 1, 0);
+			for (std::size_t u = 0; u < n_; ++u) {
+				offsets_[u + 1] = offsets_[u] + degree[u + 1];
+			}
+			auto const arcs = offsets_.back();
+			head_.assign(arcs, 0);
+			mate_.assign(arcs, 0);
+			capacity_.assign(arcs, E{});
+			auto fill = std::vector<std::size_t>(offsets_.begin(), offsets_.end() - 1);
+			for (std::size_t u = 0; u < n_; ++u) {
+				auto const targets = g.neighbours(u);
+				auto const weights = g.weights(u);
+				for (std::size_t e = 0; e < targets.size(); ++e) {
+					auto const v = targets[e];
+					if (u == v) {
+						continue;
+					}
+					auto const capacity = weights[e] ? *weights[e] : E{1};
+					if (capacity < E{}) {
+						throw std::runtime_error("Cannot construct gdwg::max_flow from a graph with negative edge "
+						                         "weights");
+					}
+					auto const forward = fill[u]++;
+					auto const backward = fill[v]++;
+					head_[forward] = v;
+					head_[backward] = u;
+					mate_[forward] = backward;
+					mate_[backward] = forward;
+					capacity_[forward] = capacity;
+				}
+			}
+			residual_.assign(arcs, E{});
+			excess_.assign(n_, E{});
+			height_.assign(n_, 0);
+			current_.assign(n_, 0);
+			count_.assign(n_ + 1, 0);
+			active_.assign(n_, false);
+		}
+
+		// Return the number of nodes
+		[[nodiscard]] std::size_t node_count() const noexcept {
+			return n_;
+		}
+
+		// Compute the value of a maximum flow from s to t
+		E solve(std::size_t s, std::size_t t) {
+			if (s >= n_ or t >= n_) {
+				throw std::runtime_error("Cannot call gdwg::max_flow::solve with a source or sink outside the graph");
+			}
+			source_ = s;
+			sink_ = t;
+			std::copy(capacity_.begin(), capacity_.end(), residual_.begin());
+			std::fill(excess_.begin(), excess_.end(), E{});
+			std::fill(active_.begin(), active_.end(), false);
+			queue_.clear();
+			if (s == t) {
+				return E{};
+			}
+
+			global_relabel();
+			for (auto a = offsets_[s]; a < offsets_[s + 1]; ++a) {
+				if (residual_[a] > E{}) {
+					auto const amount = residual_[a];
+					residual_[a] = E{};
+					residual_[mate_[a]] += amount;
+					excess_[head_[a]] += amount;
+					excess_[s] -= amount;
+					activate(head_[a]);
+				}
+			}
+
+			// Relabel from the sink again after roughly this much discharge work
+			auto const relabel_interval = 6 * n_ + offsets_.back();
+			auto work = std::size_t{0};
+			while (!queue_.empty()) {
+				auto const v = queue_.front();
+				queue_.pop_front();
+				active_[v] = false;
+				if (height_[v] >= n_) {
+					continue; // The sink became unreachable from v
+				}
+				work += discharge(v);
+				if (work > relabel_interval) {
+					work = 0;
+					global_relabel();
+				}
+			}
+			return excess_[t];
+		}
+
+		// After solve, return whether each node is on the source side of a minimum cut
+		// (the nodes that cannot reach the sink in the residual network)
+		[[nodiscard]] std::vector<bool> source_side() const {
+			auto reaches_sink = std::vector<bool>(n_, false);
+			if (n_ == 0) {
+				return reaches_sink;
+			}
+			auto queue = std::vector<std::size_t>{sink_};
+			reaches_sink[sink_] = true;
+			for (std::size_t head = 0; head < queue.size(); ++head) {
+				auto const w = queue[head];
+				for (auto a = offsets_[w]; a < offsets_[w + 1]; ++a) {
+					auto const u = head_[a];
+					if (!reaches_sink[u] and residual_[mate_[a]] > E{}) {
+						reaches_sink[u] = true;
+						queue.push_back(u);
+					}
+				}
+			}
+			reaches_sink.flip();
+			return reaches_sink;
+		}
+
+	 private:
+		void activate(std::size_t v) {
+			if (!active_[v] and v != source_ and v != sink_ and excess_[v] > E{}) {
+				active_[v] = true;
+				queue_.push_back(v);
+			}
+		}
+
+		// Exact heights by breadth-first search from the sink over residual arcs; unreachable nodes get n
+		void global_relabel() {
+			std::fill(height_.begin(), height_.end(), n_);
+			std::fill(count_.begin(), count_.end(), 0);
+			bfs_.clear();
+			bfs_.push_back(sink_);
+			height_[sink_] = 0;
+			for (std::size_t head = 0; head < bfs_.size(); ++head) {
+				auto const w = bfs_[head];
+				for (auto a = offsets_[w]; a < offsets_[w + 1]; ++a) {
+					auto const u = head_[a];
+					if (height_[u] == n_ and u != source_ and residual_[mate_[a]] > E{}) {
+						height_[u] = height_[w] + 1;
+						bfs_.push_back(u);
+					}
+				}
+			}
+			height_[source_] = n_;
+			for (std::size_t v = 0; v < n_; ++v) {
+				++count_[height_[v]];
+				current_[v] = offsets_[v];
+			}
+		}
+
+		// Push v's excess along admissible arcs, relabelling when none is left; returns the arcs scanned
+		std::size_t discharge(std::size_t v) {
+			auto scanned = std::size_t{0};
+			while (excess_[v] > E{} and height_[v] < n_) {
+				if (current_[v] == offsets_[v + 1]) {
+					scanned += relabel(v);
+					continue;
+				}
+				auto const a = current_[v];
+				auto const w = head_[a];
+				if (residual_[a] > E{} and height_[v] == height_[w] + 1) {
+					auto const amount = std::min(excess_[v], residual_[a]);
+					residual_[a] -= amount;
+					residual_[mate_[a]] += amount;
+					excess_[v] -= amount;
+					excess_[w] += amount;
+					activate(w);
+					if (excess_[v] == E{}) {
+						break; // Keep the current arc, it may still be admissible
+					}
+				}
+				++current_[v];
+				++scanned;
+			}
+			return scanned;
+		}
+
+		std::size_t relabel(std::size_t v) {
+			auto const old = height_[v];
+			auto lowest = n_;
+			for (auto a = offsets_[v]; a < offsets_[v + 1]; ++a) {
+				if (residual_[a] > E{}) {
+					lowest = std::min(lowest, height_[head_[a]] + 1);
+				}
+			}
+			--count_[old];
+			if (count_[old] == 0 and old < n_) {
+				// Gap: nothing is left at height old, so nodes above it can no longer reach the sink
+				for (std::size_t u = 0; u < n_; ++u) {
+					if (height_[u] > old and height_[u] < n_) {
+						--count_[height_[u]];
+						height_[u] = n_;
+						++count_[n_];
+					}
+				}
+				lowest = n_;
+			}
+			height_[v] = std::min(lowest, n_);
+			++count_[height_[v]];
+			current_[v] = offsets_[v];
+			return offsets_[v + 1] - offsets_[v];
+		}
+
+		std::size_t n_;
+		std::vector<std::size_t> offsets_; // Arcs of node u are [offsets_[u], offsets_[u + 1])
+		std::vector<std::size_t> head_; // Head node of every arc
+		std::vector<std::size_t> mate_; // Reverse arc of every arc
+		std::vector<E> capacity_; // Original capacity of every arc (0 for reverse arcs)
+		std::vector<E> residual_; // Residual capacity of every arc
+		std::vector<E> excess_;
+		std::vector<std::size_t> height_;
+		std::vector<std::size_t> current_; // Current arc of every node
+		std::vector<std::size_t> count_; // Number of nodes at each height
+		std::vector<bool> active_; // Whether each node is in queue_
+		std::deque<std::size_t> queue_; // FIFO of active nodes
+		std::vector<std::size_t> bfs_; // Scratch queue of the global relabel
+		std::size_t source_ = 0;
+		std::size_t sink_ = 0;
+	};
+
+	// Compute a maximum flow from src to dst and a minimum cut separating them
+	template<typename N, typename E>
+	[[nodiscard]] flow_cut<N, E> min_cut(graph<N, E> const& g, N const& src, N const& dst) {
+		if (!g.is_node(src) or !g.is_node(dst)) {
+			throw std::runtime_error("Cannot call gdwg::min_cut if src or dst node don't exist in the graph");
+		}
+		auto const snapshot = csr_graph<N, E>(g);
+		auto solver = max_flow<E>(snapshot);
+		auto result = flow_cut<N, E>{};
+		result.flow = solver.solve(*snapshot.index_of(src), *snapshot.index_of(dst));
+		auto const side = solver.source_side();
+		for (std::size_t u = 0; u < snapshot.node_count(); ++u) {
+			(side[u] ? result.source_side : result.sink_side).push_back(snapshot.node(u));
+		}
+		return result;
+	}
+} // namespace gdwg
+
+#endif // GDWG_FLOW_H
@@ -0,0 +1,158 @@
+#include "gdwg_flow.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+
+namespace {
+	// Edmonds-Karp over a dense capacity matrix, as an independent reference
+	int reference_max_flow(std::vector<std::vector<int>> capacity, std::size_t s, std::size_t t) {
+		auto const n = capacity.size();
+		auto flow = 0;
+		while (true) {
+			auto parent = std::vector<std::size_t>(n, n);
+			parent[s] = s;
+			auto queue = std::vector<std::size_t>{s};
+			for (std::size_t head = 0; head < queue.size() and parent[t] == n; ++head) {
+				auto const u = queue[head];
+				for (std::size_t v = 0; v < n; ++v) {
+					if (parent[v] == n and capacity[u][v] > 0) {
+						parent[v] = u;
+						queue.push_back(v);
+					}
+				}
+			}
+			if (parent[t] == n) {
+				return flow;
+			}
+			auto bottleneck = std::numeric_limits<int>::max();
+			for (auto v = t; v != s; v = parent[v]) {
+				bottleneck = std::min(bottleneck, capacity[parent[v]][v]);
+			}
+			for (auto v = t; v != s; v = parent[v]) {
+				capacity[parent[v]][v] -= bottleneck;
+				capacity[v][parent[v]] += bottleneck;
+			}
+			flow += bottleneck;
+		}
+	}
+} // namespace
+
+// Max-flow / min-cut tests
+TEST_CASE("Maximum flow of the textbook network", "[flow]") {
+	gdwg::graph<std::string, int> g;
+	for (auto const* v : {"s", "v1", "v2", "v3", "v4", "t"}) {
+		g.insert_node(v);
+	}
+	g.insert_edge("s", "v1", 16);
+	g.insert_edge("s", "v2", 13);
+	g.insert_edge("v1", "v3", 12);
+	g.insert_edge("v2", "v1", 4);
+	g.insert_edge("v2", "v4", 14);
+	g.insert_edge("v3", "v2", 9);
+	g.insert_edge("v3", "t", 20);
+	g.insert_edge("v4", "v3", 7);
+	g.insert_edge("v4", "t", 4);
+
+	auto const cut = gdwg::min_cut(g, std::string("s"), std::string("t"));
+	REQUIRE(cut.flow == 23);
+	REQUIRE(cut.source_side == std::vector<std::string>{"s", "v1", "v2", "v4"});
+	REQUIRE(cut.sink_side == std::vector<std::string>{"t", "v3"});
+
+	// The graph is left untouched
+	REQUIRE(g.find("s", "v1", 16) != g.end());
+}
+
+TEST_CASE("Maximum flow edge cases", "[flow]") {
+	SECTION("Unweighted edges have capacity 1 and parallel edges add up") {
+		gdwg::graph<int, int> g{1, 2, 3};
+		g.insert_edge(1, 2);
+		g.insert_edge(1, 2, 3);
+		g.insert_edge(2, 3, 10);
+		g.insert_edge(2, 2, 5);
+		REQUIRE(gdwg::min_cut(g, 1, 3).flow == 4);
+	}
+
+	SECTION("An unreachable sink gets no flow") {
+		gdwg::graph<int, int> g{1, 2, 3};
+		g.insert_edge(1, 2, 5);
+		g.insert_edge(3, 2, 5);
+		auto const cut = gdwg::min_cut(g, 1, 3);
+		REQUIRE(cut.flow == 0);
+		REQUIRE(cut.source_side == std::vector<int>{1, 2});
+		REQUIRE(cut.sink_side == std::vector<int>{3});
+	}
+
+	SECTION("The same node as source and sink") {
+		gdwg::graph<int, int> g{1, 2};
+		g.insert_edge(1, 2, 5);
+		REQUIRE(gdwg::min_cut(g, 1, 1).flow == 0);
+	}
+
+	SECTION("Floating capacities") {
+		gdwg::graph<int, double> g{1, 2, 3};
+		g.insert_edge(1, 2, 0.5);
+		g.insert_edge(1, 3, 0.25);
+		g.insert_edge(2, 3, 1.0);
+		REQUIRE(gdwg::min_cut(g, 1, 3).flow == Approx(0.75));
+	}
+
+	SECTION("Missing nodes and negative capacities throw") {
+		gdwg::graph<int, int> g{1, 2};
+		g.insert_edge(1, 2, -1);
+		REQUIRE_THROWS_WITH(gdwg::min_cut(g, 1, 3),
+		                    "Cannot call gdwg::min_cut if src or dst node don't exist in the graph");
+		REQUIRE_THROWS_WITH(gdwg::min_cut(g, 1, 2),
+		                    "Cannot construct gdwg::max_flow from a graph with negative edge weights");
+	}
+}
+
+TEST_CASE("Maximum flow agrees with Edmonds-Karp and the cut capacity on random graphs", "[flow]") {
+	auto rng = std::mt19937(32);
+	for (auto trial = 0; trial < 40; ++trial) {
+		auto const n = 2 + static_cast<int>(rng() % 30);
+		auto const edges = static_cast<int>(rng() % static_cast<unsigned>(n * 4));
+		gdwg::graph<int, int> g;
+		for (auto v = 0; v < n; ++v) {
+			g.insert_node(v);
+		}
+		auto capacity = std::vector<std::vector<int>>(static_cast<std::size_t>(n),
+		                                              std::vector<int>(static_cast<std::size_t>(n), 0));
+		for (auto e = 0; e < edges; ++e) {
+			auto const u = static_cast<int>(rng() % static_cast<unsigned>(n));
+			auto const v = static_cast<int>(rng() % static_cast<unsigned>(n));
+			auto const c = static_cast<int>(rng() % 20);
+			if (g.insert_edge(u, v, c) and u != v) {
+				capacity[static_cast<std::size_t>(u)][static_cast<std::size_t>(v)] += c;
+			}
+		}
+
+		// One solver answers many queries over the same capacities
+		auto const snapshot = gdwg::csr_graph<int, int>(g);
+		auto solver = gdwg::max_flow<int>(snapshot);
+		for (auto query = 0; query < 5; ++query) {
+			auto const s = rng() % static_cast<unsigned>(n);
+			auto const t = rng() % static_cast<unsigned>(n);
+			if (s == t) {
+				continue;
+			}
+			auto const flow = solver.solve(s, t);
+			REQUIRE(flow == reference_max_flow(capacity, s, t));
+
+			auto const side = solver.source_side();
+			REQUIRE(side[s]);
+			REQUIRE(!side[t]);
+			auto crossing = 0;
+			for (std::size_t u = 0; u < side.size(); ++u) {
+				for (std::size_t v = 0; v < side.size(); ++v) {
+					if (side[u] and !side[v]) {
+						crossing += capacity[u][v];
+					}
+				}
+			}
+			REQUIRE(crossing == flow);
+		}
+	}
+}
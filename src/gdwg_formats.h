@@ -0,0 +1,469 @@
+#ifndef GDWG_FORMATS_H
+#define GDWG_FORMATS_H
+
+#include "gdwg_builder.h"
+#include "gdwg_csr.h"
+#include "gdwg_edge_list.h"
+#include "gdwg_export.h"
+#include "gdwg_graph.h"
+#include "gdwg_mapped_file.h"
+#include "gdwg_parallel.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Matrix Market (.mtx) and DIMACS shortest-path (.gr) files
+//   %%MatrixMarket matrix coordinate real general      p sp <nodes> <arcs>
+//   % comments                                         c comments
+//   <rows> <columns> <entries>                         a <src> <dst> <weight>
+//   <row> <column> [value]
+// Nodes are the 1-based row, column or node numbers, and every number up to the matrix or problem size is a
+// node, isolated or not. The entries of symmetric matrices are stored once, so each off-diagonal entry i j v
+// is read as the two edges i -> j and j -> i, with -v for the second in skew-symmetric matrices. Pattern
+// matrices have unweighted edges; integer and real values become weights. Files are memory-mapped and their
+// entries parsed in parallel chunks into a graph_builder, as read_edge_list does
+namespace gdwg {
+	namespace detail {
+		// Node numbers and weights of Matrix Market and DIMACS files
+		template<typename T>
+		inline constexpr bool is_matrix_value = is_number<T> and !std::is_same_v<T, bool>;
+
+		enum class matrix_symmetry { general, symmetric, skew_symmetric };
+
+		struct matrix_market_header {
+			std::uint64_t rows = 0;
+			std::uint64_t columns = 0;
+			std::uint64_t entries = 0;
+			bool pattern = false;
+			matrix_symmetry symmetry = matrix_symmetry::general;
+			std::size_t body = 0; // Offset of the first line after the size line
+		};
+
+		struct dimacs_header {
+			std::uint64_t nodes = 0;
+			std::uint64_t arcs = 0;
+			std::size_t body = 0; // Offset of the first line after the problem line
+		};
+
+		// The edges parsed from one chunk, and how many entries or arcs they came from
+		template<typename N, typename E>
+		struct counted_part {
+			graph_builder<N, E> builder;
+			std::uint64_t entries = 0;
+		};
+
+		inline std::runtime_error format_error(std::string const& caller, std::string const& reason) {
+			return std::runtime_error("Cannot call gdwg::" + caller + ": " + reason);
+		}
+
+		// Return the line of text starting at pos, moving pos past its line break
+		inline std::string_view next_line(std::string_view text, std::size_t& pos) {
+			auto const end = find_newline(text, pos, text.size());
+			auto const line = text.substr(pos, end - pos);
+			pos = std::min(text.size(), end + 1);
+			return line;
+		}
+
+		inline std::vector<std::string> lowercase_tokens(std::string_view line) {
+			auto tokens = std::vector<std::string>{};
+			for (auto const* p = line.data(), *end = line.data() + line.size(); p != end;) {
+				if (is_blank(*p)) {
+					++p;
+					continue;
+				}
+				auto& token = tokens.emplace_back();
+				for (; p != end and !is_blank(*p); ++p) {
+					token.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(*p))));
+				}
+			}
+			return tokens;
+		}
+
+		// Parse a line holding exactly the given numbers
+		template<typename... T>
+		bool parse_numbers(std::string_view line, T&... values) {
+			auto const* p = line.data();
+			auto const* const end = line.data() + line.size();
+			for (; p != end and is_blank(*p); ++p) {
+			}
+			return (parse_number(p, end, values) and ...) and p == end;
+		}
+
+		inline bool is_blank_line(std::string_view line) {
+			return std::all_of(line.begin(), line.end(), is_blank);
+		}
+
+		inline matrix_market_header read_matrix_market_header(std::string_view text, std::string const& caller) {
+			auto header = matrix_market_header{};
+			auto const banner = lowercase_tokens(next_line(text, header.body));
+			if (banner.size() != 5 or banner[0] != "%%matrixmarket" or banner[1] != "matrix") {
+				throw format_error(caller, "missing %%MatrixMarket matrix header");
+			}
+			if (banner[2] != "coordinate") {
+				throw format_error(caller, "only coordinate matrices are supported, not " + banner[2]);
+			}
+			if (banner[3] == "pattern") {
+				header.pattern = true;
+			}
+			else if (banner[3] != "real" and banner[3] != "double" and banner[3] != "integer") {
+				throw format_error(caller, "unsupported field " + banner[3]);
+			}
+			if (banner[4] == "symmetric") {
+				header.symmetry = matrix_symmetry::symmetric;
+			}
+			else if (banner[4] == "skew-symmetric" and !header.pattern) {
+				header.symmetry = matrix_symmetry::skew_symmetric;
+			}
+			else if (banner[4] != "general") {
+				throw format_error(caller, "unsupported symmetry " + banner[4]);
+			}
+
+			while (header.body < text.size()) {
+				auto const line = next_line(text, header.body);
+				if (is_blank_line(line) or line.front() == '%') {
+					continue;
+				}
+				if (!parse_numbers(line, header.rows, header.columns, header.entries)) {
+					throw format_error(caller, "malformed size line: " + std::string(line));
+				}
+				return header;
+			}
+			throw format_error(caller, "missing size line");
+		}
+
+		inline dimacs_header read_dimacs_header(std::string_view text, std::string const& caller) {
+			auto header = dimacs_header{};
+			while (header.body < text.size()) {
+				auto const line = next_line(text, header.body);
+				if (is_blank_line(line) or line.front() == 'c') {
+					continue;
+				}
+				auto const tokens = lowercase_tokens(line);
+				if (tokens.size() != 4 or tokens[0] != "p" or tokens[1] != "sp"
+				    or !parse_numbers(tokens[2], header.nodes) or !parse_numbers(tokens[3], header.arcs)) {
+					throw format_error(caller, "malformed problem line: " + std::string(line));
+				}
+				return header;
+			}
+			throw format_error(caller, "missing problem line \"p sp <nodes> <arcs>\"");
+		}
+
+		// Check the entry count against the header, then add the nodes 1..n and the parsed edges to builder
+		template<typename N, typename E>
+		void merge_counted(std::vector<counted_part<N, E>>& parts,
+		                   std::uint64_t n,
+		                   std::uint64_t expected,
+		                   graph_builder<N, E>& builder,
+		                   thread_pool& pool,
+		                   std::string const& caller,
+		                   std::string const& what) {
+			auto found = std::uint64_t{0};
+			auto builders = std::vector<graph_builder<N, E>>{};
+			builders.reserve(parts.size());
+			for (auto& part : parts) {
+				found += part.entries;
+				builders.push_back(std::move(part.builder));
+			}
+			if (found != expected) {
+				throw format_error(caller,
+				                   "the header promises " + std::to_string(expected) + " " + what + " but there are "
+				                      + std::to_string(found));
+			}
+			for (auto v = std::uint64_t{1}; v <= n; ++v) {
+				builder.insert_node(static_cast<N>(v));
+			}
+			builder.merge(builders, pool);
+		}
+
+		template<typename N>
+		void check_node_range(std::uint64_t n, std::string const& caller) {
+			if constexpr (std::is_integral_v<N>) {
+				if (!std::in_range<N>(n)) {
+					throw format_error(caller, "node " + std::to_string(n) + " does not fit the node type");
+				}
+			}
+		}
+
+		template<typename N, typename E>
+		void parse_matrix_market_text(std::string_view text,
+		                              graph_builder<N, E>& builder,
+		                              edge_list_options const& options,
+		                              thread_pool& pool,
+		                              std::string const& caller) {
+			static_assert(is_matrix_value<N> and is_matrix_value<E>, "Matrix Market nodes and weights are numbers");
+			auto const header = read_matrix_market_header(text, caller);
+			auto const n = std::max(header.rows, header.columns);
+			check_node_range<N>(n, caller);
+			if constexpr (!std::is_signed_v<E>) {
+				if (header.symmetry == matrix_symmetry::skew_symmetric) {
+					throw format_error(caller, "a skew-symmetric matrix needs a signed weight type");
+				}
+			}
+
+			auto parts = parse_lines<counted_part<N, E>>(
+			   text, header.body, options, pool, caller, [&header](std::string_view line, counted_part<N, E>& part) {
+				   auto const* p = line.data();
+				   auto const* const end = line.data() + line.size();
+				   for (; p != end and is_blank(*p); ++p) {
+				   }
+				   if (p == end or *p == '%') {
+					   return true;
+				   }
+				   auto row = std::uint64_t{0};
+				   auto column = std::uint64_t{0};
+				   if (!parse_number(p, end, row) or !parse_number(p, end, column) or row == 0
+				       or row > header.rows or column == 0 or column > header.columns) {
+					   return false;
+				   }
+				   auto const src = static_cast<N>(row);
+				   auto const dst = static_cast<N>(column);
+				   auto const mirrored = row != column and header.symmetry != matrix_symmetry::general;
+				   ++part.entries;
+				   if (header.pattern) {
+					   if (p != end) {
+						   return false;
+					   }
+					   part.builder.insert_edge(src, dst);
+					   if (mirrored) {
+						   part.builder.insert_edge(dst, src);
+					   }
+					   return true;
+				   }
+				   auto weight = E{};
+				   if (!parse_number(p, end, weight) or p != end) {
+					   return false;
+				   }
+				   part.builder.insert_edge(src, dst, weight);
+				   if (mirrored) {
+					   auto mirror = weight;
+					   if constexpr (std::is_signed_v<E>) {
+						   if (header.symmetry == matrix_symmetry::skew_symmetric) {
+							   mirror = static_cast<E>(-weight);
+						   }
+					   }
+					   part.builder.insert_edge(dst, src, mirror);
+				   }
+				   return true;
+			   });
+			merge_counted(parts, n, header.entries, builder, pool, caller, "entries");
+		}
+
+		template<typename N, typename E>
+		void parse_dimacs_text(std::string_view text,
+		                       graph_builder<N, E>& builder,
+		                       edge_list_options const& options,
+		                       thread_pool& pool,
+		                       std::string const& caller) {
+			static_assert(is_matrix_value<N> and is_matrix_value<E>, "DIMACS files hold numeric nodes and weights");
+			auto const header = read_dimacs_header(text, caller);
+			check_node_range<N>(header.nodes, caller);
+
+			auto parts = parse_lines<counted_part<N, E>>(
+			   text, header.body, options, pool, caller, [&header](std::string_view line, counted_part<N, E>& part) {
+				   auto const* p = line.data();
+				   auto const* const end = line.data() + line.size();
+				   for (; p != end and is_blank(*p); ++p) {
+				   }
+				   if (p == end or *p == 'c') {
+					   return true;
+				   }
+				   if (*p != 'a' or ++p == end or !is_blank(*p)) {
+					   return false;
+				   }
+				   for (; p != end and is_blank(*p); ++p) {
+				   }
+				   auto src = std::uint64_t{0};
+				   auto dst = std::uint64_t{0};
+				   auto weight = E{};
+				   if (!parse_number(p, end, src) or !parse_number(p, end, dst) or !parse_number(p, end, weight)
+				       or p != end or src == 0 or src > header.nodes or dst == 0 or dst > header.nodes) {
+					   return false;
+				   }
+				   ++part.entries;
+				   part.builder.insert_edge(static_cast<N>(src), static_cast<N>(dst), weight);
+				   return true;
+			   });
+			merge_counted(parts, header.nodes, header.arcs, builder, pool, caller, "arcs");
+		}
+
+		// Write every edge as "<prefix><src> <dst>[ <weight>]" with 1-based node positions
+		// Unweighted edges are written with weight 1 when weights are written at all
+		template<typename N, typename E>
+		void
+		write_matrix_entries(text_writer& out, csr_graph<N, E> const& g, std::string_view prefix, bool weights) {
+			auto const& offsets = g.offsets();
+			auto const& targets = g.targets();
+			auto const& edge_weights = g.edge_weights();
+			for (std::size_t u = 0; u < g.node_count(); ++u) {
+				for (auto e = offsets[u]; e < offsets[u + 1]; ++e) {
+					out.put(prefix);
+					out.put_value(u + 1, text_format::plain);
+					out.put(' ');
+					out.put_value(targets[e] + 1, text_format::plain);
+					if (weights) {
+						out.put(' ');
+						out.put_value(edge_weights[e] ? *edge_weights[e] : E{1}, text_format::plain);
+					}
+					out.put('\n');
+				}
+			}
+		}
+
+		inline constexpr auto matrix_block_size = std::size_t{1} << 20;
+	} // namespace detail
+
+	// Parse a Matrix Market file held in memory, adding its nodes and edges to builder
+	template<typename N, typename E>
+	void parse_matrix_market(std::string_view text,
+	                         graph_builder<N, E>& builder,
+	                         edge_list_options const& options = {},
+	                         thread_pool& pool = default_thread_pool()) {
+		detail::parse_matrix_market_text(text, builder, options, pool, "parse_matrix_market");
+	}
+
+	// Parse a Matrix Market file held in memory into a graph
+	template<typename N, typename E>
+	graph<N, E> parse_matrix_market(std::string_view text,
+	                                edge_list_options const& options = {},
+	                                thread_pool& pool = default_thread_pool()) {
+		auto builder = graph_builder<N, E>{};
+		parse_matrix_market(text, builder, options, pool);
+		return builder.build(pool);
+	}
+
+	// Read a Matrix Market file, adding its nodes and edges to builder
+	template<typename N, typename E>
+	void read_matrix_market(std::string const& path,
+	                        graph_builder<N, E>& builder,
+	                        edge_list_options const& options = {},
+	                        thread_pool& pool = default_thread_pool()) {
+		auto const file = detail::mapped_file(path);
+		auto const text = std::string_view(reinterpret_cast<char const*>(file.data()), file.size());
+		detail::parse_matrix_market_text(text, builder, options, pool, "read_matrix_market");
+	}
+
+	// Read a Matrix Market file into a graph
+	template<typename N, typename E>
+	graph<N, E> read_matrix_market(std::string const& path,
+	                               edge_list_options const& options = {},
+	                               thread_pool& pool = default_thread_pool()) {
+		auto builder = graph_builder<N, E>{};
+		read_matrix_market(path, builder, options, pool);
+		return builder.build(pool);
+	}
+
+	// Parse a DIMACS shortest-path file held in memory, adding its nodes and arcs to builder
+	template<typename N, typename E>
+	void parse_dimacs(std::string_view text,
+	                  graph_builder<N, E>& builder,
+	                  edge_list_options const& options = {},
+	                  thread_pool& pool = default_thread_pool()) {
+		detail::parse_dimacs_text(text, builder, options, pool, "parse_dimacs");
+	}
+
+	// Parse a DIMACS shortest-path file held in memory into a graph
+	template<typename N, typename E>
+	graph<N, E> parse_dimacs(std::string_view text,
+	                         edge_list_options const& options = {},
+	                         thread_pool& pool = default_thread_pool()) {
+		auto builder = graph_builder<N, E>{};
+		parse_dimacs(text, builder, options, pool);
+		return builder.build(pool);
+	}
+
+	// Read a DIMACS shortest-path file, adding its nodes and arcs to builder
+	template<typename N, typename E>
+	void read_dimacs(std::string const& path,
+	                 graph_builder<N, E>& builder,
+	                 edge_list_options const& options = {},
+	                 thread_pool& pool = default_thread_pool()) {
+		auto const file = detail::mapped_file(path);
+		auto const text = std::string_view(reinterpret_cast<char const*>(file.data()), file.size());
+		detail::parse_dimacs_text(text, builder, options, pool, "read_dimacs");
+	}
+
+	// Read a DIMACS shortest-path file into a graph
+	template<typename N, typename E>
+	graph<N, E> read_dimacs(std::string const& path,
+	                        edge_list_options const& options = {},
+	                        thread_pool& pool = default_thread_pool()) {
+		auto builder = graph_builder<N, E>{};
+		read_dimacs(path, builder, options, pool);
+		return builder.build(pool);
+	}
+
+	// Write a snapshot as a general coordinate Matrix Market file, numbering the nodes 1..n in snapshot order
+	// A graph without weighted edges is written as a pattern matrix; otherwise unweighted edges get weight 1
+	template<typename N, typename E>
+	void write_matrix_market(csr_graph<N, E> const& g, std::ostream& os) {
+		static_assert(detail::is_matrix_value<E>, "Matrix Market files hold numeric weights");
+		auto const& weights = g.edge_weights();
+		auto const weighted = std::any_of(weights.begin(), weights.end(), [](auto const& w) { return w.has_value(); });
+		auto out = detail::text_writer(os, detail::matrix_block_size, "write_matrix_market");
+		out.put("%%MatrixMarket matrix coordinate ");
+		out.put(!weighted ? "pattern" : std::is_integral_v<E> ? "integer" : "real");
+		out.put(" general\n");
+		out.put_value(g.node_count(), detail::text_format::plain);
+		out.put(' ');
+		out.put_value(g.node_count(), detail::text_format::plain);
+		out.put(' ');
+		out.put_value(g.edge_count(), detail::text_format::plain);
+		out.put('\n');
+		detail::write_matrix_entries(out, g, "", weighted);
+		out.flush();
+	}
+
+	// Write a graph as a Matrix Market file, numbering its nodes 1..n in ascending order
+	template<typename N, typename E>
+	void write_matrix_market(graph<N, E> const& g, std::ostream& os) {
+		write_matrix_market(csr_graph<N, E>(g), os);
+	}
+
+	// Save a graph as a Matrix Market file
+	template<typename N, typename E>
+	void save_matrix_market(graph<N, E> const& g, std::string const& path) {
+		auto out = detail::open_export(path, "save_matrix_market");
+		write_matrix_market(g, out);
+		detail::close_export(out, path, "save_matrix_market");
+	}
+
+	// Write a snapshot as a DIMACS shortest-path file, numbering the nodes 1..n in snapshot order
+	// Every DIMACS arc has a weight, so unweighted edges are written with weight 1
+	template<typename N, typename E>
+	void write_dimacs(csr_graph<N, E> const& g, std::ostream& os) {
+		static_assert(detail::is_matrix_value<E>, "DIMACS files hold numeric weights");
+		auto out = detail::text_writer(os, detail::matrix_block_size, "write_dimacs");
+		out.put("p sp ");
+		out.put_value(g.node_count(), detail::text_format::plain);
+		out.put(' ');
+		out.put_value(g.edge_count(), detail::text_format::plain);
+		out.put('\n');
+		detail::write_matrix_entries(out, g, "a ", true);
+		out.flush();
+	}
+
+	// Write a graph as a DIMACS shortest-path file, numbering its nodes 1..n in ascending order
+	template<typename N, typename E>
+	void write_dimacs(graph<N, E> const& g, std::ostream& os) {
+		write_dimacs(csr_graph<N, E>(g), os);
+	}
+
+	// Save a graph as a DIMACS shortest-path file
+	template<typename N, typename E>
+	void save_dimacs(graph<N, E> const& g, std::string const& path) {
+		auto out = detail::open_export(path, "save_dimacs");
+		write_dimacs(g, out);
+		detail::close_export(out, path, "save_dimacs");
+	}
+} // namespace gdwg
+
+#endif // GDWG_FORMATS_H
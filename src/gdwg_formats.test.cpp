@@ -0,0 +1,186 @@
+#include "gdwg_formats.h"
+#include "gdwg_testing.h"
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <sstream>
+
+namespace {
+	using gdwg::testing::print;
+	using gdwg::testing::scratch_directory;
+
+	template<typename N, typename E>
+	std::vector<std::tuple<N, N, std::optional<E>>> edges_of(gdwg::graph<N, E> const& g) {
+		auto edges = std::vector<std::tuple<N, N, std::optional<E>>>{};
+		for (auto const& [from, to, weight] : g) {
+			edges.emplace_back(from, to, weight);
+		}
+		return edges;
+	}
+
+	template<typename N, typename E>
+	std::vector<N> nodes_of(gdwg::graph<N, E> g) {
+		return g.nodes();
+	}
+} // namespace
+
+// Matrix Market and DIMACS tests
+TEST_CASE("Matrix Market coordinate matrices", "[formats]") {
+	SECTION("A general real matrix, with comments, blank lines and an isolated node") {
+		auto const g = gdwg::parse_matrix_market<int, double>("%%MatrixMarket Matrix Coordinate Real General\n"
+		                                                      "% a comment\n"
+		                                                      "%\n"
+		                                                      "\n"
+		                                                      "4 3 3\n"
+		                                                      "1 2 0.5\n"
+		                                                      "  3   1   -2e3  \r\n"
+		                                                      "\n"
+		                                                      "4 3 7\n");
+		REQUIRE(nodes_of(g) == std::vector<int>{1, 2, 3, 4});
+		REQUIRE(edges_of(g)
+		        == std::vector<std::tuple<int, int, std::optional<double>>>{{1, 2, 0.5}, {3, 1, -2000.0}, {4, 3, 7.0}});
+	}
+
+	SECTION("Symmetric entries are mirrored, except on the diagonal") {
+		auto const g = gdwg::parse_matrix_market<int, long>("%%MatrixMarket matrix coordinate integer symmetric\n"
+		                                                    "3 3 3\n"
+		                                                    "2 1 5\n"
+		                                                    "3 3 9\n"
+		                                                    "3 1 -1\n");
+		REQUIRE(edges_of(g)
+		        == std::vector<std::tuple<int, int, std::optional<long>>>{
+		           {1, 2, 5}, {1, 3, -1}, {2, 1, 5}, {3, 1, -1}, {3, 3, 9}});
+	}
+
+	SECTION("Skew-symmetric entries are mirrored with their negation") {
+		auto const g = gdwg::parse_matrix_market<int, float>("%%MatrixMarket matrix coordinate real skew-symmetric\n"
+		                                                     "2 2 1\n"
+		                                                     "2 1 1.5\n");
+		REQUIRE(edges_of(g) == std::vector<std::tuple<int, int, std::optional<float>>>{{1, 2, -1.5f}, {2, 1, 1.5f}});
+		REQUIRE_THROWS_WITH((gdwg::parse_matrix_market<int, unsigned>("%%MatrixMarket matrix coordinate integer "
+		                                                              "skew-symmetric\n2 2 1\n2 1 1\n")),
+		                    "Cannot call gdwg::parse_matrix_market: a skew-symmetric matrix needs a signed weight "
+		                    "type");
+	}
+
+	SECTION("Pattern matrices have unweighted edges") {
+		auto const g = gdwg::parse_matrix_market<unsigned, double>("%%MatrixMarket matrix coordinate pattern "
+		                                                           "symmetric\n2 2 2\n1 1\n2 1\n");
+		REQUIRE(print(g) == "\n1 (\n  1 -> 1 | U\n  1 -> 2 | U\n)\n2 (\n  2 -> 1 | U\n)\n");
+	}
+
+	SECTION("Malformed files") {
+		auto const error = [](std::string const& text) {
+			try {
+				static_cast<void>(gdwg::parse_matrix_market<int, int>(text));
+			} catch (std::runtime_error const& e) {
+				return std::string(e.what());
+			}
+			return std::string();
+		};
+		auto const prefix = std::string("Cannot call gdwg::parse_matrix_market: ");
+		REQUIRE(error("1 1 0\n") == prefix + "missing %%MatrixMarket matrix header");
+		REQUIRE(error("%%MatrixMarket matrix array real general\n1 1\n1\n")
+		        == prefix + "only coordinate matrices are supported, not array");
+		REQUIRE(error("%%MatrixMarket matrix coordinate complex general\n") == prefix + "unsupported field complex");
+		REQUIRE(error("%%MatrixMarket matrix coordinate integer hermitian\n")
+		        == prefix + "unsupported symmetry hermitian");
+		REQUIRE(error("%%MatrixMarket matrix coordinate integer general\n% nothing else\n")
+		        == prefix + "missing size line");
+		REQUIRE(error("%%MatrixMarket matrix coordinate integer general\n2 2\n")
+		        == prefix + "malformed size line: 2 2");
+		REQUIRE(error("%%MatrixMarket matrix coordinate integer general\n2 2 2\n1 2 3\n")
+		        == prefix + "the header promises 2 entries but there are 1");
+		REQUIRE(error("%%MatrixMarket matrix coordinate integer general\n2 2 2\n1 2 3\n3 1 1\n")
+		        == prefix + "malformed line 4: 3 1 1");
+		REQUIRE(error("%%MatrixMarket matrix coordinate integer general\n2 2 1\n1 2 0.5\n")
+		        == prefix + "malformed line 3: 1 2 0.5");
+		REQUIRE(error("%%MatrixMarket matrix coordinate integer general\n3000000000 1 0\n")
+		        == prefix + "node 3000000000 does not fit the node type");
+	}
+}
+
+TEST_CASE("DIMACS shortest-path files", "[formats]") {
+	auto const g = gdwg::parse_dimacs<long, int>("c 9th DIMACS challenge\n"
+	                                             "p sp 4 3\n"
+	                                             "c arcs follow\n"
+	                                             "a 1 2 7\n"
+	                                             "a\t2 1 7\n"
+	                                             "\n"
+	                                             "a 4 4 0\n");
+	REQUIRE(nodes_of(g) == std::vector<long>{1, 2, 3, 4});
+	REQUIRE(edges_of(g) == std::vector<std::tuple<long, long, std::optional<int>>>{{1, 2, 7}, {2, 1, 7}, {4, 4, 0}});
+
+	REQUIRE_THROWS_WITH((gdwg::parse_dimacs<int, int>("c only comments\n")),
+	                    "Cannot call gdwg::parse_dimacs: missing problem line \"p sp <nodes> <arcs>\"");
+	REQUIRE_THROWS_WITH((gdwg::parse_dimacs<int, int>("p max 2 1\na 1 2 1\n")),
+	                    "Cannot call gdwg::parse_dimacs: malformed problem line: p max 2 1");
+	REQUIRE_THROWS_WITH((gdwg::parse_dimacs<int, int>("p sp 2 2\na 1 2 1\n")),
+	                    "Cannot call gdwg::parse_dimacs: the header promises 2 arcs but there are 1");
+	REQUIRE_THROWS_WITH((gdwg::parse_dimacs<int, int>("p sp 2 1\na 1 3 1\n")),
+	                    "Cannot call gdwg::parse_dimacs: malformed line 2: a 1 3 1");
+	REQUIRE_THROWS_WITH((gdwg::parse_dimacs<int, int>("p sp 2 1\nn 1 s\n")),
+	                    "Cannot call gdwg::parse_dimacs: malformed line 2: n 1 s");
+	REQUIRE_THROWS_WITH((gdwg::parse_dimacs<int, int>("p sp 2 1\na 1 2\n")),
+	                    "Cannot call gdwg::parse_dimacs: malformed line 2: a 1 2");
+}
+
+TEST_CASE("Writing and reading back Matrix Market and DIMACS files", "[formats]") {
+	auto g = gdwg::graph<int, double>{};
+	auto rng = std::mt19937(7);
+	for (auto v = 1; v <= 300; ++v) {
+		g.insert_node(v);
+	}
+	for (auto e = 0; e < 3000; ++e) {
+		g.insert_edge(static_cast<int>(rng() % 300) + 1,
+		              static_cast<int>(rng() % 300) + 1,
+		              static_cast<double>(rng() % 1000) / 8 - 60);
+	}
+	auto pool = gdwg::thread_pool(4);
+	auto const small_chunks = gdwg::edge_list_options{.chunk_size = 64};
+
+	SECTION("Matrix Market") {
+		auto out = std::ostringstream{};
+		gdwg::write_matrix_market(g, out);
+		REQUIRE(out.str().starts_with("%%MatrixMarket matrix coordinate real general\n300 300 3000\n"));
+		REQUIRE(print(gdwg::parse_matrix_market<int, double>(out.str(), small_chunks, pool)) == print(g));
+		REQUIRE(print(gdwg::parse_matrix_market<int, double>(out.str())) == print(g));
+	}
+
+	SECTION("DIMACS") {
+		auto out = std::ostringstream{};
+		gdwg::write_dimacs(g, out);
+		REQUIRE(out.str().starts_with("p sp 300 3000\na 1 "));
+		REQUIRE(print(gdwg::parse_dimacs<int, double>(out.str(), small_chunks, pool)) == print(g));
+	}
+
+	SECTION("Nodes are renumbered 1..n, and unweighted edges are a pattern or get weight 1") {
+		auto sparse = gdwg::graph<std::string, int>{};
+		for (auto const* node : {"x", "y", "z"}) {
+			sparse.insert_node(node);
+		}
+		sparse.insert_edge("z", "x");
+		sparse.insert_edge("x", "y");
+		auto out = std::ostringstream{};
+		gdwg::write_matrix_market(sparse, out);
+		REQUIRE(out.str() == "%%MatrixMarket matrix coordinate pattern general\n3 3 2\n1 2\n3 1\n");
+		sparse.insert_edge("y", "y", -4);
+		out.str("");
+		gdwg::write_matrix_market(sparse, out);
+		REQUIRE(out.str() == "%%MatrixMarket matrix coordinate integer general\n3 3 3\n1 2 1\n2 2 -4\n3 1 1\n");
+		out.str("");
+		gdwg::write_dimacs(sparse, out);
+		REQUIRE(out.str() == "p sp 3 3\na 1 2 1\na 2 2 -4\na 3 1 1\n");
+	}
+
+	SECTION("Files") {
+		auto const directory = scratch_directory("formats");
+		gdwg::save_matrix_market(g, directory.file("g.mtx"));
+		gdwg::save_dimacs(g, directory.file("g.gr"));
+		REQUIRE(print(gdwg::read_matrix_market<int, double>(directory.file("g.mtx"))) == print(g));
+		auto builder = gdwg::graph_builder<int, double>{};
+		gdwg::read_dimacs(directory.file("g.gr"), builder, small_chunks, pool);
+		REQUIRE(print(builder.build(pool)) == print(g));
+	}
+}
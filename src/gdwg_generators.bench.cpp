@@ -0,0 +1,46 @@
+#include "gdwg_bench.h"
+#include "gdwg_generators.h"
+
+#include <bit>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+// Generation throughput of the synthetic graph generators, into a graph_builder and on to a graph
+// Usage: gdwg_generators_bench [edges] [average degree] [threads]
+auto main(int argc, char** argv) -> int {
+	auto const edges = gdwg::bench::argument(argc, argv, 1, 1 << 22);
+	auto const degree = gdwg::bench::argument(argc, argv, 2, 16);
+	auto pool = gdwg::thread_pool(gdwg::bench::argument(argc, argv, 3, 0));
+	auto const nodes = edges / degree;
+	auto const scale = static_cast<std::size_t>(std::bit_width(nodes - 1));
+	auto const side = static_cast<std::size_t>(std::sqrt(static_cast<double>(edges / 2)));
+	auto const options = gdwg::generator_options{.shuffle_ids = true, .max_weight = 100};
+
+	auto report = [&](std::string const& name, auto generate) {
+		auto builder = gdwg::graph_builder<std::size_t, int>{};
+		auto seconds = gdwg::bench::best_of(3, [&] {
+			builder = {};
+			generate(builder);
+		});
+		auto const generated = builder.edge_count();
+		gdwg::bench::report(std::cout,
+		                    name + "/generate",
+		                    {{"edges", static_cast<double>(generated)}, {"threads", static_cast<double>(pool.size())}},
+		                    seconds,
+		                    {{"edges_per_second", static_cast<double>(generated) / seconds}});
+		seconds = gdwg::bench::best_of(1, [&] { static_cast<void>(builder.build(pool)); });
+		gdwg::bench::report(std::cout,
+		                    name + "/build",
+		                    {{"edges", static_cast<double>(generated)}, {"threads", static_cast<double>(pool.size())}},
+		                    seconds,
+		                    {{"edges_per_second", static_cast<double>(generated) / seconds}});
+	};
+	report("rmat", [&](auto& b) { gdwg::generate_rmat(b, scale, edges, {}, options, pool); });
+	report("gnp", [&](auto& b) {
+		gdwg::generate_gnp(b, nodes, static_cast<double>(degree) / static_cast<double>(nodes), options, pool);
+	});
+	report("gnm", [&](auto& b) { gdwg::generate_gnm(b, nodes, edges, options, pool); });
+	report("grid", [&](auto& b) { gdwg::generate_grid(b, side, side, 1.0, options, pool); });
+	report("barabasi_albert", [&](auto& b) { gdwg::generate_barabasi_albert(b, nodes, degree, options, pool); });
+}
@@ -0,0 +1,356 @@
+#ifndef GDWG_GENERATORS_H
+#define GDWG_GENERATORS_H
+
+#include "gdwg_builder.h"
+#include "gdwg_parallel.h"
+#include "gdwg_walks.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Synthetic graphs for tests and benchmarks, generated in parallel straight into a graph_builder
+// Nodes are 0..n-1 converted to N. Every edge (or row, for G(n, p) and grids) draws from its own random stream
+// derived from the seed, so a seed always gives the same graph, whatever the number of workers or chunk size
+namespace gdwg {
+	struct generator_options {
+		std::uint64_t seed = 6771;
+		bool symmetric = false; // Store every edge in both directions, as an undirected graph
+		bool shuffle_ids = false; // Number the nodes by a pseudo-random permutation instead of generation order
+		double max_weight = 0.0; // If at least 1, every edge gets a uniform random weight in [1, max_weight]
+		std::size_t chunk_size = std::size_t{1} << 16; // Edges generated by one task
+	};
+
+	// R-MAT quadrant probabilities; the fourth is 1 - a - b - c. The defaults are Graph500's
+	struct rmat_parameters {
+		double a = 0.57;
+		double b = 0.19;
+		double c = 0.19;
+	};
+
+	namespace detail {
+		// Pseudo-random permutation of [0, n): a four-round Feistel network over the smallest even number of bits
+		// that covers n, cycle-walking until the result falls inside the range
+		class id_permutation {
+		 public:
+			id_permutation(std::size_t n, std::uint64_t seed, bool enabled) noexcept
+			: n_(n)
+			, enabled_(enabled) {
+				while (half_bits_ < 32 and (std::uint64_t{1} << (2 * half_bits_)) < n) {
+					++half_bits_;
+				}
+				mask_ = (std::uint64_t{1} << half_bits_) - 1;
+				auto rng = walk_rng(seed ^ 0x5851f42d4c957f2dULL); // Salted so the keys differ from the edge streams
+				for (auto& key : keys_) {
+					key = rng.next();
+				}
+			}
+
+			[[nodiscard]] std::size_t operator()(std::size_t i) const noexcept {
+				if (!enabled_) {
+					return i;
+				}
+				do {
+					i = encrypt(i);
+				} while (i >= n_);
+				return i;
+			}
+
+		 private:
+			[[nodiscard]] std::uint64_t encrypt(std::uint64_t i) const noexcept {
+				auto left = i >> half_bits_;
+				auto right = i & mask_;
+				for (auto key : keys_) {
+					auto const next = left ^ (walk_rng(key ^ right).next() & mask_);
+					left = right;
+					right = next;
+				}
+				return (left << half_bits_) | right;
+			}
+
+			std::size_t n_;
+			bool enabled_;
+			unsigned half_bits_ = 0;
+			std::uint64_t mask_ = 0;
+			std::array<std::uint64_t, 4> keys_ = {};
+		};
+
+		// Check what every generator needs: nodes that fit N, and an arithmetic E if weights are asked for
+		template<typename N, typename E>
+		void check_generator(std::size_t nodes, generator_options const& options, std::string const& caller) {
+			if constexpr (std::is_integral_v<N>) {
+				if (nodes > 0 and !std::in_range<N>(nodes - 1)) {
+					throw std::runtime_error("Cannot call gdwg::" + caller + ": node " + std::to_string(nodes - 1)
+					                         + " does not fit the node type");
+				}
+			}
+			if (options.max_weight >= 1.0 and !std::is_arithmetic_v<E>) {
+				throw std::runtime_error("Cannot call gdwg::" + caller + ": random weights need an arithmetic weight "
+				                         "type");
+			}
+		}
+
+		// Weight of an edge drawn from rng, or none if the options do not ask for weights
+		template<typename E>
+		std::optional<E> random_weight(walk_rng& rng, generator_options const& options) {
+			if (options.max_weight < 1.0) {
+				return std::nullopt;
+			}
+			if constexpr (std::is_integral_v<E>) {
+				return static_cast<E>(1 + rng.below(static_cast<std::size_t>(options.max_weight)));
+			}
+			else if constexpr (std::is_floating_point_v<E>) {
+				return static_cast<E>(1.0 + rng.uniform() * (options.max_weight - 1.0));
+			}
+			else {
+				return std::nullopt; // Rejected by check_generator
+			}
+		}
+
+		// Add the edge src -> dst, and dst -> src if the graph is symmetric, with a weight drawn from rng
+		template<typename N, typename E>
+		void add_generated_edge(graph_builder<N, E>& part,
+		                        std::size_t src,
+		                        std::size_t dst,
+		                        walk_rng& rng,
+		                        generator_options const& options) {
+			auto weight = random_weight<E>(rng, options);
+			if (options.symmetric) {
+				part.insert_edge(static_cast<N>(dst), static_cast<N>(src), weight);
+			}
+			part.insert_edge(static_cast<N>(src), static_cast<N>(dst), std::move(weight));
+		}
+
+		// Insert the nodes 0..nodes-1 and call generate(first, last, part) for chunks of [0, items), each task
+		// filling its own builder; the parts are then merged into builder
+		template<typename N, typename E, typename Generate>
+		void generate_parts(graph_builder<N, E>& builder,
+		                    std::size_t nodes,
+		                    std::size_t items,
+		                    std::size_t items_per_chunk,
+		                    generator_options const& options,
+		                    thread_pool& pool,
+		                    Generate generate) {
+			auto const nodes_per_chunk = std::max<std::size_t>(1, options.chunk_size);
+			items_per_chunk = std::max<std::size_t>(1, items_per_chunk);
+			auto const node_chunks = (nodes + nodes_per_chunk - 1) / nodes_per_chunk;
+			auto const item_chunks = (items + items_per_chunk - 1) / items_per_chunk;
+			auto parts = std::vector<graph_builder<N, E>>(node_chunks + item_chunks);
+			pool.run(parts.size(), [&](std::size_t c, std::size_t) {
+				auto& part = parts[c];
+				if (c < node_chunks) {
+					auto const first = c * nodes_per_chunk;
+					for (auto v = first; v < std::min(nodes, first + nodes_per_chunk); ++v) {
+						part.insert_node(static_cast<N>(v));
+					}
+				}
+				else {
+					auto const first = (c - node_chunks) * items_per_chunk;
+					generate(first, std::min(items, first + items_per_chunk), part);
+				}
+			});
+			builder.merge(parts, pool);
+		}
+
+		// Target of edge k of a Barabási–Albert graph in which node s >= 1 adds edges (s - 1) * d .. s * d - 1
+		// The edges form a virtual list of endpoints: slot 0 holds node 0, and edge k fills slot 2k + 1 with its
+		// source and slot 2k + 2 with its target. Edge k copies a uniformly chosen earlier slot, so nodes are
+		// picked in proportion to their degree; copying a target slot recomputes that edge's target from its own
+		// stream, a chain that is two steps long on average (Sanders and Schulz)
+		inline std::size_t barabasi_albert_target(std::uint64_t seed, std::size_t d, std::size_t k) {
+			auto const source = k / d + 1;
+			auto rng = walk_rng::for_walk(seed, k);
+			for (;;) {
+				auto const slot = rng.below(2 * k + 1);
+				auto const node = slot == 0       ? std::size_t{0}
+				                  : slot % 2 == 1 ? (slot - 1) / 2 / d + 1
+				                                  : barabasi_albert_target(seed, d, slot / 2 - 1);
+				if (node != source) {
+					return node; // Self loops are drawn again
+				}
+			}
+		}
+	} // namespace detail
+
+	// R-MAT graph with 2^scale nodes: every edge picks one quadrant of the adjacency matrix per bit of its
+	// endpoints, with probabilities a, b, c and d (the stochastic Kronecker graph of a 2 x 2 initiator). Skewed
+	// parameters give hub-heavy, power-law-like degrees. Repeated edges collapse when the graph is built, and self
+	// loops are kept; Graph500 also shuffles the ids, since small ids are otherwise the hubs
+	template<typename N, typename E>
+	void generate_rmat(graph_builder<N, E>& builder,
+	                   std::size_t scale,
+	                   std::size_t edges,
+	                   rmat_parameters const& parameters = {},
+	                   generator_options const& options = {},
+	                   thread_pool& pool = default_thread_pool()) {
+		auto const [a, b, c] = parameters;
+		if (!(a >= 0 and b >= 0 and c >= 0 and a + b + c <= 1)) {
+			throw std::runtime_error("Cannot call gdwg::generate_rmat with probabilities that are negative or sum "
+			                         "to more than 1");
+		}
+		if (scale >= 64) {
+			throw std::runtime_error("Cannot call gdwg::generate_rmat with a scale of 64 or more");
+		}
+		auto const nodes = std::size_t{1} << scale;
+		detail::check_generator<N, E>(nodes, options, "generate_rmat");
+		auto const id = detail::id_permutation(nodes, options.seed, options.shuffle_ids);
+		// Quadrant thresholds in 32-bit fixed point, so every 64-bit draw places two bits without branches
+		auto const fixed = [](double p) { return static_cast<std::uint64_t>(std::ldexp(p, 32)); };
+		auto const [to_b, to_c, to_d] = std::array{fixed(a), fixed(a + b), fixed(a + b + c)};
+		auto const generate = [&](std::size_t first, std::size_t last, graph_builder<N, E>& part) {
+			part.reserve((last - first) * (options.symmetric ? 2 : 1));
+			for (auto k = first; k < last; ++k) {
+				auto rng = detail::walk_rng::for_walk(options.seed, k);
+				auto src = std::size_t{0};
+				auto dst = std::size_t{0};
+				auto const place = [&](std::uint64_t r) {
+					src = (src << 1) | static_cast<std::size_t>(r >= to_c);
+					dst = (dst << 1) | static_cast<std::size_t>(((r >= to_b) & (r < to_c)) | (r >= to_d));
+				};
+				for (std::size_t bit = 0; bit < scale; bit += 2) {
+					auto const draw = rng.next();
+					place(draw & 0xffffffffU);
+					if (bit + 1 < scale) {
+						place(draw >> 32);
+					}
+				}
+				detail::add_generated_edge(part, id(src), id(dst), rng, options);
+			}
+		};
+		detail::generate_parts(builder, nodes, edges, options.chunk_size, options, pool, generate);
+	}
+
+	// Erdős–Rényi G(n, p): every ordered pair of distinct nodes is an edge with probability p (every unordered
+	// pair, with options.symmetric). Each row skips straight to its next edge with a geometric draw, so the work is
+	// proportional to the edges, not to n^2
+	template<typename N, typename E>
+	void generate_gnp(graph_builder<N, E>& builder,
+	                  std::size_t nodes,
+	                  double probability,
+	                  generator_options const& options = {},
+	                  thread_pool& pool = default_thread_pool()) {
+		if (!(probability >= 0 and probability <= 1)) {
+			throw std::runtime_error("Cannot call gdwg::generate_gnp with a probability outside [0, 1]");
+		}
+		detail::check_generator<N, E>(nodes, options, "generate_gnp");
+		auto const id = detail::id_permutation(nodes, options.seed, options.shuffle_ids);
+		auto const log_q = std::log1p(-probability);
+		auto const row_edges = std::max(1.0, probability * static_cast<double>(nodes));
+		auto const rows_per_chunk = static_cast<std::size_t>(static_cast<double>(options.chunk_size) / row_edges);
+		auto const rows = probability == 0 ? std::size_t{0} : nodes;
+		auto const generate = [&](std::size_t first, std::size_t last, graph_builder<N, E>& part) {
+			for (auto u = first; u < last; ++u) {
+				auto rng = detail::walk_rng::for_walk(options.seed, u);
+				// Candidates are the nodes after u, or all nodes but u
+				auto const slots = options.symmetric ? nodes - u - 1 : nodes - 1;
+				for (auto slot = std::size_t{0}; slot < slots; ++slot) {
+					auto const skip = std::floor(std::log1p(-rng.uniform()) / log_q);
+					if (skip >= static_cast<double>(slots - slot)) {
+						break;
+					}
+					slot += static_cast<std::size_t>(skip);
+					auto const v = options.symmetric ? u + 1 + slot : slot + (slot >= u ? 1 : 0);
+					detail::add_generated_edge(part, id(u), id(v), rng, options);
+				}
+			}
+		};
+		detail::generate_parts(builder, nodes, rows, rows_per_chunk, options, pool, generate);
+	}
+
+	// Erdős–Rényi G(n, m): m edges between distinct nodes chosen uniformly at random (undirected edges, with
+	// options.symmetric). The edges are drawn independently, so the few repeats collapse when the graph is built
+	// and a dense graph ends up with slightly fewer than m edges
+	template<typename N, typename E>
+	void generate_gnm(graph_builder<N, E>& builder,
+	                  std::size_t nodes,
+	                  std::size_t edges,
+	                  generator_options const& options = {},
+	                  thread_pool& pool = default_thread_pool()) {
+		if (edges > 0 and nodes < 2) {
+			throw std::runtime_error("Cannot call gdwg::generate_gnm with edges but fewer than 2 nodes");
+		}
+		detail::check_generator<N, E>(nodes, options, "generate_gnm");
+		auto const id = detail::id_permutation(nodes, options.seed, options.shuffle_ids);
+		auto const generate = [&](std::size_t first, std::size_t last, graph_builder<N, E>& part) {
+			part.reserve((last - first) * (options.symmetric ? 2 : 1));
+			for (auto k = first; k < last; ++k) {
+				auto rng = detail::walk_rng::for_walk(options.seed, k);
+				auto const u = rng.below(nodes);
+				auto v = rng.below(nodes - 1);
+				v += v >= u ? 1 : 0;
+				detail::add_generated_edge(part, id(u), id(v), rng, options);
+			}
+		};
+		detail::generate_parts(builder, nodes, edges, options.chunk_size, options, pool, generate);
+	}
+
+	// Two-dimensional grid of rows x columns nodes, numbered row by row, with edges to the right and downwards
+	// (both ways, with options.symmetric). Each edge is kept with probability keep; with keep below 1 and random
+	// weights as lengths, it is a stand-in for a road network: low degrees and a long diameter
+	template<typename N, typename E>
+	void generate_grid(graph_builder<N, E>& builder,
+	                   std::size_t rows,
+	                   std::size_t columns,
+	                   double keep = 1.0,
+	                   generator_options const& options = {},
+	                   thread_pool& pool = default_thread_pool()) {
+		if (!(keep >= 0 and keep <= 1)) {
+			throw std::runtime_error("Cannot call gdwg::generate_grid with a keep probability outside [0, 1]");
+		}
+		auto const nodes = rows * columns;
+		detail::check_generator<N, E>(nodes, options, "generate_grid");
+		auto const id = detail::id_permutation(nodes, options.seed, options.shuffle_ids);
+		auto const rows_per_chunk = options.chunk_size / std::max<std::size_t>(1, 2 * columns);
+		auto const generate = [&](std::size_t first, std::size_t last, graph_builder<N, E>& part) {
+			for (auto y = first; y < last; ++y) {
+				auto rng = detail::walk_rng::for_walk(options.seed, y);
+				for (std::size_t x = 0; x < columns; ++x) {
+					auto const u = y * columns + x;
+					if (x + 1 < columns and (keep == 1 or rng.uniform() < keep)) {
+						detail::add_generated_edge(part, id(u), id(u + 1), rng, options);
+					}
+					if (y + 1 < rows and (keep == 1 or rng.uniform() < keep)) {
+						detail::add_generated_edge(part, id(u), id(u + columns), rng, options);
+					}
+				}
+			}
+		};
+		detail::generate_parts(builder, nodes, rows, rows_per_chunk, options, pool, generate);
+	}
+
+	// Barabási–Albert preferential attachment: starting from node 0, every later node adds edges_per_node edges to
+	// earlier nodes chosen in proportion to their degree, giving a power-law degree distribution with exponent 3.
+	// Edges point from the new node to the old one; repeated targets of a node collapse when the graph is built
+	template<typename N, typename E>
+	void generate_barabasi_albert(graph_builder<N, E>& builder,
+	                              std::size_t nodes,
+	                              std::size_t edges_per_node,
+	                              generator_options const& options = {},
+	                              thread_pool& pool = default_thread_pool()) {
+		if (edges_per_node == 0) {
+			throw std::runtime_error("Cannot call gdwg::generate_barabasi_albert with no edges per node");
+		}
+		detail::check_generator<N, E>(nodes, options, "generate_barabasi_albert");
+		auto const id = detail::id_permutation(nodes, options.seed, options.shuffle_ids);
+		auto const edges = nodes < 2 ? std::size_t{0} : (nodes - 1) * edges_per_node;
+		auto const generate = [&](std::size_t first, std::size_t last, graph_builder<N, E>& part) {
+			part.reserve((last - first) * (options.symmetric ? 2 : 1));
+			for (auto k = first; k < last; ++k) {
+				auto const target = detail::barabasi_albert_target(options.seed, edges_per_node, k);
+				auto rng = detail::walk_rng::for_walk(~options.seed, k); // Weights come from a stream of their own
+				detail::add_generated_edge(part, id(k / edges_per_node + 1), id(target), rng, options);
+			}
+		};
+		detail::generate_parts(builder, nodes, edges, options.chunk_size, options, pool, generate);
+	}
+} // namespace gdwg
+
+#endif // GDWG_GENERATORS_H
@@ -0,0 +1,195 @@
+#include "gdwg_generators.h"
+#include "gdwg_testing.h"
+
+#include <catch2/catch.hpp>
+
+#include <map>
+#include <numeric>
+#include <set>
+#include <tuple>
+
+namespace {
+	using gdwg::testing::print;
+
+	template<typename N, typename E>
+	std::size_t edge_count(gdwg::graph<N, E> const& g) {
+		return static_cast<std::size_t>(std::distance(g.begin(), g.end()));
+	}
+
+	// Every edge has its reverse, with the same weight
+	template<typename N, typename E>
+	bool is_symmetric(gdwg::graph<N, E> const& g) {
+		auto edges = std::set<std::tuple<N, N, std::optional<E>>>{};
+		for (auto const& [from, to, weight] : g) {
+			edges.emplace(from, to, weight);
+		}
+		return std::all_of(edges.begin(), edges.end(), [&edges](auto const& edge) {
+			return edges.contains({std::get<1>(edge), std::get<0>(edge), std::get<2>(edge)});
+		});
+	}
+
+	// Sorted out-degrees, which a relabelling of the nodes does not change
+	template<typename N, typename E>
+	std::vector<std::size_t> degree_sequence(gdwg::graph<N, E> const& g) {
+		auto degree = std::map<N, std::size_t>{};
+		for (auto const& edge : g) {
+			++degree[edge.from];
+		}
+		auto degrees = std::vector<std::size_t>{};
+		for (auto const& [node, d] : degree) {
+			degrees.push_back(d);
+		}
+		std::sort(degrees.begin(), degrees.end());
+		return degrees;
+	}
+
+	template<typename N, typename E, typename Generate>
+	gdwg::graph<N, E> generated(Generate generate) {
+		auto builder = gdwg::graph_builder<N, E>{};
+		generate(builder);
+		return builder.build();
+	}
+} // namespace
+
+// Generator tests
+TEST_CASE("Generated graphs depend only on the seed", "[generators]") {
+	auto one = gdwg::thread_pool(1);
+	auto four = gdwg::thread_pool(4);
+	auto const small_chunks = gdwg::generator_options{.chunk_size = 7};
+	auto const other_seed = gdwg::generator_options{.seed = 1};
+	auto const shuffled = gdwg::generator_options{.shuffle_ids = true, .chunk_size = 13};
+
+	auto const check = [&](auto generate) {
+		auto g = generated<int, int>([&](auto& b) { generate(b, gdwg::generator_options{}, one); });
+		REQUIRE(print(generated<int, int>([&](auto& b) { generate(b, gdwg::generator_options{}, four); })) == print(g));
+		REQUIRE(print(generated<int, int>([&](auto& b) { generate(b, small_chunks, four); })) == print(g));
+		REQUIRE(print(generated<int, int>([&](auto& b) { generate(b, other_seed, four); })) != print(g));
+
+		// Shuffling the ids relabels the same graph
+		auto relabelled = generated<int, int>([&](auto& b) { generate(b, shuffled, four); });
+		REQUIRE(relabelled.nodes() == g.nodes());
+		REQUIRE(print(relabelled) != print(g));
+		REQUIRE(degree_sequence(relabelled) == degree_sequence(g));
+	};
+	check([](auto& b, auto const& options, auto& pool) { gdwg::generate_rmat(b, 8, 2000, {}, options, pool); });
+	check([](auto& b, auto const& options, auto& pool) { gdwg::generate_gnp(b, 200, 0.05, options, pool); });
+	check([](auto& b, auto const& options, auto& pool) { gdwg::generate_gnm(b, 200, 2000, options, pool); });
+	check([](auto& b, auto const& options, auto& pool) { gdwg::generate_grid(b, 10, 20, 0.7, options, pool); });
+	check([](auto& b, auto const& options, auto& pool) { gdwg::generate_barabasi_albert(b, 300, 4, options, pool); });
+}
+
+TEST_CASE("R-MAT graphs", "[generators]") {
+	auto g = generated<unsigned, int>([](auto& b) { gdwg::generate_rmat(b, 10, 20000); });
+	REQUIRE(g.nodes().size() == 1024);
+	auto const edges = edge_count(g);
+	REQUIRE(edges > 12000); // The hubs repeat many edges
+	REQUIRE(edges <= 20000);
+
+	// The default parameters make node 0 a hub; equal ones spread the edges evenly
+	auto const degrees = degree_sequence(g);
+	REQUIRE(degrees.back() > 20 * edges / 1024);
+	auto const uniform =
+	   generated<unsigned, int>([](auto& b) { gdwg::generate_rmat(b, 10, 20000, {0.25, 0.25, 0.25}); });
+	REQUIRE(degree_sequence(uniform).back() < 3 * edge_count(uniform) / 1024);
+
+	REQUIRE_THROWS_WITH((generated<int, int>([](auto& b) { gdwg::generate_rmat(b, 4, 10, {0.5, 0.5, 0.5}); })),
+	                    "Cannot call gdwg::generate_rmat with probabilities that are negative or sum to more than 1");
+	REQUIRE_THROWS_WITH((generated<short, int>([](auto& b) { gdwg::generate_rmat(b, 16, 10); })),
+	                    "Cannot call gdwg::generate_rmat: node 65535 does not fit the node type");
+}
+
+TEST_CASE("Erdős–Rényi graphs", "[generators]") {
+	SECTION("G(n, p)") {
+		auto complete = generated<int, double>([](auto& b) { gdwg::generate_gnp(b, 30, 1.0); });
+		REQUIRE(edge_count(complete) == 30 * 29);
+		REQUIRE_FALSE(complete.is_connected(4, 4));
+
+		auto empty = generated<int, double>([](auto& b) { gdwg::generate_gnp(b, 30, 0.0); });
+		REQUIRE(empty.nodes().size() == 30);
+		REQUIRE(edge_count(empty) == 0);
+
+		auto const sparse = generated<int, double>([](auto& b) { gdwg::generate_gnp(b, 2000, 0.01); });
+		REQUIRE(edge_count(sparse) > 2000 * 1999 / 100 * 9 / 10);
+		REQUIRE(edge_count(sparse) < 2000 * 1999 / 100 * 11 / 10);
+
+		auto const undirected = generated<int, double>(
+		   [](auto& b) { gdwg::generate_gnp(b, 300, 0.1, {.symmetric = true, .max_weight = 5}); });
+		REQUIRE(is_symmetric(undirected));
+		REQUIRE(edge_count(undirected) > 300 * 299 / 10 * 9 / 10);
+		REQUIRE(edge_count(undirected) < 300 * 299 / 10 * 11 / 10);
+		REQUIRE(std::all_of(undirected.begin(), undirected.end(), [](auto const& edge) {
+			return edge.weight and *edge.weight >= 1 and *edge.weight <= 5;
+		}));
+
+		REQUIRE_THROWS_WITH((generated<int, int>([](auto& b) { gdwg::generate_gnp(b, 3, 1.5); })),
+		                    "Cannot call gdwg::generate_gnp with a probability outside [0, 1]");
+	}
+
+	SECTION("G(n, m)") {
+		auto g = generated<long, int>([](auto& b) { gdwg::generate_gnm(b, 100000, 50000); });
+		REQUIRE(g.nodes().size() == 100000);
+		REQUIRE(edge_count(g) == 50000); // Repeats are vanishingly rare at this density
+		REQUIRE(std::none_of(g.begin(), g.end(), [](auto const& edge) { return edge.from == edge.to; }));
+
+		auto const undirected =
+		   generated<long, int>([](auto& b) { gdwg::generate_gnm(b, 1000, 3000, {.symmetric = true}); });
+		REQUIRE(is_symmetric(undirected));
+		REQUIRE(edge_count(undirected) <= 6000);
+		REQUIRE(edge_count(undirected) > 5900);
+
+		REQUIRE_THROWS_WITH((generated<int, int>([](auto& b) { gdwg::generate_gnm(b, 1, 1); })),
+		                    "Cannot call gdwg::generate_gnm with edges but fewer than 2 nodes");
+	}
+}
+
+TEST_CASE("Grid graphs", "[generators]") {
+	auto directed = generated<int, int>([](auto& b) { gdwg::generate_grid(b, 3, 4); });
+	REQUIRE(directed.nodes().size() == 12);
+	REQUIRE(edge_count(directed) == 3 * 3 + 2 * 4);
+	REQUIRE(directed.is_connected(5, 6));
+	REQUIRE(directed.is_connected(5, 9));
+	REQUIRE_FALSE(directed.is_connected(6, 5));
+	REQUIRE_FALSE(directed.is_connected(3, 4)); // The end of a row
+
+	auto const roads = generated<int, int>([](auto& b) {
+		gdwg::generate_grid(b, 100, 100, 0.8, {.symmetric = true, .max_weight = 100, .chunk_size = 500});
+	});
+	REQUIRE(is_symmetric(roads));
+	auto const streets = edge_count(roads) / 2;
+	REQUIRE(streets > 2 * 99 * 100 * 75 / 100);
+	REQUIRE(streets < 2 * 99 * 100 * 85 / 100);
+	REQUIRE(std::all_of(roads.begin(), roads.end(), [](auto const& edge) {
+		auto const gap = edge.from > edge.to ? edge.from - edge.to : edge.to - edge.from;
+		return (gap == 1 or gap == 100) and *edge.weight >= 1 and *edge.weight <= 100;
+	}));
+
+	REQUIRE_THROWS_WITH((generated<int, std::string>(
+	                       [](auto& b) { gdwg::generate_grid(b, 3, 3, 1, {.max_weight = 2}); })),
+	                    "Cannot call gdwg::generate_grid: random weights need an arithmetic weight type");
+}
+
+TEST_CASE("Barabási–Albert graphs", "[generators]") {
+	auto g = generated<int, int>([](auto& b) { gdwg::generate_barabasi_albert(b, 5000, 3); });
+	REQUIRE(g.nodes().size() == 5000);
+	REQUIRE(g.connections(1) == std::vector<int>{0});
+	for (auto const& edge : g) {
+		REQUIRE(edge.to < edge.from); // New nodes attach to older ones
+	}
+	auto const edges = edge_count(g);
+	REQUIRE(edges <= 4999 * 3);
+	REQUIRE(edges > 4999 * 3 * 9 / 10);
+
+	// Preferential attachment makes the oldest nodes hubs
+	auto in_degree = std::vector<std::size_t>(5000);
+	for (auto const& edge : g) {
+		++in_degree[static_cast<std::size_t>(edge.to)];
+	}
+	auto const hub = std::accumulate(in_degree.begin(), in_degree.begin() + 10, std::size_t{0});
+	REQUIRE(hub > 10 * 20);
+
+	auto const undirected =
+	   generated<int, int>([](auto& b) { gdwg::generate_barabasi_albert(b, 1000, 2, {.symmetric = true}); });
+	REQUIRE(is_symmetric(undirected));
+	REQUIRE_THROWS_WITH((generated<int, int>([](auto& b) { gdwg::generate_barabasi_albert(b, 10, 0); })),
+	                    "Cannot call gdwg::generate_barabasi_albert with no edges per node");
+}
@@ -0,0 +1,187 @@
+#include "gdwg_bench.h"
+#include "gdwg_generators.h"
+#include "gdwg_graph.h"
+
+#include <algorithm>
+#include <bit>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+	using graph_type = gdwg::graph<int, double>;
+	using edge_type = std::tuple<int, int, std::optional<double>>;
+
+	// A generated graph, with its nodes and edges in a random order for inserting, sampling and erasing
+	struct workload {
+		graph_type g;
+		std::vector<int> nodes;
+		std::vector<edge_type> edges;
+		std::size_t max_degree = 0;
+	};
+
+	workload make_workload(std::string const& distribution, std::size_t nodes, std::size_t edges, std::uint64_t seed) {
+		auto const options = gdwg::generator_options{.seed = seed, .shuffle_ids = true, .max_weight = 100};
+		auto builder = gdwg::graph_builder<int, double>{};
+		if (distribution == "uniform") {
+			gdwg::generate_gnm(builder, nodes, edges, options);
+		}
+		else {
+			auto const scale = static_cast<std::size_t>(std::bit_width(nodes - 1));
+			gdwg::generate_rmat(builder, scale, edges, {}, options);
+		}
+		auto result = workload{builder.build(), {}, {}, 0};
+		result.nodes = result.g.nodes();
+		for (auto const& [from, to, weight] : result.g) {
+			result.edges.emplace_back(from, to, weight);
+		}
+		for (auto node : result.nodes) {
+			result.max_degree = std::max(result.max_degree, result.g.connections(node).size());
+		}
+		auto rng = std::mt19937_64(seed);
+		std::shuffle(result.nodes.begin(), result.nodes.end(), rng);
+		std::shuffle(result.edges.begin(), result.edges.end(), rng);
+		return result;
+	}
+} // namespace
+
+// Every public operation of gdwg::graph, on uniform (G(n, m)) and hub-heavy (R-MAT) graphs of growing size
+// An operation is one call, except for iteration, copying and operator==, where it is one edge
+// Usage: gdwg_graph_bench [largest edge count] [average degree] [queries]
+auto main(int argc, char** argv) -> int {
+	auto const largest = gdwg::bench::argument(argc, argv, 1, 1 << 18);
+	auto const degree = std::max<std::size_t>(1, gdwg::bench::argument(argc, argv, 2, 8));
+	auto const queries = gdwg::bench::argument(argc, argv, 3, 1 << 16);
+
+	for (auto const& distribution : {"uniform", "power_law"}) {
+		for (auto const edges : {largest / 16, largest / 4, largest}) {
+			auto work = make_workload(distribution, std::max<std::size_t>(2, edges / degree), edges, 6771);
+			auto& g = work.g;
+			auto const n = work.nodes.size();
+			auto const m = work.edges.size();
+			auto const q = std::min(queries, m);
+			auto const parameters = std::vector<gdwg::bench::parameter>{
+			   {"nodes", static_cast<double>(n)},
+			   {"edges", static_cast<double>(m)},
+			   {"max_degree", static_cast<double>(work.max_degree)}};
+			auto report = [&](std::string const& operation, std::size_t operations, double seconds, double hits = 0) {
+				gdwg::bench::report(std::cout,
+				                    std::string(distribution) + "/" + operation,
+				                    parameters,
+				                    seconds,
+				                    {{"operations", static_cast<double>(operations)},
+				                     {"operations_per_second", static_cast<double>(operations) / seconds},
+				                     {"hits", hits}});
+			};
+
+			// Queries: q existing edges and q pairs of random nodes
+			auto rng = std::mt19937_64(6772);
+			auto probes = std::vector<edge_type>(work.edges.begin(), work.edges.begin() + static_cast<long>(q));
+			for (std::size_t i = 0; i < q; ++i) {
+				probes.emplace_back(work.nodes[rng() % n], work.nodes[rng() % n], static_cast<double>(rng() % 100));
+			}
+
+			// Modifiers
+			auto scratch = graph_type{};
+			auto seconds = gdwg::bench::best_of(3, [&] { scratch = graph_type{}; }, [&] {
+				for (auto node : work.nodes) {
+					scratch.insert_node(node);
+				}
+			});
+			report("insert_node", n, seconds);
+			auto const nodes_only = scratch;
+
+			seconds = gdwg::bench::best_of(1, [&] { scratch = nodes_only; }, [&] {
+				for (auto const& [from, to, weight] : work.edges) {
+					scratch.insert_edge(from, to, weight);
+				}
+			});
+			report("insert_edge", m, seconds);
+
+			auto hits = std::size_t{0};
+			seconds = gdwg::bench::best_of(3, [&] {
+				scratch = g;
+				hits = 0;
+			}, [&] {
+				for (std::size_t i = 0; i < q; ++i) {
+					auto const& [from, to, weight] = work.edges[i];
+					hits += scratch.erase_edge(from, to, weight) ? 1U : 0U;
+				}
+			});
+			report("erase_edge", q, seconds, static_cast<double>(hits));
+
+			// erase_node scans every list for edges into the node, so it gets few calls
+			auto const erased = std::min<std::size_t>(n, 32);
+			seconds = gdwg::bench::best_of(3, [&] { scratch = g; }, [&] {
+				for (std::size_t i = 0; i < erased; ++i) {
+					scratch.erase_node(work.nodes[i]);
+				}
+			});
+			report("erase_node", erased, seconds);
+
+			auto const replaced = std::min(q, n / 2);
+			seconds = gdwg::bench::best_of(3, [&] { scratch = g; }, [&] {
+				for (std::size_t i = 0; i < replaced; ++i) {
+					scratch.replace_node(work.nodes[i], -1 - static_cast<int>(i));
+				}
+			});
+			report("replace_node", replaced, seconds);
+
+			seconds = gdwg::bench::best_of(3, [&] { scratch = g; }, [&] {
+				for (std::size_t i = 0; i < replaced; ++i) {
+					scratch.merge_replace_node(work.nodes[2 * i], work.nodes[2 * i + 1]);
+				}
+			});
+			report("merge_replace_node", replaced, seconds);
+
+			// Accessors
+			seconds = gdwg::bench::best_of(3, [&] {
+				hits = 0;
+				for (auto const& [from, to, weight] : probes) {
+					hits += g.is_connected(from, to) ? 1U : 0U;
+				}
+			});
+			report("is_connected", probes.size(), seconds, static_cast<double>(hits));
+
+			seconds = gdwg::bench::best_of(3, [&] {
+				hits = 0;
+				for (auto const& [from, to, weight] : probes) {
+					hits += g.edges(from, to).size();
+				}
+			});
+			report("edges", probes.size(), seconds, static_cast<double>(hits));
+
+			seconds = gdwg::bench::best_of(3, [&] {
+				hits = 0;
+				for (auto const& probe : probes) {
+					hits += g.connections(std::get<0>(probe)).size();
+				}
+			});
+			report("connections", probes.size(), seconds, static_cast<double>(hits));
+
+			seconds = gdwg::bench::best_of(3, [&] {
+				hits = 0;
+				for (auto const& [from, to, weight] : probes) {
+					hits += g.find(from, to, weight) != g.end() ? 1U : 0U;
+				}
+			});
+			report("find", probes.size(), seconds, static_cast<double>(hits));
+
+			// Whole-graph operations
+			seconds = gdwg::bench::best_of(3, [&] {
+				hits = static_cast<std::size_t>(std::distance(g.begin(), g.end()));
+			});
+			report("iterate", m, seconds, static_cast<double>(hits));
+
+			seconds = gdwg::bench::best_of(3, [&] { scratch = graph_type{}; }, [&] { scratch = g; });
+			report("copy", m, seconds);
+
+			seconds = gdwg::bench::best_of(3, [&] { hits = g == scratch ? 1U : 0U; });
+			report("equal", m, seconds, static_cast<double>(hits));
+		}
+	}
+}
@@ -5,7 +5,9 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <algorithm>
+#include <charconv>
 #include <iomanip>
+#include <locale>
 #include <map>
 #include <memory>
 #include <optional>
@@ -14,7 +16,10 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -25,6 +30,18 @@ namespace gdwg {
 	template<typename N, typename E>
 	class graph;
 
+	template<typename N, typename E>
+	class csr_graph;
+
+	template<typename N, typename E>
+	class graph_builder;
+
+	template<typename N, typename E>
+	class durable_graph;
+
+	template<typename N, typename E>
+	class graph_exporter;
+
 	// Edge: An Abstract BASE Class
 	template<typename N, typename E>
 	class edge {
@@ -145,6 +162,104 @@ namespace gdwg {
 		N dst_;
 	};
 
+	namespace detail {
+		template<typename T>
+		inline constexpr bool is_print_char =
+		   std::is_same_v<T, char> or std::is_same_v<T, signed char> or std::is_same_v<T, unsigned char>;
+
+		// Nodes and weights that print_buffer formats itself
+		template<typename T>
+		inline constexpr bool is_printable = std::is_arithmetic_v<T> or std::is_same_v<T, std::string>;
+
+		// The text of graph<N, E>::operator<<, gathered into large blocks that are handed to sink(data, size)
+		// Nodes are written as operator<< writes them to a stream with default flags, and weights as
+		// std::to_string writes them, but with std::to_chars instead of a temporary string per value
+		template<typename Sink>
+		class print_buffer {
+		 public:
+			explicit print_buffer(Sink sink)
+			: data_(block_size)
+			, sink_(std::move(sink)) {}
+
+			void put(std::string_view text) {
+				if (text.size() > data_.size() - size_) {
+					flush();
+					if (text.size() > data_.size()) {
+						sink_(text.data(), text.size());
+						return;
+					}
+				}
+				std::copy(text.begin(), text.end(), data_.begin() + static_cast<std::ptrdiff_t>(size_));
+				size_ += text.size();
+			}
+
+			template<typename N>
+			void put_node(N const& node) {
+				if constexpr (std::is_same_v<N, std::string>) {
+					put(node);
+				}
+				else if constexpr (is_print_char<N>) {
+					put(std::string_view(reinterpret_cast<char const*>(&node), 1));
+				}
+				else if constexpr (std::is_same_v<N, bool>) {
+					put(node ? "1" : "0");
+				}
+				else if constexpr (std::is_floating_point_v<N>) {
+					put_chars(+node, std::chars_format::general, 6); // %g, as std::ostream prints by default
+				}
+				else {
+					put_chars(node);
+				}
+			}
+
+			template<typename E>
+			void put_weight(E const& weight) {
+				if constexpr (std::is_same_v<E, std::string>) {
+					put(weight);
+				}
+				else if constexpr (std::is_floating_point_v<E>) {
+					put_chars(+weight, std::chars_format::fixed, 6); // %f, as std::to_string prints
+				}
+				else {
+					put_chars(+weight); // chars and bools are promoted to int, as std::to_string takes them
+				}
+			}
+
+			void flush() {
+				if (size_ != 0) {
+					sink_(data_.data(), size_);
+					size_ = 0;
+				}
+			}
+
+		 private:
+			// Any number fits in an empty block, even a long double written with %f
+			static constexpr auto block_size = std::size_t{1} << 16;
+
+			template<typename... Args>
+			void put_chars(Args... args) {
+				auto const [end, error] = std::to_chars(data_.data() + size_, data_.data() + data_.size(), args...);
+				if (error == std::errc{}) {
+					size_ = static_cast<std::size_t>(end - data_.data());
+					return;
+				}
+				flush();
+				size_ = static_cast<std::size_t>(std::to_chars(data_.data(), data_.data() + data_.size(), args...).ptr
+				                                 - data_.data());
+			}
+
+			std::vector<char> data_;
+			std::size_t size_ = 0;
+			Sink sink_;
+		};
+
+		// Whether print_buffer writes what the stream would: default flags and precision, and the classic locale
+		inline bool is_plain_stream(std::ostream const& os) {
+			return (os.flags() & ~std::ios::skipws) == std::ios::dec and os.precision() == 6
+			       and os.getloc() == std::locale::classic();
+		}
+	} // namespace detail
+
 	// Class of Graph
 	template<typename N, typename E>
 	class graph {
@@ -454,37 +569,29 @@ namespace gdwg {
 		// then the weighted edges in ascending order
 		friend std::ostream& operator<<(std::ostream& os, const graph<N, E>& g) {
 			os << '\n';
-			std::vector<std::tuple<N, N, std::optional<E>>> edges; // Temporarily store and sort all edge information
-
-			for (const auto& [node, adj_edges] : g.adj_list_) {
-				os << node << " (\n";
-
-				// Clear the edges vector and add all edges of the current node to this vector
-				edges.clear();
-				for (const auto& edge : adj_edges) {
-					edges.emplace_back(node, edge.first, edge.second);
-				}
-
-				// First, sort by target node
-				// If the target nodes are the same, the unweighted edges are placed before the weighted edges
-				// Finally, sort by weight
-				std::sort(edges.begin(), edges.end(), [](const auto& lhs, const auto& rhs) {
-					if (std::get<1>(lhs) != std::get<1>(rhs))
-						return std::get<1>(lhs) < std::get<1>(rhs);
-					if (!std::get<2>(lhs).has_value() and std::get<2>(rhs).has_value())
-						return true;
-					if (std::get<2>(lhs).has_value() and !std::get<2>(rhs).has_value())
-						return false;
-					return std::get<2>(lhs).value() < std::get<2>(rhs).value();
-				});
-
-				// Output all sorted edges
-				for (const auto& edge : edges) {
-					os << "  " << std::get<0>(edge) << " -> " << std::get<1>(edge) << " | "
-					   << (std::get<2>(edge) ? "W | " + std::to_string(std::get<2>(edge).value()) : "U") << '\n';
+			if constexpr (detail::is_printable<N> and detail::is_printable<E>) {
+				if (detail::is_plain_stream(os)) {
+					auto out = detail::print_buffer([&os](char const* data, std::size_t size) {
+						os.write(data, static_cast<std::streamsize>(size));
+					});
+					g.print_rows([&out](std::string_view text) { out.put(text); },
+					             [&out](N const& node) { out.put_node(node); },
+					             [&out](E const& weight) { out.put_weight(weight); });
+					out.flush();
+					return os;
 				}
-				os << ")\n";
 			}
+			// Other types, and streams with their own flags, precision or locale, go through the stream's own formatting
+			g.print_rows([&os](std::string_view text) { os << text; },
+			             [&os](N const& node) { os << node; },
+			             [&os](E const& weight) {
+				             if constexpr (std::is_arithmetic_v<E>) {
+					             os << std::to_string(weight);
+				             }
+				             else {
+					             os << weight;
+				             }
+			             });
 			return os;
 		}
 
@@ -546,7 +653,7 @@ namespace gdwg {
 
 			// operator--()
 			iterator& operator--() {
-				if (node_it_ == graph_ptr_->adj_list_.begin() and edge_it_ == node_it_->second.begin()) {
+				if (*this == graph_ptr_->begin()) {
 					throw std::out_of_range("Iterator cannot decrement past the beginning of the graph");
 				}
 				// If the current node is at the end of the graph or the edge iterator is at the beginning of a node,
@@ -591,11 +698,15 @@ namespace gdwg {
 		// 2.6 Iterator Access
 		// Return the iterator pointing to the first element in the container
 		[[nodiscard]] iterator begin() const {
-			if (adj_list_.empty()) {
+			// Cast to remove constness
+			auto& lists = const_cast<std::map<N, std::vector<std::pair<N, std::optional<E>>>>&>(adj_list_);
+			// Skip the nodes without edges, as operator++ does
+			auto node_it = std::find_if(lists.begin(), lists.end(), [](auto const& list) {
+				return !list.second.empty();
+			});
+			if (node_it == lists.end()) {
 				return end();
 			}
-			// Cast to remove constness
-			auto node_it = const_cast<std::map<N, std::vector<std::pair<N, std::optional<E>>>>&>(adj_list_).begin();
 			return iterator(node_it, node_it->second.begin(), const_cast<graph*>(this));
 		}
 
@@ -669,6 +780,44 @@ namespace gdwg {
 		}
 
 	 private:
+		friend class csr_graph<N, E>;
+		friend class graph_builder<N, E>;
+		friend class durable_graph<N, E>;
+		friend class graph_exporter<N, E>;
+
+		// Print every adjacency list in order, with text, node and weight writing the pieces
+		// insert_edge keeps the lists sorted by target and then weight, unweighted first, so they are printed in
+		// place; only a list left out of order by merge_replace_node is sorted, in a copy
+		template<typename Text, typename Node, typename Weight>
+		void print_rows(Text text, Node node, Weight weight) const {
+			auto unsorted = std::vector<std::pair<N, std::optional<E>>>{};
+			for (auto const& [src, edges] : adj_list_) {
+				node(src);
+				text(" (\n");
+				auto const* row = &edges;
+				if (!std::is_sorted(edges.begin(), edges.end())) {
+					unsorted = edges;
+					std::sort(unsorted.begin(), unsorted.end());
+					row = &unsorted;
+				}
+				for (auto const& [dst, w] : *row) {
+					text("  ");
+					node(src);
+					text(" -> ");
+					node(dst);
+					if (w) {
+						text(" | W | ");
+						weight(*w);
+					}
+					else {
+						text(" | U");
+					}
+					text("\n");
+				}
+				text(")\n");
+			}
+		}
+
 		std::map<N, std::vector<std::pair<N, std::optional<E>>>> adj_list_; // Adjacency lists for nodes and edges
 		std::set<N> nodes_; // Set of nodes
 	};
@@ -2,6 +2,9 @@
 
 #include <catch2/catch.hpp>
 
+#include <iomanip>
+#include <sstream>
+
 TEST_CASE("basic test") {
 	// These are commented out right now
 	//  because withour your implementation
@@ -488,6 +491,65 @@ TEST_CASE("Graph output format test", "[graph][output]") {
 	CHECK(out.str() == expected_output);
 }
 
+TEST_CASE("Graph output of other types, and of streams with their own flags", "[graph][output]") {
+	auto reals = gdwg::graph<double, float>{};
+	for (auto node : {0.5, 1e7, -2.0}) {
+		reals.insert_node(node);
+	}
+	reals.insert_edge(0.5, 1e7, 1.25f);
+	reals.insert_edge(0.5, -2);
+	reals.insert_edge(1e7, 1e7, -3e20f);
+	auto out = std::ostringstream{};
+	out << reals;
+	CHECK(out.str()
+	      == "\n-2 (\n)\n0.5 (\n  0.5 -> -2 | U\n  0.5 -> 1e+07 | W | " + std::to_string(1.25f) + "\n)\n1e+07 (\n"
+	            "  1e+07 -> 1e+07 | W | " + std::to_string(-3e20f) + "\n)\n");
+
+	// Weights that std::to_string does not take are written as they are
+	auto words = gdwg::graph<char, std::string>{};
+	words.insert_node('a');
+	words.insert_node('b');
+	words.insert_edge('a', 'b', "heavy");
+	words.insert_edge('b', 'a');
+	out.str("");
+	out << words;
+	CHECK(out.str() == "\na (\n  a -> b | W | heavy\n)\nb (\n  b -> a | U\n)\n");
+
+	// A list left out of order by merge_replace_node is still printed in order: 3's edges are appended to 4's
+	auto merged = gdwg::graph<int, int>{};
+	for (auto node : {1, 3, 4}) {
+		merged.insert_node(node);
+	}
+	merged.insert_edge(3, 1, 2);
+	merged.insert_edge(4, 3, 3);
+	merged.insert_edge(3, 3, 4);
+	merged.insert_edge(4, 4, 5);
+	merged.merge_replace_node(3, 4);
+	out.str("");
+	out << merged;
+	CHECK(out.str()
+	      == "\n1 (\n)\n4 (\n  4 -> 1 | W | 2\n  4 -> 3 | W | 3\n  4 -> 3 | W | 4\n  4 -> 4 | W | 5\n)\n");
+
+	out.str("");
+	out << std::hex << std::showbase << merged;
+	CHECK(out.str()
+	      == "\n0x1 (\n)\n0x4 (\n  0x4 -> 0x1 | W | 2\n  0x4 -> 0x3 | W | 3\n  0x4 -> 0x3 | W | 4\n"
+	         "  0x4 -> 0x4 | W | 5\n)\n");
+
+	// Floating point nodes follow the stream's precision
+	auto precise = gdwg::graph<double, int>{};
+	precise.insert_node(1.23456789);
+	precise.insert_node(2.5);
+	precise.insert_edge(1.23456789, 2.5, 3);
+	out.str("");
+	out.flags(std::ios::dec);
+	out << precise;
+	CHECK(out.str() == "\n1.23457 (\n  1.23457 -> 2.5 | W | 3\n)\n2.5 (\n)\n");
+	out.str("");
+	out << std::setprecision(10) << precise;
+	CHECK(out.str() == "\n1.23456789 (\n  1.23456789 -> 2.5 | W | 3\n)\n2.5 (\n)\n");
+}
+
 // Test iterator
 TEST_CASE("Iterator functionality for graph<int, int>", "[graph]") {
 	gdwg::graph<int, int> g;
@@ -592,6 +654,20 @@ TEST_CASE("Iterator functionality for graph<int, int>", "[graph]") {
 		same_as_begin++;
 		REQUIRE(begin != same_as_begin);
 	}
+
+	SECTION("Nodes without edges before the first edge are skipped") {
+		g.insert_node(-5);
+		g.insert_node(0);
+		auto it = g.begin();
+		REQUIRE((*it).from == 1);
+		REQUIRE((*it).to == 7);
+		REQUIRE_THROWS_AS(--it, std::out_of_range);
+		REQUIRE(std::distance(g.begin(), g.end()) == 10);
+
+		auto isolated = gdwg::graph<int, int>{};
+		isolated.insert_node(3);
+		REQUIRE(isolated.begin() == isolated.end());
+	}
 }
 
 // Tests for removing the edge pointing to iterator i
@@ -0,0 +1,181 @@
+#ifndef GDWG_MAPPED_FILE_H
+#define GDWG_MAPPED_FILE_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace gdwg::detail {
+	// A read-only memory mapping of a whole file
+	class mapped_file {
+	 public:
+		explicit mapped_file(std::string const& path) {
+			auto const fd = ::open(path.c_str(), O_RDONLY);
+			if (fd < 0) {
+				throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+			}
+			struct ::stat status = {};
+			if (::fstat(fd, &status) != 0) {
+				auto const error = errno;
+				::close(fd);
+				throw std::runtime_error("Cannot open " + path + ": " + std::strerror(error));
+			}
+			size_ = static_cast<std::size_t>(status.st_size);
+			if (size_ > 0) {
+				auto* data = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+				if (data == MAP_FAILED) {
+					auto const error = errno;
+					::close(fd);
+					throw std::runtime_error("Cannot map " + path + ": " + std::strerror(error));
+				}
+				data_ = data;
+			}
+			::close(fd);
+		}
+
+		mapped_file(mapped_file&& other) noexcept
+		: data_(std::exchange(other.data_, nullptr))
+		, size_(std::exchange(other.size_, 0)) {}
+
+		mapped_file& operator=(mapped_file&& other) noexcept {
+			if (this != &other) {
+				unmap();
+				data_ = std::exchange(other.data_, nullptr);
+				size_ = std::exchange(other.size_, 0);
+			}
+			return *this;
+		}
+
+		mapped_file(mapped_file const&) = delete;
+		mapped_file& operator=(mapped_file const&) = delete;
+
+		~mapped_file() {
+			unmap();
+		}
+
+		[[nodiscard]] std::byte const* data() const noexcept {
+			return static_cast<std::byte const*>(data_);
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept {
+			return size_;
+		}
+
+	 private:
+		void unmap() noexcept {
+			if (data_ != nullptr) {
+				::munmap(data_, size_);
+			}
+			data_ = nullptr;
+		}
+
+		void* data_ = nullptr;
+		std::size_t size_ = 0;
+	};
+
+	// A file descriptor opened for appending, closed on destruction
+	class append_file {
+	 public:
+		append_file() = default;
+
+		explicit append_file(std::string const& path)
+		: fd_(::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644))
+		, path_(path) {
+			if (fd_ < 0) {
+				throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+			}
+		}
+
+		append_file(append_file&& other) noexcept
+		: fd_(std::exchange(other.fd_, -1))
+		, path_(std::move(other.path_)) {}
+
+		append_file& operator=(append_file&& other) noexcept {
+			if (this != &other) {
+				close();
+				fd_ = std::exchange(other.fd_, -1);
+				path_ = std::move(other.path_);
+			}
+			return *this;
+		}
+
+		append_file(append_file const&) = delete;
+		append_file& operator=(append_file const&) = delete;
+
+		~append_file() {
+			close();
+		}
+
+		void write(void const* data, std::size_t size) {
+			auto const* bytes = static_cast<char const*>(data);
+			while (size > 0) {
+				auto const written = ::write(fd_, bytes, size);
+				if (written < 0 and errno == EINTR) {
+					continue;
+				}
+				if (written < 0) {
+					throw std::runtime_error("Writing " + path_ + " failed: " + std::strerror(errno));
+				}
+				bytes += written;
+				size -= static_cast<std::size_t>(written);
+			}
+		}
+
+		void sync() {
+			if (::fdatasync(fd_) != 0) {
+				throw std::runtime_error("Syncing " + path_ + " failed: " + std::strerror(errno));
+			}
+		}
+
+	 private:
+		void close() noexcept {
+			if (fd_ >= 0) {
+				::close(fd_);
+			}
+			fd_ = -1;
+		}
+
+		int fd_ = -1;
+		std::string path_;
+	};
+
+	// Flush a file or directory to disk, so that a rename into it survives a crash
+	inline void sync_path(std::string const& path) {
+		auto const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0) {
+			throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+		}
+		auto const failed = ::fsync(fd) != 0;
+		auto const error = errno;
+		::close(fd);
+		if (failed) {
+			throw std::runtime_error("Syncing " + path + " failed: " + std::strerror(error));
+		}
+	}
+
+	// Write the bytes to path through a temporary file and a rename, so the file is either whole or unchanged
+	inline void replace_file(std::string const& path, std::string_view bytes, std::string const& directory) {
+		auto const temporary = path + ".tmp";
+		std::remove(temporary.c_str());
+		{
+			auto file = append_file(temporary);
+			file.write(bytes.data(), bytes.size());
+			file.sync();
+		}
+		std::filesystem::rename(temporary, path);
+		sync_path(directory);
+	}
+} // namespace gdwg::detail
+
+#endif // GDWG_MAPPED_FILE_H
@@ -0,0 +1,558 @@
+#ifndef GDWG_PAGERANK_H
+#define GDWG_PAGERANK_H
+
+#include "gdwg_csr.h"
+#include "gdwg_graph.h"
+#include "gdwg_parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <optional>
+#include <set>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#	include <immintrin.h>
+#endif
+
+namespace gdwg {
+	// Sparse matrix in CSR form, used for pull-based iteration: row i gathers from the columns it lists
+	struct sparse_matrix {
+		std::size_t rows = 0;
+		std::size_t cols = 0;
+		std::vector<std::size_t> row_offsets = {0}; // Start of each row, plus one past the end
+		std::vector<std::size_t> columns; // Column of every entry
+		std::vector<double> values; // Value of every entry
+	};
+
+	// Stopping rule shared by the iterative solvers
+	struct iteration_options {
+		double tolerance = 1e-9; // Stop when the L1 change of an iteration drops below this
+		std::size_t max_iterations = 100;
+	};
+
+	// Outcome of an iterative solver
+	struct iteration_result {
+		std::size_t iterations = 0; // Iterations performed
+		double delta = 0; // L1 change of the last iteration
+		bool converged = false; // Whether delta dropped below the tolerance
+	};
+
+	namespace detail {
+		// Return sum(values[i] * x[cols[i]]) for i in [0, count)
+		inline double gather_dot(double const* values, std::size_t const* cols, double const* x, std::size_t count) {
+			auto sum = 0.0;
+			auto i = std::size_t{0};
+#if defined(__AVX2__)
+			static_assert(sizeof(std::size_t) == sizeof(long long), "AVX2 gather needs 64-bit indices");
+			auto acc = _mm256_setzero_pd();
+			for (; i + 4 <= count; i += 4) {
+				auto const idx = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(cols + i));
+				auto const gathered = _mm256_i64gather_pd(x, idx, 8);
+				acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_loadu_pd(values + i), gathered));
+			}
+			auto const halves = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+			sum = _mm_cvtsd_f64(_mm_add_sd(halves, _mm_unpackhi_pd(halves, halves)));
+#endif
+			for (; i < count; ++i) {
+				sum += values[i] * x[cols[i]];
+			}
+			return sum;
+		}
+
+		// Split the rows of a into chunks holding roughly the same number of entries
+		// Returns the chunk boundaries, starting with 0 and ending with a.rows
+		inline std::vector<std::size_t> balanced_rows(sparse_matrix const& a, std::size_t chunks) {
+			auto bounds = std::vector<std::size_t>{0};
+			auto const entries = a.columns.size() + a.rows; // Count each row as one entry of work
+			auto const per_chunk = std::max<std::size_t>(1, entries / std::max<std::size_t>(1, chunks));
+			auto next = per_chunk;
+			for (std::size_t row = 0; row < a.rows; ++row) {
+				if (a.row_offsets[row + 1] + row + 1 >= next) {
+					bounds.push_back(row + 1);
+					next = a.row_offsets[row + 1] + row + 1 + per_chunk;
+				}
+			}
+			if (bounds.back() != a.rows) {
+				bounds.push_back(a.rows);
+			}
+			return bounds;
+		}
+
+		// Compute y = alpha * (A x) + beta over the row chunks, returning sum |y_i - x_i|
+		inline double
+		affine_spmv(sparse_matrix const& a,
+		            std::vector<std::size_t> const& bounds,
+		            std::span<double const> x,
+		            std::span<double> y,
+		            double alpha,
+		            double beta,
+		            thread_pool& pool) {
+			auto partial = std::vector<double>(bounds.size() - 1, 0.0);
+			pool.run(bounds.size() - 1, [&](std::size_t chunk, std::size_t) {
+				auto change = 0.0;
+				for (auto row = bounds[chunk]; row < bounds[chunk + 1]; ++row) {
+					auto const first = a.row_offsets[row];
+					auto const count = a.row_offsets[row + 1] - first;
+					auto const value =
+					    alpha * gather_dot(a.values.data() + first, a.columns.data() + first, x.data(), count) + beta;
+					if (row < x.size()) {
+						change += std::abs(value - x[row]);
+					}
+					y[row] = value;
+				}
+				partial[chunk] = change;
+			});
+			auto total = 0.0;
+			for (auto change : partial) {
+				total += change;
+			}
+			return total;
+		}
+
+		// Chunks per worker used to balance skewed rows
+		constexpr auto chunks_per_worker = std::size_t{8};
+
+		// Return the transition weight of an edge: its value for arithmetic E, otherwise 1
+		template<typename E>
+		double transition_weight(std::optional<E> const& weight) {
+			if constexpr (std::is_arithmetic_v<E>) {
+				if (weight) {
+					if (*weight < E{}) {
+						throw std::runtime_error("Cannot call gdwg::pagerank on a graph with negative edge weights");
+					}
+					return static_cast<double>(*weight);
+				}
+			}
+			return 1.0;
+		}
+	} // namespace detail
+
+	// Compute y = A x, splitting the rows across the pool
+	inline void spmv(sparse_matrix const& a,
+	                 std::span<double const> x,
+	                 std::span<double> y,
+	                 thread_pool& pool = default_thread_pool()) {
+		if (x.size() != a.cols or y.size() != a.rows) {
+			throw std::runtime_error("Cannot call gdwg::spmv with vectors that don't match the matrix dimensions");
+		}
+		auto const bounds = detail::balanced_rows(a, pool.size() * detail::chunks_per_worker);
+		detail::affine_spmv(a, bounds, x, y, 1.0, 0.0, pool);
+	}
+
+	// Power iteration: repeat x <- A x / |A x|_1 until the L1 change drops below the tolerance
+	// x holds the starting vector on entry and the dominant eigenvector estimate on return
+	inline iteration_result power_iteration(sparse_matrix const& a,
+	                                        std::vector<double>& x,
+	                                        iteration_options const& options = {},
+	                                        thread_pool& pool = default_thread_pool()) {
+		if (a.rows != a.cols or x.size() != a.rows) {
+			throw std::runtime_error("Cannot call gdwg::power_iteration on a non-square matrix or a vector of the "
+			                         "wrong size");
+		}
+		auto const bounds = detail::balanced_rows(a, pool.size() * detail::chunks_per_worker);
+		auto next = std::vector<double>(x.size());
+		auto result = iteration_result{};
+		while (result.iterations < options.max_iterations) {
+			detail::affine_spmv(a, bounds, x, next, 1.0, 0.0, pool);
+			auto norm = 0.0;
+			for (auto value : next) {
+				norm += std::abs(value);
+			}
+			if (norm == 0.0) {
+				break; // x is in the null space of A
+			}
+			result.delta = 0.0;
+			for (std::size_t i = 0; i < next.size(); ++i) {
+				next[i] /= norm;
+				result.delta += std::abs(next[i] - x[i]);
+			}
+			x.swap(next);
+			++result.iterations;
+			if (result.delta < options.tolerance) {
+				result.converged = true;
+				break;
+			}
+		}
+		return result;
+	}
+
+	// Settings for PageRank
+	struct pagerank_options {
+		double damping = 0.85; // Probability of following an edge rather than teleporting
+		iteration_options iteration = {};
+	};
+
+	// PageRank of every node of a snapshot, by node index
+	struct pagerank_result {
+		std::vector<double> rank; // Rank of every node; the ranks sum to 1
+		iteration_result iteration;
+	};
+
+	// Build the pull-based transition matrix of g: row v holds (u, w(u, v) / W(u)) for every edge u -> v,
+	// where W(u) is the total weight leaving u. Arithmetic weights are transition weights; unweighted edges
+	// (and every edge of a graph with non-arithmetic E) weigh 1. Parallel edges add up
+	// Nodes with no outgoing weight are listed in dangling
+	template<typename N, typename E>
+	sparse_matrix transition_matrix(csr_graph<N, E> const& g, std::vector<std::size_t>* dangling = nullptr) {
+		auto const n = g.node_count();
+		auto weight_of = detail::transition_weight<E>;
+
+		auto out_weight = std::vector<double>(n, 0.0);
+		auto in_count = std::vector<std::size_t>(n + 1, 0);
+		for (std::size_t u = 0; u < n; ++u) {
+			auto const targets = g.neighbours(u);
+			auto const weights = g.weights(u);
+			for (std::size_t e = 0; e < targets.size(); ++e) {
+				out_weight[u] += weight_of(weights[e]);
+				++in_count[targets[e] + 1];
+			}
+		}
+
+		auto a = sparse_matrix{};
+		a.rows = n;
+		a.cols = n;
+		a.row_offsets.assign(n + 1, 0);
+		for (std::size_t v = 0; v < n; ++v) {
+			a.row_offsets[v + 1] = a.row_offsets[v] + in_count[v + 1];
+		}
+		a.columns.resize(g.edge_count());
+		a.values.resize(g.edge_count());
+		auto fill = std::vector<std::size_t>(a.row_offsets.begin(), a.row_offsets.end() - 1);
+		for (std::size_t u = 0; u < n; ++u) {
+			auto const targets = g.neighbours(u);
+			auto const weights = g.weights(u);
+			for (std::size_t e = 0; e < targets.size(); ++e) {
+				auto const slot = fill[targets[e]]++;
+				a.columns[slot] = u; // Sources are visited in order, so each row's columns stay sorted
+				a.values[slot] = out_weight[u] > 0.0 ? weight_of(weights[e]) / out_weight[u] : 0.0;
+			}
+			if (dangling and out_weight[u] == 0.0) {
+				dangling->push_back(u);
+			}
+		}
+		return a;
+	}
+
+	// Compute PageRank over a snapshot; the mass of dangling nodes is spread uniformly
+	// The L1 change is checked after every iteration
+	template<typename N, typename E>
+	[[nodiscard]] pagerank_result pagerank(csr_graph<N, E> const& g,
+	                                       pagerank_options const& options = {},
+	                                       thread_pool& pool = default_thread_pool()) {
+		if (options.damping < 0.0 or options.damping > 1.0) {
+			throw std::runtime_error("Cannot call gdwg::pagerank with a damping factor outside [0, 1]");
+		}
+		auto result = pagerank_result{};
+		auto const n = g.node_count();
+		if (n == 0) {
+			result.iteration.converged = true;
+			return result;
+		}
+		auto dangling = std::vector<std::size_t>{};
+		auto const a = transition_matrix(g, &dangling);
+		auto const bounds = detail::balanced_rows(a, pool.size() * detail::chunks_per_worker);
+		auto const size = static_cast<double>(n);
+
+		result.rank.assign(n, 1.0 / size);
+		auto next = std::vector<double>(n);
+		auto& it = result.iteration;
+		while (it.iterations < options.iteration.max_iterations) {
+			auto dangling_mass = 0.0;
+			for (auto u : dangling) {
+				dangling_mass += result.rank[u];
+			}
+			auto const teleport = (1.0 - options.damping + options.damping * dangling_mass) / size;
+			it.delta = detail::affine_spmv(a, bounds, result.rank, next, options.damping, teleport, pool);
+			result.rank.swap(next);
+			++it.iterations;
+			if (it.delta < options.iteration.tolerance) {
+				it.converged = true;
+				break;
+			}
+		}
+		return result;
+	}
+
+	// Compute PageRank over a graph, keyed by node value
+	template<typename N, typename E>
+	[[nodiscard]] std::map<N, double>
+	pagerank(graph<N, E> const& g, pagerank_options const& options = {}, thread_pool& pool = default_thread_pool()) {
+		auto const snapshot = csr_graph<N, E>(g);
+		auto const result = pagerank(snapshot, options, pool);
+		auto ranks = std::map<N, double>{};
+		for (std::size_t u = 0; u < snapshot.node_count(); ++u) {
+			ranks.emplace_hint(ranks.end(), snapshot.node(u), result.rank[u]);
+		}
+		return ranks;
+	}
+	// Settings for incremental PageRank
+	struct incremental_pagerank_options {
+		double damping = 0.85; // Probability of following an edge rather than teleporting
+		double tolerance = 1e-10; // Push a node once the magnitude of its residual exceeds this
+	};
+
+	// Outcome of one incremental update
+	struct incremental_pagerank_update {
+		std::size_t pushes = 0; // Residual pushes performed
+		double error_bound = 0; // Upper bound on the L1 distance between the ranks and exact PageRank
+	};
+
+	// PageRank kept up to date under edge insertions and deletions by forward push
+	// The ranks p and residuals r satisfy r = (1 - d) / n + d P^T p - p, so that the exact PageRank is
+	// p + (I - d P^T)^-1 r and |PageRank - p|_1 <= |r|_1 / (1 - d). An edge change at u only shifts the residuals
+	// of u's neighbours by d p(u) (P'(u, .) - P(u, .)); update() then pushes the residuals that exceed the
+	// tolerance, touching only the part of the graph the change reaches
+	// Edge changes must go through insert_edge and erase_edge (or be reported with touch); changing the
+	// node set requires rebuild()
+	template<typename N, typename E>
+	class incremental_pagerank {
+	 public:
+		// Start from a full PageRank computation over g
+		explicit incremental_pagerank(graph<N, E>& g,
+		                              incremental_pagerank_options const& options = {},
+		                              thread_pool& pool = default_thread_pool())
+		: graph_(&g)
+		, options_(options) {
+			if (options.damping < 0.0 or options.damping >= 1.0) {
+				throw std::runtime_error("Cannot construct gdwg::incremental_pagerank with a damping factor outside "
+				                         "[0, 1)");
+			}
+			rebuild(pool);
+		}
+
+		// Recompute the ranks from scratch, picking up any change to the node set
+		void rebuild(thread_pool& pool = default_thread_pool()) {
+			auto const snapshot = csr_graph<N, E>(*graph_);
+			auto const n = snapshot.node_count();
+			nodes_ = snapshot.nodes();
+			rows_.assign(n, {});
+			out_weight_.assign(n, 0.0);
+			for (std::size_t u = 0; u < n; ++u) {
+				auto const targets = snapshot.neighbours(u);
+				auto const weights = snapshot.weights(u);
+				for (std::size_t e = 0; e < targets.size(); ++e) {
+					auto const weight = detail::transition_weight<E>(weights[e]);
+					rows_[u].emplace_back(targets[e], weight);
+					out_weight_[u] += weight;
+				}
+			}
+
+			auto pagerank_settings = pagerank_options{};
+			pagerank_settings.damping = options_.damping;
+			pagerank_settings.iteration.tolerance = options_.tolerance;
+			pagerank_settings.iteration.max_iterations = 1000;
+			rank_ = pagerank(snapshot, pagerank_settings, pool).rank;
+
+			// One more product gives the exact residual of the starting ranks
+			residual_.assign(n, 0.0);
+			uniform_ = 0.0;
+			dirty_.clear();
+			queued_.assign(n, false);
+			queue_.clear();
+			if (n > 0) {
+				auto dangling = std::vector<std::size_t>{};
+				auto const a = transition_matrix(snapshot, &dangling);
+				auto dangling_mass = 0.0;
+				for (auto u : dangling) {
+					dangling_mass += rank_[u];
+				}
+				auto const size = static_cast<double>(n);
+				auto const teleport = (1.0 - options_.damping + options_.damping * dangling_mass) / size;
+				auto const bounds = detail::balanced_rows(a, pool.size() * detail::chunks_per_worker);
+				detail::affine_spmv(a, bounds, rank_, residual_, options_.damping, teleport, pool);
+				for (std::size_t v = 0; v < n; ++v) {
+					residual_[v] -= rank_[v];
+					enqueue(v);
+				}
+			}
+			last_ = {};
+			last_.error_bound = error_bound();
+		}
+
+		// Insert an edge into the graph, recording the change; returns what graph::insert_edge returns
+		bool insert_edge(N const& src, N const& dst, std::optional<E> weight = std::nullopt) {
+			auto const u = index_of(src, "insert_edge");
+			auto const v = index_of(dst, "insert_edge");
+			auto const w = detail::transition_weight<E>(weight);
+			if (!graph_->insert_edge(src, dst, weight)) {
+				return false;
+			}
+			detach(u);
+			rows_[u].emplace_back(v, w);
+			out_weight_[u] += w;
+			return true;
+		}
+
+		// Erase an edge from the graph, recording the change; returns what graph::erase_edge returns
+		bool erase_edge(N const& src, N const& dst, std::optional<E> weight = std::nullopt) {
+			auto const u = index_of(src, "erase_edge");
+			auto const v = index_of(dst, "erase_edge");
+			auto const w = detail::transition_weight<E>(weight);
+			if (!graph_->erase_edge(src, dst, weight)) {
+				return false;
+			}
+			detach(u);
+			auto& row = rows_[u];
+			auto it = std::find(row.begin(), row.end(), std::make_pair(v, w));
+			if (it != row.end()) {
+				row.erase(it);
+			}
+			out_weight_[u] -= w;
+			if (row.empty()) {
+				out_weight_[u] = 0.0; // Avoid leaving rounding error behind on a dangling node
+			}
+			return true;
+		}
+
+		// Report that src's outgoing edges were changed directly on the graph
+		// The new row is read in full before anything changes, so a throw leaves the ranks as they were
+		void touch(N const& src) {
+			auto const u = index_of(src, "touch");
+			auto row = std::vector<std::pair<std::size_t, double>>{};
+			auto out_weight = 0.0;
+			for (auto const& dst : graph_->connections(src)) {
+				auto const v = index_of(dst, "touch");
+				for (auto const& edge : graph_->edges(src, dst)) {
+					auto const w = detail::transition_weight<E>(edge->get_weight());
+					row.emplace_back(v, w);
+					out_weight += w;
+				}
+			}
+			detach(u);
+			rows_[u].swap(row);
+			out_weight_[u] = out_weight;
+		}
+
+		// Push the corrections of every change since the last update until all residuals are within tolerance
+		incremental_pagerank_update update() {
+			for (auto u : dirty_) {
+				spread(u, rank_[u]);
+			}
+			dirty_.clear();
+
+			auto result = incremental_pagerank_update{};
+			for (;;) {
+				while (!queue_.empty()) {
+					auto const v = queue_.front();
+					queue_.pop_front();
+					queued_[v] = false;
+					auto const amount = residual_[v];
+					if (std::abs(amount) <= options_.tolerance) {
+						continue;
+					}
+					residual_[v] = 0.0;
+					rank_[v] += amount;
+					spread(v, amount);
+					++result.pushes;
+				}
+				// Fold the residual owed to every node (from dangling nodes) in once it is large enough to matter
+				if (std::abs(uniform_) <= options_.tolerance) {
+					break;
+				}
+				for (std::size_t v = 0; v < residual_.size(); ++v) {
+					residual_[v] += uniform_;
+					enqueue(v);
+				}
+				uniform_ = 0.0;
+			}
+			result.error_bound = error_bound();
+			last_ = result;
+			return result;
+		}
+
+		// Return the current rank of a node
+		[[nodiscard]] double rank(N const& node) const {
+			return rank_[index_of(node, "rank")];
+		}
+
+		// Return the current ranks, keyed by node value
+		[[nodiscard]] std::map<N, double> ranks() const {
+			auto result = std::map<N, double>{};
+			for (std::size_t u = 0; u < nodes_.size(); ++u) {
+				result.emplace_hint(result.end(), nodes_[u], rank_[u]);
+			}
+			return result;
+		}
+
+		// Return the current ranks, by node index
+		[[nodiscard]] std::vector<double> const& rank_vector() const noexcept {
+			return rank_;
+		}
+
+		// Return the outcome of the last update (or rebuild)
+		[[nodiscard]] incremental_pagerank_update const& last_update() const noexcept {
+			return last_;
+		}
+
+	 private:
+		// Return the index of a node, throwing if it was not in the graph at the last rebuild
+		std::size_t index_of(N const& node, char const* caller) const {
+			auto it = std::lower_bound(nodes_.begin(), nodes_.end(), node);
+			if (it == nodes_.end() or node < *it) {
+				throw std::runtime_error(std::string("Cannot call gdwg::incremental_pagerank::") + caller
+				                         + " on a node that wasn't in the graph at the last rebuild");
+			}
+			return static_cast<std::size_t>(it - nodes_.begin());
+		}
+
+		// Before u's first change in a batch, take back what p(u) contributed through u's old edges
+		void detach(std::size_t u) {
+			if (dirty_.insert(u).second) {
+				spread(u, -rank_[u]);
+			}
+		}
+
+		// Add d * amount * P(u, .) to the residuals, queueing any that grow past the tolerance
+		void spread(std::size_t u, double amount) {
+			auto const scaled = options_.damping * amount;
+			if (out_weight_[u] <= 0.0) {
+				uniform_ += scaled / static_cast<double>(nodes_.size()); // Dangling: spread to every node
+				return;
+			}
+			for (auto const& [v, weight] : rows_[u]) {
+				residual_[v] += scaled * weight / out_weight_[u];
+				enqueue(v);
+			}
+		}
+
+		void enqueue(std::size_t v) {
+			if (!queued_[v] and std::abs(residual_[v]) > options_.tolerance) {
+				queued_[v] = true;
+				queue_.push_back(v);
+			}
+		}
+
+		// |r|_1 / (1 - d), where r includes the share owed to every node
+		[[nodiscard]] double error_bound() const {
+			auto total = 0.0;
+			for (auto value : residual_) {
+				total += std::abs(value + uniform_);
+			}
+			return total / (1.0 - options_.damping);
+		}
+
+		graph<N, E>* graph_; // Graph whose changes are tracked
+		incremental_pagerank_options options_;
+		std::vector<N> nodes_; // Node values at the last rebuild, indexed by node index
+		std::vector<std::vector<std::pair<std::size_t, double>>> rows_; // (target, weight) of every edge
+		std::vector<double> out_weight_; // Total weight leaving each node
+		std::vector<double> rank_; // Rank estimate p
+		std::vector<double> residual_; // Residual r, apart from the share owed to every node
+		double uniform_ = 0.0; // Residual owed to every node, from pushes through dangling nodes
+		std::set<std::size_t> dirty_; // Nodes whose edges changed since the last update
+		std::vector<bool> queued_; // Whether each node is in queue_
+		std::deque<std::size_t> queue_; // Nodes whose residual exceeds the tolerance
+		incremental_pagerank_update last_;
+	};
+} // namespace gdwg
+
+#endif // GDWG_PAGERANK_H
@@ -0,0 +1,216 @@
+#include "gdwg_pagerank.h"
+
+#include <catch2/catch.hpp>
+
+#include <numeric>
+
+namespace {
+	// Straightforward PageRank to compare against, with unit weights for unweighted edges
+	std::vector<double> reference_pagerank(gdwg::csr_graph<int, double> const& g, double damping, int iterations) {
+		auto const n = g.node_count();
+		auto rank = std::vector<double>(n, 1.0 / static_cast<double>(n));
+		for (auto it = 0; it < iterations; ++it) {
+			auto next = std::vector<double>(n, 0.0);
+			auto dangling = 0.0;
+			for (std::size_t u = 0; u < n; ++u) {
+				auto total = 0.0;
+				for (auto const& weight : g.weights(u)) {
+					total += weight.value_or(1.0);
+				}
+				if (total == 0.0) {
+					dangling += rank[u];
+					continue;
+				}
+				for (std::size_t e = 0; e < g.degree(u); ++e) {
+					next[g.neighbours(u)[e]] += damping * rank[u] * g.weights(u)[e].value_or(1.0) / total;
+				}
+			}
+			for (auto& value : next) {
+				value += (1.0 - damping + damping * dangling) / static_cast<double>(n);
+			}
+			rank = next;
+		}
+		return rank;
+	}
+} // namespace
+
+// SpMV and power iteration tests
+TEST_CASE("Sparse matrix vector product", "[pagerank]") {
+	// [[1 2 0 0 0 0]
+	//  [0 0 0 0 0 0]
+	//  [3 4 5 6 7 8]]
+	auto a = gdwg::sparse_matrix{};
+	a.rows = 3;
+	a.cols = 6;
+	a.row_offsets = {0, 2, 2, 8};
+	a.columns = {0, 1, 0, 1, 2, 3, 4, 5};
+	a.values = {1, 2, 3, 4, 5, 6, 7, 8};
+	auto const x = std::vector<double>{1, 1, 1, 1, 1, 2};
+	auto y = std::vector<double>(3);
+	auto pool = gdwg::thread_pool(2);
+	gdwg::spmv(a, x, y, pool);
+	REQUIRE(y == std::vector<double>{3, 0, 41});
+
+	auto wrong = std::vector<double>(2);
+	REQUIRE_THROWS_WITH(gdwg::spmv(a, x, wrong, pool),
+	                    "Cannot call gdwg::spmv with vectors that don't match the matrix dimensions");
+}
+
+TEST_CASE("Power iteration finds the dominant eigenvector", "[pagerank]") {
+	// [[2 1]
+	//  [1 2]] has dominant eigenvector (1, 1) with eigenvalue 3
+	auto a = gdwg::sparse_matrix{};
+	a.rows = 2;
+	a.cols = 2;
+	a.row_offsets = {0, 2, 4};
+	a.columns = {0, 1, 0, 1};
+	a.values = {2, 1, 1, 2};
+	auto x = std::vector<double>{1, 0};
+	auto const result = gdwg::power_iteration(a, x, {1e-12, 200});
+	REQUIRE(result.converged);
+	REQUIRE(x[0] == Approx(0.5));
+	REQUIRE(x[1] == Approx(0.5));
+}
+
+// PageRank tests
+TEST_CASE("PageRank of a cycle is uniform", "[pagerank]") {
+	gdwg::graph<std::string, int> g;
+	for (auto const& node : {"a", "b", "c"}) {
+		g.insert_node(node);
+	}
+	g.insert_edge("a", "b");
+	g.insert_edge("b", "c", 4);
+	g.insert_edge("c", "a", 9);
+
+	auto const ranks = gdwg::pagerank(g);
+	REQUIRE(ranks.size() == 3);
+	for (auto const& [node, rank] : ranks) {
+		REQUIRE(rank == Approx(1.0 / 3));
+	}
+}
+
+TEST_CASE("PageRank matches a reference implementation", "[pagerank]") {
+	gdwg::graph<int, double> g;
+	for (auto i = 0; i < 40; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 0; i < 40; ++i) {
+		// Mix of weighted, unweighted and parallel edges, with node 39 left dangling
+		if (i == 39) {
+			continue;
+		}
+		g.insert_edge(i, (i * 7 + 3) % 40, 0.5 + i % 3);
+		g.insert_edge(i, (i * 7 + 3) % 40);
+		g.insert_edge(i, (i + 1) % 40, 2.0);
+		g.insert_edge(i, i % 5);
+	}
+	auto const csr = gdwg::csr_graph<int, double>(g);
+	auto pool = gdwg::thread_pool(3);
+	auto options = gdwg::pagerank_options{};
+	options.iteration = {1e-14, 500};
+	auto const result = gdwg::pagerank(csr, options, pool);
+	REQUIRE(result.iteration.converged);
+	REQUIRE(std::accumulate(result.rank.begin(), result.rank.end(), 0.0) == Approx(1.0));
+
+	auto const expected = reference_pagerank(csr, 0.85, static_cast<int>(result.iteration.iterations));
+	for (std::size_t u = 0; u < csr.node_count(); ++u) {
+		REQUIRE(result.rank[u] == Approx(expected[u]).epsilon(1e-9));
+	}
+}
+
+TEST_CASE("PageRank argument checks", "[pagerank]") {
+	gdwg::graph<int, int> g;
+	g.insert_node(1);
+	g.insert_node(2);
+	g.insert_edge(1, 2, -1);
+	REQUIRE_THROWS_WITH(gdwg::pagerank(g), "Cannot call gdwg::pagerank on a graph with negative edge weights");
+
+	auto options = gdwg::pagerank_options{};
+	options.damping = 1.5;
+	REQUIRE_THROWS_WITH(gdwg::pagerank(gdwg::graph<int, int>{}, options),
+	                    "Cannot call gdwg::pagerank with a damping factor outside [0, 1]");
+	REQUIRE(gdwg::pagerank(gdwg::graph<int, int>{}).empty());
+}
+
+// Incremental PageRank tests
+TEST_CASE("Incremental PageRank tracks edge changes", "[pagerank]") {
+	gdwg::graph<int, double> g;
+	for (auto i = 0; i < 60; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 0; i < 59; ++i) {
+		g.insert_edge(i, (i * 11 + 5) % 60, 1.0 + i % 4);
+		g.insert_edge(i, (i + 1) % 60);
+	}
+
+	auto options = gdwg::incremental_pagerank_options{};
+	options.tolerance = 1e-12;
+	auto pool = gdwg::thread_pool(2);
+	auto incremental = gdwg::incremental_pagerank<int, double>(g, options, pool);
+	incremental.update();
+
+	// The ranks after each batch should match a full recomputation within the reported bound
+	auto check = [&](gdwg::incremental_pagerank_update const& update) {
+		auto full_options = gdwg::pagerank_options{};
+		full_options.iteration = {1e-15, 2000};
+		auto const exact = gdwg::pagerank(gdwg::csr_graph<int, double>(g), full_options, pool).rank;
+		auto error = 0.0;
+		for (std::size_t u = 0; u < exact.size(); ++u) {
+			error += std::abs(exact[u] - incremental.rank_vector()[u]);
+		}
+		REQUIRE(update.error_bound < 1e-8);
+		REQUIRE(error <= update.error_bound + 1e-12);
+	};
+
+	SECTION("Inserting edges") {
+		REQUIRE(incremental.insert_edge(3, 40, 5.0));
+		REQUIRE(incremental.insert_edge(59, 0)); // Node 59 was dangling
+		REQUIRE_FALSE(incremental.insert_edge(3, 40, 5.0)); // Already there
+		auto const update = incremental.update();
+		REQUIRE(update.pushes > 0);
+		check(update);
+	}
+
+	SECTION("Erasing edges") {
+		REQUIRE(incremental.erase_edge(10, 11));
+		REQUIRE(incremental.erase_edge(10, (10 * 11 + 5) % 60, 3.0));
+		REQUIRE_FALSE(incremental.erase_edge(10, 11)); // Already gone; node 10 is now dangling
+		check(incremental.update());
+	}
+
+	SECTION("Changes made directly on the graph") {
+		g.insert_edge(7, 8, 10.0);
+		g.erase_edge(7, 8);
+		incremental.touch(7);
+		check(incremental.update());
+	}
+
+	SECTION("A touch that throws changes nothing") {
+		auto const before = incremental.ranks();
+		g.insert_node(100);
+		g.insert_edge(7, 100, 1.0);
+		REQUIRE_THROWS_WITH(incremental.touch(7),
+		                    "Cannot call gdwg::incremental_pagerank::touch on a node that wasn't in the graph at the "
+		                    "last rebuild");
+		REQUIRE(incremental.update().pushes == 0);
+		REQUIRE(incremental.ranks() == before);
+		g.erase_node(100);
+		incremental.touch(7);
+		check(incremental.update());
+	}
+
+	SECTION("An update with no changes does no work") {
+		REQUIRE(incremental.update().pushes == 0);
+	}
+
+	SECTION("Nodes added after construction need a rebuild") {
+		g.insert_node(100);
+		REQUIRE_THROWS_WITH(incremental.insert_edge(100, 1),
+		                    "Cannot call gdwg::incremental_pagerank::insert_edge on a node that wasn't in the graph at "
+		                    "the last rebuild");
+		incremental.rebuild(pool);
+		REQUIRE(incremental.insert_edge(100, 1));
+		check(incremental.update());
+		REQUIRE(incremental.ranks().size() == 61);
+	}
+}
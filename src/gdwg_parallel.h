@@ -0,0 +1,187 @@
+#ifndef GDWG_PARALLEL_H
+#define GDWG_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// Fork-join thread pool used by the graph algorithms
+	// The calling thread takes part in every job as worker 0, so a pool of size 1 runs everything inline
+	class thread_pool {
+	 public:
+		// Construct a pool with the given number of workers (0 means one per hardware thread)
+		explicit thread_pool(std::size_t threads = 0)
+		: size_(threads == 0 ? std::max<std::size_t>(1, std::thread::hardware_concurrency()) : threads) {
+			workers_.reserve(size_ - 1);
+			for (std::size_t id = 1; id < size_; ++id) {
+				workers_.emplace_back([this, id] { work(id); });
+			}
+		}
+
+		thread_pool(thread_pool const&) = delete;
+		thread_pool& operator=(thread_pool const&) = delete;
+
+		~thread_pool() {
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				stop_ = true;
+			}
+			wake_.notify_all();
+			for (auto& worker : workers_) {
+				worker.join();
+			}
+		}
+
+		// Return the number of workers, including the calling thread
+		[[nodiscard]] std::size_t size() const noexcept {
+			return size_;
+		}
+
+		// Call fn(task, worker) for every task in [0, tasks), handing tasks out dynamically.
+		// Blocks until all tasks are done; the first exception thrown by a task is rethrown here
+		template<typename F>
+		void run(std::size_t tasks, F&& fn) {
+			if (tasks == 0) {
+				return;
+			}
+			auto next = std::atomic<std::size_t>{0};
+			auto error = std::exception_ptr{};
+			auto error_mutex = std::mutex{};
+			auto body = [&](std::size_t worker) {
+				for (auto task = next.fetch_add(1); task < tasks; task = next.fetch_add(1)) {
+					try {
+						fn(task, worker);
+					} catch (...) {
+						std::lock_guard<std::mutex> lock(error_mutex);
+						if (!error) {
+							error = std::current_exception();
+						}
+						next.store(tasks); // Stop handing out work
+					}
+				}
+			};
+			if (size_ == 1 or tasks == 1 or in_job()) {
+				body(0); // Nested calls from inside a task run inline instead of deadlocking
+			}
+			else {
+				std::lock_guard<std::mutex> serial(run_mutex_); // One job at a time
+				{
+					std::lock_guard<std::mutex> lock(mutex_);
+					job_ = body;
+					pending_ = size_ - 1;
+					++generation_;
+				}
+				wake_.notify_all();
+				in_job() = true;
+				body(0);
+				in_job() = false;
+				std::unique_lock<std::mutex> lock(mutex_);
+				done_.wait(lock, [this] { return pending_ == 0; });
+				job_ = nullptr;
+			}
+			if (error) {
+				std::rethrow_exception(error);
+			}
+		}
+
+	 private:
+		// Flag set on threads that are currently running a job
+		static bool& in_job() noexcept {
+			thread_local bool flag = false;
+			return flag;
+		}
+
+		void work(std::size_t id) {
+			auto seen = std::size_t{0};
+			for (;;) {
+				std::function<void(std::size_t)> job;
+				{
+					std::unique_lock<std::mutex> lock(mutex_);
+					wake_.wait(lock, [this, seen] { return stop_ or generation_ != seen; });
+					if (stop_) {
+						return;
+					}
+					seen = generation_;
+					job = job_;
+				}
+				in_job() = true;
+				job(id);
+				in_job() = false;
+				{
+					std::lock_guard<std::mutex> lock(mutex_);
+					--pending_;
+				}
+				done_.notify_one();
+			}
+		}
+
+		std::size_t size_; // Number of workers including the caller
+		std::vector<std::thread> workers_; // Background workers 1..size_-1
+		std::mutex run_mutex_; // Serialises concurrent calls to run()
+		std::mutex mutex_; // Guards the job state below
+		std::condition_variable wake_; // Signalled when a job is published or the pool stops
+		std::condition_variable done_; // Signalled when a worker finishes its share of a job
+		std::function<void(std::size_t)> job_; // Current job
+		std::size_t pending_ = 0; // Workers still running the current job
+		std::size_t generation_ = 0; // Incremented for every published job
+		bool stop_ = false;
+	};
+
+	// Return the process-wide pool with one worker per hardware thread
+	inline thread_pool& default_thread_pool() {
+		static thread_pool pool;
+		return pool;
+	}
+
+	// Split [first, last) into chunks of at most grain elements and call fn(lo, hi, worker) for each chunk
+	template<typename F>
+	void parallel_for(thread_pool& pool, std::size_t first, std::size_t last, std::size_t grain, F&& fn) {
+		if (first >= last) {
+			return;
+		}
+		grain = std::max<std::size_t>(1, grain);
+		auto const chunks = (last - first + grain - 1) / grain;
+		pool.run(chunks, [&](std::size_t chunk, std::size_t worker) {
+			auto const lo = first + chunk * grain;
+			fn(lo, std::min(last, lo + grain), worker);
+		});
+	}
+
+	// Sort [first, last) with comp: one block per worker is sorted in parallel, then neighbouring blocks are merged
+	// pairwise in parallel rounds
+	template<typename RandomIt, typename Compare = std::less<>>
+	void parallel_sort(thread_pool& pool, RandomIt first, RandomIt last, Compare comp = {}) {
+		auto const size = static_cast<std::size_t>(last - first);
+		auto const blocks = std::min(pool.size(), size / 4096 + 1);
+		if (blocks <= 1) {
+			std::sort(first, last, comp);
+			return;
+		}
+		auto bounds = std::vector<std::size_t>(blocks + 1);
+		for (std::size_t b = 0; b <= blocks; ++b) {
+			bounds[b] = size * b / blocks;
+		}
+		auto const at = [first](std::size_t i) { return first + static_cast<std::ptrdiff_t>(i); };
+		pool.run(blocks, [&](std::size_t b, std::size_t) { std::sort(at(bounds[b]), at(bounds[b + 1]), comp); });
+		for (std::size_t width = 1; width < blocks; width *= 2) {
+			pool.run((blocks + 2 * width - 1) / (2 * width), [&](std::size_t pair, std::size_t) {
+				auto const lo = pair * 2 * width;
+				auto const mid = std::min(lo + width, blocks);
+				auto const hi = std::min(lo + 2 * width, blocks);
+				if (mid < hi) {
+					std::inplace_merge(at(bounds[lo]), at(bounds[mid]), at(bounds[hi]), comp);
+				}
+			});
+		}
+	}
+} // namespace gdwg
+
+#endif // GDWG_PARALLEL_H
@@ -0,0 +1,75 @@
+#include "gdwg_parallel.h"
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+// Thread pool tests
+TEST_CASE("Thread pool runs every task once", "[parallel]") {
+	auto pool = gdwg::thread_pool(4);
+	REQUIRE(pool.size() == 4);
+
+	auto hits = std::vector<std::atomic<int>>(1000);
+	auto bad_worker = std::atomic<bool>{false};
+	pool.run(hits.size(), [&](std::size_t task, std::size_t worker) {
+		bad_worker = bad_worker or worker >= 4;
+		++hits[task];
+	});
+	REQUIRE_FALSE(bad_worker);
+	for (auto const& hit : hits) {
+		REQUIRE(hit == 1);
+	}
+}
+
+TEST_CASE("parallel_for covers the range in chunks", "[parallel]") {
+	auto pool = gdwg::thread_pool(3);
+	auto values = std::vector<int>(10007, 0);
+	auto oversized = std::atomic<bool>{false};
+	gdwg::parallel_for(pool, 0, values.size(), 100, [&](std::size_t lo, std::size_t hi, std::size_t) {
+		oversized = oversized or hi - lo > 100;
+		for (auto i = lo; i < hi; ++i) {
+			values[i] += 1;
+		}
+	});
+	REQUIRE_FALSE(oversized);
+	REQUIRE(std::accumulate(values.begin(), values.end(), 0) == 10007);
+
+	// An empty range runs nothing
+	auto calls = 0;
+	gdwg::parallel_for(pool, 5, 5, 1, [&](std::size_t, std::size_t, std::size_t) { ++calls; });
+	REQUIRE(calls == 0);
+}
+
+TEST_CASE("parallel_sort matches std::sort", "[parallel]") {
+	auto pool = gdwg::thread_pool(3);
+	auto rng = std::mt19937(42);
+	for (auto size : {std::size_t{0}, std::size_t{10}, std::size_t{50000}, std::size_t{100003}}) {
+		auto values = std::vector<std::pair<int, int>>(size);
+		for (auto& [key, order] : values) {
+			key = static_cast<int>(rng() % 1000);
+			order = static_cast<int>(rng() % 1000);
+		}
+		auto expected = values;
+		std::sort(expected.begin(), expected.end(), std::greater<>{});
+		gdwg::parallel_sort(pool, values.begin(), values.end(), std::greater<>{});
+		REQUIRE(values == expected);
+	}
+}
+
+TEST_CASE("Thread pool rethrows task exceptions", "[parallel]") {
+	auto pool = gdwg::thread_pool(2);
+	REQUIRE_THROWS_AS(pool.run(64,
+	                           [](std::size_t task, std::size_t) {
+		                           if (task == 13) {
+			                           throw std::runtime_error("task failed");
+		                           }
+	                           }),
+	                  std::runtime_error);
+
+	auto count = std::atomic<std::size_t>{0};
+	pool.run(10, [&](std::size_t, std::size_t) { ++count; });
+	REQUIRE(count == 10);
+}
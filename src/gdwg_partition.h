@@ -0,0 +1,559 @@
+#ifndef GDWG_PARTITION_H
+#define GDWG_PARTITION_H
+
+#include "gdwg_csr.h"
+#include "gdwg_graph.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <queue>
+#include <random>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	struct partition_options {
+		std::size_t parts = 2;
+		double imbalance = 0.03; // Every part may hold up to (1 + imbalance) times its share of the nodes
+		std::size_t coarsest = 100; // Stop coarsening once a graph has this few nodes
+		std::size_t initial_tries = 4; // Bisections grown on the coarsest graph, of which the best is kept
+		std::size_t refinement_passes = 8; // Fiduccia-Mattheyses passes per level, at most
+		std::uint64_t seed = 6771;
+	};
+
+	// Balanced partition of a snapshot, by node index
+	struct partition_labels {
+		std::vector<std::size_t> part; // Part id of every node, 0..parts-1
+		std::vector<std::size_t> sizes; // Number of nodes in each part
+		double cut = 0; // Total weight of the edges between parts
+	};
+
+	// Balanced partition of a graph, by node value
+	template<typename N>
+	struct graph_partition {
+		std::map<N, std::size_t> part; // Part id of every node, 0..parts-1
+		std::vector<std::size_t> sizes; // Number of nodes in each part
+		double cut = 0; // Total weight of the edges between parts
+	};
+
+	namespace detail {
+		// Undirected graph with node weights, one per coarsening level: edges are listed from both ends, with
+		// the weights of parallel edges summed and self loops dropped
+		struct weighted_graph {
+			std::vector<std::size_t> offsets;
+			std::vector<std::size_t> targets;
+			std::vector<double> weights; // Weight of every edge
+			std::vector<std::size_t> node_weights; // Number of original nodes merged into every node
+			std::size_t total_weight = 0;
+
+			[[nodiscard]] std::size_t node_count() const noexcept {
+				return node_weights.size();
+			}
+		};
+
+		// Cut costs of a snapshot: arithmetic weights are the costs and every other edge costs 1
+		template<typename N, typename E>
+		weighted_graph make_weighted_graph(csr_graph<N, E> const& g) {
+			auto const n = g.node_count();
+			auto offsets = std::vector<std::size_t>(n + 1, 0);
+			for (std::size_t u = 0; u < n; ++u) {
+				for (auto v : g.neighbours(u)) {
+					if (u != v) {
+						++offsets[u + 1];
+						++offsets[v + 1];
+					}
+				}
+			}
+			for (std::size_t u = 0; u < n; ++u) {
+				offsets[u + 1] += offsets[u];
+			}
+			auto both = std::vector<std::pair<std::size_t, double>>(offsets.back());
+			auto fill = std::vector<std::size_t>(offsets.begin(), offsets.end() - 1);
+			for (std::size_t u = 0; u < n; ++u) {
+				auto const targets = g.neighbours(u);
+				auto const weights = g.weights(u);
+				for (std::size_t e = 0; e < targets.size(); ++e) {
+					auto weight = 1.0;
+					if constexpr (std::is_arithmetic_v<E>) {
+						if (weights[e]) {
+							weight = static_cast<double>(*weights[e]);
+						}
+					}
+					if (weight < 0.0) {
+						throw std::runtime_error("Cannot call gdwg::partition_graph on a graph with negative edge "
+						                         "weights");
+					}
+					if (auto const v = targets[e]; u != v) {
+						both[fill[u]++] = {v, weight};
+						both[fill[v]++] = {u, weight};
+					}
+				}
+			}
+
+			auto result = weighted_graph{};
+			result.offsets.reserve(n + 1);
+			result.offsets.push_back(0);
+			for (std::size_t u = 0; u < n; ++u) {
+				auto const first = both.begin() + static_cast<std::ptrdiff_t>(offsets[u]);
+				auto const last = both.begin() + static_cast<std::ptrdiff_t>(offsets[u + 1]);
+				std::sort(first, last);
+				for (auto it = first; it != last; ++it) {
+					if (it != first and (it - 1)->first == it->first) {
+						result.weights.back() += it->second;
+					}
+					else {
+						result.targets.push_back(it->first);
+						result.weights.push_back(it->second);
+					}
+				}
+				result.offsets.push_back(result.targets.size());
+			}
+			result.node_weights.assign(n, 1);
+			result.total_weight = n;
+			return result;
+		}
+
+		// Contract a heavy-edge matching of g into a new graph: nodes are visited in random order, and each
+		// unmatched node is matched with the unmatched neighbour it shares the heaviest edge with, unless the
+		// pair would weigh more than max_weight. coarse_of receives the coarse node of every node
+		inline weighted_graph coarsen(weighted_graph const& g,
+		                              std::size_t max_weight,
+		                              std::mt19937_64& rng,
+		                              std::vector<std::size_t>& coarse_of) {
+			auto const n = g.node_count();
+			auto const none = std::numeric_limits<std::size_t>::max();
+			auto order = std::vector<std::size_t>(n);
+			for (std::size_t u = 0; u < n; ++u) {
+				order[u] = u;
+			}
+			std::shuffle(order.begin(), order.end(), rng);
+			auto mate = std::vector<std::size_t>(n, none);
+			for (auto u : order) {
+				if (mate[u] != none) {
+					continue;
+				}
+				auto best = u;
+				auto heaviest = -1.0;
+				for (auto e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+					auto const v = g.targets[e];
+					if (mate[v] == none and g.weights[e] > heaviest
+					    and g.node_weights[u] + g.node_weights[v] <= max_weight) {
+						best = v;
+						heaviest = g.weights[e];
+					}
+				}
+				mate[u] = best;
+				mate[best] = u;
+			}
+
+			auto members = std::vector<std::size_t>{}; // First member of every coarse node
+			coarse_of.assign(n, none);
+			for (std::size_t u = 0; u < n; ++u) {
+				if (coarse_of[u] == none) {
+					coarse_of[u] = coarse_of[mate[u]] = members.size();
+					members.push_back(u);
+				}
+			}
+
+			// Merge the rows of the members of every coarse node, summing edges that meet the same coarse node
+			auto result = weighted_graph{};
+			result.offsets.reserve(members.size() + 1);
+			result.offsets.push_back(0);
+			result.node_weights.assign(members.size(), 0);
+			result.total_weight = g.total_weight;
+			auto slot = std::vector<std::size_t>(members.size(), none); // Position of every target in the row
+			for (std::size_t c = 0; c < members.size(); ++c) {
+				auto const first = result.targets.size();
+				auto const pair = std::array<std::size_t, 2>{members[c], mate[members[c]]};
+				for (std::size_t k = 0; k < (pair[0] == pair[1] ? 1 : 2); ++k) {
+					auto const member = pair[k];
+					result.node_weights[c] += g.node_weights[member];
+					for (auto e = g.offsets[member]; e < g.offsets[member + 1]; ++e) {
+						auto const d = coarse_of[g.targets[e]];
+						if (d == c) {
+							continue;
+						}
+						if (slot[d] == none) {
+							slot[d] = result.targets.size();
+							result.targets.push_back(d);
+							result.weights.push_back(g.weights[e]);
+						}
+						else {
+							result.weights[slot[d]] += g.weights[e];
+						}
+					}
+				}
+				for (auto i = first; i < result.targets.size(); ++i) {
+					slot[result.targets[i]] = none;
+				}
+				result.offsets.push_back(result.targets.size());
+			}
+			return result;
+		}
+
+		// Two-way split of a weighted graph
+		struct bisection {
+			std::vector<std::uint8_t> side; // 0 or 1 for every node
+			std::array<std::size_t, 2> weight = {0, 0}; // Node weight of each side
+			double cut = 0;
+
+			// Node weight above the limits of the sides
+			[[nodiscard]] std::size_t excess(std::array<std::size_t, 2> const& limit) const noexcept {
+				auto const over = [](std::size_t w, std::size_t cap) { return w > cap ? w - cap : 0; };
+				return over(weight[0], limit[0]) + over(weight[1], limit[1]);
+			}
+
+			// Move node u, of the given weight, to the other side
+			void flip(std::size_t u, std::size_t node_weight) noexcept {
+				auto const from = std::size_t{side[u]};
+				weight[from] -= node_weight;
+				weight[1 - from] += node_weight;
+				side[u] = static_cast<std::uint8_t>(1 - from);
+			}
+
+			// Whether this split is better than other: closer to balanced, then a smaller cut
+			[[nodiscard]] bool better(bisection const& other, std::array<std::size_t, 2> const& limit) const noexcept {
+				auto const mine = excess(limit);
+				auto const theirs = other.excess(limit);
+				return mine != theirs ? mine < theirs : cut < other.cut;
+			}
+		};
+
+		inline double cut_of(weighted_graph const& g, std::vector<std::uint8_t> const& side) {
+			auto cut = 0.0;
+			for (std::size_t u = 0; u < g.node_count(); ++u) {
+				for (auto e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+					if (u < g.targets[e] and side[u] != side[g.targets[e]]) {
+						cut += g.weights[e];
+					}
+				}
+			}
+			return cut;
+		}
+
+		// Fiduccia-Mattheyses refinement: every pass moves unlocked nodes one at a time, always the node of
+		// highest gain (cut weight removed) whose move the balance allows, locks it, and finally rolls back to
+		// the best split seen. Moves out of an overweight side are always allowed, so passes also repair the
+		// balance. A pass gives up after a run of moves without improvement
+		inline void refine_bisection(weighted_graph const& g,
+		                             bisection& b,
+		                             std::array<std::size_t, 2> const& limit,
+		                             std::size_t passes) {
+			auto const n = g.node_count();
+			auto gain = std::vector<double>(n);
+			auto locked = std::vector<std::uint8_t>(n);
+			auto moves = std::vector<std::size_t>{};
+			auto heaps = std::array<std::priority_queue<std::pair<double, std::size_t>>, 2>{};
+			auto const patience = std::max<std::size_t>(50, n / 50);
+
+			for (std::size_t pass = 0; pass < passes; ++pass) {
+				for (auto& heap : heaps) {
+					heap = {};
+				}
+				for (std::size_t u = 0; u < n; ++u) {
+					gain[u] = 0.0;
+					for (auto e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+						gain[u] += b.side[g.targets[e]] != b.side[u] ? g.weights[e] : -g.weights[e];
+					}
+					locked[u] = 0;
+					heaps[b.side[u]].emplace(gain[u], u);
+				}
+				moves.clear();
+				auto best_excess = b.excess(limit);
+				auto best_cut = b.cut;
+				auto best_moves = std::size_t{0};
+
+				while (moves.size() < n and moves.size() - best_moves <= patience) {
+					// The best valid candidate of each side, if the balance lets it move
+					auto chosen = std::size_t{2};
+					for (std::size_t s = 0; s < 2; ++s) {
+						auto& heap = heaps[s];
+						while (!heap.empty()) {
+							auto const [top_gain, u] = heap.top();
+							if (!locked[u] and b.side[u] == s and top_gain == gain[u]) {
+								break;
+							}
+							heap.pop();
+						}
+						if (heap.empty()) {
+							continue;
+						}
+						auto const u = heap.top().second;
+						auto const other = 1 - s;
+						auto const arriving = b.weight[other] + g.node_weights[u];
+						auto const relieves = b.weight[s] > limit[s] and arriving < b.weight[s];
+						auto const allowed = arriving <= limit[other] or relieves;
+						if (allowed and (chosen == 2 or gain[u] > gain[heaps[chosen].top().second])) {
+							chosen = s;
+						}
+					}
+					if (chosen == 2) {
+						break;
+					}
+					auto const u = heaps[chosen].top().second;
+					heaps[chosen].pop();
+					auto const from = b.side[u];
+					b.cut -= gain[u];
+					b.flip(u, g.node_weights[u]);
+					locked[u] = 1;
+					moves.push_back(u);
+					for (auto e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+						auto const v = g.targets[e];
+						gain[v] += b.side[v] == from ? 2.0 * g.weights[e] : -2.0 * g.weights[e];
+						if (!locked[v]) {
+							heaps[b.side[v]].emplace(gain[v], v);
+						}
+					}
+
+					auto const excess = b.excess(limit);
+					if (excess < best_excess or (excess == best_excess and b.cut < best_cut - 1e-12)) {
+						best_excess = excess;
+						best_cut = b.cut;
+						best_moves = moves.size();
+					}
+				}
+
+				// Roll back the moves after the best split
+				for (auto i = moves.size(); i > best_moves; --i) {
+					b.flip(moves[i - 1], g.node_weights[moves[i - 1]]);
+				}
+				b.cut = best_cut;
+				if (best_moves == 0) {
+					break;
+				}
+			}
+		}
+
+		// Grow side 0 breadth first from a random node until it holds the target weight, then refine; the best of
+		// several tries is kept
+		inline bisection initial_bisection(weighted_graph const& g,
+		                                   std::size_t target,
+		                                   std::array<std::size_t, 2> const& limit,
+		                                   partition_options const& options,
+		                                   std::mt19937_64& rng) {
+			auto const n = g.node_count();
+			auto order = std::vector<std::size_t>(n);
+			for (std::size_t u = 0; u < n; ++u) {
+				order[u] = u;
+			}
+			auto queued = std::vector<std::uint8_t>(n);
+			auto queue = std::vector<std::size_t>{};
+			auto best = bisection{};
+			for (std::size_t attempt = 0; attempt < std::max<std::size_t>(1, options.initial_tries); ++attempt) {
+				std::shuffle(order.begin(), order.end(), rng);
+				auto b = bisection{};
+				b.side.assign(n, 1);
+				b.weight = {0, g.total_weight};
+				std::fill(queued.begin(), queued.end(), 0);
+				queue.clear();
+				auto head = std::size_t{0};
+				auto next_seed = std::size_t{0};
+				while (b.weight[0] < target) {
+					if (head == queue.size()) {
+						// Start again from an unreached node, e.g. in another component
+						while (queued[order[next_seed]]) {
+							++next_seed;
+						}
+						queued[order[next_seed]] = 1;
+						queue.push_back(order[next_seed]);
+					}
+					auto const u = queue[head++];
+					b.flip(u, g.node_weights[u]);
+					for (auto e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+						if (!queued[g.targets[e]]) {
+							queued[g.targets[e]] = 1;
+							queue.push_back(g.targets[e]);
+						}
+					}
+				}
+				b.cut = cut_of(g, b.side);
+				refine_bisection(g, b, limit, options.refinement_passes);
+				if (attempt == 0 or b.better(best, limit)) {
+					best = std::move(b);
+				}
+			}
+			return best;
+		}
+
+		// Multilevel bisection: coarsen by heavy-edge matching, split the coarsest graph, then project the split
+		// back level by level, refining it at every level
+		inline bisection multilevel_bisection(weighted_graph const& g,
+		                                      std::size_t target,
+		                                      std::array<std::size_t, 2> const& limit,
+		                                      partition_options const& options,
+		                                      std::mt19937_64& rng) {
+			auto levels = std::vector<weighted_graph>{};
+			auto maps = std::vector<std::vector<std::size_t>>{}; // Coarse node of every node of the level above
+			auto const coarsest = std::max<std::size_t>(options.coarsest, 2);
+			// Keep coarse nodes light enough that the coarsest graph can still be balanced
+			auto const max_weight = std::max<std::size_t>(
+			   1,
+			   static_cast<std::size_t>(1.5 * static_cast<double>(g.total_weight) / static_cast<double>(coarsest)));
+			while (true) {
+				auto const& current = levels.empty() ? g : levels.back();
+				if (current.node_count() <= coarsest) {
+					break;
+				}
+				auto map = std::vector<std::size_t>{};
+				auto coarse = coarsen(current, max_weight, rng, map);
+				if (coarse.node_count() * 20 > current.node_count() * 19) {
+					break; // Matching has stalled, e.g. on a star
+				}
+				levels.push_back(std::move(coarse));
+				maps.push_back(std::move(map));
+			}
+
+			auto b = initial_bisection(levels.empty() ? g : levels.back(), target, limit, options, rng);
+			for (auto level = levels.size(); level > 0; --level) {
+				auto const& fine = level > 1 ? levels[level - 2] : g;
+				auto const& map = maps[level - 1];
+				auto side = std::vector<std::uint8_t>(fine.node_count());
+				for (std::size_t u = 0; u < side.size(); ++u) {
+					side[u] = b.side[map[u]];
+				}
+				b.side = std::move(side); // Weights and cut carry over unchanged
+				refine_bisection(fine, b, limit, options.refinement_passes);
+			}
+			return b;
+		}
+
+		// The subgraph induced by one side of a split, with its nodes renumbered; original receives the
+		// original node of every subgraph node
+		inline weighted_graph induced_subgraph(weighted_graph const& g,
+		                                       std::vector<std::uint8_t> const& side,
+		                                       std::uint8_t which,
+		                                       std::vector<std::size_t> const& parent_original,
+		                                       std::vector<std::size_t>& original) {
+			auto const n = g.node_count();
+			auto local = std::vector<std::size_t>(n, std::numeric_limits<std::size_t>::max());
+			original.clear();
+			auto result = weighted_graph{};
+			for (std::size_t u = 0; u < n; ++u) {
+				if (side[u] == which) {
+					local[u] = original.size();
+					original.push_back(parent_original[u]);
+					result.node_weights.push_back(g.node_weights[u]);
+					result.total_weight += g.node_weights[u];
+				}
+			}
+			result.offsets.reserve(original.size() + 1);
+			result.offsets.push_back(0);
+			for (std::size_t u = 0; u < n; ++u) {
+				if (side[u] != which) {
+					continue;
+				}
+				for (auto e = g.offsets[u]; e < g.offsets[u + 1]; ++e) {
+					if (side[g.targets[e]] == which) {
+						result.targets.push_back(local[g.targets[e]]);
+						result.weights.push_back(g.weights[e]);
+					}
+				}
+				result.offsets.push_back(result.targets.size());
+			}
+			return result;
+		}
+
+		// Split g into parts parts numbered from first_part by recursive multilevel bisection; every
+		// bisection gets the slack per_level, so the slack compounds to the requested imbalance
+		inline void recursive_bisection(weighted_graph const& g,
+		                                std::vector<std::size_t> const& original,
+		                                std::size_t parts,
+		                                std::size_t first_part,
+		                                double per_level,
+		                                partition_options const& options,
+		                                std::mt19937_64& rng,
+		                                std::vector<std::size_t>& part) {
+			if (parts == 1 or g.node_count() == 0) {
+				for (auto u : original) {
+					part[u] = first_part;
+				}
+				return;
+			}
+			auto const left = parts / 2;
+			auto const target = (g.total_weight * left + parts / 2) / parts;
+			auto const targets = std::array<std::size_t, 2>{target, g.total_weight - target};
+			auto limit = std::array<std::size_t, 2>{};
+			for (std::size_t s = 0; s < 2; ++s) {
+				limit[s] = static_cast<std::size_t>(static_cast<double>(targets[s]) * (1.0 + per_level));
+			}
+			auto const b = multilevel_bisection(g, target, limit, options, rng);
+			auto sub_original = std::vector<std::size_t>{};
+			for (std::uint8_t s = 0; s < 2; ++s) {
+				auto const sub = induced_subgraph(g, b.side, s, original, sub_original);
+				recursive_bisection(sub,
+				                    sub_original,
+				                    s == 0 ? left : parts - left,
+				                    s == 0 ? first_part : first_part + left,
+				                    per_level,
+				                    options,
+				                    rng,
+				                    part);
+			}
+		}
+	} // namespace detail
+
+	// Split a snapshot into balanced parts with a small edge cut, for sharding
+	// Multilevel recursive bisection: every bisection coarsens the graph by heavy-edge matching, building a new
+	// compact graph per level, grows an initial split of the coarsest graph and refines it with
+	// Fiduccia-Mattheyses on the way back up. The snapshot is treated as undirected: an edge's cut cost is its
+	// weight (1 if unweighted or not arithmetic), and edges in both directions between two nodes both count.
+	// Parts hold at most (1 + imbalance) times their share of the nodes whenever the refinement can reach that.
+	// The result depends only on the graph and the options
+	template<typename N, typename E>
+	[[nodiscard]] partition_labels partition_graph(csr_graph<N, E> const& g, partition_options const& options = {}) {
+		if (options.parts == 0) {
+			throw std::runtime_error("Cannot call gdwg::partition_graph with zero parts");
+		}
+		auto const level = detail::make_weighted_graph(g);
+		auto const n = g.node_count();
+		auto result = partition_labels{};
+		result.part.assign(n, 0);
+		auto original = std::vector<std::size_t>(n);
+		for (std::size_t u = 0; u < n; ++u) {
+			original[u] = u;
+		}
+		auto depth = 0.0;
+		for (std::size_t span = 1; span < options.parts; span *= 2) {
+			++depth;
+		}
+		auto const per_level = depth > 0 ? std::pow(1.0 + std::max(options.imbalance, 0.0), 1.0 / depth) - 1.0 : 0.0;
+		auto rng = std::mt19937_64(options.seed);
+		detail::recursive_bisection(level, original, options.parts, 0, per_level, options, rng, result.part);
+
+		result.sizes.assign(options.parts, 0);
+		for (auto p : result.part) {
+			++result.sizes[p];
+		}
+		for (std::size_t u = 0; u < n; ++u) {
+			for (auto e = level.offsets[u]; e < level.offsets[u + 1]; ++e) {
+				if (u < level.targets[e] and result.part[u] != result.part[level.targets[e]]) {
+					result.cut += level.weights[e];
+				}
+			}
+		}
+		return result;
+	}
+
+	// Split a graph into balanced parts with a small edge cut, by node value
+	template<typename N, typename E>
+	[[nodiscard]] graph_partition<N> partition_graph(graph<N, E> const& g, partition_options const& options = {}) {
+		auto const snapshot = csr_graph<N, E>(g);
+		auto const labels = partition_graph(snapshot, options);
+		auto result = graph_partition<N>{};
+		for (std::size_t u = 0; u < snapshot.node_count(); ++u) {
+			result.part.emplace_hint(result.part.end(), snapshot.node(u), labels.part[u]);
+		}
+		result.sizes = labels.sizes;
+		result.cut = labels.cut;
+		return result;
+	}
+} // namespace gdwg
+
+#endif // GDWG_PARTITION_H
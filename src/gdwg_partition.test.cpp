@@ -0,0 +1,180 @@
+#include "gdwg_partition.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <random>
+
+namespace {
+	// Total weight of the snapshot's edges whose ends are in different parts
+	double cut_of(gdwg::csr_graph<int, int> const& g, std::vector<std::size_t> const& part) {
+		auto cut = 0.0;
+		for (std::size_t u = 0; u < g.node_count(); ++u) {
+			auto const targets = g.neighbours(u);
+			auto const weights = g.weights(u);
+			for (std::size_t e = 0; e < targets.size(); ++e) {
+				if (part[u] != part[targets[e]]) {
+					cut += weights[e] ? *weights[e] : 1;
+				}
+			}
+		}
+		return cut;
+	}
+
+	gdwg::graph<int, int> grid(int width, int height) {
+		gdwg::graph<int, int> g;
+		for (auto v = 0; v < width * height; ++v) {
+			g.insert_node(v);
+		}
+		for (auto y = 0; y < height; ++y) {
+			for (auto x = 0; x < width; ++x) {
+				if (x + 1 < width) {
+					g.insert_edge(y * width + x, y * width + x + 1);
+				}
+				if (y + 1 < height) {
+					g.insert_edge(y * width + x, (y + 1) * width + x);
+				}
+			}
+		}
+		return g;
+	}
+} // namespace
+
+// Graph partitioning tests
+TEST_CASE("Two cliques split at their bridge", "[partition]") {
+	gdwg::graph<int, int> g;
+	for (auto v = 0; v < 10; ++v) {
+		g.insert_node(v);
+	}
+	for (auto base : {0, 5}) {
+		for (auto u = base; u < base + 5; ++u) {
+			for (auto v = u + 1; v < base + 5; ++v) {
+				g.insert_edge(u, v, 3);
+			}
+		}
+	}
+	g.insert_edge(4, 5, 1);
+
+	auto const result = gdwg::partition_graph(g);
+	REQUIRE(result.sizes == std::vector<std::size_t>{5, 5});
+	REQUIRE(result.cut == 1.0);
+	for (auto v = 0; v < 10; ++v) {
+		REQUIRE(result.part.at(v) == result.part.at(v < 5 ? 0 : 5));
+	}
+	REQUIRE(result.part.at(0) != result.part.at(5));
+}
+
+TEST_CASE("Edge weights are the cut costs", "[partition]") {
+	// a - b - c - d with a light middle edge, and a heavy edge in both directions at the ends
+	gdwg::graph<char, int> g{'a', 'b', 'c', 'd'};
+	g.insert_edge('a', 'b', 10);
+	g.insert_edge('b', 'a', 5);
+	g.insert_edge('b', 'c', 2);
+	g.insert_edge('c', 'd', 10);
+	g.insert_edge('c', 'c', 100); // Loops never cross
+	auto options = gdwg::partition_options{};
+	options.imbalance = 0.0;
+	auto const result = gdwg::partition_graph(g, options);
+	REQUIRE(result.part.at('a') == result.part.at('b'));
+	REQUIRE(result.part.at('c') == result.part.at('d'));
+	REQUIRE(result.part.at('a') != result.part.at('c'));
+	REQUIRE(result.cut == 2.0);
+}
+
+TEST_CASE("Grids split into balanced parts with short borders", "[partition]") {
+	auto const g = grid(40, 40);
+	auto const snapshot = gdwg::csr_graph<int, int>(g);
+	for (auto parts : {std::size_t{2}, std::size_t{3}, std::size_t{4}, std::size_t{8}}) {
+		auto options = gdwg::partition_options{};
+		options.parts = parts;
+		auto const result = gdwg::partition_graph(snapshot, options);
+		REQUIRE(result.part.size() == 1600);
+		REQUIRE(result.sizes.size() == parts);
+		auto const limit = 1.03 * 1600.0 / static_cast<double>(parts);
+		for (auto size : result.sizes) {
+			REQUIRE(static_cast<double>(size) <= limit);
+		}
+		REQUIRE(result.cut == cut_of(snapshot, result.part));
+		// Straight cuts between strips cost 40 per border; allow some slack for ragged borders
+		REQUIRE(result.cut <= 1.5 * 40.0 * static_cast<double>(parts - 1));
+	}
+}
+
+TEST_CASE("Planted partitions are found", "[partition]") {
+	auto rng = std::mt19937(39);
+	auto coin = std::uniform_real_distribution<double>(0.0, 1.0);
+	constexpr auto groups = 4;
+	constexpr auto group_size = 250;
+	gdwg::graph<int, int> g;
+	for (auto v = 0; v < groups * group_size; ++v) {
+		g.insert_node(v);
+	}
+	// Groups are interleaved, so node order gives no hint
+	auto crossing = 0.0;
+	for (auto u = 0; u < groups * group_size; ++u) {
+		for (auto v = u + 1; v < groups * group_size; ++v) {
+			auto const same = u % groups == v % groups;
+			if (coin(rng) < (same ? 0.05 : 0.001)) {
+				g.insert_edge(u, v);
+				crossing += same ? 0.0 : 1.0;
+			}
+		}
+	}
+	auto const snapshot = gdwg::csr_graph<int, int>(g);
+	auto options = gdwg::partition_options{};
+	options.parts = groups;
+	auto const result = gdwg::partition_graph(snapshot, options);
+	REQUIRE(result.cut <= crossing);
+	for (std::size_t u = 0; u < snapshot.node_count(); ++u) {
+		REQUIRE(result.part[u] == result.part[u % groups]);
+	}
+
+	// The same options give the same partition
+	REQUIRE(gdwg::partition_graph(snapshot, options).part == result.part);
+}
+
+TEST_CASE("Partitioning edge cases", "[partition]") {
+	SECTION("Fewer nodes than parts") {
+		gdwg::graph<int, int> g{1, 2, 3};
+		auto options = gdwg::partition_options{};
+		options.parts = 5;
+		auto const result = gdwg::partition_graph(g, options);
+		auto sizes = result.sizes;
+		std::sort(sizes.begin(), sizes.end());
+		REQUIRE(sizes == std::vector<std::size_t>{0, 0, 1, 1, 1});
+		REQUIRE(result.cut == 0.0);
+	}
+
+	SECTION("One part and empty graphs") {
+		auto const g = grid(5, 5);
+		auto options = gdwg::partition_options{};
+		options.parts = 1;
+		auto const result = gdwg::partition_graph(g, options);
+		REQUIRE(result.sizes == std::vector<std::size_t>{25});
+		REQUIRE(result.cut == 0.0);
+		REQUIRE(gdwg::partition_graph(gdwg::graph<int, int>{}).sizes == std::vector<std::size_t>{0, 0});
+	}
+
+	SECTION("Disconnected graphs and stars still balance") {
+		gdwg::graph<int, int> g;
+		for (auto v = 0; v < 301; ++v) {
+			g.insert_node(v);
+		}
+		for (auto v = 1; v < 201; ++v) {
+			g.insert_edge(0, v);
+		}
+		auto const result = gdwg::partition_graph(g);
+		REQUIRE(std::max(result.sizes[0], result.sizes[1]) <= 155);
+	}
+
+	SECTION("Invalid input throws") {
+		gdwg::graph<int, int> g{1, 2};
+		g.insert_edge(1, 2, -1);
+		REQUIRE_THROWS_WITH(gdwg::partition_graph(g),
+		                    "Cannot call gdwg::partition_graph on a graph with negative edge weights");
+		auto options = gdwg::partition_options{};
+		options.parts = 0;
+		REQUIRE_THROWS_WITH(gdwg::partition_graph(gdwg::graph<int, int>{1}, options),
+		                    "Cannot call gdwg::partition_graph with zero parts");
+	}
+}
@@ -0,0 +1,330 @@
+#ifndef GDWG_PATHS_H
+#define GDWG_PATHS_H
+
+#include "gdwg_csr.h"
+#include "gdwg_graph.h"
+#include "gdwg_parallel.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	// A path through a snapshot as a sequence of edge positions (indices into the snapshot's edge arrays)
+	struct index_path {
+		std::vector<std::size_t> edges;
+		double length = 0;
+	};
+
+	// A path through a graph as a sequence of edges, in the same form the graph's iterator yields them
+	template<typename N, typename E>
+	struct graph_path {
+		std::vector<typename graph<N, E>::iterator::value_type> edges;
+		double length = 0;
+	};
+
+	namespace detail {
+		// Edge lengths and reverse adjacency of a snapshot, shared by all searches over it
+		struct path_network {
+			std::vector<std::size_t> offsets; // Forward CSR offsets (the snapshot's)
+			std::vector<std::size_t> targets; // Forward CSR targets (the snapshot's)
+			std::vector<std::size_t> sources; // Source node of every edge
+			std::vector<double> lengths; // Length of every edge
+			std::vector<std::size_t> in_offsets; // Reverse CSR over edge positions
+			std::vector<std::size_t> in_edges;
+		};
+
+		template<typename N, typename E>
+		path_network make_path_network(csr_graph<N, E> const& g) {
+			auto const n = g.node_count();
+			auto network = path_network{g.offsets(), g.targets(), {}, {}, {}, {}};
+			network.sources.reserve(g.edge_count());
+			network.lengths.reserve(g.edge_count());
+			for (std::size_t u = 0; u < n; ++u) {
+				for (auto const& weight : g.weights(u)) {
+					auto length = 1.0;
+					if constexpr (std::is_arithmetic_v<E>) {
+						if (weight) {
+							length = static_cast<double>(*weight);
+							if (length < 0.0) {
+								throw std::runtime_error("Cannot call gdwg::k_shortest_paths on a graph with negative "
+								                         "edge weights");
+							}
+						}
+					}
+					network.sources.push_back(u);
+					network.lengths.push_back(length);
+				}
+			}
+			network.in_offsets.assign(n + 1, 0);
+			for (auto v : network.targets) {
+				++network.in_offsets[v + 1];
+			}
+			for (std::size_t v = 0; v < n; ++v) {
+				network.in_offsets[v + 1] += network.in_offsets[v];
+			}
+			network.in_edges.assign(network.targets.size(), 0);
+			auto fill = std::vector<std::size_t>(network.in_offsets.begin(), network.in_offsets.end() - 1);
+			for (std::size_t e = 0; e < network.targets.size(); ++e) {
+				network.in_edges[fill[network.targets[e]]++] = e;
+			}
+			return network;
+		}
+
+		// Reusable Dijkstra/A* state: arrays are sized once and reset through generation stamps,
+		// so a search allocates nothing once its heap has grown to the working size
+		class path_search {
+		 public:
+			static constexpr auto infinity = std::numeric_limits<double>::infinity();
+
+			explicit path_search(std::size_t nodes, std::size_t edges)
+			: distance_(nodes, infinity)
+			, parent_(nodes, none)
+			, seen_(nodes, 0)
+			, done_(nodes, 0)
+			, node_ban_(nodes, 0)
+			, edge_ban_(edges, 0) {}
+
+			// Start a new search; bans from previous searches are forgotten
+			void reset() {
+				++stamp_;
+			}
+
+			void ban_node(std::size_t v) {
+				node_ban_[v] = stamp_;
+			}
+
+			void ban_edge(std::size_t e) {
+				edge_ban_[e] = stamp_;
+			}
+
+			// Distances from every node to dst over the full network (the A* heuristic)
+			void distances_to(path_network const& g, std::size_t dst, std::vector<double>& out) {
+				reset();
+				run(g, dst, none, nullptr, true);
+				out.assign(distance_.size(), infinity);
+				for (std::size_t v = 0; v < out.size(); ++v) {
+					if (seen_[v] == stamp_) {
+						out[v] = distance_[v];
+					}
+				}
+			}
+
+			// Shortest path from src to dst avoiding the banned nodes and edges, guided by the lower bounds in
+			// remaining (distances to dst in the full network). Appends the edges to path and returns the length,
+			// or infinity if dst is unreachable
+			double shortest(path_network const& g,
+			                std::size_t src,
+			                std::size_t dst,
+			                std::vector<double> const& remaining,
+			                std::vector<std::size_t>& path) {
+				run(g, src, dst, &remaining, false);
+				if (done_[dst] != stamp_) {
+					return infinity;
+				}
+				auto const first = path.size();
+				for (auto v = dst; v != src; v = g.sources[parent_[v]]) {
+					path.push_back(parent_[v]);
+				}
+				std::reverse(path.begin() + static_cast<std::ptrdiff_t>(first), path.end());
+				return distance_[dst];
+			}
+
+		 private:
+			static constexpr auto none = std::numeric_limits<std::size_t>::max();
+
+			void run(path_network const& g,
+			         std::size_t src,
+			         std::size_t dst,
+			         std::vector<double> const* remaining,
+			         bool reverse) {
+				auto bound = [remaining](std::size_t v) { return remaining ? (*remaining)[v] : 0.0; };
+				heap_.clear();
+				distance_[src] = 0.0;
+				parent_[src] = none;
+				seen_[src] = stamp_;
+				heap_.emplace_back(bound(src), src);
+				while (!heap_.empty()) {
+					std::pop_heap(heap_.begin(), heap_.end(), std::greater<>{});
+					auto const v = heap_.back().second;
+					heap_.pop_back();
+					if (done_[v] == stamp_) {
+						continue;
+					}
+					done_[v] = stamp_;
+					if (v == dst) {
+						return;
+					}
+					auto const first = reverse ? g.in_offsets[v] : g.offsets[v];
+					auto const last = reverse ? g.in_offsets[v + 1] : g.offsets[v + 1];
+					for (auto i = first; i < last; ++i) {
+						auto const e = reverse ? g.in_edges[i] : i;
+						auto const w = reverse ? g.sources[e] : g.targets[e];
+						if (edge_ban_[e] == stamp_ or node_ban_[w] == stamp_ or done_[w] == stamp_) {
+							continue;
+						}
+						if (bound(w) == infinity) {
+							continue; // dst is unreachable from w
+						}
+						auto const candidate = distance_[v] + g.lengths[e];
+						if (seen_[w] != stamp_ or candidate < distance_[w]) {
+							seen_[w] = stamp_;
+							distance_[w] = candidate;
+							parent_[w] = e;
+							heap_.emplace_back(candidate + bound(w), w);
+							std::push_heap(heap_.begin(), heap_.end(), std::greater<>{});
+						}
+					}
+				}
+			}
+
+			std::vector<double> distance_;
+			std::vector<std::size_t> parent_; // Edge used to reach each node
+			std::vector<std::uint64_t> seen_; // Stamp of the search that reached each node
+			std::vector<std::uint64_t> done_; // Stamp of the search that settled each node
+			std::vector<std::uint64_t> node_ban_;
+			std::vector<std::uint64_t> edge_ban_;
+			std::vector<std::pair<double, std::size_t>> heap_;
+			std::uint64_t stamp_ = 1;
+		};
+	} // namespace detail
+
+	// Yen's algorithm for the k shortest loopless paths from src to dst, in non-decreasing length
+	// Paths are sequences of edges, so routes that differ only in which parallel edge they take are distinct.
+	// Arithmetic weights are lengths (unweighted edges have length 1). As in the Martins-Pascoal-Santos
+	// refinements, every spur search is an A* search guided by exact distances to dst in the full graph, and
+	// skips nodes that cannot reach dst. The spur searches of each round run in parallel, one reusable search
+	// context per worker
+	template<typename N, typename E>
+	[[nodiscard]] std::vector<index_path> k_shortest_paths(csr_graph<N, E> const& g,
+	                                                       std::size_t src,
+	                                                       std::size_t dst,
+	                                                       std::size_t k,
+	                                                       thread_pool& pool = default_thread_pool()) {
+		auto result = std::vector<index_path>{};
+		if (k == 0) {
+			return result;
+		}
+		if (src == dst) {
+			result.push_back({}); // Only the empty path is loopless
+			return result;
+		}
+		auto const network = detail::make_path_network(g);
+		auto const n = g.node_count();
+		auto searches = std::vector<std::optional<detail::path_search>>(pool.size());
+		searches[0].emplace(n, g.edge_count());
+
+		auto remaining = std::vector<double>{};
+		searches[0]->distances_to(network, dst, remaining);
+		if (remaining[src] == detail::path_search::infinity) {
+			return result;
+		}
+		auto first = index_path{};
+		searches[0]->reset();
+		first.length = searches[0]->shortest(network, src, dst, remaining, first.edges);
+		result.push_back(std::move(first));
+
+		// Candidates ordered by (length, edges); the set also removes duplicate spur results
+		auto candidates = std::set<std::pair<double, std::vector<std::size_t>>>{};
+		auto spurs = std::vector<std::optional<index_path>>{};
+		while (result.size() < k) {
+			auto const& previous = result.back().edges;
+			spurs.assign(previous.size(), std::nullopt);
+			pool.run(previous.size(), [&](std::size_t i, std::size_t worker) {
+				if (!searches[worker]) {
+					searches[worker].emplace(n, g.edge_count());
+				}
+				auto& search = *searches[worker];
+				search.reset();
+				auto const spur = network.sources[previous[i]];
+				// Ban the next edge of every accepted path that shares this root, and the root's nodes
+				for (auto const& accepted : result) {
+					if (accepted.edges.size() > i
+					    and std::equal(previous.begin(),
+					                   previous.begin() + static_cast<std::ptrdiff_t>(i),
+					                   accepted.edges.begin()))
+					{
+						search.ban_edge(accepted.edges[i]);
+					}
+				}
+				auto root_length = 0.0;
+				for (std::size_t j = 0; j < i; ++j) {
+					search.ban_node(network.sources[previous[j]]);
+					root_length += network.lengths[previous[j]];
+				}
+				auto path = index_path{};
+				path.edges.assign(previous.begin(), previous.begin() + static_cast<std::ptrdiff_t>(i));
+				auto const spur_length = search.shortest(network, spur, dst, remaining, path.edges);
+				if (spur_length != detail::path_search::infinity) {
+					path.length = root_length + spur_length;
+					spurs[i] = std::move(path);
+				}
+			});
+			for (auto& spur : spurs) {
+				if (spur) {
+					candidates.emplace(spur->length, std::move(spur->edges));
+				}
+			}
+			// Take the shortest candidate not already accepted
+			auto accepted = false;
+			while (!candidates.empty() and !accepted) {
+				auto node = candidates.extract(candidates.begin());
+				auto& [length, edges] = node.value();
+				accepted = std::none_of(result.begin(), result.end(), [&edges](index_path const& p) {
+					return p.edges == edges;
+				});
+				if (accepted) {
+					result.push_back({std::move(edges), length});
+				}
+			}
+			if (!accepted) {
+				break; // Fewer than k loopless paths exist
+			}
+		}
+		return result;
+	}
+
+	// Yen's k shortest loopless paths between two nodes of a graph, as lists of (from, to, weight) edges
+	template<typename N, typename E>
+	[[nodiscard]] std::vector<graph_path<N, E>> k_shortest_paths(graph<N, E> const& g,
+	                                                             N const& src,
+	                                                             N const& dst,
+	                                                             std::size_t k,
+	                                                             thread_pool& pool = default_thread_pool()) {
+		if (!g.is_node(src) or !g.is_node(dst)) {
+			throw std::runtime_error("Cannot call gdwg::k_shortest_paths if src or dst node don't exist in the graph");
+		}
+		auto const snapshot = csr_graph<N, E>(g);
+		auto const from = *snapshot.index_of(src);
+		auto const to = *snapshot.index_of(dst);
+		auto const paths = k_shortest_paths(snapshot, from, to, k, pool);
+
+		// Edge positions map back to their source through the offsets
+		auto const& offsets = snapshot.offsets();
+		auto result = std::vector<graph_path<N, E>>{};
+		result.reserve(paths.size());
+		for (auto const& path : paths) {
+			auto converted = graph_path<N, E>{};
+			converted.length = path.length;
+			for (auto e : path.edges) {
+				auto const u = static_cast<std::size_t>(std::upper_bound(offsets.begin(), offsets.end(), e)
+				                                        - offsets.begin() - 1);
+				converted.edges.push_back({snapshot.node(u),
+				                           snapshot.node(snapshot.targets()[e]),
+				                           snapshot.edge_weights()[e]});
+			}
+			result.push_back(std::move(converted));
+		}
+		return result;
+	}
+} // namespace gdwg
+
+#endif // GDWG_PATHS_H
@@ -0,0 +1,138 @@
+#include "gdwg_paths.h"
+
+#include <catch2/catch.hpp>
+
+#include <random>
+
+namespace {
+	// Lengths of every loopless path from src to dst, found by depth-first enumeration over edges
+	void all_path_lengths(gdwg::csr_graph<int, int> const& g,
+	                      std::size_t u,
+	                      std::size_t dst,
+	                      double length,
+	                      std::vector<bool>& on_path,
+	                      std::vector<double>& out) {
+		if (u == dst) {
+			out.push_back(length);
+			return;
+		}
+		on_path[u] = true;
+		for (std::size_t e = 0; e < g.degree(u); ++e) {
+			auto const v = g.neighbours(u)[e];
+			if (!on_path[v]) {
+				all_path_lengths(g, v, dst, length + g.weights(u)[e].value_or(1), on_path, out);
+			}
+		}
+		on_path[u] = false;
+	}
+} // namespace
+
+// k shortest paths tests
+TEST_CASE("Yen's algorithm on the textbook example", "[paths]") {
+	gdwg::graph<char, int> g;
+	for (auto c : {'C', 'D', 'E', 'F', 'G', 'H'}) {
+		g.insert_node(c);
+	}
+	g.insert_edge('C', 'D', 3);
+	g.insert_edge('C', 'E', 2);
+	g.insert_edge('D', 'F', 4);
+	g.insert_edge('E', 'D', 1);
+	g.insert_edge('E', 'F', 2);
+	g.insert_edge('E', 'G', 3);
+	g.insert_edge('F', 'G', 2);
+	g.insert_edge('F', 'H', 1);
+	g.insert_edge('G', 'H', 2);
+
+	auto const paths = gdwg::k_shortest_paths(g, 'C', 'H', 3);
+	REQUIRE(paths.size() == 3);
+	REQUIRE(paths[0].length == 5);
+	REQUIRE(paths[1].length == 7);
+	REQUIRE(paths[2].length == 8);
+
+	// The shortest path is C -> E -> F -> H, given as the iterator's (from, to, weight) triples
+	REQUIRE(paths[0].edges.size() == 3);
+	REQUIRE(paths[0].edges[0].from == 'C');
+	REQUIRE(paths[0].edges[0].to == 'E');
+	REQUIRE(paths[0].edges[0].weight == 2);
+	REQUIRE(paths[0].edges[2].from == 'F');
+	REQUIRE(paths[0].edges[2].to == 'H');
+
+	// Every path is connected, starts at C and ends at H
+	for (auto const& path : paths) {
+		REQUIRE(path.edges.front().from == 'C');
+		REQUIRE(path.edges.back().to == 'H');
+		for (std::size_t i = 1; i < path.edges.size(); ++i) {
+			REQUIRE(path.edges[i - 1].to == path.edges[i].from);
+		}
+	}
+}
+
+TEST_CASE("Parallel edges give distinct paths", "[paths]") {
+	gdwg::graph<std::string, int> g;
+	for (auto const& node : {"a", "b", "c"}) {
+		g.insert_node(node);
+	}
+	g.insert_edge("a", "b", 1);
+	g.insert_edge("a", "b", 4);
+	g.insert_edge("a", "b"); // Unweighted edges have length 1
+	g.insert_edge("b", "c", 2);
+
+	auto const paths = gdwg::k_shortest_paths(g, std::string("a"), std::string("c"), 5);
+	REQUIRE(paths.size() == 3);
+	REQUIRE(paths[0].length == 3);
+	REQUIRE(paths[1].length == 3);
+	REQUIRE(paths[2].length == 6);
+	REQUIRE(paths[2].edges[0].weight == 4);
+}
+
+TEST_CASE("k shortest paths edge cases", "[paths]") {
+	gdwg::graph<int, int> g;
+	g.insert_node(1);
+	g.insert_node(2);
+	g.insert_node(3);
+	g.insert_edge(1, 2, 1);
+
+	REQUIRE(gdwg::k_shortest_paths(g, 1, 3, 4).empty()); // Unreachable
+	REQUIRE(gdwg::k_shortest_paths(g, 1, 2, 0).empty());
+	auto const self = gdwg::k_shortest_paths(g, 1, 1, 4);
+	REQUIRE(self.size() == 1);
+	REQUIRE(self[0].edges.empty());
+	REQUIRE_THROWS_WITH(gdwg::k_shortest_paths(g, 1, 9, 1),
+	                    "Cannot call gdwg::k_shortest_paths if src or dst node don't exist in the graph");
+
+	g.insert_edge(2, 3, -1);
+	REQUIRE_THROWS_WITH(gdwg::k_shortest_paths(g, 1, 3, 1),
+	                    "Cannot call gdwg::k_shortest_paths on a graph with negative edge weights");
+}
+
+TEST_CASE("k shortest paths match exhaustive enumeration", "[paths]") {
+	auto rng = std::mt19937(3);
+	auto pool = gdwg::thread_pool(4);
+	for (auto trial = 0; trial < 10; ++trial) {
+		gdwg::graph<int, int> g;
+		for (auto i = 0; i < 9; ++i) {
+			g.insert_node(i);
+		}
+		for (auto e = 0; e < 26; ++e) {
+			auto const u = static_cast<int>(rng() % 9);
+			auto const v = static_cast<int>(rng() % 9);
+			if (e % 4 == 0) {
+				g.insert_edge(u, v);
+			}
+			else {
+				g.insert_edge(u, v, static_cast<int>(rng() % 5));
+			}
+		}
+		auto const csr = gdwg::csr_graph<int, int>(g);
+		auto on_path = std::vector<bool>(9, false);
+		auto expected = std::vector<double>{};
+		all_path_lengths(csr, 0, 8, 0.0, on_path, expected);
+		std::sort(expected.begin(), expected.end());
+
+		auto const paths = gdwg::k_shortest_paths(csr, 0, 8, 12, pool);
+		REQUIRE(paths.size() == std::min<std::size_t>(12, expected.size()));
+		for (std::size_t i = 0; i < paths.size(); ++i) {
+			REQUIRE(paths[i].length == expected[i]);
+		}
+	}
+}
@@ -0,0 +1,108 @@
+#include "gdwg_bench.h"
+#include "gdwg_builder.h"
+#include "gdwg_graph.h"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+	// A stream buffer that only counts what is written to it, so printing is measured without any I/O
+	class counting_buffer : public std::streambuf {
+	 public:
+		[[nodiscard]] std::size_t count() const noexcept {
+			return count_;
+		}
+
+	 protected:
+		std::streamsize xsputn(char const*, std::streamsize size) override {
+			count_ += static_cast<std::size_t>(size);
+			return size;
+		}
+
+		int_type overflow(int_type c) override {
+			++count_;
+			return traits_type::not_eof(c);
+		}
+
+	 private:
+		std::size_t count_ = 0;
+	};
+
+	// operator<< as it was: every list copied into tuples, re-sorted, and each weight formatted into a temporary
+	// string by std::to_string; the lists are read through the public iterator, which walks them in place
+	template<typename N, typename E>
+	void print_by_copy_and_sort(std::ostream& os, gdwg::graph<N, E> const& g, std::vector<N> const& nodes) {
+		os << '\n';
+		auto edges = std::vector<std::tuple<N, N, std::optional<E>>>{};
+		auto it = g.begin();
+		for (auto const& node : nodes) {
+			os << node << " (\n";
+			edges.clear();
+			for (; it != g.end() and (*it).from == node; ++it) {
+				auto const edge = *it;
+				edges.emplace_back(edge.from, edge.to, edge.weight);
+			}
+			std::sort(edges.begin(), edges.end(), [](const auto& lhs, const auto& rhs) {
+				if (std::get<1>(lhs) != std::get<1>(rhs))
+					return std::get<1>(lhs) < std::get<1>(rhs);
+				if (!std::get<2>(lhs).has_value() and std::get<2>(rhs).has_value())
+					return true;
+				if (std::get<2>(lhs).has_value() and !std::get<2>(rhs).has_value())
+					return false;
+				return std::get<2>(lhs).value() < std::get<2>(rhs).value();
+			});
+			for (const auto& edge : edges) {
+				os << "  " << std::get<0>(edge) << " -> " << std::get<1>(edge) << " | "
+				   << (std::get<2>(edge) ? "W | " + std::to_string(std::get<2>(edge).value()) : "U") << '\n';
+			}
+			os << ")\n";
+		}
+	}
+} // namespace
+
+// Printing throughput of operator<<
+// Usage: gdwg_print_bench [edges] [nodes]
+auto main(int argc, char** argv) -> int {
+	auto const edges = gdwg::bench::argument(argc, argv, 1, 1 << 20);
+	auto const nodes = gdwg::bench::argument(argc, argv, 2, 1 << 16);
+
+	auto builder = gdwg::graph_builder<int, double>{};
+	auto rng = std::mt19937_64(6771);
+	builder.reserve(edges);
+	for (std::size_t v = 0; v < nodes; ++v) {
+		builder.insert_node(static_cast<int>(v));
+	}
+	for (std::size_t e = 0; e < edges; ++e) {
+		auto const src = static_cast<int>(rng() % nodes);
+		auto const dst = static_cast<int>(rng() % nodes);
+		if (rng() % 4 == 0) {
+			builder.insert_edge(src, dst);
+		}
+		else {
+			builder.insert_edge(src, dst, static_cast<double>(rng() % 10000) / 100);
+		}
+	}
+	auto const g = builder.build();
+	auto all_nodes = std::vector<int>(nodes);
+	std::iota(all_nodes.begin(), all_nodes.end(), 0);
+
+	auto report = [&](std::string const& name, auto&& print) {
+		auto sink = counting_buffer{};
+		auto os = std::ostream(&sink);
+		auto const seconds = gdwg::bench::best_of(3, [&] { print(os); });
+		auto const bytes = static_cast<double>(sink.count()) / 3;
+		gdwg::bench::report(std::cout,
+		                    name,
+		                    {{"edges", static_cast<double>(edges)}, {"nodes", static_cast<double>(nodes)}},
+		                    seconds,
+		                    {{"bytes", bytes}, {"megabytes_per_second", bytes / seconds / 1e6}});
+	};
+	report("operator_output", [&g](std::ostream& os) { os << g; });
+	report("copy_and_sort_output", [&](std::ostream& os) { print_by_copy_and_sort(os, g, all_nodes); });
+}
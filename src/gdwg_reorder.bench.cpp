@@ -0,0 +1,117 @@
+#include "gdwg_bench.h"
+#include "gdwg_generators.h"
+#include "gdwg_pagerank.h"
+#include "gdwg_reorder.h"
+
+#include <bit>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+namespace {
+	// Snapshot of a symmetric graph made by one of the generators, with its ids shuffled so ascending order
+	// scatters neighbours the way arbitrary ids do
+	template<typename Generate>
+	gdwg::csr_graph<std::size_t, int> generated(gdwg::thread_pool& pool, Generate generate) {
+		auto builder = gdwg::graph_builder<std::size_t, int>{};
+		generate(builder, gdwg::generator_options{.symmetric = true, .shuffle_ids = true});
+		return gdwg::csr_graph<std::size_t, int>(builder.build(pool));
+	}
+
+	// Breadth-first search over the out-edges from source, returning the number of nodes reached
+	std::size_t breadth_first(gdwg::csr_graph<std::size_t, int> const& g,
+	                          std::size_t source,
+	                          std::vector<std::size_t>& distance,
+	                          std::vector<std::size_t>& queue) {
+		auto const unreached = static_cast<std::size_t>(-1);
+		distance.assign(g.node_count(), unreached);
+		queue.assign(1, source);
+		distance[source] = 0;
+		auto const& offsets = g.offsets();
+		auto const& targets = g.targets();
+		for (std::size_t head = 0; head < queue.size(); ++head) {
+			auto const u = queue[head];
+			for (auto e = offsets[u]; e < offsets[u + 1]; ++e) {
+				auto const v = targets[e];
+				if (distance[v] == unreached) {
+					distance[v] = distance[u] + 1;
+					queue.push_back(v);
+				}
+			}
+		}
+		return queue.size();
+	}
+
+	// Average index distance between the ends of an edge
+	double average_gap(gdwg::csr_graph<std::size_t, int> const& g) {
+		auto total = 0.0;
+		for (std::size_t u = 0; u < g.node_count(); ++u) {
+			for (auto v : g.neighbours(u)) {
+				total += static_cast<double>(u > v ? u - v : v - u);
+			}
+		}
+		return g.edge_count() == 0 ? 0.0 : total / static_cast<double>(g.edge_count());
+	}
+} // namespace
+
+// BFS and PageRank on graphs with scattered node ids, before and after reordering
+// Usage: gdwg_reorder_bench [nodes] [average degree] [threads]
+auto main(int argc, char** argv) -> int {
+	auto const nodes = gdwg::bench::argument(argc, argv, 1, 1 << 20);
+	auto const degree = gdwg::bench::argument(argc, argv, 2, 8);
+	auto pool = gdwg::thread_pool(gdwg::bench::argument(argc, argv, 3, 0));
+	auto const side = static_cast<std::size_t>(std::sqrt(static_cast<double>(nodes)));
+
+	auto const scale = static_cast<std::size_t>(std::bit_width(nodes - 1));
+	auto graphs = std::vector<std::pair<std::string, gdwg::csr_graph<std::size_t, int>>>{};
+	graphs.emplace_back("grid", generated(pool, [&](auto& b, auto const& options) {
+		gdwg::generate_grid(b, side, side, 1.0, options, pool);
+	}));
+	graphs.emplace_back("rmat", generated(pool, [&](auto& b, auto const& options) {
+		gdwg::generate_rmat(b, scale, nodes * degree / 2, {}, options, pool);
+	}));
+	auto const methods = std::vector<std::pair<std::string, gdwg::node_order>>{
+	   {"ascending", gdwg::node_order::ascending},
+	   {"degree", gdwg::node_order::degree},
+	   {"reverse_cuthill_mckee", gdwg::node_order::reverse_cuthill_mckee},
+	   {"gorder", gdwg::node_order::gorder}};
+
+	auto distance = std::vector<std::size_t>{};
+	auto queue = std::vector<std::size_t>{};
+	for (auto const& [graph_name, original] : graphs) {
+		for (auto const& [method_name, method] : methods) {
+			auto order = std::vector<std::size_t>{};
+			auto seconds = gdwg::bench::best_of(1, [&] { order = gdwg::node_ordering(original, method, pool); });
+			auto const g = original.permuted(order);
+			auto const parameters = std::vector<gdwg::bench::parameter>{{"nodes", static_cast<double>(g.node_count())},
+			                                                            {"edges", static_cast<double>(g.edge_count())},
+			                                                            {"threads", static_cast<double>(pool.size())}};
+			auto const prefix = graph_name + "/" + method_name + "/";
+			gdwg::bench::report(std::cout, prefix + "order", parameters, seconds, {{"average_gap", average_gap(g)}});
+
+			// The same source node, wherever the ordering put it
+			auto const source = *g.index_of(0);
+			auto reached = std::size_t{0};
+			seconds = gdwg::bench::best_of(5, [&] { reached = breadth_first(g, source, distance, queue); });
+			gdwg::bench::report(std::cout,
+			                    prefix + "bfs",
+			                    parameters,
+			                    seconds,
+			                    {{"reached", static_cast<double>(reached)},
+			                     {"edges_per_second", static_cast<double>(g.edge_count()) / seconds}});
+
+			auto options = gdwg::pagerank_options{};
+			options.iteration.tolerance = 0.0;
+			options.iteration.max_iterations = 20;
+			auto result = gdwg::pagerank_result{};
+			seconds = gdwg::bench::best_of(3, [&] { result = gdwg::pagerank(g, options, pool); });
+			gdwg::bench::report(std::cout,
+			                    prefix + "pagerank",
+			                    parameters,
+			                    seconds,
+			                    {{"iterations", static_cast<double>(result.iteration.iterations)},
+			                     {"edges_per_second",
+			                      static_cast<double>(g.edge_count() * result.iteration.iterations) / seconds}});
+		}
+	}
+}
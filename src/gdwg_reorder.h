@@ -0,0 +1,312 @@
+#ifndef GDWG_REORDER_H
+#define GDWG_REORDER_H
+
+#include "gdwg_csr.h"
+#include "gdwg_graph.h"
+#include "gdwg_parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// Node orderings that improve memory locality. Each returns an order for csr_graph::permuted: order[i] is the
+// index of the node to place at index i
+namespace gdwg {
+	enum class node_order {
+		ascending, // The graph's own order, by node value
+		degree, // Highest degree first
+		reverse_cuthill_mckee, // Breadth-first bands of small bandwidth
+		gorder, // Greedy windowed ordering that keeps nodes with shared neighbours together
+	};
+
+	// Nodes by descending degree (in plus out, counting parallel edges); ties keep their relative order
+	// Hubs end up next to each other at the front, where their rank or distance values stay in cache
+	template<typename N, typename E>
+	[[nodiscard]] std::vector<std::size_t> degree_order(csr_graph<N, E> const& g) {
+		auto const n = g.node_count();
+		auto degree = std::vector<std::size_t>(n, 0);
+		for (std::size_t u = 0; u < n; ++u) {
+			degree[u] += g.degree(u);
+			for (auto v : g.neighbours(u)) {
+				++degree[v];
+			}
+		}
+		auto order = std::vector<std::size_t>(n);
+		for (std::size_t u = 0; u < n; ++u) {
+			order[u] = u;
+		}
+		std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+			return degree[a] > degree[b];
+		});
+		return order;
+	}
+
+	// Reverse Cuthill-McKee ordering of the graph with edge directions ignored
+	// Every connected component is numbered breadth first from a pseudo-peripheral node (George-Liu), visiting
+	// the unnumbered neighbours of each node by increasing degree, and the whole order is then reversed. This
+	// keeps the endpoints of every edge close in index, so a traversal touches few cache lines per frontier
+	template<typename N, typename E>
+	[[nodiscard]] std::vector<std::size_t> reverse_cuthill_mckee(csr_graph<N, E> const& g,
+	                                                             thread_pool& pool = default_thread_pool()) {
+		auto const undirected = detail::make_undirected(g, pool);
+		auto const n = g.node_count();
+		auto degree = [&](std::size_t u) {
+			return undirected.offsets[u + 1] - undirected.offsets[u];
+		};
+		auto by_degree = std::vector<std::size_t>(n);
+		for (std::size_t u = 0; u < n; ++u) {
+			by_degree[u] = u;
+		}
+		std::stable_sort(by_degree.begin(), by_degree.end(), [&](std::size_t a, std::size_t b) {
+			return degree(a) < degree(b);
+		});
+
+		auto order = std::vector<std::size_t>{};
+		order.reserve(n);
+		auto numbered = std::vector<bool>(n, false);
+		auto stamp = std::vector<std::size_t>(n, 0); // Breadth-first search generation of every node
+		auto generation = std::size_t{0};
+		auto level = std::vector<std::size_t>{};
+		auto next = std::vector<std::size_t>{};
+
+		// Breadth-first levels from root within its component: return the eccentricity of root and leave the
+		// last level in level
+		auto last_level = [&](std::size_t root) {
+			++generation;
+			stamp[root] = generation;
+			level.assign(1, root);
+			auto eccentricity = std::size_t{0};
+			while (true) {
+				next.clear();
+				for (auto u : level) {
+					for (auto v : detail::undirected_neighbours(undirected, u)) {
+						if (stamp[v] != generation) {
+							stamp[v] = generation;
+							next.push_back(v);
+						}
+					}
+				}
+				if (next.empty()) {
+					return eccentricity;
+				}
+				level.swap(next);
+				++eccentricity;
+			}
+		};
+
+		for (auto start : by_degree) {
+			if (numbered[start]) {
+				continue;
+			}
+			// Move to a node of least degree in the last level while that increases the eccentricity
+			auto root = start;
+			auto eccentricity = last_level(root);
+			while (true) {
+				auto const candidate = *std::min_element(level.begin(), level.end(), [&](std::size_t a, std::size_t b) {
+					return degree(a) != degree(b) ? degree(a) < degree(b) : a < b;
+				});
+				auto const further = last_level(candidate);
+				if (further <= eccentricity) {
+					break;
+				}
+				root = candidate;
+				eccentricity = further;
+			}
+
+			auto const first = order.size();
+			numbered[root] = true;
+			order.push_back(root);
+			for (auto head = first; head < order.size(); ++head) {
+				auto const band = order.size();
+				for (auto v : detail::undirected_neighbours(undirected, order[head])) {
+					if (!numbered[v]) {
+						numbered[v] = true;
+						order.push_back(v);
+					}
+				}
+				std::stable_sort(order.begin() + static_cast<std::ptrdiff_t>(band),
+				                 order.end(),
+				                 [&](std::size_t a, std::size_t b) { return degree(a) < degree(b); });
+			}
+		}
+		std::reverse(order.begin(), order.end());
+		return order;
+	}
+
+	namespace detail {
+		// Max-priority queue over small integer keys that change by one at a time (Gorder's unit heap): nodes
+		// sit in one doubly linked list per key, so an increment, decrement or removal is O(1)
+		class unit_heap {
+		 public:
+			explicit unit_heap(std::size_t n)
+			: key_(n, 0)
+			, next_(n, none)
+			, previous_(n, none)
+			, head_(1, none)
+			, top_(0) {
+				for (std::size_t u = n; u-- > 0;) {
+					link(u);
+				}
+			}
+
+			[[nodiscard]] std::size_t key(std::size_t u) const {
+				return key_[u];
+			}
+
+			// Return a node of the largest key, or none if every node has key 0
+			[[nodiscard]] std::size_t top() {
+				while (top_ > 0 and head_[top_] == none) {
+					--top_;
+				}
+				return top_ > 0 ? head_[top_] : none;
+			}
+
+			void increment(std::size_t u) {
+				unlink(u);
+				++key_[u];
+				if (key_[u] == head_.size()) {
+					head_.push_back(none);
+				}
+				link(u);
+				top_ = std::max(top_, key_[u]);
+			}
+
+			void decrement(std::size_t u) {
+				unlink(u);
+				--key_[u];
+				link(u);
+			}
+
+			void remove(std::size_t u) {
+				unlink(u);
+			}
+
+			static constexpr auto none = static_cast<std::size_t>(-1);
+
+		 private:
+			void link(std::size_t u) {
+				auto& head = head_[key_[u]];
+				previous_[u] = none;
+				next_[u] = head;
+				if (head != none) {
+					previous_[head] = u;
+				}
+				head = u;
+			}
+
+			void unlink(std::size_t u) {
+				if (previous_[u] != none) {
+					next_[previous_[u]] = next_[u];
+				}
+				else {
+					head_[key_[u]] = next_[u];
+				}
+				if (next_[u] != none) {
+					previous_[next_[u]] = previous_[u];
+				}
+			}
+
+			std::vector<std::size_t> key_;
+			std::vector<std::size_t> next_;
+			std::vector<std::size_t> previous_;
+			std::vector<std::size_t> head_; // First node of every key's list
+			std::size_t top_; // No key above this has nodes
+		};
+	} // namespace detail
+
+	// Gorder (Wei et al.) with edge directions ignored: nodes are placed one at a time, each time choosing the
+	// unplaced node with the highest score against the last window placed nodes, where a node scores one for
+	// every window node it is adjacent to and one for every neighbour it shares with a window node. Neighbours
+	// are not shared through hubs of degree above sqrt(n), which bounds the work. When no unplaced node scores,
+	// the order continues from the highest-degree unplaced node
+	template<typename N, typename E>
+	[[nodiscard]] std::vector<std::size_t>
+	gorder(csr_graph<N, E> const& g, std::size_t window = 5, thread_pool& pool = default_thread_pool()) {
+		auto const undirected = detail::make_undirected(g, pool);
+		auto const n = g.node_count();
+		auto const hub = static_cast<std::size_t>(std::sqrt(static_cast<double>(n)));
+		auto degree = [&](std::size_t u) {
+			return undirected.offsets[u + 1] - undirected.offsets[u];
+		};
+		auto by_degree = std::vector<std::size_t>(n);
+		for (std::size_t u = 0; u < n; ++u) {
+			by_degree[u] = u;
+		}
+		std::stable_sort(by_degree.begin(), by_degree.end(), [&](std::size_t a, std::size_t b) {
+			return degree(a) > degree(b);
+		});
+
+		auto heap = detail::unit_heap(n);
+		auto placed = std::vector<bool>(n, false);
+		// Add (or take back) u's contribution to the scores of the unplaced nodes
+		auto update = [&](std::size_t u, bool entering) {
+			auto touch = [&](std::size_t v) {
+				if (!placed[v]) {
+					entering ? heap.increment(v) : heap.decrement(v);
+				}
+			};
+			for (auto w : detail::undirected_neighbours(undirected, u)) {
+				touch(w);
+				if (degree(w) <= hub) {
+					for (auto v : detail::undirected_neighbours(undirected, w)) {
+						if (v != u) {
+							touch(v);
+						}
+					}
+				}
+			}
+		};
+
+		auto order = std::vector<std::size_t>{};
+		order.reserve(n);
+		auto cursor = std::size_t{0};
+		while (order.size() < n) {
+			auto u = heap.top();
+			if (u == detail::unit_heap::none) {
+				while (placed[by_degree[cursor]]) {
+					++cursor;
+				}
+				u = by_degree[cursor];
+			}
+			heap.remove(u);
+			placed[u] = true;
+			order.push_back(u);
+			update(u, true);
+			if (window > 0 and order.size() > window) {
+				update(order[order.size() - window - 1], false);
+			}
+		}
+		return order;
+	}
+
+	// Return the order the given method produces for g
+	template<typename N, typename E>
+	[[nodiscard]] std::vector<std::size_t>
+	node_ordering(csr_graph<N, E> const& g, node_order method, thread_pool& pool = default_thread_pool()) {
+		switch (method) {
+		case node_order::degree: return degree_order(g);
+		case node_order::reverse_cuthill_mckee: return reverse_cuthill_mckee(g, pool);
+		case node_order::gorder: return gorder(g, 5, pool);
+		case node_order::ascending: break;
+		}
+		auto order = std::vector<std::size_t>(g.node_count());
+		for (std::size_t u = 0; u < order.size(); ++u) {
+			order[u] = u;
+		}
+		return order;
+	}
+
+	// Build a snapshot of g with its nodes laid out by the given method
+	template<typename N, typename E>
+	[[nodiscard]] csr_graph<N, E>
+	reordered_snapshot(graph<N, E> const& g, node_order method, thread_pool& pool = default_thread_pool()) {
+		auto snapshot = csr_graph<N, E>(g);
+		if (method == node_order::ascending) {
+			return snapshot;
+		}
+		return snapshot.permuted(node_ordering(snapshot, method, pool));
+	}
+} // namespace gdwg
+
+#endif // GDWG_REORDER_H
@@ -0,0 +1,217 @@
+#include "gdwg_reorder.h"
+#include "gdwg_pagerank.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+namespace {
+	// Largest index distance between the ends of an edge
+	template<typename N, typename E>
+	std::size_t bandwidth(gdwg::csr_graph<N, E> const& g) {
+		auto result = std::size_t{0};
+		for (std::size_t u = 0; u < g.node_count(); ++u) {
+			for (auto v : g.neighbours(u)) {
+				result = std::max(result, u > v ? u - v : v - u);
+			}
+		}
+		return result;
+	}
+
+	bool is_permutation(std::vector<std::size_t> order, std::size_t n) {
+		std::sort(order.begin(), order.end());
+		auto identity = std::vector<std::size_t>(n);
+		std::iota(identity.begin(), identity.end(), std::size_t{0});
+		return order == identity;
+	}
+
+	// A width x height grid whose node values are shuffled, so ascending order scatters neighbours
+	gdwg::graph<int, int> shuffled_grid(int width, int height) {
+		auto label = std::vector<int>(static_cast<std::size_t>(width * height));
+		std::iota(label.begin(), label.end(), 0);
+		std::shuffle(label.begin(), label.end(), std::mt19937(38));
+		auto at = [&](int x, int y) {
+			return label[static_cast<std::size_t>(y * width + x)];
+		};
+		gdwg::graph<int, int> g;
+		for (auto v : label) {
+			g.insert_node(v);
+		}
+		for (auto y = 0; y < height; ++y) {
+			for (auto x = 0; x < width; ++x) {
+				if (x + 1 < width) {
+					g.insert_edge(at(x, y), at(x + 1, y), 1);
+				}
+				if (y + 1 < height) {
+					g.insert_edge(at(x, y), at(x, y + 1), 1);
+				}
+			}
+		}
+		return g;
+	}
+} // namespace
+
+// Node reordering tests
+TEST_CASE("Permuted snapshots keep the graph", "[reorder]") {
+	gdwg::graph<char, int> g{'a', 'b', 'c', 'd'};
+	g.insert_edge('a', 'b', 1);
+	g.insert_edge('a', 'd', 2);
+	g.insert_edge('c', 'a', 3);
+	g.insert_edge('d', 'd', 4);
+	auto const snapshot = gdwg::csr_graph<char, int>(g);
+	auto const order = std::vector<std::size_t>{3, 1, 0, 2}; // d, b, a, c
+	auto const permuted = snapshot.permuted(order);
+
+	REQUIRE(permuted.nodes() == std::vector<char>{'d', 'b', 'a', 'c'});
+	for (auto value : {'a', 'b', 'c', 'd'}) {
+		REQUIRE(permuted.node(*permuted.index_of(value)) == value);
+	}
+	REQUIRE_FALSE(permuted.index_of('e'));
+	// a's row is (d, 2), (b, 1), sorted by new index
+	auto const a = *permuted.index_of('a');
+	REQUIRE(std::vector<std::size_t>(permuted.neighbours(a).begin(), permuted.neighbours(a).end())
+	        == std::vector<std::size_t>{0, 1});
+	REQUIRE(*permuted.weights(a)[0] == 2);
+	REQUIRE(*permuted.weights(a)[1] == 1);
+	REQUIRE(permuted.neighbours(0)[0] == 0);
+
+	// Building from the graph with the same order gives the same arrays
+	auto const direct = gdwg::csr_graph<char, int>(g, order);
+	REQUIRE(direct.nodes() == permuted.nodes());
+	REQUIRE(direct.offsets() == permuted.offsets());
+	REQUIRE(direct.targets() == permuted.targets());
+	REQUIRE(direct.edge_weights() == permuted.edge_weights());
+	REQUIRE(*direct.index_of('c') == 3);
+
+	// Permuting again composes, and the inverse order restores the original
+	auto const back = permuted.permuted(std::vector<std::size_t>{2, 1, 3, 0});
+	REQUIRE(back.nodes() == snapshot.nodes());
+	REQUIRE(back.targets() == snapshot.targets());
+	REQUIRE(*back.index_of('d') == 3);
+
+	REQUIRE_THROWS_WITH(snapshot.permuted(std::vector<std::size_t>{0, 1, 1, 2}),
+	                    "Cannot build a gdwg::csr_graph from a node order that is not a permutation");
+	auto const short_order = std::vector<std::size_t>{0, 1};
+	REQUIRE_THROWS_WITH((gdwg::csr_graph<char, int>(g, short_order)),
+	                    "Cannot build a gdwg::csr_graph from a node order that is not a permutation");
+}
+
+TEST_CASE("Snapshots built from unsorted node arrays find their nodes", "[reorder]") {
+	auto const g = gdwg::csr_graph<int, int>({30, 10, 20}, {0, 1, 1, 1}, {2}, {std::nullopt});
+	REQUIRE(*g.index_of(10) == 1);
+	REQUIRE(*g.index_of(20) == 2);
+	REQUIRE(*g.index_of(30) == 0);
+	REQUIRE_FALSE(g.index_of(15));
+}
+
+TEST_CASE("Orderings are permutations that improve locality", "[reorder]") {
+	auto const g = shuffled_grid(30, 20);
+	auto const snapshot = gdwg::csr_graph<int, int>(g);
+	auto const n = snapshot.node_count();
+	REQUIRE(bandwidth(snapshot) > 400);
+
+	for (auto method : {gdwg::node_order::ascending,
+	                    gdwg::node_order::degree,
+	                    gdwg::node_order::reverse_cuthill_mckee,
+	                    gdwg::node_order::gorder}) {
+		auto const order = gdwg::node_ordering(snapshot, method);
+		REQUIRE(is_permutation(order, n));
+		auto const reordered = gdwg::reordered_snapshot(g, method);
+		REQUIRE(reordered.nodes() == snapshot.permuted(order).nodes());
+		REQUIRE(reordered.edge_count() == snapshot.edge_count());
+	}
+
+	// Cuthill-McKee bands a grid along its shorter side
+	auto const rcm = snapshot.permuted(gdwg::reverse_cuthill_mckee(snapshot));
+	REQUIRE(bandwidth(rcm) <= 21);
+
+	// Gorder brings grid neighbours much closer than the shuffled values do
+	auto average_gap = [n](gdwg::csr_graph<int, int> const& h) {
+		auto total = 0.0;
+		for (std::size_t u = 0; u < n; ++u) {
+			for (auto v : h.neighbours(u)) {
+				total += static_cast<double>(u > v ? u - v : v - u);
+			}
+		}
+		return total / static_cast<double>(h.edge_count());
+	};
+	REQUIRE(average_gap(snapshot.permuted(gdwg::gorder(snapshot))) < average_gap(snapshot) / 3.0);
+
+	// Interior nodes (degree 4) come first and corners (degree 2) last
+	auto degree = std::vector<std::size_t>(n, 0);
+	for (std::size_t u = 0; u < n; ++u) {
+		degree[u] += snapshot.degree(u);
+		for (auto v : snapshot.neighbours(u)) {
+			++degree[v];
+		}
+	}
+	auto const by_degree = gdwg::degree_order(snapshot);
+	REQUIRE(degree[by_degree.front()] == 4);
+	REQUIRE(degree[by_degree.back()] == 2);
+	REQUIRE(std::is_sorted(by_degree.begin(), by_degree.end(), [&](std::size_t a, std::size_t b) {
+		return degree[a] > degree[b];
+	}));
+}
+
+TEST_CASE("Cuthill-McKee and Gorder on small graphs", "[reorder]") {
+	SECTION("A shuffled path is numbered end to end") {
+		auto const g = shuffled_grid(50, 1);
+		auto const snapshot = gdwg::csr_graph<int, int>(g);
+		REQUIRE(bandwidth(snapshot.permuted(gdwg::reverse_cuthill_mckee(snapshot))) == 1);
+	}
+
+	SECTION("Disconnected cliques stay contiguous") {
+		gdwg::graph<int, int> g;
+		for (auto v = 0; v < 12; ++v) {
+			g.insert_node(v);
+		}
+		// Cliques {0, 3, 6, 9}, {1, 4, 7, 10} and {2, 5, 8, 11}
+		for (auto u = 0; u < 12; ++u) {
+			for (auto v = u + 3; v < 12; v += 3) {
+				g.insert_edge(u, v);
+			}
+		}
+		auto const snapshot = gdwg::csr_graph<int, int>(g);
+		for (auto const& order : {gdwg::reverse_cuthill_mckee(snapshot), gdwg::gorder(snapshot)}) {
+			REQUIRE(is_permutation(order, 12));
+			for (std::size_t i = 0; i < 12; i += 4) {
+				for (std::size_t j = i; j < i + 4; ++j) {
+					REQUIRE(order[j] % 3 == order[i] % 3);
+				}
+			}
+		}
+	}
+
+	SECTION("Empty graphs") {
+		auto const snapshot = gdwg::csr_graph<int, int>{};
+		REQUIRE(gdwg::reverse_cuthill_mckee(snapshot).empty());
+		REQUIRE(gdwg::gorder(snapshot).empty());
+		REQUIRE(gdwg::degree_order(snapshot).empty());
+		REQUIRE(snapshot.permuted(std::vector<std::size_t>{}).node_count() == 0);
+	}
+}
+
+TEST_CASE("Algorithms agree on reordered snapshots", "[reorder]") {
+	auto rng = std::mt19937(381);
+	gdwg::graph<int, double> g;
+	for (auto v = 0; v < 300; ++v) {
+		g.insert_node(v);
+	}
+	for (auto e = 0; e < 1500; ++e) {
+		auto const u = static_cast<int>(rng() % 300);
+		auto const v = static_cast<int>(rng() % 300);
+		g.insert_edge(u, v, 1.0 + static_cast<double>(rng() % 3));
+	}
+	auto const snapshot = gdwg::csr_graph<int, double>(g);
+	auto const expected = gdwg::pagerank(snapshot);
+	for (auto method : {gdwg::node_order::degree, gdwg::node_order::reverse_cuthill_mckee, gdwg::node_order::gorder}) {
+		auto const reordered = gdwg::reordered_snapshot(g, method);
+		auto const result = gdwg::pagerank(reordered);
+		for (std::size_t u = 0; u < reordered.node_count(); ++u) {
+			auto const original = *snapshot.index_of(reordered.node(u));
+			REQUIRE(result.rank[u] == Approx(expected.rank[original]).margin(1e-9));
+		}
+	}
+}
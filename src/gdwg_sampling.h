@@ -0,0 +1,309 @@
+#ifndef GDWG_SAMPLING_H
+#define GDWG_SAMPLING_H
+
+#include "gdwg_csr.h"
+#include "gdwg_graph.h"
+#include "gdwg_parallel.h"
+#include "gdwg_walks.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gdwg {
+	enum class sample_direction {
+		in, // Sample the sources of edges into each node (messages flow along the edges)
+		out, // Sample the targets of edges out of each node
+	};
+
+	struct sampler_options {
+		std::vector<std::size_t> fanouts; // Neighbours sampled per node at each hop, starting from the seeds
+		bool weighted = false; // Sample in proportion to edge weight (unweighted edges weigh 1) instead of uniformly
+		sample_direction direction = sample_direction::in;
+		std::uint64_t seed = 6771;
+	};
+
+	// One hop of a sampled neighbourhood, with nodes renumbered locally
+	// The first dst_count source nodes are the destination nodes, so a layer can keep its own features. Sampled
+	// edges are grouped by destination: those of local destination i are [offsets[i], offsets[i + 1])
+	struct sampled_block {
+		std::size_t dst_count = 0;
+		std::vector<std::size_t> src_nodes; // Snapshot index of every local source node
+		std::vector<std::size_t> offsets;
+		std::vector<std::size_t> sources; // Local source index of every sampled edge
+		std::vector<std::size_t> edges; // Position of every sampled edge in the snapshot's edge arrays
+	};
+
+	// A sampled k-hop neighbourhood: blocks[0] holds the seeds as destinations, and the sources of every block
+	// are the destinations of the next, so a GNN consumes the blocks from last to first
+	struct sampled_subgraph {
+		std::vector<sampled_block> blocks;
+	};
+
+	// One hop of a sampled neighbourhood of a graph, by node value
+	template<typename N, typename E>
+	struct graph_block {
+		std::size_t dst_count = 0;
+		std::vector<N> src_nodes;
+		std::vector<std::size_t> offsets;
+		std::vector<std::size_t> sources; // Local source index of every sampled edge
+		std::vector<std::optional<E>> weights; // Weight of every sampled edge
+	};
+
+	// k-hop fan-out neighbourhood sampler over a snapshot, for minibatch GNN training
+	// Neighbours are drawn without replacement: uniformly by Floyd's algorithm, or in proportion to weight by
+	// Efraimidis-Spirakis keys; nodes with no more neighbours than the fan-out keep them all. Local renumbering
+	// uses generation-stamped arrays the size of the graph, kept per worker, so after warm-up a batch allocates
+	// only when its output grows. Each batch draws from its own random stream (seed and batch number), so
+	// results do not depend on the number of workers. A sampler runs one call at a time
+	class neighbour_sampler {
+	 public:
+		template<typename N, typename E>
+		neighbour_sampler(csr_graph<N, E> const& g, sampler_options options)
+		: options_(std::move(options))
+		, node_count_(g.node_count()) {
+			auto const n = g.node_count();
+			auto const& offsets = g.offsets();
+			auto const& targets = g.targets();
+			auto weight = [&g](std::size_t e) {
+				auto result = 1.0;
+				if constexpr (std::is_arithmetic_v<E>) {
+					if (auto const& w = g.edge_weights()[e]) {
+						result = static_cast<double>(*w);
+						if (result < 0.0) {
+							throw std::runtime_error("Cannot construct gdwg::neighbour_sampler from a graph with "
+							                         "negative edge weights");
+						}
+					}
+				}
+				return result;
+			};
+			if (options_.direction == sample_direction::out) {
+				offsets_ = offsets;
+				neighbours_ = targets;
+				edges_.resize(targets.size());
+				for (std::size_t e = 0; e < targets.size(); ++e) {
+					edges_[e] = e;
+				}
+			}
+			else {
+				// Reverse CSR: the edges into v, as positions in the snapshot
+				offsets_.assign(n + 1, 0);
+				for (auto v : targets) {
+					++offsets_[v + 1];
+				}
+				for (std::size_t v = 0; v < n; ++v) {
+					offsets_[v + 1] += offsets_[v];
+				}
+				neighbours_.assign(targets.size(), 0);
+				edges_.assign(targets.size(), 0);
+				auto fill = std::vector<std::size_t>(offsets_.begin(), offsets_.end() - 1);
+				for (std::size_t u = 0; u < n; ++u) {
+					for (auto e = offsets[u]; e < offsets[u + 1]; ++e) {
+						auto const slot = fill[targets[e]]++;
+						neighbours_[slot] = u;
+						edges_[slot] = e;
+					}
+				}
+			}
+			if (options_.weighted) {
+				weights_.resize(edges_.size());
+				for (std::size_t i = 0; i < edges_.size(); ++i) {
+					weights_[i] = weight(edges_[i]);
+				}
+			}
+		}
+
+		// Sample the neighbourhood of one batch of seed nodes (snapshot indices), reusing out's storage
+		void sample(std::span<std::size_t const> seeds, std::uint64_t batch, sampled_subgraph& out) {
+			workspaces_.resize(std::max<std::size_t>(workspaces_.size(), 1));
+			sample_batch(seeds, batch, out, workspace(0));
+		}
+
+		[[nodiscard]] sampled_subgraph sample(std::span<std::size_t const> seeds, std::uint64_t batch = 0) {
+			auto result = sampled_subgraph{};
+			sample(seeds, batch, result);
+			return result;
+		}
+
+		// Sample many batches in parallel; batch i uses random stream i
+		[[nodiscard]] std::vector<sampled_subgraph> sample(std::span<std::vector<std::size_t> const> batches,
+		                                                   thread_pool& pool = default_thread_pool()) {
+			workspaces_.resize(std::max(workspaces_.size(), pool.size()));
+			auto result = std::vector<sampled_subgraph>(batches.size());
+			pool.run(batches.size(), [&](std::size_t i, std::size_t worker) {
+				sample_batch(batches[i], i, result[i], workspace(worker));
+			});
+			return result;
+		}
+
+	 private:
+		struct sampler_workspace {
+			explicit sampler_workspace(std::size_t nodes)
+			: local(nodes, 0)
+			, stamp(nodes, 0) {}
+
+			std::vector<std::size_t> local; // Local index of every node stamped in the current block
+			std::vector<std::uint64_t> stamp;
+			std::uint64_t current = 0;
+			std::vector<std::size_t> chosen; // Positions in the current row picked so far
+			std::vector<std::pair<double, std::size_t>> keys; // Weighted sampling heap of (key, position)
+		};
+
+		sampler_workspace& workspace(std::size_t worker) {
+			if (!workspaces_[worker]) {
+				workspaces_[worker].emplace(node_count_);
+			}
+			return *workspaces_[worker];
+		}
+
+		void sample_batch(std::span<std::size_t const> seeds,
+		                  std::uint64_t batch,
+		                  sampled_subgraph& out,
+		                  sampler_workspace& work) const {
+			auto rng = detail::walk_rng::for_walk(options_.seed, batch);
+			out.blocks.resize(options_.fanouts.size());
+			for (std::size_t hop = 0; hop < options_.fanouts.size(); ++hop) {
+				auto& block = out.blocks[hop];
+				block.src_nodes.clear();
+				block.offsets.assign(1, 0);
+				block.sources.clear();
+				block.edges.clear();
+				++work.current;
+				auto local_of = [&](std::size_t v) {
+					if (work.stamp[v] != work.current) {
+						work.stamp[v] = work.current;
+						work.local[v] = block.src_nodes.size();
+						block.src_nodes.push_back(v);
+					}
+					return work.local[v];
+				};
+
+				// Destinations are the seeds, or the sources of the previous hop
+				if (hop == 0) {
+					for (auto v : seeds) {
+						if (v >= node_count_) {
+							throw std::runtime_error("Cannot call gdwg::neighbour_sampler::sample with a seed outside "
+							                         "the graph");
+						}
+						local_of(v);
+					}
+				}
+				else {
+					for (auto v : out.blocks[hop - 1].src_nodes) {
+						local_of(v);
+					}
+				}
+				block.dst_count = block.src_nodes.size();
+
+				for (std::size_t i = 0; i < block.dst_count; ++i) {
+					choose(block.src_nodes[i], options_.fanouts[hop], rng, work);
+					for (auto slot : work.chosen) {
+						block.sources.push_back(local_of(neighbours_[slot]));
+						block.edges.push_back(edges_[slot]);
+					}
+					block.offsets.push_back(block.sources.size());
+				}
+			}
+		}
+
+		// Pick up to fanout positions of u's row into work.chosen
+		void choose(std::size_t u, std::size_t fanout, detail::walk_rng& rng, sampler_workspace& work) const {
+			auto const first = offsets_[u];
+			auto const degree = offsets_[u + 1] - first;
+			work.chosen.clear();
+			if (options_.weighted) {
+				// Efraimidis-Spirakis: keep the fanout largest log(uniform) / weight, skipping zero weights
+				auto& keys = work.keys;
+				keys.clear();
+				for (auto slot = first; slot < first + degree; ++slot) {
+					if (weights_[slot] <= 0.0) {
+						continue;
+					}
+					auto const key = std::log(1.0 - rng.uniform()) / weights_[slot];
+					if (keys.size() < fanout) {
+						keys.emplace_back(key, slot);
+						std::push_heap(keys.begin(), keys.end(), std::greater<>{});
+					}
+					else if (fanout > 0 and key > keys.front().first) {
+						std::pop_heap(keys.begin(), keys.end(), std::greater<>{});
+						keys.back() = {key, slot};
+						std::push_heap(keys.begin(), keys.end(), std::greater<>{});
+					}
+				}
+				for (auto const& [key, slot] : keys) {
+					work.chosen.push_back(slot);
+				}
+				std::sort(work.chosen.begin(), work.chosen.end());
+				return;
+			}
+			if (degree <= fanout) {
+				for (auto slot = first; slot < first + degree; ++slot) {
+					work.chosen.push_back(slot);
+				}
+				return;
+			}
+			// Floyd's algorithm: a uniform fanout-subset of the row in fanout draws
+			for (auto j = degree - fanout; j < degree; ++j) {
+				auto pick = first + rng.below(j + 1);
+				if (std::find(work.chosen.begin(), work.chosen.end(), pick) != work.chosen.end()) {
+					pick = first + j;
+				}
+				work.chosen.push_back(pick);
+			}
+			std::sort(work.chosen.begin(), work.chosen.end());
+		}
+
+		sampler_options options_;
+		std::size_t node_count_;
+		std::vector<std::size_t> offsets_; // Rows of the sampled direction
+		std::vector<std::size_t> neighbours_; // Neighbour at every row position
+		std::vector<std::size_t> edges_; // Snapshot edge position at every row position
+		std::vector<double> weights_; // Weight at every row position (weighted sampling only)
+		std::vector<std::optional<sampler_workspace>> workspaces_;
+	};
+
+	// Sample the k-hop neighbourhood of seed nodes of a graph, by node value
+	template<typename N, typename E>
+	[[nodiscard]] std::vector<graph_block<N, E>>
+	sample_neighbourhood(graph<N, E> const& g, std::vector<N> const& seeds, sampler_options options) {
+		auto const snapshot = csr_graph<N, E>(g);
+		auto indices = std::vector<std::size_t>{};
+		indices.reserve(seeds.size());
+		for (auto const& seed : seeds) {
+			auto const index = snapshot.index_of(seed);
+			if (!index) {
+				throw std::runtime_error("Cannot call gdwg::sample_neighbourhood if a seed node doesn't exist in the "
+				                         "graph");
+			}
+			indices.push_back(*index);
+		}
+		auto sampler = neighbour_sampler(snapshot, std::move(options));
+		auto const sample = sampler.sample(indices);
+		auto result = std::vector<graph_block<N, E>>{};
+		result.reserve(sample.blocks.size());
+		for (auto const& block : sample.blocks) {
+			auto& converted = result.emplace_back();
+			converted.dst_count = block.dst_count;
+			for (auto v : block.src_nodes) {
+				converted.src_nodes.push_back(snapshot.node(v));
+			}
+			converted.offsets = block.offsets;
+			converted.sources = block.sources;
+			for (auto e : block.edges) {
+				converted.weights.push_back(snapshot.edge_weights()[e]);
+			}
+		}
+		return result;
+	}
+} // namespace gdwg
+
+#endif // GDWG_SAMPLING_H
@@ -0,0 +1,158 @@
+#include "gdwg_sampling.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+
+namespace {
+	// Every block is consistent with the snapshot: local ids map to real edges in the sampled direction
+	void check_blocks(gdwg::csr_graph<int, int> const& g,
+	                  gdwg::sampled_subgraph const& sample,
+	                  gdwg::sampler_options const& options) {
+		REQUIRE(sample.blocks.size() == options.fanouts.size());
+		auto const& offsets = g.offsets();
+		for (std::size_t hop = 0; hop < sample.blocks.size(); ++hop) {
+			auto const& block = sample.blocks[hop];
+			REQUIRE(block.offsets.size() == block.dst_count + 1);
+			REQUIRE(std::set<std::size_t>(block.src_nodes.begin(), block.src_nodes.end()).size()
+			        == block.src_nodes.size());
+			if (hop > 0) {
+				auto const& previous = sample.blocks[hop - 1].src_nodes;
+				REQUIRE(std::vector<std::size_t>(block.src_nodes.begin(),
+				                                 block.src_nodes.begin() + static_cast<std::ptrdiff_t>(block.dst_count))
+				        == previous);
+			}
+			for (std::size_t i = 0; i < block.dst_count; ++i) {
+				auto const count = block.offsets[i + 1] - block.offsets[i];
+				REQUIRE(count <= options.fanouts[hop]);
+				auto seen = std::set<std::size_t>{};
+				for (auto k = block.offsets[i]; k < block.offsets[i + 1]; ++k) {
+					auto const e = block.edges[k];
+					REQUIRE(seen.insert(e).second); // Without replacement
+					auto const source = static_cast<std::size_t>(std::upper_bound(offsets.begin(), offsets.end(), e)
+					                                             - offsets.begin() - 1);
+					auto const target = g.targets()[e];
+					auto const dst = block.src_nodes[i];
+					auto const src = block.src_nodes[block.sources[k]];
+					if (options.direction == gdwg::sample_direction::in) {
+						REQUIRE((target == dst and source == src));
+					}
+					else {
+						REQUIRE((source == dst and target == src));
+					}
+				}
+			}
+		}
+	}
+} // namespace
+
+// Neighbourhood sampling tests
+TEST_CASE("Fan-out sampling of a small graph", "[sampling]") {
+	// 0 has in-edges from 1..6; 1 has in-edges from 7 and 8
+	gdwg::graph<int, int> g{0, 1, 2, 3, 4, 5, 6, 7, 8};
+	for (auto v = 1; v <= 6; ++v) {
+		g.insert_edge(v, 0, v);
+	}
+	g.insert_edge(7, 1, 1);
+	g.insert_edge(8, 1, 1);
+
+	auto options = gdwg::sampler_options{};
+	options.fanouts = {3, 10};
+	auto const blocks = gdwg::sample_neighbourhood(g, {0}, options);
+	REQUIRE(blocks.size() == 2);
+	REQUIRE(blocks[0].dst_count == 1);
+	REQUIRE(blocks[0].src_nodes.front() == 0);
+	REQUIRE(blocks[0].src_nodes.size() == 4);
+	REQUIRE(blocks[0].offsets == std::vector<std::size_t>{0, 3});
+	for (std::size_t k = 0; k < 3; ++k) {
+		// Weights are the source values, and sources are numbered after the destinations
+		REQUIRE(blocks[0].sources[k] == k + 1);
+		REQUIRE(*blocks[0].weights[k] == blocks[0].src_nodes[k + 1]);
+	}
+	// The second hop keeps every in-neighbour, since none has more than 10, and 0 is a destination again
+	REQUIRE(blocks[1].dst_count == 4);
+	auto const& second = blocks[1];
+	for (std::size_t i = 0; i < second.dst_count; ++i) {
+		auto const node = second.src_nodes[i];
+		REQUIRE(second.offsets[i + 1] - second.offsets[i] == (node == 0 ? 6u : node == 1 ? 2u : 0u));
+	}
+
+	options.direction = gdwg::sample_direction::out;
+	auto const out = gdwg::sample_neighbourhood(g, {1, 7}, options);
+	REQUIRE(out[0].src_nodes == std::vector<int>{1, 7, 0});
+	REQUIRE(out[0].sources == std::vector<std::size_t>{2, 0});
+
+	REQUIRE_THROWS_WITH(gdwg::sample_neighbourhood(g, {42}, options),
+	                    "Cannot call gdwg::sample_neighbourhood if a seed node doesn't exist in the graph");
+}
+
+TEST_CASE("Uniform and weighted sampling frequencies", "[sampling]") {
+	gdwg::graph<int, int> g{0, 1, 2, 3, 4};
+	for (auto v = 1; v <= 4; ++v) {
+		g.insert_edge(v, 0, v);
+	}
+	auto const snapshot = gdwg::csr_graph<int, int>(g);
+	auto const seeds = std::vector<std::size_t>{0};
+	for (auto weighted : {false, true}) {
+		auto options = gdwg::sampler_options{};
+		options.fanouts = {1};
+		options.weighted = weighted;
+		auto sampler = gdwg::neighbour_sampler(snapshot, options);
+		auto counts = std::map<std::size_t, double>{};
+		auto sample = gdwg::sampled_subgraph{};
+		constexpr auto batches = 40000;
+		for (auto batch = 0; batch < batches; ++batch) {
+			sampler.sample(seeds, static_cast<std::uint64_t>(batch), sample);
+			++counts[sample.blocks[0].src_nodes[1]];
+		}
+		for (std::size_t v = 1; v <= 4; ++v) {
+			auto const expected = weighted ? static_cast<double>(v) / 10.0 : 0.25;
+			CHECK(counts[v] / batches == Approx(expected).margin(0.01));
+		}
+	}
+}
+
+TEST_CASE("Batches sampled in parallel are valid and reproducible", "[sampling]") {
+	auto rng = std::mt19937(37);
+	gdwg::graph<int, int> g;
+	for (auto v = 0; v < 300; ++v) {
+		g.insert_node(v);
+	}
+	for (auto e = 0; e < 3000; ++e) {
+		g.insert_edge(static_cast<int>(rng() % 300), static_cast<int>(rng() % 300), 1 + static_cast<int>(rng() % 4));
+	}
+	auto const snapshot = gdwg::csr_graph<int, int>(g);
+	auto batches = std::vector<std::vector<std::size_t>>(16);
+	for (auto& batch : batches) {
+		for (auto i = 0; i < 8; ++i) {
+			batch.push_back(rng() % 300);
+		}
+	}
+	for (auto direction : {gdwg::sample_direction::in, gdwg::sample_direction::out}) {
+		for (auto weighted : {false, true}) {
+			auto options = gdwg::sampler_options{};
+			options.fanouts = {5, 3, 2};
+			options.direction = direction;
+			options.weighted = weighted;
+			auto sampler = gdwg::neighbour_sampler(snapshot, options);
+			auto one = gdwg::thread_pool(1);
+			auto four = gdwg::thread_pool(4);
+			auto const expected = sampler.sample(batches, one);
+			auto const samples = sampler.sample(batches, four);
+			REQUIRE(samples.size() == batches.size());
+			for (std::size_t b = 0; b < samples.size(); ++b) {
+				check_blocks(snapshot, samples[b], options);
+				// Duplicate seeds share one local node
+				REQUIRE(samples[b].blocks[0].dst_count
+				        == std::set<std::size_t>(batches[b].begin(), batches[b].end()).size());
+				for (std::size_t hop = 0; hop < options.fanouts.size(); ++hop) {
+					REQUIRE(samples[b].blocks[hop].src_nodes == expected[b].blocks[hop].src_nodes);
+					REQUIRE(samples[b].blocks[hop].edges == expected[b].blocks[hop].edges);
+				}
+			}
+		}
+	}
+}
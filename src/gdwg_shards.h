@@ -0,0 +1,778 @@
+#ifndef GDWG_SHARDS_H
+#define GDWG_SHARDS_H
+
+#include "gdwg_csr.h"
+#include "gdwg_graph.h"
+#include "gdwg_partition.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// A partitioned graph served by several local processes over POSIX shared memory (Linux)
+// The graph lives in one segment per shard plus a small directory segment. A shard server (any process that
+// calls sharded_graph::serve) answers requests for the nodes it owns through a mailbox in its segment, and
+// clients route every call to the owning shard, so the edges are only ever touched by the shard processes
+namespace gdwg {
+	namespace detail {
+		[[noreturn]] inline void segment_error(char const* action, std::string const& name, int error) {
+			throw std::runtime_error(std::string("Cannot ") + action + " shared memory segment " + name + ": "
+			                         + std::strerror(error));
+		}
+
+		// A POSIX shared memory segment mapped into this process
+		class shared_memory {
+		 public:
+			shared_memory() noexcept = default;
+
+			// Create a segment of size bytes, failing if the name is taken; it is unlinked when this object is
+			// destroyed
+			static shared_memory create(std::string name, std::size_t size) {
+				auto const fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+				if (fd < 0) {
+					segment_error("create", name, errno);
+				}
+				if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+					auto const error = errno;
+					::close(fd);
+					::shm_unlink(name.c_str());
+					segment_error("size", name, error);
+				}
+				auto result = shared_memory{};
+				result.name_ = std::move(name);
+				result.owner_ = true;
+				result.map(fd, size);
+				return result;
+			}
+
+			// Map the first length bytes of an existing segment, or all of it if length is 0
+			static shared_memory open(std::string name, std::size_t length = 0) {
+				auto const fd = ::shm_open(name.c_str(), O_RDWR, 0);
+				if (fd < 0) {
+					segment_error("open", name, errno);
+				}
+				if (length == 0) {
+					struct ::stat status = {};
+					if (::fstat(fd, &status) != 0) {
+						auto const error = errno;
+						::close(fd);
+						segment_error("open", name, error);
+					}
+					length = static_cast<std::size_t>(status.st_size);
+				}
+				auto result = shared_memory{};
+				result.name_ = std::move(name);
+				result.map(fd, length);
+				return result;
+			}
+
+			shared_memory(shared_memory&& other) noexcept
+			: name_(std::move(other.name_))
+			, data_(std::exchange(other.data_, nullptr))
+			, size_(std::exchange(other.size_, 0))
+			, owner_(std::exchange(other.owner_, false)) {}
+
+			shared_memory& operator=(shared_memory&& other) noexcept {
+				if (this != &other) {
+					release();
+					name_ = std::move(other.name_);
+					data_ = std::exchange(other.data_, nullptr);
+					size_ = std::exchange(other.size_, 0);
+					owner_ = std::exchange(other.owner_, false);
+				}
+				return *this;
+			}
+
+			shared_memory(shared_memory const&) = delete;
+			shared_memory& operator=(shared_memory const&) = delete;
+
+			~shared_memory() {
+				release();
+			}
+
+			[[nodiscard]] std::byte* data() const noexcept {
+				return static_cast<std::byte*>(data_);
+			}
+
+			[[nodiscard]] std::size_t size() const noexcept {
+				return size_;
+			}
+
+		 private:
+			void map(int fd, std::size_t size) {
+				auto* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+				auto const error = errno;
+				::close(fd);
+				if (data == MAP_FAILED) {
+					if (owner_) {
+						::shm_unlink(name_.c_str());
+					}
+					segment_error("map", name_, error);
+				}
+				data_ = data;
+				size_ = size;
+			}
+
+			void release() noexcept {
+				if (data_ != nullptr) {
+					::munmap(data_, size_);
+				}
+				if (owner_) {
+					::shm_unlink(name_.c_str());
+				}
+				data_ = nullptr;
+				owner_ = false;
+			}
+
+			std::string name_;
+			void* data_ = nullptr;
+			std::size_t size_ = 0;
+			bool owner_ = false;
+		};
+
+		enum class shard_request : std::uint32_t { is_connected, connections, edges, expand, stop };
+
+		[[noreturn]] inline void mailbox_error(char const* action, int error) {
+			throw std::runtime_error(std::string("Cannot ") + action + " a gdwg::sharded_graph mailbox: "
+			                         + std::strerror(error));
+		}
+
+		inline void check_mailbox(char const* action, int error) {
+			if (error != 0) {
+				mailbox_error(action, error);
+			}
+		}
+
+		// One-request mailbox between clients and a shard server, in shared memory. A client claims the
+		// mailbox, posts a request and waits for the response; the server waits for a post and responds.
+		// Claiming separately from posting lets a client post to every shard before waiting for any.
+		// A client process that dies must not block the others: the mutex is robust, so one that dies holding
+		// it leaves it usable, and the mailbox records which process claimed it, so a claim left behind by a
+		// dead process is taken back once the server is no longer answering its request
+		struct shard_mailbox {
+			enum : std::uint32_t { idle, posted, done };
+
+			// How often a client waiting to claim the mailbox checks whether its claimant is still alive
+			static constexpr auto poll_nanoseconds = long{100'000'000};
+
+			void init() {
+				auto mutex_attributes = ::pthread_mutexattr_t{};
+				check_mailbox("initialise the mutex attributes of", ::pthread_mutexattr_init(&mutex_attributes));
+				auto error = ::pthread_mutexattr_setpshared(&mutex_attributes, PTHREAD_PROCESS_SHARED);
+				if (error == 0) {
+					error = ::pthread_mutexattr_setrobust(&mutex_attributes, PTHREAD_MUTEX_ROBUST);
+				}
+				if (error == 0) {
+					error = ::pthread_mutex_init(&mutex, &mutex_attributes);
+				}
+				::pthread_mutexattr_destroy(&mutex_attributes);
+				check_mailbox("initialise the mutex of", error);
+
+				auto cond_attributes = ::pthread_condattr_t{};
+				error = ::pthread_condattr_init(&cond_attributes);
+				if (error != 0) {
+					::pthread_mutex_destroy(&mutex);
+					mailbox_error("initialise the condition attributes of", error);
+				}
+				error = ::pthread_condattr_setpshared(&cond_attributes, PTHREAD_PROCESS_SHARED);
+				if (error == 0) {
+					error = ::pthread_condattr_setclock(&cond_attributes, CLOCK_MONOTONIC);
+				}
+				if (error == 0) {
+					error = ::pthread_cond_init(&changed, &cond_attributes);
+				}
+				::pthread_condattr_destroy(&cond_attributes);
+				if (error != 0) {
+					::pthread_mutex_destroy(&mutex);
+					mailbox_error("initialise the condition variable of", error);
+				}
+			}
+
+			// Client side: take the mailbox, then post a request filled in while holding it
+			void claim() {
+				lock();
+				while (busy != 0) {
+					wait(true);
+					reclaim_abandoned();
+				}
+				owner = ::getpid();
+				busy = 1;
+				::pthread_mutex_unlock(&mutex);
+			}
+
+			void post() {
+				set(posted);
+			}
+
+			// Client side: wait for the response to the posted request
+			void await() {
+				wait_for(done);
+			}
+
+			// Client side: hand the mailbox back once the response has been read
+			void release() {
+				lock();
+				busy = 0;
+				state = idle;
+				::pthread_cond_broadcast(&changed);
+				::pthread_mutex_unlock(&mutex);
+			}
+
+			// Server side
+			void receive() {
+				wait_for(posted);
+			}
+
+			void respond() {
+				set(done);
+			}
+
+			::pthread_mutex_t mutex;
+			::pthread_cond_t changed;
+			std::uint32_t busy = 0;
+			std::uint32_t state = idle;
+			::pid_t owner = 0; // Process that claimed the mailbox
+			shard_request kind = shard_request::stop;
+			std::uint64_t arguments[2] = {0, 0};
+			std::uint64_t input_count = 0; // Words in the input buffer
+			std::uint64_t output_count = 0; // Entries in the output buffer
+			std::uint64_t result = 0;
+
+		 private:
+			void set(std::uint32_t value) {
+				lock();
+				state = value;
+				::pthread_cond_broadcast(&changed);
+				::pthread_mutex_unlock(&mutex);
+			}
+
+			void wait_for(std::uint32_t value) {
+				lock();
+				while (state != value) {
+					wait(false);
+				}
+				::pthread_mutex_unlock(&mutex);
+			}
+
+			void lock() {
+				recover(::pthread_mutex_lock(&mutex), "lock");
+			}
+
+			// Wait on the condition variable with the mutex held, for at most the poll interval if timed
+			void wait(bool timed) {
+				if (!timed) {
+					recover(::pthread_cond_wait(&changed, &mutex), "wait on");
+					return;
+				}
+				auto deadline = ::timespec{};
+				::clock_gettime(CLOCK_MONOTONIC, &deadline);
+				deadline.tv_nsec += poll_nanoseconds;
+				if (deadline.tv_nsec >= 1'000'000'000) {
+					deadline.tv_sec += 1;
+					deadline.tv_nsec -= 1'000'000'000;
+				}
+				auto const error = ::pthread_cond_timedwait(&changed, &mutex, &deadline);
+				recover(error == ETIMEDOUT ? 0 : error, "wait on");
+			}
+
+			// The mutex is held after a lock or wait that returned error; if its last holder died, the mailbox is
+			// checked for an abandoned claim and the mutex made usable again
+			void recover(int error, char const* action) {
+				if (error == EOWNERDEAD) {
+					reclaim_abandoned();
+					check_mailbox("recover the mutex of", ::pthread_mutex_consistent(&mutex));
+					return;
+				}
+				check_mailbox(action, error);
+			}
+
+			// Free a mailbox whose claimant died, unless the server is still answering its request
+			void reclaim_abandoned() {
+				if (busy == 0 or state == posted) {
+					return;
+				}
+				if (owner > 0 and (::kill(owner, 0) == 0 or errno == EPERM)) {
+					return;
+				}
+				busy = 0;
+				state = idle;
+				::pthread_cond_broadcast(&changed);
+			}
+		};
+
+		inline constexpr auto shard_magic = std::uint64_t{0x6764776773686431}; // "gdwgshd1"
+
+		inline std::size_t align_segment(std::size_t bytes) {
+			return (bytes + 63) / 64 * 64;
+		}
+
+		// Start of the directory segment; byte offsets are from the start of the segment
+		struct shard_directory {
+			std::uint64_t magic;
+			std::uint64_t node_size; // sizeof(N) and sizeof(E), checked by clients and servers
+			std::uint64_t weight_size;
+			std::uint64_t node_count;
+			std::uint64_t shard_count;
+			std::uint64_t owner; // Owning shard of every node (uint64_t[node_count])
+			std::uint64_t local; // Index of every node within its shard (uint64_t[node_count])
+			std::uint64_t nodes; // Node values in ascending order (N[node_count])
+		};
+
+		// Start of a shard segment. The mailbox and buffers come first, so clients map only that prefix
+		struct shard_header {
+			std::uint64_t magic;
+			std::uint64_t weight_size;
+			std::uint64_t node_count; // Nodes owned by the shard
+			std::uint64_t edge_count; // Edges leaving them
+			std::uint64_t input; // Request buffer (uint64_t[node_count])
+			std::uint64_t output; // Response buffer
+			std::uint64_t client_size; // Bytes clients map
+			std::uint64_t offsets; // Row offsets (uint64_t[node_count + 1])
+			std::uint64_t targets; // Global target of every edge (uint64_t[edge_count])
+			std::uint64_t weights; // Weight of every edge (E[edge_count])
+			std::uint64_t present; // Whether every edge is weighted (uint8_t[edge_count])
+			shard_mailbox mailbox;
+		};
+
+		inline std::string directory_name(std::string const& name) {
+			return "/" + name;
+		}
+
+		inline std::string shard_name(std::string const& name, std::size_t shard) {
+			return "/" + name + "." + std::to_string(shard);
+		}
+
+		template<typename T>
+		T* at(std::byte* base, std::uint64_t offset) {
+			return std::launder(reinterpret_cast<T*>(base + offset));
+		}
+	} // namespace detail
+
+	// Owner of a partitioned graph laid out in shared memory under a name (letters, digits, '_', '-', '.').
+	// Node u of the snapshot is owned by shard part[u]; every shard stores the rows of its nodes with global
+	// targets. The segments are removed when this object is destroyed, so it must outlive the servers and
+	// clients. Node values and weights are copied bytewise, so both types must be trivially copyable
+	template<typename N, typename E>
+	class sharded_graph {
+		static_assert(std::is_trivially_copyable_v<N> and std::is_trivially_copyable_v<E>,
+		              "gdwg::sharded_graph needs trivially copyable node and weight types");
+
+	 public:
+		sharded_graph(std::string name,
+		              csr_graph<N, E> const& g,
+		              std::span<std::size_t const> part,
+		              std::size_t shards)
+		: name_(std::move(name))
+		, shard_count_(shards) {
+			auto const n = g.node_count();
+			if (shards == 0 or part.size() != n
+			    or std::any_of(part.begin(), part.end(), [shards](std::size_t p) { return p >= shards; })) {
+				throw std::runtime_error("Cannot construct gdwg::sharded_graph with a part outside the shards");
+			}
+			if (!std::is_sorted(g.nodes().begin(), g.nodes().end())) {
+				throw std::runtime_error("Cannot construct gdwg::sharded_graph from a reordered snapshot");
+			}
+
+			auto directory_layout = detail::shard_directory{};
+			directory_layout.magic = detail::shard_magic;
+			directory_layout.node_size = sizeof(N);
+			directory_layout.weight_size = sizeof(E);
+			directory_layout.node_count = n;
+			directory_layout.shard_count = shards;
+			directory_layout.owner = detail::align_segment(sizeof(detail::shard_directory));
+			directory_layout.local = detail::align_segment(directory_layout.owner + n * sizeof(std::uint64_t));
+			directory_layout.nodes = detail::align_segment(directory_layout.local + n * sizeof(std::uint64_t));
+			auto const directory_size = std::max<std::size_t>(directory_layout.nodes + n * sizeof(N), 1);
+			directory_ = detail::shared_memory::create(detail::directory_name(name_), directory_size);
+			auto* const base = directory_.data();
+			new (base) detail::shard_directory(directory_layout);
+			auto* const owner = detail::at<std::uint64_t>(base, directory_layout.owner);
+			auto* const local = detail::at<std::uint64_t>(base, directory_layout.local);
+			auto members = std::vector<std::vector<std::size_t>>(shards);
+			for (std::size_t u = 0; u < n; ++u) {
+				owner[u] = part[u];
+				local[u] = members[part[u]].size();
+				members[part[u]].push_back(u);
+			}
+			if (n > 0) {
+				std::memcpy(base + directory_layout.nodes, g.nodes().data(), n * sizeof(N));
+			}
+
+			for (std::size_t s = 0; s < shards; ++s) {
+				auto edges = std::size_t{0};
+				for (auto u : members[s]) {
+					edges += g.degree(u);
+				}
+				auto header = detail::shard_header{};
+				header.magic = detail::shard_magic;
+				header.weight_size = sizeof(E);
+				header.node_count = members[s].size();
+				header.edge_count = edges;
+				header.input = detail::align_segment(sizeof(detail::shard_header));
+				header.output = detail::align_segment(header.input + std::max<std::size_t>(members[s].size(), 2) * 8);
+				header.client_size = detail::align_segment(header.output + output_bytes(edges));
+				header.offsets = header.client_size;
+				header.targets = detail::align_segment(header.offsets + (members[s].size() + 1) * 8);
+				header.weights = detail::align_segment(header.targets + edges * 8);
+				header.present = detail::align_segment(header.weights + edges * sizeof(E));
+				auto memory = detail::shared_memory::create(detail::shard_name(name_, s), header.present + edges + 1);
+
+				auto* const shard = memory.data();
+				auto* const stored = new (shard) detail::shard_header(header);
+				stored->mailbox.init();
+				auto* const offsets = detail::at<std::uint64_t>(shard, header.offsets);
+				auto* const targets = detail::at<std::uint64_t>(shard, header.targets);
+				auto* const present = detail::at<std::uint8_t>(shard, header.present);
+				auto position = std::size_t{0};
+				offsets[0] = 0;
+				for (std::size_t i = 0; i < members[s].size(); ++i) {
+					auto const u = members[s][i];
+					auto const row = g.neighbours(u);
+					auto const weights = g.weights(u);
+					for (std::size_t e = 0; e < row.size(); ++e, ++position) {
+						targets[position] = row[e];
+						present[position] = weights[e] ? 1 : 0;
+						auto const weight = weights[e].value_or(E{});
+						std::memcpy(shard + header.weights + position * sizeof(E), &weight, sizeof(E));
+					}
+					offsets[i + 1] = position;
+				}
+				shards_.push_back(std::move(memory));
+			}
+		}
+
+		// Partition g into the given number of shards (see partition_graph) and lay it out
+		sharded_graph(std::string name, graph<N, E> const& g, std::size_t shards)
+		: sharded_graph(std::move(name), csr_graph<N, E>(g), shards) {}
+
+		[[nodiscard]] std::string const& name() const noexcept {
+			return name_;
+		}
+
+		[[nodiscard]] std::size_t shard_count() const noexcept {
+			return shard_count_;
+		}
+
+		// Answer requests for one shard until a client calls shard_client::stop. Call this from the process
+		// (or thread) that serves the shard; it maps the shard's segment by name
+		static void serve(std::string const& name, std::size_t shard) {
+			auto const memory = detail::shared_memory::open(detail::shard_name(name, shard));
+			auto* const base = memory.data();
+			auto* const header = detail::at<detail::shard_header>(base, 0);
+			if (header->magic != detail::shard_magic or header->weight_size != sizeof(E)) {
+				throw std::runtime_error("Cannot call gdwg::sharded_graph::serve on a segment of another graph type");
+			}
+			auto* const offsets = detail::at<std::uint64_t const>(base, header->offsets);
+			auto* const targets = detail::at<std::uint64_t const>(base, header->targets);
+			auto* const present = detail::at<std::uint8_t const>(base, header->present);
+			auto* const input = detail::at<std::uint64_t const>(base, header->input);
+			auto* const output = base + header->output;
+			auto& mailbox = header->mailbox;
+			while (true) {
+				mailbox.receive();
+				auto const first = [&] { return targets + offsets[mailbox.arguments[0]]; };
+				auto const last = [&] { return targets + offsets[mailbox.arguments[0] + 1]; };
+				auto count = std::uint64_t{0};
+				switch (mailbox.kind) {
+				case detail::shard_request::is_connected:
+					mailbox.result = std::binary_search(first(), last(), mailbox.arguments[1]) ? 1 : 0;
+					break;
+				case detail::shard_request::connections:
+					for (auto it = first(); it != last(); ++it) {
+						if (it == first() or *it != *(it - 1)) {
+							std::memcpy(output + count++ * 8, it, 8);
+						}
+					}
+					break;
+				case detail::shard_request::edges: {
+					// Rows are sorted by (target, weight), so the edges to one node are already in graph order
+					auto const range = std::equal_range(first(), last(), mailbox.arguments[1]);
+					for (auto it = range.first; it != range.second; ++it) {
+						auto const e = static_cast<std::size_t>(it - targets);
+						auto* const entry = output + count++ * (sizeof(E) + 1);
+						entry[0] = std::byte{present[e]};
+						std::memcpy(entry + 1, base + header->weights + e * sizeof(E), sizeof(E));
+					}
+					break;
+				}
+				case detail::shard_request::expand:
+					for (std::uint64_t i = 0; i < mailbox.input_count; ++i) {
+						auto const v = input[i];
+						std::memcpy(output + count * 8, targets + offsets[v], (offsets[v + 1] - offsets[v]) * 8);
+						count += offsets[v + 1] - offsets[v];
+					}
+					break;
+				case detail::shard_request::stop: mailbox.respond(); return;
+				}
+				mailbox.output_count = count;
+				mailbox.respond();
+			}
+		}
+
+	 private:
+		sharded_graph(std::string name, csr_graph<N, E> const& snapshot, std::size_t shards)
+		: sharded_graph(std::move(name), snapshot, partition_of(snapshot, shards), shards) {}
+
+		static std::vector<std::size_t> partition_of(csr_graph<N, E> const& g, std::size_t shards) {
+			auto options = partition_options{};
+			options.parts = shards;
+			return partition_graph(g, options).part;
+		}
+
+		// Room for the largest response: every edge target, or every edge weight with its flag
+		static std::size_t output_bytes(std::size_t edges) {
+			return std::max<std::size_t>(edges, 1) * std::max<std::size_t>(8, sizeof(E) + 1);
+		}
+
+		std::string name_;
+		std::size_t shard_count_;
+		detail::shared_memory directory_;
+		std::vector<detail::shared_memory> shards_;
+	};
+
+	// Client of a sharded graph: maps the directory and the mailboxes of the shards and routes every call to
+	// the shard that owns the node. Calls block until the shard answers; one client object serves one thread
+	// at a time, but any number of clients, in any processes, may share the shards
+	template<typename N, typename E>
+	class shard_client {
+		static_assert(std::is_trivially_copyable_v<N> and std::is_trivially_copyable_v<E>,
+		              "gdwg::shard_client needs trivially copyable node and weight types");
+
+	 public:
+		explicit shard_client(std::string const& name)
+		: directory_(detail::shared_memory::open(detail::directory_name(name))) {
+			auto const& directory = *detail::at<detail::shard_directory>(directory_.data(), 0);
+			if (directory.magic != detail::shard_magic or directory.node_size != sizeof(N)
+			    or directory.weight_size != sizeof(E)) {
+				throw std::runtime_error("Cannot construct gdwg::shard_client for a graph of another type");
+			}
+			node_count_ = directory.node_count;
+			owner_ = detail::at<std::uint64_t const>(directory_.data(), directory.owner);
+			local_ = detail::at<std::uint64_t const>(directory_.data(), directory.local);
+			nodes_ = detail::at<N const>(directory_.data(), directory.nodes);
+			for (std::size_t s = 0; s < directory.shard_count; ++s) {
+				auto const segment = detail::shard_name(name, s);
+				auto client_size = std::size_t{0};
+				{
+					auto const peek = detail::shared_memory::open(segment, sizeof(detail::shard_header));
+					auto const& header = *detail::at<detail::shard_header>(peek.data(), 0);
+					if (header.magic != detail::shard_magic or header.weight_size != sizeof(E)) {
+						throw std::runtime_error("Cannot construct gdwg::shard_client for a graph of another type");
+					}
+					client_size = header.client_size;
+				}
+				shards_.push_back(detail::shared_memory::open(segment, client_size));
+			}
+		}
+
+		// Return the number of shards
+		[[nodiscard]] std::size_t shard_count() const noexcept {
+			return shards_.size();
+		}
+
+		// Return the number of nodes across all shards
+		[[nodiscard]] std::size_t node_count() const noexcept {
+			return node_count_;
+		}
+
+		[[nodiscard]] bool is_node(N const& value) const {
+			return index_of(value).has_value();
+		}
+
+		// Return the shard that owns a node
+		[[nodiscard]] std::size_t shard_of(N const& value) const {
+			auto const u = index_of(value);
+			if (!u) {
+				throw std::runtime_error("Cannot call gdwg::shard_client<N, E>::shard_of if the node doesn't exist in "
+				                         "the graph");
+			}
+			return owner_[*u];
+		}
+
+		// Check if there is an edge from src to dst
+		[[nodiscard]] bool is_connected(N const& src, N const& dst) {
+			auto const u = index_of(src);
+			auto const v = index_of(dst);
+			if (!u or !v) {
+				throw std::runtime_error("Cannot call gdwg::shard_client<N, E>::is_connected if src or dst node don't "
+				                         "exist in the graph");
+			}
+			auto& mailbox = call(owner_[*u], detail::shard_request::is_connected, local_[*u], *v);
+			auto const result = mailbox.result != 0;
+			mailbox.release();
+			return result;
+		}
+
+		// Return all dst nodes of edges from src, sorted in ascending order
+		[[nodiscard]] std::vector<N> connections(N const& src) {
+			auto const u = index_of(src);
+			if (!u) {
+				throw std::runtime_error("Cannot call gdwg::shard_client<N, E>::connections if src doesn't exist in "
+				                         "the graph");
+			}
+			auto const shard = owner_[*u];
+			auto& mailbox = call(shard, detail::shard_request::connections, local_[*u], 0);
+			auto result = std::vector<N>{};
+			result.reserve(mailbox.output_count);
+			for (std::uint64_t i = 0; i < mailbox.output_count; ++i) {
+				result.push_back(nodes_[word(shard, i)]);
+			}
+			mailbox.release();
+			return result;
+		}
+
+		// Return all edges from src to dst, unweighted first and then by ascending weight
+		[[nodiscard]] std::vector<std::unique_ptr<edge<N, E>>> edges(N const& src, N const& dst) {
+			auto const u = index_of(src);
+			auto const v = index_of(dst);
+			if (!u or !v) {
+				throw std::runtime_error("Cannot call gdwg::shard_client<N, E>::edges if src or dst node don't exist "
+				                         "in the graph");
+			}
+			auto const shard = owner_[*u];
+			auto& mailbox = call(shard, detail::shard_request::edges, local_[*u], *v);
+			auto result = std::vector<std::unique_ptr<edge<N, E>>>{};
+			for (std::uint64_t i = 0; i < mailbox.output_count; ++i) {
+				auto const* const entry = output(shard) + i * (sizeof(E) + 1);
+				if (entry[0] == std::byte{0}) {
+					result.push_back(std::make_unique<unweighted_edge<N, E>>(src, dst));
+				}
+				else {
+					auto weight = E{};
+					std::memcpy(&weight, entry + 1, sizeof(E));
+					result.push_back(std::make_unique<weighted_edge<N, E>>(src, dst, weight));
+				}
+			}
+			mailbox.release();
+			return result;
+		}
+
+		// Breadth-first search from src across the shards, returning the hop distance of every reached node
+		// Level-synchronous: each round, every shard with frontier nodes expands their rows in parallel with
+		// the others, and the client keeps the targets not seen before as the next frontier, grouped by owner
+		[[nodiscard]] std::map<N, std::size_t> breadth_first(N const& src) {
+			auto const source = index_of(src);
+			if (!source) {
+				throw std::runtime_error("Cannot call gdwg::shard_client<N, E>::breadth_first if src doesn't exist in "
+				                         "the graph");
+			}
+			auto const unreached = static_cast<std::size_t>(-1);
+			auto distance = std::vector<std::size_t>(node_count_, unreached);
+			auto frontier = std::vector<std::vector<std::uint64_t>>(shards_.size());
+			auto next = std::vector<std::vector<std::uint64_t>>(shards_.size());
+			distance[*source] = 0;
+			frontier[owner_[*source]].push_back(local_[*source]);
+			for (std::size_t level = 0;; ++level) {
+				auto active = std::vector<std::size_t>{};
+				for (std::size_t s = 0; s < shards_.size(); ++s) {
+					if (!frontier[s].empty()) {
+						auto& mailbox = header(s).mailbox;
+						mailbox.claim();
+						std::memcpy(shards_[s].data() + header(s).input, frontier[s].data(), frontier[s].size() * 8);
+						mailbox.kind = detail::shard_request::expand;
+						mailbox.input_count = frontier[s].size();
+						mailbox.post();
+						active.push_back(s);
+					}
+				}
+				if (active.empty()) {
+					break;
+				}
+				for (auto s : active) {
+					auto& mailbox = header(s).mailbox;
+					mailbox.await();
+					for (std::uint64_t i = 0; i < mailbox.output_count; ++i) {
+						auto const v = word(s, i);
+						if (distance[v] == unreached) {
+							distance[v] = level + 1;
+							next[owner_[v]].push_back(local_[v]);
+						}
+					}
+					mailbox.release();
+					frontier[s].clear();
+				}
+				frontier.swap(next);
+			}
+			auto result = std::map<N, std::size_t>{};
+			for (std::size_t v = 0; v < node_count_; ++v) {
+				if (distance[v] != unreached) {
+					result.emplace_hint(result.end(), nodes_[v], distance[v]);
+				}
+			}
+			return result;
+		}
+
+		// Ask every shard server to return from sharded_graph::serve
+		void stop() {
+			for (std::size_t s = 0; s < shards_.size(); ++s) {
+				call(s, detail::shard_request::stop, 0, 0).release();
+			}
+		}
+
+	 private:
+		[[nodiscard]] std::optional<std::size_t> index_of(N const& value) const {
+			auto const it = std::lower_bound(nodes_, nodes_ + node_count_, value);
+			if (it == nodes_ + node_count_ or value < *it) {
+				return std::nullopt;
+			}
+			return static_cast<std::size_t>(it - nodes_);
+		}
+
+		[[nodiscard]] detail::shard_header& header(std::size_t shard) const {
+			return *detail::at<detail::shard_header>(shards_[shard].data(), 0);
+		}
+
+		[[nodiscard]] std::byte const* output(std::size_t shard) const {
+			return shards_[shard].data() + header(shard).output;
+		}
+
+		[[nodiscard]] std::uint64_t word(std::size_t shard, std::uint64_t i) const {
+			auto value = std::uint64_t{0};
+			std::memcpy(&value, output(shard) + i * 8, 8);
+			return value;
+		}
+
+		// Send one request and wait for its response; the caller releases the mailbox after reading it
+		detail::shard_mailbox&
+		call(std::size_t shard, detail::shard_request kind, std::uint64_t first, std::uint64_t second) {
+			auto& mailbox = header(shard).mailbox;
+			mailbox.claim();
+			mailbox.kind = kind;
+			mailbox.arguments[0] = first;
+			mailbox.arguments[1] = second;
+			mailbox.input_count = 0;
+			mailbox.post();
+			mailbox.await();
+			return mailbox;
+		}
+
+		detail::shared_memory directory_;
+		std::size_t node_count_ = 0;
+		std::uint64_t const* owner_ = nullptr;
+		std::uint64_t const* local_ = nullptr;
+		N const* nodes_ = nullptr;
+		std::vector<detail::shared_memory> shards_;
+	};
+} // namespace gdwg
+
+#endif // GDWG_SHARDS_H
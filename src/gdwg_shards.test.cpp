@@ -0,0 +1,237 @@
+#include "gdwg_shards.h"
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <queue>
+#include <random>
+#include <thread>
+
+#include <sys/wait.h>
+
+namespace {
+	std::string unique_name(std::string const& tag) {
+		return "gdwg_test_" + tag + "_" + std::to_string(::getpid());
+	}
+
+	gdwg::graph<int, double> random_graph(int nodes, int edges, unsigned seed) {
+		auto rng = std::mt19937(seed);
+		gdwg::graph<int, double> g;
+		for (auto v = 0; v < nodes; ++v) {
+			g.insert_node(v * 3); // Values are not indices
+		}
+		for (auto e = 0; e < edges; ++e) {
+			auto const u = static_cast<int>(rng() % static_cast<unsigned>(nodes)) * 3;
+			auto const v = static_cast<int>(rng() % static_cast<unsigned>(nodes)) * 3;
+			if (rng() % 4 == 0) {
+				g.insert_edge(u, v);
+			}
+			else {
+				g.insert_edge(u, v, static_cast<double>(rng() % 5));
+			}
+		}
+		return g;
+	}
+
+	std::map<int, std::size_t> reference_bfs(gdwg::graph<int, double> const& g, int source) {
+		auto distance = std::map<int, std::size_t>{{source, 0}};
+		auto queue = std::queue<int>{};
+		queue.push(source);
+		while (!queue.empty()) {
+			auto const u = queue.front();
+			queue.pop();
+			for (auto v : g.connections(u)) {
+				if (distance.emplace(v, distance[u] + 1).second) {
+					queue.push(v);
+				}
+			}
+		}
+		return distance;
+	}
+
+	// Every routed call agrees with the graph itself
+	void check_client(gdwg::shard_client<int, double>& client, gdwg::graph<int, double> const& g) {
+		for (auto v = 0; v < static_cast<int>(client.node_count()) * 3; v += 3) {
+			REQUIRE(client.connections(v) == g.connections(v));
+			for (auto w = 0; w < 30; w += 3) {
+				REQUIRE(client.is_connected(v, w) == g.is_connected(v, w));
+				auto const expected = g.edges(v, w);
+				auto const routed = client.edges(v, w);
+				REQUIRE(routed.size() == expected.size());
+				for (std::size_t i = 0; i < routed.size(); ++i) {
+					REQUIRE(routed[i]->print_edge() == expected[i]->print_edge());
+				}
+			}
+		}
+		for (auto source : {0, 3, 51}) {
+			REQUIRE(client.breadth_first(source) == reference_bfs(g, source));
+		}
+	}
+} // namespace
+
+// Sharded graph tests
+TEST_CASE("Shards served by separate processes answer routed calls", "[shards]") {
+	auto const g = random_graph(120, 500, 40);
+	auto const name = unique_name("processes");
+	auto const shards = std::size_t{3};
+	auto const store = gdwg::sharded_graph<int, double>(name, g, shards);
+	REQUIRE(store.shard_count() == shards);
+
+	auto children = std::vector<pid_t>{};
+	for (std::size_t s = 0; s < shards; ++s) {
+		auto const pid = ::fork();
+		REQUIRE(pid >= 0);
+		if (pid == 0) {
+			try {
+				gdwg::sharded_graph<int, double>::serve(name, s);
+			} catch (...) {
+				::_exit(1);
+			}
+			::_exit(0);
+		}
+		children.push_back(pid);
+	}
+
+	auto client = gdwg::shard_client<int, double>(name);
+	REQUIRE(client.shard_count() == shards);
+	REQUIRE(client.node_count() == 120);
+	REQUIRE(client.is_node(9));
+	REQUIRE_FALSE(client.is_node(10));
+	check_client(client, g);
+
+	// Every shard owns a share of the nodes
+	auto owned = std::vector<std::size_t>(shards, 0);
+	for (auto v = 0; v < 360; v += 3) {
+		++owned[client.shard_of(v)];
+	}
+	for (auto count : owned) {
+		REQUIRE(count >= 35);
+	}
+
+	REQUIRE_THROWS_WITH(client.is_connected(1, 0),
+	                    "Cannot call gdwg::shard_client<N, E>::is_connected if src or dst node don't exist in the "
+	                    "graph");
+	REQUIRE_THROWS_WITH(client.connections(1),
+	                    "Cannot call gdwg::shard_client<N, E>::connections if src doesn't exist in the graph");
+	REQUIRE_THROWS_WITH(client.edges(0, 1),
+	                    "Cannot call gdwg::shard_client<N, E>::edges if src or dst node don't exist in the graph");
+
+	client.stop();
+	for (auto pid : children) {
+		auto status = 0;
+		REQUIRE(::waitpid(pid, &status, 0) == pid);
+		REQUIRE(WIFEXITED(status));
+		REQUIRE(WEXITSTATUS(status) == 0);
+	}
+}
+
+TEST_CASE("Several clients share threads serving the shards", "[shards]") {
+	auto const g = random_graph(80, 300, 41);
+	auto const name = unique_name("threads");
+	auto const snapshot = gdwg::csr_graph<int, double>(g);
+	auto part = std::vector<std::size_t>(snapshot.node_count());
+	for (std::size_t u = 0; u < part.size(); ++u) {
+		part[u] = u % 4;
+	}
+	auto const store = gdwg::sharded_graph<int, double>(name, snapshot, part, 4);
+	auto servers = std::vector<std::thread>{};
+	for (std::size_t s = 0; s < 4; ++s) {
+		servers.emplace_back([&name, s] { gdwg::sharded_graph<int, double>::serve(name, s); });
+	}
+
+	auto failures = std::atomic<int>{0};
+	auto clients = std::vector<std::thread>{};
+	for (auto c = 0; c < 3; ++c) {
+		clients.emplace_back([&] {
+			auto client = gdwg::shard_client<int, double>(name);
+			for (auto round = 0; round < 5; ++round) {
+				if (client.breadth_first(0) != reference_bfs(g, 0) or client.connections(6) != g.connections(6)) {
+					++failures;
+				}
+			}
+		});
+	}
+	for (auto& client : clients) {
+		client.join();
+	}
+	REQUIRE(failures == 0);
+	auto client = gdwg::shard_client<int, double>(name);
+	REQUIRE(client.shard_of(9) == 3);
+	check_client(client, g);
+	client.stop();
+	for (auto& server : servers) {
+		server.join();
+	}
+}
+
+TEST_CASE("A client process that dies while using a mailbox does not block the others", "[shards]") {
+	auto const g = random_graph(40, 150, 43);
+	auto const name = unique_name("abandoned");
+	auto const store = gdwg::sharded_graph<int, double>(name, g, 1);
+	auto const segment = gdwg::detail::shared_memory::open(gdwg::detail::shard_name(name, 0));
+	auto& mailbox = gdwg::detail::at<gdwg::detail::shard_header>(segment.data(), 0)->mailbox;
+
+	auto const server = ::fork();
+	REQUIRE(server >= 0);
+	if (server == 0) {
+		try {
+			gdwg::sharded_graph<int, double>::serve(name, 0);
+		} catch (...) {
+			::_exit(1);
+		}
+		::_exit(0);
+	}
+
+	// Run action in a child process that exits without cleaning up after it
+	auto const die_after = [](auto action) {
+		auto const pid = ::fork();
+		REQUIRE(pid >= 0);
+		if (pid == 0) {
+			action();
+			::_exit(0);
+		}
+		auto status = 0;
+		REQUIRE(::waitpid(pid, &status, 0) == pid);
+	};
+	auto client = gdwg::shard_client<int, double>(name);
+
+	die_after([&mailbox] { mailbox.claim(); }); // Between claim and release
+	REQUIRE(client.connections(0) == g.connections(0));
+
+	die_after([&mailbox] { ::pthread_mutex_lock(&mailbox.mutex); }); // Holding the mutex
+	REQUIRE(client.connections(3) == g.connections(3));
+
+	die_after([&mailbox] { // Before reading the response to its request
+		mailbox.claim();
+		mailbox.kind = gdwg::detail::shard_request::connections;
+		mailbox.arguments[0] = 0;
+		mailbox.input_count = 0;
+		mailbox.post();
+	});
+	check_client(client, g);
+
+	client.stop();
+	auto status = 0;
+	REQUIRE(::waitpid(server, &status, 0) == server);
+	REQUIRE(WIFEXITED(status));
+	REQUIRE(WEXITSTATUS(status) == 0);
+}
+
+TEST_CASE("Sharded graph edge cases", "[shards]") {
+	auto const g = random_graph(10, 20, 42);
+	auto const snapshot = gdwg::csr_graph<int, double>(g);
+	auto const bad = std::vector<std::size_t>(snapshot.node_count(), 2);
+	REQUIRE_THROWS_WITH((gdwg::sharded_graph<int, double>(unique_name("bad"), snapshot, bad, 2)),
+	                    "Cannot construct gdwg::sharded_graph with a part outside the shards");
+
+	// Names are exclusive while the owner is alive, and free again afterwards
+	auto const name = unique_name("exclusive");
+	{
+		auto const store = gdwg::sharded_graph<int, double>(name, g, 2);
+		REQUIRE_THROWS((gdwg::sharded_graph<int, double>(name, g, 2)));
+		REQUIRE_THROWS((gdwg::shard_client<int, int>(name)));
+	}
+	REQUIRE_THROWS((gdwg::shard_client<int, double>(name)));
+	auto const again = gdwg::sharded_graph<int, double>(name, g, 5);
+	REQUIRE(gdwg::shard_client<int, double>(name).shard_count() == 5);
+}
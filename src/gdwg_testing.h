@@ -0,0 +1,81 @@
+#ifndef GDWG_TESTING_H
+#define GDWG_TESTING_H
+
+#include "gdwg_graph.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+// Helpers shared by the *.test.cpp programs
+namespace gdwg::testing {
+	// The text operator<< prints for g
+	template<typename N, typename E>
+	std::string print(graph<N, E> const& g) {
+		auto out = std::ostringstream{};
+		out << g;
+		return out.str();
+	}
+
+	// The whole contents of a file
+	inline std::string contents(std::string const& path) {
+		auto in = std::ifstream(path, std::ios::binary);
+		auto out = std::ostringstream{};
+		out << in.rdbuf();
+		return out.str();
+	}
+
+	// A fresh, empty directory for the test's files, removed with everything in it at the end of the test
+	class scratch_directory {
+	 public:
+		explicit scratch_directory(std::string const& tag)
+		: path_(std::filesystem::temp_directory_path()
+		        / ("gdwg_test_" + tag + "_" + std::to_string(::getpid()))) {
+			std::filesystem::remove_all(path_);
+			std::filesystem::create_directories(path_);
+		}
+
+		scratch_directory(scratch_directory const&) = delete;
+		scratch_directory& operator=(scratch_directory const&) = delete;
+
+		~scratch_directory() {
+			std::filesystem::remove_all(path_);
+		}
+
+		[[nodiscard]] std::string path() const {
+			return path_.string();
+		}
+
+		[[nodiscard]] std::string file(std::string const& name) const {
+			return (path_ / name).string();
+		}
+
+		// Names of the files in the directory, sorted
+		[[nodiscard]] std::vector<std::string> files() const {
+			auto names = std::vector<std::string>{};
+			for (auto const& entry : std::filesystem::directory_iterator(path_)) {
+				names.push_back(entry.path().filename().string());
+			}
+			std::sort(names.begin(), names.end());
+			return names;
+		}
+
+		// Number of files in the directory
+		[[nodiscard]] std::size_t file_count() const {
+			auto const entries = std::filesystem::directory_iterator(path_);
+			return static_cast<std::size_t>(std::distance(begin(entries), end(entries)));
+		}
+
+	 private:
+		std::filesystem::path path_;
+	};
+} // namespace gdwg::testing
+
+#endif // GDWG_TESTING_H
@@ -0,0 +1,64 @@
+#include "gdwg_bench.h"
+#include "gdwg_generators.h"
+#include "gdwg_triangles.h"
+
+#include <bit>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+	// Snapshot of a graph made by one of the generators
+	template<typename Generate>
+	gdwg::csr_graph<std::size_t, int> generated(gdwg::thread_pool& pool, Generate generate) {
+		auto builder = gdwg::graph_builder<std::size_t, int>{};
+		generate(builder);
+		return gdwg::csr_graph<std::size_t, int>(builder.build(pool));
+	}
+} // namespace
+
+// Triangle counting on generated graphs
+// Usage: gdwg_triangles_bench [nodes] [average degree] [threads]
+auto main(int argc, char** argv) -> int {
+	auto const nodes = gdwg::bench::argument(argc, argv, 1, 1 << 18);
+	auto const degree = gdwg::bench::argument(argc, argv, 2, 16);
+	auto pool = gdwg::thread_pool(gdwg::bench::argument(argc, argv, 3, 0));
+
+	// Hub-heavy R-MAT and Barabási–Albert graphs, and a uniform G(n, m) graph; R-MAT rounds nodes up to a power of 2
+	auto const edges = nodes * degree;
+	auto const options = gdwg::generator_options{.shuffle_ids = true};
+	auto const scale = static_cast<std::size_t>(std::bit_width(nodes - 1));
+	auto graphs = std::vector<std::pair<std::string, gdwg::csr_graph<std::size_t, int>>>{};
+	graphs.emplace_back("rmat", generated(pool, [&](auto& b) {
+		gdwg::generate_rmat(b, scale, edges, {}, options, pool);
+	}));
+	graphs.emplace_back("barabasi_albert", generated(pool, [&](auto& b) {
+		gdwg::generate_barabasi_albert(b, nodes, degree, options, pool);
+	}));
+	graphs.emplace_back("gnm", generated(pool, [&](auto& b) { gdwg::generate_gnm(b, nodes, edges, options, pool); }));
+
+	for (auto const& [name, g] : graphs) {
+		auto const parameters = std::vector<gdwg::bench::parameter>{{"nodes", static_cast<double>(g.node_count())},
+		                                                            {"edges", static_cast<double>(g.edge_count())},
+		                                                            {"threads", static_cast<double>(pool.size())}};
+
+		auto count = std::size_t{0};
+		auto seconds = gdwg::bench::best_of(3, [&] { count = gdwg::triangle_count(g, pool); });
+		gdwg::bench::report(std::cout,
+		                    name + "/triangle_count",
+		                    parameters,
+		                    seconds,
+		                    {{"triangles", static_cast<double>(count)},
+		                     {"edges_per_second", static_cast<double>(g.edge_count()) / seconds}});
+
+		auto stats = gdwg::triangle_stats{};
+		seconds = gdwg::bench::best_of(3, [&] { stats = gdwg::triangles(g, pool); });
+		gdwg::bench::report(std::cout,
+		                    name + "/triangles_with_clustering",
+		                    parameters,
+		                    seconds,
+		                    {{"triangles", static_cast<double>(stats.triangles)},
+		                     {"average_clustering", stats.average_clustering}});
+	}
+}
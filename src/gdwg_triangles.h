@@ -0,0 +1,284 @@
+#ifndef GDWG_TRIANGLES_H
+#define GDWG_TRIANGLES_H
+
+#include "gdwg_csr.h"
+#include "gdwg_graph.h"
+#include "gdwg_parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__) or defined(__SSE4_1__)
+#	include <immintrin.h>
+#endif
+
+namespace gdwg {
+	namespace detail {
+		// Intersections switch to galloping once one list is this many times longer than the other
+		constexpr auto gallop_ratio = std::size_t{32};
+
+		// Intersect sorted lists by exponential search of each element of the short list in the long one
+		template<typename F>
+		std::size_t
+		intersect_galloping(std::span<std::size_t const> small, std::span<std::size_t const> large, F& on_match) {
+			auto count = std::size_t{0};
+			auto base = large.begin();
+			for (auto value : small) {
+				auto step = std::size_t{1};
+				auto hi = base;
+				while (hi != large.end() and *hi < value) {
+					base = hi;
+					hi = static_cast<std::size_t>(large.end() - hi) > step ? hi + static_cast<std::ptrdiff_t>(step)
+					                                                        : large.end();
+					step *= 2;
+				}
+				base = std::lower_bound(base, hi, value);
+				if (base == large.end()) {
+					break;
+				}
+				if (*base == value) {
+					on_match(value);
+					++count;
+				}
+			}
+			return count;
+		}
+
+		// Report every element of the block a[0..width) whose bit is set in mask
+		template<typename F>
+		void report_matches(std::size_t const* a, unsigned mask, F& on_match) {
+			for (auto bit = 0; mask != 0; ++bit, mask >>= 1) {
+				if (mask & 1u) {
+					on_match(a[bit]);
+				}
+			}
+		}
+
+		// Intersect sorted lists with a merge that compares blocks of elements all-against-all in SIMD registers
+		template<typename F>
+		std::size_t intersect_merge(std::span<std::size_t const> a, std::span<std::size_t const> b, F& on_match) {
+			auto count = std::size_t{0};
+			auto i = std::size_t{0};
+			auto j = std::size_t{0};
+#if defined(__AVX2__)
+			// 4 x 4 blocks: compare a block of a against every rotation of a block of b
+			while (i + 4 <= a.size() and j + 4 <= b.size()) {
+				auto const va = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a.data() + i));
+				auto const vb = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b.data() + j));
+				auto const hit = _mm256_or_si256(
+				    _mm256_or_si256(_mm256_cmpeq_epi64(va, vb),
+				                    _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, 0x39))),
+				    _mm256_or_si256(_mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, 0x4e)),
+				                    _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, 0x93))));
+				auto const mask = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(hit)));
+				if (mask != 0) {
+					count += static_cast<std::size_t>(__builtin_popcount(mask));
+					report_matches(a.data() + i, mask, on_match);
+				}
+				auto const a_last = a[i + 3];
+				auto const b_last = b[j + 3];
+				i += a_last <= b_last ? 4 : 0;
+				j += b_last <= a_last ? 4 : 0;
+			}
+#elif defined(__SSE4_1__)
+			// 2 x 2 blocks
+			while (i + 2 <= a.size() and j + 2 <= b.size()) {
+				auto const va = _mm_loadu_si128(reinterpret_cast<__m128i const*>(a.data() + i));
+				auto const vb = _mm_loadu_si128(reinterpret_cast<__m128i const*>(b.data() + j));
+				auto const hit =
+				    _mm_or_si128(_mm_cmpeq_epi64(va, vb), _mm_cmpeq_epi64(va, _mm_shuffle_epi32(vb, 0x4e)));
+				auto const mask = static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(hit)));
+				if (mask != 0) {
+					count += static_cast<std::size_t>(__builtin_popcount(mask));
+					report_matches(a.data() + i, mask, on_match);
+				}
+				auto const a_last = a[i + 1];
+				auto const b_last = b[j + 1];
+				i += a_last <= b_last ? 2 : 0;
+				j += b_last <= a_last ? 2 : 0;
+			}
+#endif
+			// Scalar merge for the tails (and the whole list without SIMD)
+			while (i < a.size() and j < b.size()) {
+				if (a[i] < b[j]) {
+					++i;
+				}
+				else if (b[j] < a[i]) {
+					++j;
+				}
+				else {
+					on_match(a[i]);
+					++count;
+					++i;
+					++j;
+				}
+			}
+			return count;
+		}
+
+		// Intersect two sorted lists of distinct values, calling on_match for every common value
+		template<typename F>
+		std::size_t intersect(std::span<std::size_t const> a, std::span<std::size_t const> b, F&& on_match) {
+			if (a.size() > b.size()) {
+				std::swap(a, b);
+			}
+			if (a.empty()) {
+				return 0;
+			}
+			if (a.size() * gallop_ratio < b.size()) {
+				return intersect_galloping(a, b, on_match);
+			}
+			return intersect_merge(a, b, on_match);
+		}
+
+		// Degree-oriented simple undirected graph: u keeps the neighbours that rank above it by (degree, index)
+		struct oriented_graph {
+			std::vector<std::size_t> degree; // Undirected degree of every node, ignoring loops and parallel edges
+			std::vector<std::size_t> offsets;
+			std::vector<std::size_t> targets; // Sorted by index within each node
+		};
+
+		template<typename N, typename E>
+		oriented_graph orient_by_degree(csr_graph<N, E> const& g, thread_pool& pool) {
+			auto const n = g.node_count();
+			auto const undirected = make_undirected(g, pool);
+			auto result = oriented_graph{};
+			result.degree.assign(n, 0);
+			for (std::size_t u = 0; u < n; ++u) {
+				result.degree[u] = undirected.offsets[u + 1] - undirected.offsets[u];
+			}
+
+			auto ranks_below = [&result](std::size_t u, std::size_t v) {
+				return result.degree[u] != result.degree[v] ? result.degree[u] < result.degree[v] : u < v;
+			};
+			result.offsets.assign(n + 1, 0);
+			for (std::size_t u = 0; u < n; ++u) {
+				auto kept = std::size_t{0};
+				for (auto v : undirected_neighbours(undirected, u)) {
+					kept += ranks_below(u, v) ? std::size_t{1} : std::size_t{0};
+				}
+				result.offsets[u + 1] = result.offsets[u] + kept;
+			}
+			result.targets.assign(result.offsets.back(), 0);
+			parallel_for(pool, 0, n, 256, [&](std::size_t lo, std::size_t hi, std::size_t) {
+				for (auto u = lo; u < hi; ++u) {
+					auto out = result.offsets[u];
+					for (auto v : undirected_neighbours(undirected, u)) {
+						if (ranks_below(u, v)) {
+							result.targets[out++] = v;
+						}
+					}
+				}
+			});
+			return result;
+		}
+
+		inline std::span<std::size_t const> oriented_neighbours(oriented_graph const& g, std::size_t u) {
+			return {g.targets.data() + g.offsets[u], g.offsets[u + 1] - g.offsets[u]};
+		}
+
+		// Nodes per dynamically scheduled chunk; small because the work per node is very uneven
+		constexpr auto triangle_grain = std::size_t{64};
+	} // namespace detail
+
+	// Triangles of a snapshot, treating it as a simple undirected graph
+	// (edge direction, parallel edges and self loops are ignored)
+	struct triangle_stats {
+		std::size_t triangles = 0; // Number of triangles in the graph
+		std::vector<std::size_t> node_triangles; // Triangles through every node
+		std::vector<double> clustering; // Local clustering coefficient of every node (0 below degree 2)
+		double average_clustering = 0; // Mean of the local clustering coefficients
+	};
+
+	// Count the triangles of a snapshot, treating it as a simple undirected graph
+	template<typename N, typename E>
+	[[nodiscard]] std::size_t triangle_count(csr_graph<N, E> const& g, thread_pool& pool = default_thread_pool()) {
+		auto const oriented = detail::orient_by_degree(g, pool);
+		auto const n = g.node_count();
+		auto partial = std::vector<std::size_t>(pool.size(), 0);
+		parallel_for(pool, 0, n, detail::triangle_grain, [&](std::size_t lo, std::size_t hi, std::size_t w) {
+			auto count = std::size_t{0};
+			for (auto u = lo; u < hi; ++u) {
+				auto const out_u = detail::oriented_neighbours(oriented, u);
+				for (auto v : out_u) {
+					auto const out_v = detail::oriented_neighbours(oriented, v);
+					count += detail::intersect(out_u, out_v, [](std::size_t) {});
+				}
+			}
+			partial[w] += count;
+		});
+		auto total = std::size_t{0};
+		for (auto count : partial) {
+			total += count;
+		}
+		return total;
+	}
+
+	// Count the triangles through every node and compute the local clustering coefficients
+	template<typename N, typename E>
+	[[nodiscard]] triangle_stats triangles(csr_graph<N, E> const& g, thread_pool& pool = default_thread_pool()) {
+		auto const n = g.node_count();
+		auto const oriented = detail::orient_by_degree(g, pool);
+		auto counts = std::make_unique<std::atomic<std::size_t>[]>(n);
+		auto partial = std::vector<std::size_t>(pool.size(), 0);
+		parallel_for(pool, 0, n, detail::triangle_grain, [&](std::size_t lo, std::size_t hi, std::size_t w) {
+			auto count = std::size_t{0};
+			for (auto u = lo; u < hi; ++u) {
+				auto const out_u = detail::oriented_neighbours(oriented, u);
+				auto at_u = std::size_t{0};
+				for (auto v : out_u) {
+					auto const found =
+					    detail::intersect(out_u, detail::oriented_neighbours(oriented, v), [&](std::size_t x) {
+						    counts[x].fetch_add(1, std::memory_order_relaxed);
+					    });
+					if (found != 0) {
+						counts[v].fetch_add(found, std::memory_order_relaxed);
+						at_u += found;
+					}
+				}
+				counts[u].fetch_add(at_u, std::memory_order_relaxed);
+				count += at_u;
+			}
+			partial[w] += count;
+		});
+
+		auto result = triangle_stats{};
+		for (auto count : partial) {
+			result.triangles += count;
+		}
+		result.node_triangles.assign(n, 0);
+		result.clustering.assign(n, 0.0);
+		auto sum = 0.0;
+		for (std::size_t u = 0; u < n; ++u) {
+			result.node_triangles[u] = counts[u].load(std::memory_order_relaxed);
+			auto const degree = static_cast<double>(oriented.degree[u]);
+			if (oriented.degree[u] >= 2) {
+				result.clustering[u] = 2.0 * static_cast<double>(result.node_triangles[u]) / (degree * (degree - 1.0));
+			}
+			sum += result.clustering[u];
+		}
+		result.average_clustering = n == 0 ? 0.0 : sum / static_cast<double>(n);
+		return result;
+	}
+
+	// Compute the local clustering coefficient of every node of a graph, keyed by node value
+	template<typename N, typename E>
+	[[nodiscard]] std::map<N, double> clustering_coefficients(graph<N, E> const& g,
+	                                                          thread_pool& pool = default_thread_pool()) {
+		auto const snapshot = csr_graph<N, E>(g);
+		auto const stats = triangles(snapshot, pool);
+		auto result = std::map<N, double>{};
+		for (std::size_t u = 0; u < snapshot.node_count(); ++u) {
+			result.emplace_hint(result.end(), snapshot.node(u), stats.clustering[u]);
+		}
+		return result;
+	}
+} // namespace gdwg
+
+#endif // GDWG_TRIANGLES_H
@@ -0,0 +1,121 @@
+#include "gdwg_triangles.h"
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <set>
+
+// Sorted set intersection tests
+TEST_CASE("Sorted list intersection kernels", "[triangles]") {
+	auto rng = std::mt19937_64(42);
+	for (auto trial = 0; trial < 200; ++trial) {
+		// Sizes range from balanced (merge path) to very skewed (galloping path)
+		auto const a_size = rng() % 40;
+		auto const b_size = trial % 2 == 0 ? rng() % 40 : rng() % 4000;
+		auto a_set = std::set<std::size_t>{};
+		auto b_set = std::set<std::size_t>{};
+		while (a_set.size() < a_size) {
+			a_set.insert(rng() % 5000);
+		}
+		while (b_set.size() < b_size) {
+			b_set.insert(rng() % 5000);
+		}
+		auto const a = std::vector<std::size_t>(a_set.begin(), a_set.end());
+		auto const b = std::vector<std::size_t>(b_set.begin(), b_set.end());
+
+		auto expected = std::vector<std::size_t>{};
+		std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+		auto found = std::vector<std::size_t>{};
+		auto const count = gdwg::detail::intersect(a, b, [&](std::size_t x) { found.push_back(x); });
+		std::sort(found.begin(), found.end());
+		REQUIRE(count == expected.size());
+		REQUIRE(found == expected);
+	}
+}
+
+// Triangle counting tests
+TEST_CASE("Triangles of a complete graph", "[triangles]") {
+	gdwg::graph<char, int> g;
+	for (auto c : {'a', 'b', 'c', 'd'}) {
+		g.insert_node(c);
+	}
+	// One direction of every pair, plus a reverse edge, a parallel edge and a loop that must be ignored
+	g.insert_edge('a', 'b');
+	g.insert_edge('b', 'a', 3);
+	g.insert_edge('a', 'c', 1);
+	g.insert_edge('a', 'c', 2);
+	g.insert_edge('d', 'a');
+	g.insert_edge('b', 'c');
+	g.insert_edge('c', 'd');
+	g.insert_edge('d', 'b');
+	g.insert_edge('d', 'd');
+
+	auto const csr = gdwg::csr_graph<char, int>(g);
+	REQUIRE(gdwg::triangle_count(csr) == 4);
+
+	auto const stats = gdwg::triangles(csr);
+	REQUIRE(stats.triangles == 4);
+	REQUIRE(stats.node_triangles == std::vector<std::size_t>{3, 3, 3, 3});
+	REQUIRE(stats.average_clustering == Approx(1.0));
+
+	auto const coefficients = gdwg::clustering_coefficients(g);
+	REQUIRE(coefficients.at('a') == Approx(1.0));
+}
+
+TEST_CASE("Clustering coefficients of a star with one chord", "[triangles]") {
+	gdwg::graph<int, int> g;
+	for (auto i = 0; i < 5; ++i) {
+		g.insert_node(i);
+	}
+	for (auto i = 1; i < 5; ++i) {
+		g.insert_edge(0, i);
+	}
+	g.insert_edge(1, 2);
+
+	auto const coefficients = gdwg::clustering_coefficients(g);
+	REQUIRE(coefficients.at(0) == Approx(1.0 / 6.0)); // 1 of the 6 pairs of neighbours is linked
+	REQUIRE(coefficients.at(1) == Approx(1.0));
+	REQUIRE(coefficients.at(3) == Approx(0.0)); // Degree 1
+}
+
+TEST_CASE("Triangle counts match brute force on a random graph", "[triangles]") {
+	auto const n = 120;
+	auto rng = std::mt19937(7);
+	auto adjacent = std::vector<std::vector<bool>>(n, std::vector<bool>(n, false));
+	gdwg::graph<int, int> g;
+	for (auto i = 0; i < n; ++i) {
+		g.insert_node(i);
+	}
+	for (auto e = 0; e < 1500; ++e) {
+		// Skew the endpoints towards low ids so some nodes become hubs
+		auto const u = static_cast<int>(rng() % 2 == 0 ? rng() % static_cast<unsigned>(n) : rng() % 10);
+		auto const v = static_cast<int>(rng() % static_cast<unsigned>(n));
+		if (u != v) {
+			g.insert_edge(u, v, static_cast<int>(rng() % 3));
+			adjacent[static_cast<std::size_t>(u)][static_cast<std::size_t>(v)] = true;
+			adjacent[static_cast<std::size_t>(v)][static_cast<std::size_t>(u)] = true;
+		}
+	}
+
+	auto expected_total = std::size_t{0};
+	auto expected = std::vector<std::size_t>(n, 0);
+	for (std::size_t a = 0; a < n; ++a) {
+		for (auto b = a + 1; b < n; ++b) {
+			for (auto c = b + 1; c < n; ++c) {
+				if (adjacent[a][b] and adjacent[b][c] and adjacent[a][c]) {
+					++expected_total;
+					++expected[a];
+					++expected[b];
+					++expected[c];
+				}
+			}
+		}
+	}
+
+	auto pool = gdwg::thread_pool(4);
+	auto const csr = gdwg::csr_graph<int, int>(g);
+	REQUIRE(gdwg::triangle_count(csr, pool) == expected_total);
+	auto const stats = gdwg::triangles(csr, pool);
+	REQUIRE(stats.triangles == expected_total);
+	REQUIRE(stats.node_triangles == expected);
+}
@@ -0,0 +1,74 @@
+#include "gdwg_bench.h"
+#include "gdwg_wal.h"
+
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+// Durable mutation throughput
+// Usage: gdwg_wal_bench [mutations] [threads] [directory]
+auto main(int argc, char** argv) -> int {
+	auto const mutations = gdwg::bench::argument(argc, argv, 1, 1 << 20);
+	auto const threads = std::max<std::size_t>(1, gdwg::bench::argument(argc, argv, 2, 8));
+	auto const directory = (argc > 3 ? std::string(argv[3]) : std::string("/tmp")) + "/gdwg_wal_bench_"
+	                       + std::to_string(::getpid());
+	auto const nodes = std::size_t{1} << 16;
+
+	// Random edges between a fixed set of nodes, split between the threads
+	auto run = [&](gdwg::wal_sync sync, std::size_t workers, std::size_t count) {
+		std::filesystem::remove_all(directory);
+		auto options = gdwg::durable_options{};
+		options.sync = gdwg::wal_sync::manual;
+		{
+			auto initial = gdwg::durable_graph<int, double>(directory, options);
+			for (std::size_t v = 0; v < nodes; ++v) {
+				initial.insert_node(static_cast<int>(v));
+			}
+			initial.checkpoint();
+		}
+		options.sync = sync;
+		auto g = gdwg::durable_graph<int, double>(directory, options);
+		auto const seconds = gdwg::bench::best_of(1, [&] {
+			auto pool = std::vector<std::thread>{};
+			for (std::size_t t = 0; t < workers; ++t) {
+				pool.emplace_back([&, t] {
+					auto rng = std::mt19937_64(t);
+					for (auto i = t; i < count; i += workers) {
+						g.insert_edge(static_cast<int>(rng() % nodes),
+						              static_cast<int>(rng() % nodes),
+						              static_cast<double>(rng() % 1000) / 10);
+					}
+				});
+			}
+			for (auto& thread : pool) {
+				thread.join();
+			}
+			g.sync();
+		});
+		auto const bytes = static_cast<double>(g.log_size());
+		return std::make_pair(seconds, bytes);
+	};
+
+	auto report = [&](std::string const& name, gdwg::wal_sync sync, std::size_t workers, std::size_t count) {
+		auto const [seconds, bytes] = run(sync, workers, count);
+		gdwg::bench::report(std::cout,
+		                    name,
+		                    {{"mutations", static_cast<double>(count)},
+		                     {"threads", static_cast<double>(workers)},
+		                     {"nodes", static_cast<double>(nodes)}},
+		                    seconds,
+		                    {{"mutations_per_second", static_cast<double>(count) / seconds},
+		                     {"log_bytes_per_mutation", bytes / static_cast<double>(count)}});
+	};
+
+	// Buffered records with one fsync at the end, then an fsync before every mutation returns, shared between
+	// concurrent callers by group commit
+	report("wal_manual_sync", gdwg::wal_sync::manual, 1, mutations);
+	report("wal_group_commit", gdwg::wal_sync::group, 1, std::min<std::size_t>(mutations, 2000));
+	report("wal_group_commit", gdwg::wal_sync::group, threads, std::min<std::size_t>(mutations, 2000 * threads));
+	std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,761 @@
+#ifndef GDWG_WAL_H
+#define GDWG_WAL_H
+
+#include "gdwg_binary.h"
+#include "gdwg_checkpoint.h"
+#include "gdwg_graph.h"
+#include "gdwg_mapped_file.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Crash-safe persistence for a graph held in memory
+// A durable_graph keeps its graph in a directory of numbered checkpoints and a log:
+//   snapshot.<g>   the whole graph as of checkpoint g, in the binary graph format (see gdwg_binary.h)
+//   delta.<g>      the adjacency lists that changed between checkpoints g - 1 and g (see gdwg_checkpoint.h)
+//   wal            every mutation since the last checkpoint, as compact binary records appended to a write-ahead log
+// Mutations are applied to the graph and then logged; calls that throw or change nothing are not logged. The nodes
+// whose adjacency lists a mutation changes are marked dirty, and checkpoint() writes only their lists as a delta
+// segment before starting an empty log, so its I/O follows the churn rather than the size of the graph. Once
+// enough delta segments pile up, a background thread compacts them and the snapshot into a new snapshot.
+// Opening the directory loads the newest snapshot, applies the delta segments after it and replays the log,
+// dropping a torn record at the end of the log left by a crash. Every file appears through a rename and the log
+// names the checkpoint it follows, so a crash between writing a checkpoint and starting the new log leaves a stale
+// log that is ignored, never replayed twice. Unlike gdwg::graph, replace_node and merge_replace_node drop the edges
+// into the old value instead of leaving them to come back with it, so the graph in memory is always the graph its
+// checkpoints store.
+// Node and weight types must be trivially copyable or std::string
+namespace gdwg {
+	// When logged mutations reach the disk
+	enum class wal_sync {
+		group, // A mutation returns once its record is fsynced; concurrent mutations share one fsync
+		manual, // A mutation returns at once; records are written when the buffer fills and fsynced by sync()
+	};
+
+	struct durable_options {
+		wal_sync sync = wal_sync::group;
+		std::size_t buffer_size = std::size_t{1} << 20; // Bytes of records buffered before a write in manual mode
+		std::size_t compact_after = 8; // Delta segments that start a background compaction, 0 for compact() only
+	};
+
+	namespace detail {
+		inline constexpr auto wal_magic = std::array<char, 8>{'G', 'D', 'W', 'G', 'W', 'A', 'L', '\0'};
+		inline constexpr auto wal_version = std::uint32_t{1};
+
+		struct wal_header {
+			std::array<char, 8> magic;
+			std::uint64_t endian; // binary_endian as written
+			std::uint32_t version;
+			std::uint32_t flags; // Reserved, 0
+			binary_kind node_kind;
+			std::uint32_t node_size;
+			binary_kind weight_kind;
+			std::uint32_t weight_size;
+			std::uint64_t generation; // Checkpoint the log follows, 0 before the first
+			std::uint64_t header_checksum; // Of the header with this field zero
+		};
+
+		// Every record is a u32 payload size, the u32 checksum of the payload, and the payload: the operation
+		// followed by its operands
+		enum class wal_operation : std::uint8_t {
+			insert_node = 1,
+			insert_edge,
+			replace_node,
+			merge_replace_node,
+			erase_node,
+			erase_edge,
+			clear,
+		};
+
+		inline constexpr auto wal_frame_size = 2 * sizeof(std::uint32_t);
+
+		inline std::uint32_t wal_checksum(void const* data, std::size_t size) {
+			auto sum = checksum64{};
+			sum.update(data, size);
+			auto const value = sum.value();
+			return static_cast<std::uint32_t>(value ^ (value >> 32));
+		}
+
+		inline std::uint64_t wal_header_checksum(wal_header header) {
+			header.header_checksum = 0;
+			auto sum = checksum64{};
+			sum.update(&header, sizeof(header));
+			return sum.value();
+		}
+
+		template<typename N, typename E>
+		wal_header make_wal_header(std::uint64_t generation) {
+			auto header = wal_header{};
+			header.magic = wal_magic;
+			header.endian = binary_endian;
+			header.version = wal_version;
+			header.node_kind = binary_codec<N>::kind;
+			header.node_size = binary_codec<N>::size;
+			header.weight_kind = binary_codec<E>::kind;
+			header.weight_size = binary_codec<E>::size;
+			header.generation = generation;
+			header.header_checksum = wal_header_checksum(header);
+			return header;
+		}
+	} // namespace detail
+
+	template<typename N, typename E>
+	class durable_graph {
+	 public:
+		// Open the graph stored in directory, creating the directory and an empty graph if it does not exist
+		explicit durable_graph(std::string directory, durable_options const& options = {})
+		: directory_(std::move(directory))
+		, options_(options) {
+			std::filesystem::create_directories(directory_);
+			load_checkpoints();
+			if (!std::filesystem::exists(log_path()) or !replay()) {
+				start_log();
+			}
+			log_ = detail::append_file(log_path());
+		}
+
+		durable_graph(durable_graph const&) = delete;
+		durable_graph& operator=(durable_graph const&) = delete;
+
+		// Buffered records are written and fsynced, and a running compaction is waited for; errors are ignored,
+		// as they would be lost by a crash anyway
+		~durable_graph() {
+			try {
+				sync();
+			} catch (std::exception const&) {
+			}
+			std::unique_lock<std::mutex> lock(mutex_);
+			compacted_.wait(lock, [this] { return !compacting_; });
+			lock.unlock();
+			if (compactor_.joinable()) {
+				compactor_.join();
+			}
+		}
+
+		// The mutations of gdwg::graph, with the same results and errors
+		bool insert_node(N const& value) {
+			return mutate([&] { return change_insert_node(value); },
+			              [&](std::string& out) { encode(out, detail::wal_operation::insert_node, value); });
+		}
+
+		bool insert_edge(N const& src, N const& dst, std::optional<E> weight = std::nullopt) {
+			return mutate([&] { return change_insert_edge(src, dst, weight); },
+			              [&](std::string& out) { encode(out, detail::wal_operation::insert_edge, src, dst, weight); });
+		}
+
+		bool replace_node(N const& old_data, N const& new_data) {
+			return mutate([&] { return change_replace_node(old_data, new_data); },
+			              [&](std::string& out) {
+				              encode(out, detail::wal_operation::replace_node, old_data, new_data);
+			              });
+		}
+
+		void merge_replace_node(N const& old_data, N const& new_data) {
+			mutate([&] { return change_merge_replace_node(old_data, new_data); },
+			       [&](std::string& out) {
+				       encode(out, detail::wal_operation::merge_replace_node, old_data, new_data);
+			       });
+		}
+
+		bool erase_node(N const& value) {
+			return mutate([&] { return change_erase_node(value); },
+			              [&](std::string& out) { encode(out, detail::wal_operation::erase_node, value); });
+		}
+
+		bool erase_edge(N const& src, N const& dst, std::optional<E> weight = std::nullopt) {
+			return mutate([&] { return change_erase_edge(src, dst, weight); },
+			              [&](std::string& out) { encode(out, detail::wal_operation::erase_edge, src, dst, weight); });
+		}
+
+		void clear() {
+			mutate([&] { return change_clear(); },
+			       [&](std::string& out) { encode(out, detail::wal_operation::clear); });
+		}
+
+		// Call fn(graph const&) with mutations held off, returning its result
+		template<typename F>
+		decltype(auto) read(F&& fn) const {
+			std::lock_guard<std::mutex> lock(mutex_);
+			return std::forward<F>(fn)(std::as_const(graph_));
+		}
+
+		// Write and fsync every logged mutation
+		void sync() {
+			std::unique_lock<std::mutex> lock(mutex_);
+			wait_durable(lock, logged_);
+		}
+
+		// Write the adjacency lists changed since the last checkpoint as a delta segment, or the whole graph as a
+		// snapshot if there is none yet or the graph was cleared, and empty the log; mutations wait until it is done
+		void checkpoint() {
+			std::unique_lock<std::mutex> lock(mutex_);
+			wait_idle(lock);
+			if (dirty_.empty() and !full_) {
+				return;
+			}
+			auto const next = generation_ + 1;
+			if (base_ == 0 or full_) {
+				auto const temporary = snapshot_path(next) + ".tmp";
+				save_binary(graph_, temporary);
+				detail::sync_path(temporary);
+				std::filesystem::rename(temporary, snapshot_path(next));
+				detail::sync_path(directory_);
+				base_ = next;
+				deltas_.clear();
+			}
+			else {
+				detail::write_delta<N, E>(delta_path(next), directory_, next, dirty_rows());
+				deltas_.push_back(next);
+			}
+			generation_ = next;
+			dirty_.clear();
+			full_ = false;
+			// Until the new log replaces the old one, the old one names the previous checkpoint and is ignored
+			start_log();
+			log_ = detail::append_file(log_path());
+			buffer_.clear();
+			durable_ = logged_;
+			written_.notify_all();
+			remove_obsolete();
+			if (options_.compact_after > 0 and deltas_.size() >= options_.compact_after and !compacting_) {
+				start_compaction();
+			}
+		}
+
+		// Merge every delta segment into a new snapshot now, waiting for it; throws if this or an earlier
+		// background compaction failed (the segments are then kept, so nothing is lost)
+		void compact() {
+			std::unique_lock<std::mutex> lock(mutex_);
+			compacted_.wait(lock, [this] { return !compacting_; });
+			if (!deltas_.empty()) {
+				start_compaction();
+				compacted_.wait(lock, [this] { return !compacting_; });
+			}
+			if (auto error = std::exchange(compaction_error_, std::nullopt)) {
+				throw std::runtime_error("Cannot call gdwg::durable_graph::compact: " + *error);
+			}
+		}
+
+		// Delta segments written since the snapshot they apply to
+		[[nodiscard]] std::size_t delta_segments() const {
+			std::lock_guard<std::mutex> lock(mutex_);
+			return deltas_.size();
+		}
+
+		// Bytes in the log, including records not yet written
+		[[nodiscard]] std::uint64_t log_size() const {
+			std::lock_guard<std::mutex> lock(mutex_);
+			return log_size_;
+		}
+
+		[[nodiscard]] std::string const& directory() const noexcept {
+			return directory_;
+		}
+
+	 private:
+		[[nodiscard]] std::string snapshot_path(std::uint64_t generation) const {
+			return directory_ + "/snapshot." + std::to_string(generation);
+		}
+
+		[[nodiscard]] std::string delta_path(std::uint64_t generation) const {
+			return directory_ + "/delta." + std::to_string(generation);
+		}
+
+		[[nodiscard]] std::string log_path() const {
+			return directory_ + "/wal";
+		}
+
+		[[nodiscard]] std::runtime_error open_error(std::string const& reason) const {
+			return std::runtime_error("Cannot open gdwg::durable_graph " + directory_ + ": " + reason);
+		}
+
+		// The generation in a file name of the form prefix.<generation>
+		static std::optional<std::uint64_t> generation_of(std::string_view name, std::string_view prefix) {
+			if (name.size() <= prefix.size() or name.substr(0, prefix.size()) != prefix) {
+				return std::nullopt;
+			}
+			auto generation = std::uint64_t{0};
+			auto const* const end = name.data() + name.size();
+			auto const [last, error] = std::from_chars(name.data() + prefix.size(), end, generation);
+			return error == std::errc{} and last == end ? std::optional<std::uint64_t>(generation) : std::nullopt;
+		}
+
+		// Load the newest snapshot and apply the delta segments after it, clearing away files a crash left behind
+		void load_checkpoints() {
+			auto snapshots = std::vector<std::uint64_t>{};
+			auto deltas = std::vector<std::uint64_t>{};
+			for (auto const& entry : std::filesystem::directory_iterator(directory_)) {
+				auto const name = entry.path().filename().string();
+				if (name.ends_with(".tmp")) {
+					std::filesystem::remove(entry.path());
+				}
+				else if (auto const snapshot = generation_of(name, "snapshot.")) {
+					snapshots.push_back(*snapshot);
+				}
+				else if (auto const delta = generation_of(name, "delta.")) {
+					deltas.push_back(*delta);
+				}
+			}
+			base_ = snapshots.empty() ? 0 : *std::max_element(snapshots.begin(), snapshots.end());
+			generation_ = base_;
+			if (base_ != 0) {
+				graph_ = mmap_graph<N, E>(snapshot_path(base_), true).to_graph();
+			}
+
+			std::sort(deltas.begin(), deltas.end());
+			auto removed = std::set<N>{}; // Nodes the segments erased, whose incoming edges are dropped at the end
+			for (auto const delta : deltas) {
+				if (delta <= base_) {
+					continue; // Already compacted into the snapshot
+				}
+				if (delta != generation_ + 1) {
+					throw open_error("delta segment " + std::to_string(generation_ + 1) + " is missing");
+				}
+				for (auto& [node, row] : detail::read_delta<N, E>(delta_path(delta))) {
+					if (row) {
+						graph_.nodes_.insert(node);
+						graph_.adj_list_.insert_or_assign(node, std::move(*row));
+						removed.erase(node);
+					}
+					else {
+						graph_.nodes_.erase(node);
+						graph_.adj_list_.erase(node);
+						removed.insert(node);
+					}
+				}
+				deltas_.push_back(delta);
+				generation_ = delta;
+			}
+			if (!removed.empty()) {
+				for (auto& [src, row] : graph_.adj_list_) {
+					std::erase_if(row, [&removed](auto const& edge) { return removed.contains(edge.first); });
+				}
+			}
+			remove_obsolete();
+		}
+
+		// Remove snapshots and delta segments older than the current snapshot, unless a compaction is reading them
+		void remove_obsolete() {
+			if (compacting_) {
+				return;
+			}
+			for (auto const& entry : std::filesystem::directory_iterator(directory_)) {
+				auto const name = entry.path().filename().string();
+				auto const snapshot = generation_of(name, "snapshot.");
+				auto const delta = generation_of(name, "delta.");
+				if ((snapshot and *snapshot < base_) or (delta and *delta <= base_)) {
+					auto error = std::error_code{};
+					std::filesystem::remove(entry.path(), error);
+				}
+			}
+		}
+
+		// Merge the snapshot and every delta segment into a new snapshot on a background thread, which only reads
+		// files that never change; called with the lock held
+		void start_compaction() {
+			if (compactor_.joinable()) {
+				compactor_.join(); // Finished, as compacting_ is false
+			}
+			compacting_ = true;
+			auto const base = snapshot_path(base_);
+			auto const target = deltas_.back();
+			auto inputs = std::vector<std::string>{};
+			for (auto const delta : deltas_) {
+				inputs.push_back(delta_path(delta));
+			}
+			compactor_ = std::thread([this, base, target, inputs = std::move(inputs)] {
+				auto error = std::optional<std::string>{};
+				try {
+					auto const temporary = snapshot_path(target) + ".tmp";
+					detail::compact_segments<N, E>(base, inputs, temporary);
+					detail::sync_path(temporary);
+					std::filesystem::rename(temporary, snapshot_path(target));
+					detail::sync_path(directory_);
+				} catch (std::exception const& e) {
+					error = e.what();
+				}
+				std::lock_guard<std::mutex> lock(mutex_);
+				if (!error and target > base_) {
+					base_ = target;
+					std::erase_if(deltas_, [target](std::uint64_t delta) { return delta <= target; });
+				}
+				compaction_error_ = error;
+				compacting_ = false;
+				remove_obsolete();
+				compacted_.notify_all();
+			});
+		}
+
+		// Each node whose adjacency list changed: its row as a snapshot would store it, or nothing if it is gone
+		[[nodiscard]] detail::delta_rows<N, E> dirty_rows() const {
+			auto rows = detail::delta_rows<N, E>{};
+			for (auto const& node : dirty_) {
+				auto& row = rows.emplace_hint(rows.end(), node, std::nullopt)->second;
+				if (!graph_.is_node(node)) {
+					continue;
+				}
+				row.emplace();
+				if (auto const it = graph_.adj_list_.find(node); it != graph_.adj_list_.end()) {
+					std::copy_if(it->second.begin(),
+					             it->second.end(),
+					             std::back_inserter(*row),
+					             [this](auto const& edge) { return graph_.is_node(edge.first); });
+				}
+				std::sort(row->begin(), row->end());
+			}
+			return rows;
+		}
+
+		// Drop the edges into a value that is no longer a node, marking the lists they leave. gdwg::graph drops them
+		// in erase_node but leaves them dangling in replace_node and merge_replace_node, where they would come back
+		// with the value; checkpoints never store them, so the graph in memory does not keep them either
+		void drop_edges_to(N const& value) {
+			for (auto& [src, row] : graph_.adj_list_) {
+				auto const end =
+				   std::remove_if(row.begin(), row.end(), [&value](auto const& edge) { return edge.first == value; });
+				if (end != row.end()) {
+					row.erase(end, row.end());
+					dirty_.insert(src);
+				}
+			}
+		}
+
+		// The mutations, applied to the graph and marking the nodes whose adjacency lists they change
+		bool change_insert_node(N const& value) {
+			if (!graph_.insert_node(value)) {
+				return false;
+			}
+			dirty_.insert(value);
+			return true;
+		}
+
+		bool change_insert_edge(N const& src, N const& dst, std::optional<E> const& weight) {
+			if (!graph_.insert_edge(src, dst, weight)) {
+				return false;
+			}
+			dirty_.insert(src);
+			return true;
+		}
+
+		bool change_replace_node(N const& old_data, N const& new_data) {
+			if (!graph_.replace_node(old_data, new_data)) {
+				return false;
+			}
+			drop_edges_to(old_data);
+			if (auto const it = graph_.adj_list_.find(old_data); it != graph_.adj_list_.end()) {
+				it->second.clear(); // replace_node keeps the old list, which must not come back either
+			}
+			dirty_.insert(old_data);
+			dirty_.insert(new_data);
+			return true;
+		}
+
+		bool change_merge_replace_node(N const& old_data, N const& new_data) {
+			graph_.merge_replace_node(old_data, new_data);
+			drop_edges_to(old_data);
+			dirty_.insert(old_data);
+			dirty_.insert(new_data);
+			return true;
+		}
+
+		bool change_erase_node(N const& value) {
+			if (!graph_.is_node(value)) {
+				return false;
+			}
+			drop_edges_to(value);
+			dirty_.insert(value);
+			return graph_.erase_node(value);
+		}
+
+		bool change_erase_edge(N const& src, N const& dst, std::optional<E> const& weight) {
+			if (!graph_.erase_edge(src, dst, weight)) {
+				return false;
+			}
+			dirty_.insert(src);
+			return true;
+		}
+
+		// The next checkpoint writes a whole snapshot instead of marking every node
+		bool change_clear() {
+			graph_.clear();
+			dirty_.clear();
+			full_ = true;
+			return true;
+		}
+
+		// Start an empty log that follows the current checkpoint
+		void start_log() {
+			auto const header = detail::make_wal_header<N, E>(generation_);
+			auto const bytes = std::string_view(reinterpret_cast<char const*>(&header), sizeof(header));
+			detail::replace_file(log_path(), bytes, directory_);
+			log_size_ = sizeof(header);
+		}
+
+		// Replay the log onto the checkpoints, cutting off a torn or corrupt tail; returns false if the log follows
+		// an earlier checkpoint and has to be started again
+		bool replay() {
+			auto const file = detail::mapped_file(log_path());
+			auto header = detail::wal_header{};
+			if (file.size() < sizeof(header)) {
+				return false; // A crash while the log was started
+			}
+			std::memcpy(&header, file.data(), sizeof(header));
+			if (header.magic != detail::wal_magic) {
+				throw open_error("the log is not a graph log");
+			}
+			if (header.endian != detail::binary_endian) {
+				throw open_error("the log was written with another byte order");
+			}
+			if (header.version != detail::wal_version) {
+				throw open_error("unsupported log version " + std::to_string(header.version));
+			}
+			if (header.header_checksum != detail::wal_header_checksum(header)) {
+				throw open_error("the log is corrupt");
+			}
+			auto const expected = detail::make_wal_header<N, E>(header.generation);
+			if (header.node_kind != expected.node_kind or header.node_size != expected.node_size
+			    or header.weight_kind != expected.weight_kind or header.weight_size != expected.weight_size)
+			{
+				throw open_error("node or weight type mismatch");
+			}
+			if (header.generation > generation_) {
+				throw open_error("the log follows checkpoint " + std::to_string(header.generation)
+				                 + ", which is missing");
+			}
+			if (header.generation < generation_) {
+				return false;
+			}
+
+			auto const bytes = std::string_view(reinterpret_cast<char const*>(file.data()), file.size());
+			auto end = sizeof(header);
+			while (bytes.size() - end >= detail::wal_frame_size) {
+				auto frame = std::array<std::uint32_t, 2>{};
+				std::memcpy(frame.data(), bytes.data() + end, sizeof(frame));
+				if (frame[0] > bytes.size() - end - sizeof(frame)) {
+					break;
+				}
+				auto const payload = bytes.substr(end + sizeof(frame), frame[0]);
+				if (frame[1] != detail::wal_checksum(payload.data(), payload.size()) or !apply(payload)) {
+					break;
+				}
+				end += sizeof(frame) + frame[0];
+			}
+			if (end != bytes.size()) {
+				std::filesystem::resize_file(log_path(), end);
+				detail::sync_path(log_path());
+			}
+			log_size_ = end;
+			return true;
+		}
+
+		// Apply one record's payload to the graph, returning false if it does not decode
+		bool apply(std::string_view payload) {
+			auto operation = detail::wal_operation{};
+			auto src = N{};
+			auto dst = N{};
+			if (!detail::read_operand(payload, operation)) {
+				return false;
+			}
+			auto const edge = [&] {
+				auto weighted = false;
+				auto weight = std::optional<E>{};
+				if (!detail::read_operand(payload, src) or !detail::read_operand(payload, dst)
+				    or !detail::read_operand(payload, weighted)) {
+					return std::optional<std::optional<E>>{};
+				}
+				if (weighted and !detail::read_operand(payload, weight.emplace())) {
+					return std::optional<std::optional<E>>{};
+				}
+				return std::optional<std::optional<E>>(std::move(weight));
+			};
+			switch (operation) {
+			case detail::wal_operation::insert_node:
+				if (!detail::read_operand(payload, src)) {
+					return false;
+				}
+				change_insert_node(src);
+				break;
+			case detail::wal_operation::erase_node:
+				if (!detail::read_operand(payload, src)) {
+					return false;
+				}
+				change_erase_node(src);
+				break;
+			case detail::wal_operation::replace_node:
+			case detail::wal_operation::merge_replace_node:
+				if (!detail::read_operand(payload, src) or !detail::read_operand(payload, dst)) {
+					return false;
+				}
+				if (operation == detail::wal_operation::replace_node) {
+					change_replace_node(src, dst);
+				}
+				else {
+					change_merge_replace_node(src, dst);
+				}
+				break;
+			case detail::wal_operation::insert_edge:
+			case detail::wal_operation::erase_edge:
+				if (auto weight = edge()) {
+					if (operation == detail::wal_operation::insert_edge) {
+						change_insert_edge(src, dst, *weight);
+					}
+					else {
+						change_erase_edge(src, dst, *weight);
+					}
+					break;
+				}
+				return false;
+			case detail::wal_operation::clear: change_clear(); break;
+			default: return false;
+			}
+			return payload.empty();
+		}
+
+		// Append one framed record to out
+		template<typename... Operands>
+		static void encode(std::string& out, detail::wal_operation operation, Operands const&... operands) {
+			auto const start = out.size();
+			out.resize(start + detail::wal_frame_size);
+			detail::append_operand(out, operation);
+			(append(out, operands), ...);
+			auto const size = out.size() - start - detail::wal_frame_size;
+			auto const frame = std::array<std::uint32_t, 2>{
+			    static_cast<std::uint32_t>(size),
+			    detail::wal_checksum(out.data() + start + detail::wal_frame_size, size)};
+			std::memcpy(out.data() + start, frame.data(), sizeof(frame));
+		}
+
+		template<typename T>
+		static void append(std::string& out, T const& value) {
+			detail::append_operand(out, value);
+		}
+
+		static void append(std::string& out, std::optional<E> const& weight) {
+			detail::append_operand(out, weight.has_value());
+			if (weight) {
+				detail::append_operand(out, *weight);
+			}
+		}
+
+		// Apply a mutation and log it if it changed the graph, then wait as the sync mode asks
+		template<typename Change, typename Encode>
+		bool mutate(Change change, Encode record) {
+			std::unique_lock<std::mutex> lock(mutex_);
+			if (failure_) {
+				throw std::runtime_error(*failure_);
+			}
+			auto const changed = change();
+			if (!changed) {
+				return changed;
+			}
+			auto const before = buffer_.size();
+			record(buffer_);
+			log_size_ += buffer_.size() - before;
+			++logged_;
+			if (options_.sync == wal_sync::group) {
+				wait_durable(lock, logged_);
+			}
+			else if (buffer_.size() >= options_.buffer_size and !writing_) {
+				write(lock, false);
+			}
+			return changed;
+		}
+
+		// Wait until the record numbered record is on disk; the first waiter writes and fsyncs everything buffered
+		// while the others wait, so records buffered during one fsync all go out with the next
+		void wait_durable(std::unique_lock<std::mutex>& lock, std::uint64_t record) {
+			while (durable_ < record) {
+				if (writing_) {
+					written_.wait(lock);
+				}
+				else {
+					write(lock, true);
+				}
+			}
+		}
+
+		void wait_idle(std::unique_lock<std::mutex>& lock) {
+			written_.wait(lock, [this] { return !writing_; });
+			if (failure_) {
+				throw std::runtime_error(*failure_);
+			}
+		}
+
+		// Write the buffer, and fsync the log if sync is set; the lock is released meanwhile so that other
+		// mutations can fill the next buffer
+		void write(std::unique_lock<std::mutex>& lock, bool sync) {
+			if (failure_) {
+				throw std::runtime_error(*failure_);
+			}
+			writing_ = true;
+			auto batch = std::exchange(buffer_, std::move(spare_));
+			auto const last = logged_;
+			lock.unlock();
+			auto error = std::optional<std::string>{};
+			try {
+				log_.write(batch.data(), batch.size());
+				if (sync) {
+					log_.sync();
+				}
+			} catch (std::runtime_error const& e) {
+				error = e.what();
+			}
+			lock.lock();
+			batch.clear();
+			spare_ = std::move(batch);
+			writing_ = false;
+			if (error) {
+				// Records in the failed batch may or may not be on disk, so nothing more can be logged safely
+				failure_ = "Cannot call gdwg::durable_graph: " + *error;
+			}
+			else if (sync) {
+				durable_ = last;
+			}
+			written_.notify_all();
+			if (failure_) {
+				throw std::runtime_error(*failure_);
+			}
+		}
+
+		std::string directory_;
+		durable_options options_;
+		mutable std::mutex mutex_; // Guards everything below
+		std::condition_variable written_; // Signalled when a write finishes
+		std::condition_variable compacted_; // Signalled when a compaction finishes
+		graph<N, E> graph_;
+		detail::append_file log_;
+		std::string buffer_; // Records not yet written
+		std::string spare_; // The previous buffer, kept for its capacity
+		std::uint64_t log_size_ = 0;
+		std::uint64_t logged_ = 0; // Records logged since opening
+		std::uint64_t durable_ = 0; // Records known to be on disk
+		bool writing_ = false;
+		std::optional<std::string> failure_;
+		std::set<N> dirty_; // Nodes whose adjacency lists changed since the last checkpoint
+		bool full_ = false; // The graph was cleared, so the next checkpoint is a whole snapshot
+		std::uint64_t generation_ = 0; // The last checkpoint, 0 before the first
+		std::uint64_t base_ = 0; // The checkpoint of the current snapshot, 0 if there is none
+		std::vector<std::uint64_t> deltas_; // Checkpoints of the delta segments after it
+		std::thread compactor_;
+		bool compacting_ = false;
+		std::optional<std::string> compaction_error_;
+	};
+} // namespace gdwg
+
+#endif // GDWG_WAL_H
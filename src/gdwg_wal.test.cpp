@@ -0,0 +1,195 @@
+#include "gdwg_testing.h"
+#include "gdwg_wal.h"
+
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace {
+	using gdwg::testing::print;
+	using gdwg::testing::scratch_directory;
+
+	template<typename N, typename E>
+	std::string print(gdwg::durable_graph<N, E> const& g) {
+		return g.read([](gdwg::graph<N, E> const& inner) { return print(inner); });
+	}
+
+	// Snapshots leave out the empty adjacency lists that replace_node keeps for the old value, which operator<<
+	// prints, so graphs that went through a checkpoint are compared by their CSR snapshots
+	template<typename N, typename E>
+	bool same_graph(gdwg::durable_graph<N, E> const& lhs, gdwg::graph<N, E> const& rhs) {
+		auto const a = lhs.read([](gdwg::graph<N, E> const& inner) { return gdwg::csr_graph<N, E>(inner); });
+		auto const b = gdwg::csr_graph<N, E>(rhs);
+		return a.nodes() == b.nodes() and a.offsets() == b.offsets() and a.targets() == b.targets()
+		       and a.edge_weights() == b.edge_weights();
+	}
+
+	// Every kind of mutation, applied to a graph or a durable_graph alike
+	template<typename Graph>
+	void mutate(Graph& g) {
+		for (auto v : {1, 2, 3, 4, 5, 6}) {
+			g.insert_node(v);
+		}
+		g.insert_edge(1, 2, 3);
+		g.insert_edge(1, 2);
+		g.insert_edge(2, 3, -1);
+		g.insert_edge(3, 1, 7);
+		g.insert_edge(4, 5, 2);
+		g.insert_edge(4, 5, 2);
+		g.erase_edge(1, 2);
+		g.replace_node(6, 60);
+		g.merge_replace_node(4, 5);
+		g.erase_node(3);
+		g.insert_edge(5, 1, 9);
+		g.insert_edge(60, 60);
+	}
+} // namespace
+
+// Write-ahead log tests
+TEST_CASE("Mutations survive reopening through the log and through checkpoints", "[wal]") {
+	auto const scratch = scratch_directory("wal_reopen");
+	auto expected = gdwg::graph<int, int>{};
+	mutate(expected);
+
+	{
+		auto g = gdwg::durable_graph<int, int>(scratch.path());
+		mutate(g);
+		REQUIRE(print(g) == print(expected));
+		REQUIRE_FALSE(g.insert_node(1)); // Unchanged, so not logged
+		REQUIRE_THROWS_WITH(g.insert_edge(1, 99), "Cannot call gdwg::graph<N, E>::insert_edge when either src or dst "
+		                                          "node does not exist");
+	}
+	{
+		auto g = gdwg::durable_graph<int, int>(scratch.path());
+		REQUIRE(print(g) == print(expected));
+		g.checkpoint();
+		REQUIRE(g.log_size() == sizeof(gdwg::detail::wal_header));
+		REQUIRE(std::filesystem::file_size(scratch.file("wal")) == sizeof(gdwg::detail::wal_header));
+		g.insert_node(7);
+		expected.insert_node(7);
+		g.insert_edge(7, 1, 1);
+		expected.insert_edge(7, 1, 1);
+	}
+	{
+		auto g = gdwg::durable_graph<int, int>(scratch.path());
+		REQUIRE(same_graph(g, expected));
+		g.clear();
+	}
+	auto const cleared = gdwg::durable_graph<int, int>(scratch.path());
+	REQUIRE(cleared.read([](auto const& inner) { return inner.empty(); }));
+}
+
+TEST_CASE("Torn records at the end of the log are dropped", "[wal]") {
+	auto const scratch = scratch_directory("wal_torn");
+	auto options = gdwg::durable_options{};
+	options.sync = gdwg::wal_sync::manual;
+	{
+		auto g = gdwg::durable_graph<int, int>(scratch.path(), options);
+		g.insert_node(1);
+		g.insert_node(2);
+		g.insert_edge(1, 2, 5);
+	}
+	auto const size = std::filesystem::file_size(scratch.file("wal"));
+	auto edge_kept = false;
+
+	SECTION("A partly written record") {
+		std::filesystem::resize_file(scratch.file("wal"), size - 1);
+	}
+	SECTION("A record with a bad checksum") {
+		auto file = std::fstream(scratch.file("wal"), std::ios::binary | std::ios::in | std::ios::out);
+		file.seekp(static_cast<std::streamoff>(size - 1));
+		file.put('\x7f');
+	}
+	SECTION("Garbage after the last record") {
+		auto file = std::ofstream(scratch.file("wal"), std::ios::binary | std::ios::app);
+		file << std::string("\x05\x00\x00\x00garbage", 11);
+		edge_kept = true;
+	}
+
+	{
+		auto g = gdwg::durable_graph<int, int>(scratch.path(), options);
+		REQUIRE(g.read([](auto const& inner) { return inner.node_count(); }) == 2);
+		REQUIRE(g.read([](auto const& inner) { return inner.is_connected(1, 2); }) == edge_kept);
+		REQUIRE(std::filesystem::file_size(scratch.file("wal")) == g.log_size());
+		REQUIRE((g.log_size() == size) == edge_kept);
+		// Appends continue after the last good record
+		g.insert_node(3);
+	}
+	auto const reopened = gdwg::durable_graph<int, int>(scratch.path(), options);
+	REQUIRE(reopened.read([](auto const& inner) { return inner.is_node(3); }));
+}
+
+TEST_CASE("A log left behind by a crash during a checkpoint is not replayed twice", "[wal]") {
+	auto const scratch = scratch_directory("wal_checkpoint_crash");
+	auto const stale = scratch.file("stale");
+	{
+		auto g = gdwg::durable_graph<int, int>(scratch.path());
+		g.insert_node(1);
+		g.insert_node(2);
+		g.merge_replace_node(1, 2); // Replaying this onto the checkpoint would throw, as 1 is gone
+		g.insert_node(3);
+		std::filesystem::copy_file(scratch.file("wal"), stale);
+		g.checkpoint();
+	}
+	// The crash happened after the snapshot was replaced but before the log was
+	std::filesystem::rename(stale, scratch.file("wal"));
+	auto g = gdwg::durable_graph<int, int>(scratch.path());
+	REQUIRE(g.read([](auto inner) { return inner.nodes(); }) == std::vector<int>{2, 3});
+	REQUIRE(g.log_size() == sizeof(gdwg::detail::wal_header));
+}
+
+TEST_CASE("Group commit and manual syncing from several threads", "[wal]") {
+	auto const mode = GENERATE(gdwg::wal_sync::group, gdwg::wal_sync::manual);
+	auto const scratch = scratch_directory("wal_threads");
+	auto options = gdwg::durable_options{};
+	options.sync = mode;
+	options.buffer_size = 64; // Several writes in manual mode
+	{
+		auto g = gdwg::durable_graph<int, double>(scratch.path(), options);
+		for (auto v = 0; v < 100; ++v) {
+			g.insert_node(v);
+		}
+		auto threads = std::vector<std::thread>{};
+		for (auto t = 0; t < 4; ++t) {
+			threads.emplace_back([&g, t] {
+				for (auto i = 0; i < 100; ++i) {
+					g.insert_edge(t, i, static_cast<double>(i) / 2);
+				}
+			});
+		}
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		g.sync();
+	}
+	auto const g = gdwg::durable_graph<int, double>(scratch.path(), options);
+	for (auto t = 0; t < 4; ++t) {
+		REQUIRE(g.read([t](auto const& inner) { return inner.connections(t).size(); }) == 100);
+	}
+}
+
+TEST_CASE("String graphs and mismatched types", "[wal]") {
+	auto const scratch = scratch_directory("wal_strings");
+	{
+		auto g = gdwg::durable_graph<std::string, int>(scratch.path());
+		g.insert_node("alpha");
+		g.insert_node(std::string(1000, 'b'));
+		g.insert_edge("alpha", std::string(1000, 'b'), 4);
+		g.checkpoint();
+		g.replace_node("alpha", "");
+		g.insert_edge("", "", 1);
+	}
+	auto g = gdwg::durable_graph<std::string, int>(scratch.path());
+	REQUIRE(g.read([](auto inner) { return inner.nodes(); })
+	        == std::vector<std::string>{"", std::string(1000, 'b')});
+	REQUIRE(g.read([](auto const& inner) { return inner.is_connected("", ""); }));
+	REQUIRE_THROWS_WITH((gdwg::durable_graph<int, int>(scratch.path())),
+	                    "Cannot open gdwg::mmap_graph file " + scratch.file("snapshot.1")
+	                        + ": node or weight type mismatch");
+	std::filesystem::remove(scratch.file("snapshot.1"));
+	REQUIRE_THROWS_WITH((gdwg::durable_graph<int, int>(scratch.path())),
+	                    "Cannot open gdwg::durable_graph " + scratch.path() + ": node or weight type mismatch");
+}
@@ -0,0 +1,283 @@
+#ifndef GDWG_WALKS_H
+#define GDWG_WALKS_H
+
+#include "gdwg_csr.h"
+#include "gdwg_graph.h"
+#include "gdwg_parallel.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace gdwg {
+	struct walk_options {
+		std::size_t walks_per_node = 10; // Walks started from every start node
+		std::size_t length = 80; // Nodes per walk, including the start
+		double p = 1.0; // node2vec return parameter: a step back to the previous node is weighted by 1 / p
+		double q = 1.0; // node2vec in-out parameter: a step away from the previous node is weighted by 1 / q
+		std::uint64_t seed = 6771;
+	};
+
+	// Walks stored contiguously with a fixed stride: walk i is nodes[i * length, i * length + lengths[i])
+	// A walk is shorter than length only if it reached a node it cannot leave; the rest of its slot is unused
+	struct walk_set {
+		std::size_t length = 0;
+		std::vector<std::size_t> nodes; // Node indices
+		std::vector<std::size_t> lengths;
+
+		[[nodiscard]] std::size_t size() const noexcept {
+			return lengths.size();
+		}
+
+		[[nodiscard]] std::span<std::size_t const> walk(std::size_t i) const {
+			return {nodes.data() + i * length, lengths[i]};
+		}
+	};
+
+	namespace detail {
+		// SplitMix64: a tiny generator whose state can be derived cheaply for every walk
+		class walk_rng {
+		 public:
+			explicit walk_rng(std::uint64_t state) noexcept
+			: state_(state) {}
+
+			// Stream of walk i: starts from the i-th output of the seed's own stream
+			static walk_rng for_walk(std::uint64_t seed, std::uint64_t i) noexcept {
+				return walk_rng(walk_rng(seed + i * golden).next());
+			}
+
+			std::uint64_t next() noexcept {
+				auto z = (state_ += golden);
+				z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+				z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+				return z ^ (z >> 31);
+			}
+
+			// Uniform in [0, 1)
+			double uniform() noexcept {
+				return static_cast<double>(next() >> 11) * 0x1.0p-53;
+			}
+
+			// Uniform in [0, n), for n > 0
+			std::size_t below(std::size_t n) noexcept {
+				return std::min(static_cast<std::size_t>(uniform() * static_cast<double>(n)), n - 1);
+			}
+
+		 private:
+			static constexpr auto golden = std::uint64_t{0x9e3779b97f4a7c15};
+			std::uint64_t state_;
+		};
+	} // namespace detail
+
+	// Weighted random walks over a snapshot (DeepWalk, or node2vec when p or q is not 1)
+	// Every node gets an alias table over its out-edges (Walker/Vose), so a weighted step is one uniform draw
+	// and one comparison. Arithmetic weights are the sampling weights (unweighted edges weigh 1). node2vec's
+	// second-order bias is applied by rejection: a candidate drawn from the first-order table is kept with
+	// probability bias / max bias, testing adjacency to the previous node by binary search in its sorted row.
+	// Every walk has its own random stream derived from the seed and the walk's index, so the output does not
+	// depend on the number of workers
+	class random_walker {
+	 public:
+		template<typename N, typename E>
+		explicit random_walker(csr_graph<N, E> const& g, thread_pool& pool = default_thread_pool())
+		: offsets_(g.offsets())
+		, targets_(g.targets())
+		, probability_(g.edge_count(), 1.0)
+		, alias_(g.edge_count(), 0)
+		, live_(g.node_count(), 0) {
+			auto weights = std::vector<double>(g.edge_count(), 1.0);
+			if constexpr (std::is_arithmetic_v<E>) {
+				auto const& edge_weights = g.edge_weights();
+				for (std::size_t e = 0; e < weights.size(); ++e) {
+					if (edge_weights[e]) {
+						weights[e] = static_cast<double>(*edge_weights[e]);
+						if (weights[e] < 0.0) {
+							throw std::runtime_error("Cannot construct gdwg::random_walker from a graph with negative "
+							                         "edge weights");
+						}
+					}
+				}
+			}
+			auto scratch = std::vector<alias_scratch>(pool.size());
+			parallel_for(pool, 0, g.node_count(), 256, [&](std::size_t lo, std::size_t hi, std::size_t worker) {
+				for (auto u = lo; u < hi; ++u) {
+					build_alias(u, weights, scratch[worker]);
+				}
+			});
+		}
+
+		// Return the number of nodes
+		[[nodiscard]] std::size_t node_count() const noexcept {
+			return live_.size();
+		}
+
+		// Generate walks_per_node walks from every node; walk i starts at node i % node_count()
+		[[nodiscard]] walk_set walks(walk_options const& options, thread_pool& pool = default_thread_pool()) const {
+			auto starts = std::vector<std::size_t>(node_count());
+			for (std::size_t u = 0; u < starts.size(); ++u) {
+				starts[u] = u;
+			}
+			return walks(starts, options, pool);
+		}
+
+		// Generate walks_per_node walks from each of the given nodes; walk i starts at starts[i % starts.size()]
+		[[nodiscard]] walk_set walks(std::span<std::size_t const> starts,
+		                             walk_options const& options,
+		                             thread_pool& pool = default_thread_pool()) const {
+			if (options.p <= 0.0 or options.q <= 0.0) {
+				throw std::runtime_error("Cannot call gdwg::random_walker::walks with non-positive p or q");
+			}
+			auto result = walk_set{};
+			result.length = options.length;
+			auto const count = starts.size() * options.walks_per_node;
+			result.nodes.assign(count * options.length, 0);
+			result.lengths.assign(count, 0);
+			if (options.length == 0) {
+				return result;
+			}
+			auto const second_order = options.p != 1.0 or options.q != 1.0;
+			parallel_for(pool, 0, count, 64, [&](std::size_t lo, std::size_t hi, std::size_t) {
+				for (auto i = lo; i < hi; ++i) {
+					auto rng = detail::walk_rng::for_walk(options.seed, i);
+					auto* out = result.nodes.data() + i * options.length;
+					result.lengths[i] = second_order ? walk_node2vec(starts[i % starts.size()], options, rng, out)
+					                                 : walk_first_order(starts[i % starts.size()], options, rng, out);
+				}
+			});
+			return result;
+		}
+
+	 private:
+		struct alias_scratch {
+			std::vector<std::size_t> small; // Edges below their fair share
+			std::vector<std::size_t> large; // Edges at or above their fair share
+		};
+
+		// Vose's alias method over the out-edges of u: every slot keeps its own edge with probability_[e] and
+		// hands the rest to alias_[e]
+		void build_alias(std::size_t u, std::vector<double> const& weights, alias_scratch& scratch) {
+			auto const first = offsets_[u];
+			auto const last = offsets_[u + 1];
+			auto total = 0.0;
+			for (auto e = first; e < last; ++e) {
+				total += weights[e];
+			}
+			if (first == last or total <= 0.0) {
+				return; // u cannot be left
+			}
+			live_[u] = 1;
+			scratch.small.clear();
+			scratch.large.clear();
+			for (auto e = first; e < last; ++e) {
+				probability_[e] = weights[e] * static_cast<double>(last - first) / total;
+				alias_[e] = e;
+				(probability_[e] < 1.0 ? scratch.small : scratch.large).push_back(e);
+			}
+			while (!scratch.small.empty() and !scratch.large.empty()) {
+				auto const s = scratch.small.back();
+				auto const l = scratch.large.back();
+				scratch.small.pop_back();
+				alias_[s] = l;
+				probability_[l] -= 1.0 - probability_[s];
+				if (probability_[l] < 1.0) {
+					scratch.large.pop_back();
+					scratch.small.push_back(l);
+				}
+			}
+			// Entries left over are 1 up to rounding
+			for (auto e : scratch.small) {
+				probability_[e] = 1.0;
+			}
+			for (auto e : scratch.large) {
+				probability_[e] = 1.0;
+			}
+		}
+
+		// Draw the target of one weighted out-edge of a live node
+		std::size_t step(std::size_t u, detail::walk_rng& rng) const {
+			auto const e = offsets_[u] + rng.below(offsets_[u + 1] - offsets_[u]);
+			return rng.uniform() < probability_[e] ? targets_[e] : targets_[alias_[e]];
+		}
+
+		[[nodiscard]] bool has_edge(std::size_t u, std::size_t v) const {
+			auto const first = targets_.begin() + static_cast<std::ptrdiff_t>(offsets_[u]);
+			auto const last = targets_.begin() + static_cast<std::ptrdiff_t>(offsets_[u + 1]);
+			return std::binary_search(first, last, v);
+		}
+
+		std::size_t walk_first_order(std::size_t u,
+		                             walk_options const& options,
+		                             detail::walk_rng& rng,
+		                             std::size_t* out) const {
+			auto written = std::size_t{0};
+			out[written++] = u;
+			while (written < options.length and live_[u]) {
+				u = step(u, rng);
+				out[written++] = u;
+			}
+			return written;
+		}
+
+		std::size_t walk_node2vec(std::size_t u,
+		                          walk_options const& options,
+		                          detail::walk_rng& rng,
+		                          std::size_t* out) const {
+			auto const back = 1.0 / options.p;
+			auto const away = 1.0 / options.q;
+			auto const most = std::max({back, 1.0, away});
+			auto written = std::size_t{0};
+			out[written++] = u;
+			if (written < options.length and live_[u]) {
+				auto previous = u;
+				u = step(u, rng);
+				out[written++] = u;
+				while (written < options.length and live_[u]) {
+					auto next = step(u, rng);
+					while (true) {
+						auto const bias = next == previous ? back : has_edge(previous, next) ? 1.0 : away;
+						if (rng.uniform() * most < bias) {
+							break;
+						}
+						next = step(u, rng);
+					}
+					previous = u;
+					u = next;
+					out[written++] = u;
+				}
+			}
+			return written;
+		}
+
+		std::vector<std::size_t> offsets_;
+		std::vector<std::size_t> targets_;
+		std::vector<double> probability_; // Probability of keeping every edge over its alias
+		std::vector<std::size_t> alias_; // Alias edge of every edge
+		std::vector<std::uint8_t> live_; // Whether each node has an out-edge of positive weight (bytes, since
+		                                 // the tables are built concurrently)
+	};
+
+	// Generate weighted random walks over a graph, as sequences of node values
+	template<typename N, typename E>
+	[[nodiscard]] std::vector<std::vector<N>> random_walks(graph<N, E> const& g,
+	                                                       walk_options const& options = {},
+	                                                       thread_pool& pool = default_thread_pool()) {
+		auto const snapshot = csr_graph<N, E>(g);
+		auto const walks = random_walker(snapshot, pool).walks(options, pool);
+		auto result = std::vector<std::vector<N>>{};
+		result.reserve(walks.size());
+		for (std::size_t i = 0; i < walks.size(); ++i) {
+			auto& walk = result.emplace_back();
+			walk.reserve(walks.lengths[i]);
+			for (auto u : walks.walk(i)) {
+				walk.push_back(snapshot.node(u));
+			}
+		}
+		return result;
+	}
+} // namespace gdwg
+
+#endif // GDWG_WALKS_H
@@ -0,0 +1,137 @@
+#include "gdwg_walks.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <map>
+
+// Random walk tests
+TEST_CASE("Walk steps follow the edge weights", "[walks]") {
+	gdwg::graph<int, int> g{0, 1, 2, 3, 4};
+	g.insert_edge(0, 1, 1);
+	g.insert_edge(0, 2, 2);
+	g.insert_edge(0, 3, 3);
+	g.insert_edge(0, 4, 4);
+	g.insert_edge(0, 4, 0); // Zero weights are never taken
+	auto const snapshot = gdwg::csr_graph<int, int>(g);
+	auto const walker = gdwg::random_walker(snapshot);
+
+	auto options = gdwg::walk_options{};
+	options.walks_per_node = 40000;
+	options.length = 2;
+	auto const start = std::vector<std::size_t>{0};
+	auto const walks = walker.walks(start, options);
+	REQUIRE(walks.size() == 40000);
+	auto counts = std::map<std::size_t, double>{};
+	for (std::size_t i = 0; i < walks.size(); ++i) {
+		REQUIRE(walks.lengths[i] == 2);
+		REQUIRE(walks.walk(i)[0] == 0);
+		++counts[walks.walk(i)[1]];
+	}
+	REQUIRE(counts.size() == 4);
+	for (std::size_t v = 1; v <= 4; ++v) {
+		CHECK(counts[v] / 40000.0 == Approx(static_cast<double>(v) / 10.0).margin(0.01));
+	}
+}
+
+TEST_CASE("Walks stop where they cannot go on", "[walks]") {
+	gdwg::graph<char, int> g{'a', 'b', 'c', 'd'};
+	g.insert_edge('a', 'b');
+	g.insert_edge('b', 'c');
+	g.insert_edge('d', 'a', 0);
+
+	auto options = gdwg::walk_options{};
+	options.walks_per_node = 2;
+	options.length = 5;
+	auto const walks = gdwg::random_walks(g, options);
+	REQUIRE(walks.size() == 8);
+	// Walk i starts at node i % 4
+	REQUIRE(walks[0] == std::vector<char>{'a', 'b', 'c'});
+	REQUIRE(walks[1] == std::vector<char>{'b', 'c'});
+	REQUIRE(walks[2] == std::vector<char>{'c'});
+	REQUIRE(walks[3] == std::vector<char>{'d'});
+	REQUIRE(walks[4] == walks[0]);
+
+	options.length = 0;
+	REQUIRE(gdwg::random_walks(g, options)[0].empty());
+}
+
+TEST_CASE("node2vec biases the second step", "[walks]") {
+	// From 1 (reached from 0) the walk can return to 0, go to 2 (adjacent to 0) or go to 3 (away from 0)
+	gdwg::graph<int, int> g{0, 1, 2, 3};
+	g.insert_edge(0, 1);
+	g.insert_edge(0, 2);
+	g.insert_edge(1, 0);
+	g.insert_edge(1, 2);
+	g.insert_edge(1, 3);
+	auto const snapshot = gdwg::csr_graph<int, int>(g);
+	auto const walker = gdwg::random_walker(snapshot);
+
+	auto options = gdwg::walk_options{};
+	options.walks_per_node = 60000;
+	options.length = 3;
+	options.p = 0.5;
+	options.q = 2.0;
+	auto const start = std::vector<std::size_t>{0};
+	auto const walks = walker.walks(start, options);
+	auto counts = std::map<std::size_t, double>{};
+	auto through = 0.0;
+	for (std::size_t i = 0; i < walks.size(); ++i) {
+		if (walks.walk(i)[1] == 1) {
+			REQUIRE(walks.lengths[i] == 3);
+			++counts[walks.walk(i)[2]];
+			++through;
+		}
+	}
+	// Biases 1 / p = 2, 1 and 1 / q = 0.5
+	CHECK(counts[0] / through == Approx(2.0 / 3.5).margin(0.015));
+	CHECK(counts[2] / through == Approx(1.0 / 3.5).margin(0.015));
+	CHECK(counts[3] / through == Approx(0.5 / 3.5).margin(0.015));
+
+	options.q = 0.0;
+	REQUIRE_THROWS_WITH(walker.walks(start, options),
+	                    "Cannot call gdwg::random_walker::walks with non-positive p or q");
+}
+
+TEST_CASE("Walks are reproducible for any number of workers", "[walks]") {
+	gdwg::graph<int, double> g;
+	for (auto v = 0; v < 200; ++v) {
+		g.insert_node(v);
+	}
+	for (auto v = 0; v < 200; ++v) {
+		for (auto d : {1, 7, 31}) {
+			g.insert_edge(v, (v + d) % 200, 1.0 + d % 5);
+		}
+	}
+	auto const snapshot = gdwg::csr_graph<int, double>(g);
+	auto one = gdwg::thread_pool(1);
+	auto four = gdwg::thread_pool(4);
+	auto const walker = gdwg::random_walker(snapshot, four);
+	auto options = gdwg::walk_options{};
+	options.q = 0.5;
+	auto const expected = walker.walks(options, one);
+	auto const walks = walker.walks(options, four);
+	REQUIRE(walks.nodes == expected.nodes);
+	REQUIRE(walks.lengths == expected.lengths);
+	REQUIRE(walks.size() == 200 * options.walks_per_node);
+
+	options.seed += 1;
+	REQUIRE(walker.walks(options, four).nodes != expected.nodes);
+
+	// Every step follows an edge
+	for (std::size_t i = 0; i < walks.size(); ++i) {
+		auto const walk = walks.walk(i);
+		REQUIRE(walk.size() == options.length);
+		for (std::size_t j = 1; j < walk.size(); ++j) {
+			auto const next = snapshot.neighbours(walk[j - 1]);
+			REQUIRE(std::find(next.begin(), next.end(), walk[j]) != next.end());
+		}
+	}
+}
+
+TEST_CASE("Negative walk weights throw", "[walks]") {
+	gdwg::graph<int, int> g{1, 2};
+	g.insert_edge(1, 2, -1);
+	REQUIRE_THROWS_WITH(gdwg::random_walks(g),
+	                    "Cannot construct gdwg::random_walker from a graph with negative edge weights");
+}